@@ -29,6 +29,7 @@
 #include <unistd.h>
 #include "misc.h"
 #include "devname.h"
+#include "procps-private.h"
 
 // This is the buffer size for a tty name. Any path is legal,
 // which makes PAGE_SIZE appropriate (see kernel source), but
@@ -67,7 +68,7 @@ static void load_drivers(void){
   char *p;
   int fd;
   int bytes;
-  fd = open("/proc/tty/drivers",O_RDONLY);
+  fd = open(procfs_path("/proc/tty/drivers"),O_RDONLY);
   if(fd == -1) goto fail;
   bytes = read(fd, buf, sizeof(buf) - 1);
   if(bytes == -1) goto fail;
@@ -285,9 +286,9 @@ static int guess_name(char *restrict const buf, unsigned maj, unsigned min){
  */
 static int link_name(char *restrict const buf, unsigned maj, unsigned min, int pid, const char *restrict name){
   struct stat sbuf;
-  char path[32];
+  char path[PROCROOTLEN + 32];
   ssize_t count;
-  const int len = snprintf(path, sizeof path, "/proc/%d/%s", pid, name);  /* often permission denied */
+  const int len = snprintf(path, sizeof path, "%s/%d/%s", procfs_root(), pid, name);  /* often permission denied */
   if(len <= 0 || (size_t)len >= sizeof path) return 0;
   count = readlink(path,buf,TTY_NAME_SIZE-1);
   if(count <= 0 || count >= TTY_NAME_SIZE-1) return 0;
@@ -302,10 +303,10 @@ static int link_name(char *restrict const buf, unsigned maj, unsigned min, int p
 /* Cygwin keeps the name to the controlling tty in a virtual file called
    /proc/PID/ctty, including a trailing LF (sigh). */
 static int ctty_name(char *restrict const buf, int pid) {
-  char path[32];
+  char path[PROCROOTLEN + 32];
   FILE *fp;
   char *lf;
-  sprintf (path, "/proc/%d/ctty", pid);  /* often permission denied */
+  snprintf (path, sizeof path, "%s/%d/ctty", procfs_root(), pid);  /* often permission denied */
   fp = fopen (path, "r");
   if (!fp)
     return 0;
@@ -33,6 +33,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "misc.h"
 #include "procps-private.h"
 #include "diskstats.h"
 
@@ -113,6 +114,8 @@ struct diskstats_info {
     struct ext_support fetch_ext;      // supports concurrent select/reap
     struct fetch_support fetch;        // support for procps_diskstats_reap
     struct diskstats_result get_this;  // used by procps_diskstats_get
+    int cost_yes;                      // procps_diskstats_cost was called
+    struct procps_cost cost;           // the counters it exposes
 };
 
 
@@ -403,6 +406,7 @@ static int node_update (
     if (!target) {
         if (!(target = malloc(sizeof(struct dev_node))))
             return 0;
+        info->cost.allocs++;
         memcpy(target, source, sizeof(struct dev_node));
         // let's not distort the deltas when a new node is created ...
         memcpy(&target->old, &target->new, sizeof(struct dev_data));
@@ -515,11 +519,18 @@ static int diskstats_read_failed (
         "s %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu";
     char buf[DISKSTATS_LINE_LEN];
     struct dev_node node;
+    unsigned long long began = 0, mark = 0;
     int rc;
 
-    if (!info->diskstats_fp
-    && (!(info->diskstats_fp = fopen(DISKSTATS_FILE, "r"))))
-        return 1;
+    if (info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        mark = began = procps_cost_ns();
+    }
+    if (!info->diskstats_fp) {
+        if (!(info->diskstats_fp = fopen(procfs_path(DISKSTATS_FILE), "r")))
+            return 1;
+        info->cost.opened++;
+    }
 
     if (fseek(info->diskstats_fp, 0L, SEEK_SET) == -1)
         return 1;
@@ -528,6 +539,12 @@ static int diskstats_read_failed (
     info->new_stamp = time(NULL);
 
     while (fgets(buf, DISKSTATS_LINE_LEN, info->diskstats_fp)) {
+        if (info->cost_yes) {
+            // with reads and parsing interleaved, each line is timed apart
+            info->cost.read_ns += procps_cost_ns() - mark;
+            info->cost.reads++;
+            info->cost.bytes += strlen(buf);
+        }
         // clear out the soon to be 'current'values
         memset(&node, 0, sizeof(struct dev_node));
 
@@ -554,8 +571,18 @@ static int diskstats_read_failed (
         node.stamped = info->new_stamp;
         if (!node_update(info, &node))
             return 1;        // here, errno was set to ENOMEM
+        if (info->cost_yes)
+            mark = procps_cost_ns();
     }
 
+    if (info->cost_yes) {
+        info->cost.read_ns += procps_cost_ns() - mark;
+        info->cost.total_ns = procps_cost_ns() - began;
+        info->cost.parse_ns = info->cost.total_ns - info->cost.read_ns;
+        info->cost.file[PROCPS_COST_OTHER].opened = info->cost.opened;
+        info->cost.file[PROCPS_COST_OTHER].bytes = info->cost.bytes;
+        info->cost.file[PROCPS_COST_OTHER].read_ns = info->cost.read_ns;
+    }
     return 0;
 } // end: diskstats_read_failed
 
@@ -809,6 +836,29 @@ PROCPS_EXPORT int procps_diskstats_unref (
 
 // --- variable interface functions -------------------------------------------
 
+/* procps_diskstats_cost():
+ *
+ * Enable (on first use) the accounting of what each read of
+ * /proc/diskstats costs.
+ *
+ * Returns: pointer to the counters for the most recent read.
+ */
+PROCPS_EXPORT struct procps_cost *procps_diskstats_cost (
+        struct diskstats_info *info)
+{
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    errno = 0;
+
+    if (!info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        info->cost_yes = 1;
+    }
+    return &info->cost;
+} // end: procps_diskstats_cost
+
+
 PROCPS_EXPORT struct diskstats_result *procps_diskstats_get (
         struct diskstats_info *info,
         const char *name,
@@ -23,7 +23,9 @@
 #include <ctype.h>
 #include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <wchar.h>
 
 #include "escape.h"
 #include "readproc.h"
@@ -84,18 +86,41 @@ static int u8charlen (const unsigned char *s, unsigned size) {
    return -1;
 }
 
+/*
+ * Return the screen columns needed by one valid multibyte character,
+ * allowing a zero as with a 'combining acute accent'
+ */
+static inline int u8charcols (const unsigned char *s, int n) {
+   mbstate_t ps;
+   wchar_t wc;
+   int cols;
+
+   // unlike mbtowc, this keeps no hidden state (so it's thread-safe)
+   memset(&ps, 0, sizeof(ps));
+   if (mbrtowc(&wc, (const char *)s, n, &ps) != (size_t)n
+   || (cols = wcwidth(wc)) < 0)
+      return 1;
+   return cols;
+}
+
 /*
  * Given a bad locale/corrupt str, replace all non-printing stuff
  */
-static inline void esc_all (unsigned char *str) {
+static inline void esc_all (unsigned char *str, struct esc_meta *meta) {
+   unsigned char *beg = str, high = 0;
+
    while (*str) {
       if (!isprint(*str))
           *str = '?';
+      high |= *str;
       ++str;
    }
+   // in a single byte locale, every byte is one column
+   meta->cols = str - beg;
+   meta->ascii = !(high & 0x80);
 }
 
-static inline void esc_ctl (unsigned char *str, int len) {
+static inline void esc_ctl (unsigned char *str, int len, struct esc_meta *meta) {
    int n;
 
    if (len <= 0)
@@ -117,15 +142,31 @@ static inline void esc_ctl (unsigned char *str, int len) {
          *str = '?';
          n = 1;
       }
+      if (n > 1) {
+         meta->ascii = 0;
+         meta->cols += u8charcols(str, n);
+      } else
+         meta->cols++;
       str += n;
       len -= n;
    }
 }
 
-int escape_str (char *dst, const char *src, int bufsize) {
+/*
+ * Copy and escape src, also noting in meta (if not NULL) the screen
+ * columns it needs and whether it's pure ASCII, since that's learned
+ * for free along the way
+ */
+int escape_str (char *dst, const char *src, int bufsize, struct esc_meta *meta) {
    static __thread int utf_sw = 0;
+   struct esc_meta junk;
    int n;
 
+   if (!meta)
+      meta = &junk;
+   meta->cols = 0;
+   meta->ascii = 1;
+
    if (utf_sw == 0) {
       char *enc = nl_langinfo(CODESET);
       utf_sw = enc && strcasecmp(enc, "UTF-8") == 0 ? 1 : -1;
@@ -138,13 +179,13 @@ int escape_str (char *dst, const char *src, int bufsize) {
    }
    if (n >= bufsize) n = bufsize-1;
    if (utf_sw < 0)
-      esc_all((unsigned char *)dst);
+      esc_all((unsigned char *)dst, meta);
    else
-      esc_ctl((unsigned char *)dst, n);
+      esc_ctl((unsigned char *)dst, n, meta);
    return n;
 }
 
-int escape_command (char *outbuf, const proc_t *pp, int bytes, unsigned flags) {
+int escape_command (char *outbuf, const proc_t *pp, int bytes, unsigned flags, struct esc_meta *meta) {
    int overhead = 0;
    int end = 0;
 
@@ -157,11 +198,18 @@ int escape_command (char *outbuf, const proc_t *pp, int bytes, unsigned flags) {
    if (overhead + 1 >= bytes) {
       // if no room for even one byte of the command name
       outbuf[0] = '\0';
+      if (meta) {
+         meta->cols = 0;
+         meta->ascii = 1;
+      }
       return 0;
    }
    if (flags & ESC_BRACKETS)
       outbuf[end++] = '[';
-   end += escape_str(outbuf+end, pp->cmd, bytes-overhead);
+   end += escape_str(outbuf+end, pp->cmd, bytes-overhead, meta);
+   // our decorations are all plain ASCII, one column per byte
+   if (meta)
+      meta->cols += overhead;
    // we want "[foo] <defunct>", not "[foo <defunct>]"
    if (flags & ESC_BRACKETS)
       outbuf[end++] = ']';
@@ -85,6 +85,7 @@ struct diskstats_reaped {
 };
 
 struct diskstats_info;
+struct procps_cost;                // see misc.h
 
 
 #define DISKSTATS_TYPE_DISK       -11111
@@ -102,6 +103,9 @@ int procps_diskstats_new   (struct diskstats_info **info);
 int procps_diskstats_ref   (struct diskstats_info  *info);
 int procps_diskstats_unref (struct diskstats_info **info);
 
+struct procps_cost *procps_diskstats_cost (
+    struct diskstats_info *info);
+
 struct diskstats_result *procps_diskstats_get (
     struct diskstats_info *info,
     const char *name,
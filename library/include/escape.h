@@ -28,8 +28,8 @@
 #define ESC_BRACKETS 0x2  // if using cmd, put '[' and ']' around it
 #define ESC_DEFUNCT  0x4  // mark zombies with " <defunct>"
 
-int escape_command (char *outbuf, const proc_t *pp, int bytes, unsigned flags);
+int escape_command (char *outbuf, const proc_t *pp, int bytes, unsigned flags, struct esc_meta *meta);
 
-int escape_str (char *dst, const char *src, int bufsize);
+int escape_str (char *dst, const char *src, int bufsize, struct esc_meta *meta);
 
 #endif
@@ -0,0 +1,118 @@
+/*
+ * irq.h - interrupt and softirq related declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_IRQ_H
+#define PROCPS_IRQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum irq_item {
+    IRQ_noop,                       //        ( never altered )
+    IRQ_extra,                      //        ( reset to zero )
+                                    //  returns        origin, see proc(5)
+                                    //  -------        -------------------
+    IRQ_NAME,                       //      str        /proc/interrupts or /proc/softirqs
+    IRQ_TYPE,                       //    s_int         "
+    IRQ_DESCRIPTION,                //      str         "
+    IRQ_TOTAL,                      //   ul_int         "
+    IRQ_CPUS,                       //  ul_cpus         "
+
+    IRQ_DELTA_TOTAL,                //    s_int        derived from above
+    IRQ_DELTA_CPUS,                 //  ul_cpus         "
+    IRQ_DELTA_CPU_HOT,              //    s_int         "
+    IRQ_DELTA_CPU_MAX,              //    s_int         "
+    IRQ_DELTA_CPUS_ACTIVE           //    s_int         "
+};
+
+enum irq_sort_order {
+    IRQ_SORT_ASCEND   = +1,
+    IRQ_SORT_DESCEND  = -1
+};
+
+
+struct irq_result {
+    enum irq_item item;
+    union {
+        signed int     s_int;
+        unsigned long  ul_int;
+        unsigned long *ul_cpus;    // one per cpu, see procps_irq_cpus
+        char          *str;
+    } result;
+};
+
+struct irq_stack {
+    struct irq_result *head;
+};
+
+struct irq_reaped {
+    int total;
+    struct irq_stack **stacks;
+};
+
+struct irq_info;
+
+
+#define IRQ_TYPE_HARD  -11111
+#define IRQ_TYPE_SOFT  -22222
+
+#define IRQ_GET( info, name, actual_enum, type ) ( { \
+    struct irq_result *r = procps_irq_get( info, name, actual_enum ); \
+    r ? r->result . type : 0; } )
+
+#define IRQ_VAL( relative_enum, type, stack ) \
+    stack -> head [ relative_enum ] . result . type
+
+
+int procps_irq_new   (struct irq_info **info);
+int procps_irq_ref   (struct irq_info  *info);
+int procps_irq_unref (struct irq_info **info);
+
+int procps_irq_cpus (struct irq_info *info);
+
+struct irq_result *procps_irq_get (
+    struct irq_info *info,
+    const char *name,
+    enum irq_item item);
+
+struct irq_reaped *procps_irq_reap (
+    struct irq_info *info,
+    enum irq_item *items,
+    int numitems);
+
+struct irq_stack *procps_irq_select (
+    struct irq_info *info,
+    const char *name,
+    enum irq_item *items,
+    int numitems);
+
+struct irq_stack **procps_irq_sort (
+    struct irq_info *info,
+    struct irq_stack *stacks[],
+    int numstacked,
+    enum irq_item sortitem,
+    enum irq_sort_order order);
+
+
+#ifdef XTRA_PROCPS_DEBUG
+# include "xtra-procps-debug.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
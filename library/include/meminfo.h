@@ -192,6 +192,7 @@ struct meminfo_stack {
 };
 
 struct meminfo_info;
+struct procps_cost;                // see misc.h
 
 
 #define MEMINFO_GET( info, actual_enum, type ) ( { \
@@ -206,6 +207,9 @@ int procps_meminfo_new   (struct meminfo_info **info);
 int procps_meminfo_ref   (struct meminfo_info  *info);
 int procps_meminfo_unref (struct meminfo_info **info);
 
+struct procps_cost *procps_meminfo_cost (
+    struct meminfo_info *info);
+
 struct meminfo_result *procps_meminfo_get (
     struct meminfo_info *info,
     enum meminfo_item item);
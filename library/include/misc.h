@@ -87,6 +87,41 @@ int procps_ns_get_id (const char *name);
 int procps_ns_read_pid (const int pid, struct procps_ns *nsp);
 
 
+// //////////////////////////////////////////////////////////////////
+// Cost Particulars /////////////////////////////////////////////////
+
+enum procps_cost_file {
+    PROCPS_COST_STAT,
+    PROCPS_COST_STATM,
+    PROCPS_COST_STATUS,
+    PROCPS_COST_CMDLINE,
+    PROCPS_COST_ENVIRON,
+    PROCPS_COST_CGROUP,
+    PROCPS_COST_SMAPS,
+    PROCPS_COST_IO,
+    PROCPS_COST_OOM,
+    PROCPS_COST_OTHER,
+    PROCPS_COST_COUNT  // total file types (fencepost)
+};
+
+struct procps_cost {
+    unsigned long opened;          // files successfully opened
+    unsigned long reads;           // read requests issued against them
+    unsigned long long bytes;      // bytes those reads returned
+    unsigned long allocs;          // heap allocations made along the way
+    unsigned long vanished;        // tasks which exited while being read
+    unsigned long long read_ns;    // time spent opening and reading
+    unsigned long long parse_ns;   // time spent converting what was read
+    unsigned long long total_ns;   // time for the whole library call
+    unsigned long compares;        // made by any sorts, after a pids reap/select
+    struct {
+        unsigned long opened;
+        unsigned long long bytes;
+        unsigned long long read_ns;
+    } file[PROCPS_COST_COUNT];
+};
+
+
 #ifdef __cplusplus
 }
 #endif
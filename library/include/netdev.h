@@ -0,0 +1,137 @@
+/*
+ * netdev.h - network interface related declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_NETDEV_H
+#define PROCPS_NETDEV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum netdev_item {
+    NETDEV_noop,                    //        ( never altered )
+    NETDEV_extra,                   //        ( reset to zero )
+                                    //  returns        origin, see proc(5)
+                                    //  -------        -------------------
+    NETDEV_NAME,                    //      str        /proc/net/dev
+    NETDEV_IFINDEX,                 //    s_int        /sys/class/net/<name>/ifindex
+
+    NETDEV_RX_BYTES,                //   ul_int        /proc/net/dev
+    NETDEV_RX_PACKETS,              //   ul_int         "
+    NETDEV_RX_ERRORS,               //   ul_int         "
+    NETDEV_RX_DROPPED,              //   ul_int         "
+    NETDEV_RX_FIFO,                 //   ul_int         "
+    NETDEV_RX_FRAME,                //   ul_int         "
+    NETDEV_RX_COMPRESSED,           //   ul_int         "
+    NETDEV_RX_MULTICAST,            //   ul_int         "
+    NETDEV_TX_BYTES,                //   ul_int         "
+    NETDEV_TX_PACKETS,              //   ul_int         "
+    NETDEV_TX_ERRORS,               //   ul_int         "
+    NETDEV_TX_DROPPED,              //   ul_int         "
+    NETDEV_TX_FIFO,                 //   ul_int         "
+    NETDEV_TX_COLLISIONS,           //   ul_int         "
+    NETDEV_TX_CARRIER,              //   ul_int         "
+    NETDEV_TX_COMPRESSED,           //   ul_int         "
+
+    NETDEV_RX_CRC_ERRORS,           //   ul_int        /sys/class/net/<name>/statistics
+    NETDEV_RX_LENGTH_ERRORS,        //   ul_int         "
+    NETDEV_RX_MISSED_ERRORS,        //   ul_int         "
+    NETDEV_RX_OVER_ERRORS,          //   ul_int         "
+    NETDEV_TX_ABORTED_ERRORS,       //   ul_int         "
+    NETDEV_TX_HEARTBEAT_ERRORS,     //   ul_int         "
+    NETDEV_TX_WINDOW_ERRORS,        //   ul_int         "
+
+    NETDEV_DELTA_RX_BYTES,          //   ul_int        derived from above
+    NETDEV_DELTA_RX_PACKETS,        //   ul_int         "
+    NETDEV_DELTA_RX_ERRORS,         //   ul_int         "
+    NETDEV_DELTA_RX_DROPPED,        //   ul_int         "
+    NETDEV_DELTA_TX_BYTES,          //   ul_int         "
+    NETDEV_DELTA_TX_PACKETS,        //   ul_int         "
+    NETDEV_DELTA_TX_ERRORS,         //   ul_int         "
+    NETDEV_DELTA_TX_DROPPED         //   ul_int         "
+};
+
+enum netdev_sort_order {
+    NETDEV_SORT_ASCEND   = +1,
+    NETDEV_SORT_DESCEND  = -1
+};
+
+
+struct netdev_result {
+    enum netdev_item item;
+    union {
+        signed int     s_int;
+        unsigned long  ul_int;
+        char          *str;
+    } result;
+};
+
+struct netdev_stack {
+    struct netdev_result *head;
+};
+
+struct netdev_reaped {
+    int total;
+    struct netdev_stack **stacks;
+};
+
+struct netdev_info;
+
+
+#define NETDEV_GET( info, name, actual_enum, type ) ( { \
+    struct netdev_result *r = procps_netdev_get( info, name, actual_enum ); \
+    r ? r->result . type : 0; } )
+
+#define NETDEV_VAL( relative_enum, type, stack ) \
+    stack -> head [ relative_enum ] . result . type
+
+
+int procps_netdev_new   (struct netdev_info **info);
+int procps_netdev_ref   (struct netdev_info  *info);
+int procps_netdev_unref (struct netdev_info **info);
+
+struct netdev_result *procps_netdev_get (
+    struct netdev_info *info,
+    const char *name,
+    enum netdev_item item);
+
+struct netdev_reaped *procps_netdev_reap (
+    struct netdev_info *info,
+    enum netdev_item *items,
+    int numitems);
+
+struct netdev_stack *procps_netdev_select (
+    struct netdev_info *info,
+    const char *name,
+    enum netdev_item *items,
+    int numitems);
+
+struct netdev_stack **procps_netdev_sort (
+    struct netdev_info *info,
+    struct netdev_stack *stacks[],
+    int numstacked,
+    enum netdev_item sortitem,
+    enum netdev_sort_order order);
+
+
+#ifdef XTRA_PROCPS_DEBUG
+# include "xtra-procps-debug.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
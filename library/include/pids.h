@@ -178,6 +178,7 @@ enum pids_item {
     PIDS_UTILIZATION_C,     //     real        derived from TIME_ALL_C / TIME_ELAPSED, as percentage
     PIDS_VM_DATA,           //   ul_int        status: VmData
     PIDS_VM_EXE,            //   ul_int        status: VmExe
+    PIDS_VM_HUGETLB,        //   ul_int        status: HugetlbPages
     PIDS_VM_LIB,            //   ul_int        status: VmLib
     PIDS_VM_RSS,            //   ul_int        status: VmRSS
     PIDS_VM_RSS_ANON,       //   ul_int        status: RssAnon
@@ -241,6 +242,8 @@ struct pids_fetch {
 };
 
 struct pids_info;
+struct pids_sort_hint;             // see procps_pids_sort_hinted
+struct procps_cost;                // see misc.h
 
 
 #define PIDS_VAL( relative_enum, type, stack ) \
@@ -255,10 +258,22 @@ struct pids_stack *fatal_proc_unmounted (
     struct pids_info *info,
     int return_self);
 
+double procps_pids_age (
+    const struct pids_stack *stack,
+    int relative_enum);
+
+struct procps_cost *procps_pids_cost (
+    struct pids_info *info);
+
 struct pids_stack *procps_pids_get (
     struct pids_info *info,
     enum pids_fetch_type which);
 
+int procps_pids_max_age (
+    struct pids_info *info,
+    enum pids_item item,
+    double seconds);
+
 struct pids_fetch *procps_pids_reap (
     struct pids_info *info,
     enum pids_fetch_type which);
@@ -281,6 +296,19 @@ struct pids_stack **procps_pids_sort (
     enum pids_item sortitem,
     enum pids_sort_order order);
 
+struct pids_stack **procps_pids_sort_hinted (
+    struct pids_info *info,
+    struct pids_sort_hint **hint,
+    struct pids_stack *stacks[],
+    int numstacked,
+    enum pids_item sortitem,
+    enum pids_sort_order order);
+
+int procps_pids_str_cols (
+    const struct pids_stack *stack,
+    int relative_enum,
+    int *ascii);
+
 
 #ifdef XTRA_PROCPS_DEBUG
 # include "xtra-procps-debug.h"
@@ -18,6 +18,8 @@
 #ifndef PROCPS_PRIVATE_H
 #define PROCPS_PRIVATE_H
 
+#include <time.h>
+
 #define PROCPS_EXPORT __attribute__ ((visibility("default")))
 
 #define STRINGIFY_ARG(a)	#a
@@ -25,4 +27,27 @@
 
 #define MAXTABLE(t)		(int)(sizeof(t) / sizeof(t[0]))
 
+// an alternate to the "/proc" or "/sys" directory (LIBPROC_PROC_ROOT or
+// LIBPROC_SYS_ROOT) can't exceed this
+#define PROCROOTLEN		192
+
+const char *procfs_root (void);
+const char *procfs_path (const char *path);
+const char *sysfs_path (const char *path);
+
+// procps_uptime is served by the per thread context behind procps_loadavg
+int sysinfo_uptime (double *uptime_secs, double *idle_secs);
+
+// procps_snapshot_take lends its boot time to the next pids reap
+struct pids_info;
+void pids_snapshot_boot (struct pids_info *info, double boottime);
+
+// a monotonic timestamp for the optional cost accounting (see misc.h)
+static inline unsigned long long procps_cost_ns (void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
 #endif
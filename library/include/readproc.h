@@ -39,6 +39,13 @@
 // neither tgid nor tid seemed correct. (in other words, FIXME)
 #define XXXID tid
 
+// What escape_str learned about a string while it was being escaped,
+// so that anyone displaying it later needn't walk those bytes again.
+struct esc_meta {
+    int cols;           // screen columns it occupies, or -1 if unknown
+    int ascii;          // true if every byte is 7-bit (so cols == strlen)
+};
+
 // Basic data structure which holds all information we can get about a process.
 // (unless otherwise specified, fields are read from /proc/#/stat)
 //
@@ -105,6 +112,7 @@ typedef struct proc_t {
         vm_stack,       // status          stack only size (as kb)
         vm_swap,        // status          based on linux-2.6.34 "swap ents" (as kb)
         vm_exe,         // status          equals 'trs' (as kb)
+        vm_hugetlb,     // status          hugetlbfs pages, shared or private (as kb)
         vm_lib,         // status          total, not just used, library pages (as kb)
         vsize,          // stat            number of pages of virtual memory ...
         rss_rlim,       // stat            resident set size limit?
@@ -199,13 +207,21 @@ typedef struct proc_t {
         autogrp_id,     // autogroup       autogroup number (id)
         autogrp_nice,   // autogroup       autogroup nice value
         fds;            // fd              number of open files
+    struct esc_meta
+        cgname_esc,     // (special)       width + ascii flag of cgname
+        cgroup_esc,     // (special)       width + ascii flag of cgroup
+        cmd_esc,        // stat,status     width + ascii flag of cmd
+        cmdline_esc,    // (special)       width + ascii flag of cmdline
+        environ_esc,    // (special)       width + ascii flag of environ
+        exe_esc;        // exe             width + ascii flag of exe
 } proc_t;
 
 // PROCTAB: data structure holding the persistent information readproc needs
 // from openproc().  The setup is intentionally similar to the dirent interface
 // and other system table interfaces (utmp+wtmp come to mind).
 
-#define PROCPATHLEN 64  // must hold /proc/2000222000/task/2000222000/cmdline
+#define PROCPATHLEN 256 // must hold <root>/2000222000/task/2000222000/cmdline
+                        // ( where <root> is "/proc" or any LIBPROC_PROC_ROOT )
 
 typedef struct PROCTAB {
     DIR        *procfs;
@@ -227,6 +243,12 @@ typedef struct PROCTAB {
     void *      vp; // generic
     char        path[PROCPATHLEN];  // must hold /proc/2000222000/task/2000222000/cmdline
     unsigned pathlen;        // length of string in the above (w/o '\0')
+    struct slab_s *slab;     // when set, owns every proc_t string (see below)
+    struct procps_cost *cost; // when set, charged with all reads (see misc.h)
+    // when set, asked once stat is read which flags needn't be honored for
+    // this task, the caller having retained those values from a prior read
+    unsigned (*retained)(struct PROCTAB *__restrict const, const proc_t *__restrict const);
+    void       *retain_data;  // for use by the above
 } PROCTAB;
 
 
@@ -306,8 +328,22 @@ proc_t *readproc(PROCTAB *__restrict const PT, proc_t *__restrict p);
 proc_t *readeither(PROCTAB *__restrict const PT, proc_t *__restrict x);
 int look_up_our_self(void);
 void closeproc(PROCTAB *PT);
+// Restart a scan with the same flags, avoiding another openproc/closeproc.
+// Any PT->pids or PT->uids list must then be re-established by the caller.
+void rewindproc(PROCTAB *PT);
 char **vectorize_this_str(const char *src);
 
+// A slab is a bump allocator whose strings are released all at once.  When
+// a caller places one in PROCTAB.slab (after openproc), every proc_t string
+// (including the vectorized ones) is carved from that slab, and the caller is
+// expected to slab_reset() it only when those strings are no longer needed.
+struct slab_s;
+struct slab_s *slab_new(void);
+void slab_free(struct slab_s *slab);
+void slab_reset(struct slab_s *slab);
+char *slab_strdup(struct slab_s *slab, const char *str);
+char **slab_vectorize(struct slab_s *slab, const char *src);
+
 struct utlbuf_s;
 struct docker_ids;
 char *lxc_containers(const char *path, struct utlbuf_s *ub);
@@ -0,0 +1,69 @@
+/*
+ * snapshot.h - frame coherent sampling declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_SNAPSHOT_H
+#define PROCPS_SNAPSHOT_H
+
+#include "meminfo.h"
+#include "pids.h"
+#include "stat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct snapshot_result {
+    struct stat_reaped   *stat;        // as from procps_stat_reap (if added)
+    struct meminfo_stack *meminfo;     // as from procps_meminfo_select (if added)
+    struct pids_fetch    *pids;        // as from procps_pids_reap (if added)
+    double boottime;                   // CLOCK_BOOTTIME secs, shared by all
+    double elapsed;                    // secs since the prior snapshot (or 0)
+    double skew;                       // secs between the first & last reads
+};
+
+
+struct snapshot_info;
+
+int procps_snapshot_new   (struct snapshot_info **info);
+int procps_snapshot_ref   (struct snapshot_info  *info);
+int procps_snapshot_unref (struct snapshot_info **info);
+
+int procps_snapshot_add_meminfo (
+    struct snapshot_info *info,
+    struct meminfo_info *meminfo,
+    enum meminfo_item *items,
+    int numitems);
+
+int procps_snapshot_add_pids (
+    struct snapshot_info *info,
+    struct pids_info *pids,
+    enum pids_fetch_type which);
+
+int procps_snapshot_add_stat (
+    struct snapshot_info *info,
+    struct stat_info *stat,
+    enum stat_reap_type what,
+    enum stat_item *items,
+    int numitems);
+
+struct snapshot_result *procps_snapshot_take (
+    struct snapshot_info *info);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
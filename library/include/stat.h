@@ -82,7 +82,14 @@ enum stat_item {
     STAT_SYS_DELTA_INTERRUPTS,    //    s_int         "
     STAT_SYS_DELTA_PROC_BLOCKED,  //    s_int         "
     STAT_SYS_DELTA_PROC_CREATED,  //    s_int         "
-    STAT_SYS_DELTA_PROC_RUNNING   //    s_int         "
+    STAT_SYS_DELTA_PROC_RUNNING,  //    s_int         "
+
+    STAT_TIC_CPUFREQ_CUR,         //   ul_int        /sys/devices/system/cpu/cpuN/cpufreq, kHz
+    STAT_TIC_CPUFREQ_MAX,         //   ul_int         "
+    STAT_TIC_DELTA_CPUIDLE,       //  ull_int        /sys/devices/system/cpu/cpuN/cpuidle, usecs
+    STAT_TIC_DELTA_CPUIDLE_DEEP,  //  ull_int         "  ( deepest state only )
+    STAT_TIC_THROTTLES,           //   ul_int        /sys/devices/system/cpu/cpuN/thermal_throttle
+    STAT_TIC_DELTA_THROTTLES      //   sl_int         "
 };
 
 enum stat_reap_type {
@@ -122,6 +129,7 @@ struct stat_reaped {
 };
 
 struct stat_info;
+struct procps_cost;                // see misc.h
 
 
     // STAT_TIC_ID value for /proc/stat cpu summary
@@ -143,6 +151,9 @@ int procps_stat_new   (struct stat_info **info);
 int procps_stat_ref   (struct stat_info  *info);
 int procps_stat_unref (struct stat_info **info);
 
+struct procps_cost *procps_stat_cost (
+    struct stat_info *info);
+
 struct stat_result *procps_stat_get (
     struct stat_info *info,
     enum stat_item item);
@@ -0,0 +1,48 @@
+/*
+ * sysinfo.h - persistent system information declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_SYSINFO_H
+#define PROCPS_SYSINFO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sysinfo_result {
+    double uptime;                     // /proc/uptime: secs since boot
+    double idle;                       //   secs all cpus were idle
+    double av1, av5, av15;             // /proc/loadavg: the load averages
+    int    runnable;                   //   tasks now runnable
+    int    tasks;                      //   tasks that exist
+    int    last_pid;                   //   pid most recently assigned
+    int    pid_max;                    // /proc/sys/kernel/pid_max (or 0)
+};
+
+
+struct sysinfo_info;
+
+int procps_sysinfo_new   (struct sysinfo_info **info);
+int procps_sysinfo_ref   (struct sysinfo_info  *info);
+int procps_sysinfo_unref (struct sysinfo_info **info);
+
+struct sysinfo_result *procps_sysinfo_read (
+    struct sysinfo_info *info);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
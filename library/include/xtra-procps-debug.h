@@ -55,6 +55,39 @@ struct diskstats_result *xtra_diskstats_val (
 #endif // . . . . . . . . . .
 
 
+// --- IRQ ------------------------------------------------
+#if defined(PROCPS_IRQ_H) && !defined(PROCPS_IRQ_H_DEBUG)
+#define PROCPS_IRQ_H_DEBUG
+
+struct irq_result *xtra_irq_get (
+    struct irq_info *info,
+    const char *name,
+    enum irq_item actual_enum,
+    const char *typestr,
+    const char *file,
+    int lineno);
+
+# undef IRQ_GET
+#define IRQ_GET( info, name, actual_enum, type ) ( { \
+    struct irq_result *r; \
+    r = xtra_irq_get(info, name, actual_enum , STRINGIFY(type), __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+
+struct irq_result *xtra_irq_val (
+    int relative_enum,
+    const char *typestr,
+    const struct irq_stack *stack,
+    const char *file,
+    int lineno);
+
+# undef IRQ_VAL
+#define IRQ_VAL( relative_enum, type, stack ) ( { \
+    struct irq_result *r; \
+    r = xtra_irq_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+#endif // . . . . . . . . . .
+
+
 // --- MEMINFO --------------------------------------------
 #if defined(PROCPS_MEMINFO_H) && !defined(PROCPS_MEMINFO_H_DEBUG)
 #define PROCPS_MEMINFO_H_DEBUG
@@ -87,6 +120,39 @@ struct meminfo_result *xtra_meminfo_val (
 #endif // . . . . . . . . . .
 
 
+// --- NETDEV ---------------------------------------------
+#if defined(PROCPS_NETDEV_H) && !defined(PROCPS_NETDEV_H_DEBUG)
+#define PROCPS_NETDEV_H_DEBUG
+
+struct netdev_result *xtra_netdev_get (
+    struct netdev_info *info,
+    const char *name,
+    enum netdev_item actual_enum,
+    const char *typestr,
+    const char *file,
+    int lineno);
+
+# undef NETDEV_GET
+#define NETDEV_GET( info, name, actual_enum, type ) ( { \
+    struct netdev_result *r; \
+    r = xtra_netdev_get(info, name, actual_enum , STRINGIFY(type), __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+
+struct netdev_result *xtra_netdev_val (
+    int relative_enum,
+    const char *typestr,
+    const struct netdev_stack *stack,
+    const char *file,
+    int lineno);
+
+# undef NETDEV_VAL
+#define NETDEV_VAL( relative_enum, type, stack ) ( { \
+    struct netdev_result *r; \
+    r = xtra_netdev_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+#endif // . . . . . . . . . .
+
+
 // --- PIDS -----------------------------------------------
 #if defined(PROCPS_PIDS_H) && !defined(PROCPS_PIDS_H_DEBUG)
 #define PROCPS_PIDS_H_DEBUG
@@ -200,3 +266,37 @@ struct vmstat_result *xtra_vmstat_val (
     r = xtra_vmstat_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
     r ? r->result . type : 0; } )
 #endif // . . . . . . . . . .
+
+
+// --- ZONES ----------------------------------------------
+#if defined(PROCPS_ZONES_H) && !defined(PROCPS_ZONES_H_DEBUG)
+#define PROCPS_ZONES_H_DEBUG
+
+struct zones_result *xtra_zones_get (
+    struct zones_info *info,
+    int node,
+    const char *zone,
+    enum zones_item actual_enum,
+    const char *typestr,
+    const char *file,
+    int lineno);
+
+# undef ZONES_GET
+#define ZONES_GET( info, node, zone, actual_enum, type ) ( { \
+    struct zones_result *r; \
+    r = xtra_zones_get(info, node, zone, actual_enum , STRINGIFY(type), __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+
+struct zones_result *xtra_zones_val (
+    int relative_enum,
+    const char *typestr,
+    const struct zones_stack *stack,
+    const char *file,
+    int lineno);
+
+# undef ZONES_VAL
+#define ZONES_VAL( relative_enum, type, stack ) ( { \
+    struct zones_result *r; \
+    r = xtra_zones_val(relative_enum, STRINGIFY(type), stack, __FILE__, __LINE__); \
+    r ? r->result . type : 0; } )
+#endif // . . . . . . . . . .
@@ -0,0 +1,144 @@
+/*
+ * zones.h - memory zone and fragmentation related declarations for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef PROCPS_ZONES_H
+#define PROCPS_ZONES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum zones_item {
+    ZONES_noop,                     //        ( never altered )
+    ZONES_extra,                    //        ( reset to zero )
+                                    //  returns        origin, see proc(5)
+                                    //  -------        -------------------
+    ZONES_NODE,                     //    s_int        /proc/zoneinfo
+    ZONES_NAME,                     //      str         "
+    ZONES_PAGES_FREE,               //   ul_int         "
+    ZONES_PAGES_MIN,                //   ul_int         "
+    ZONES_PAGES_LOW,                //   ul_int         "
+    ZONES_PAGES_HIGH,               //   ul_int         "
+    ZONES_PAGES_SPANNED,            //   ul_int         "
+    ZONES_PAGES_PRESENT,            //   ul_int         "
+    ZONES_PAGES_MANAGED,            //   ul_int         "
+
+    ZONES_BLOCKS_ORDER_0,           //   ul_int        /proc/buddyinfo
+    ZONES_BLOCKS_ORDER_1,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_2,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_3,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_4,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_5,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_6,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_7,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_8,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_9,           //   ul_int         "
+    ZONES_BLOCKS_ORDER_10,          //   ul_int         "
+
+    ZONES_FREE_UNMOVABLE,           //   ul_int        /proc/pagetypeinfo
+    ZONES_FREE_MOVABLE,             //   ul_int         "
+    ZONES_FREE_RECLAIMABLE,         //   ul_int         "
+    ZONES_FREE_HIGHATOMIC,          //   ul_int         "
+    ZONES_FREE_CMA,                 //   ul_int         "
+    ZONES_FREE_ISOLATE,             //   ul_int         "
+
+    ZONES_DISTANCE_MIN,             //   sl_int        derived from above
+    ZONES_DISTANCE_LOW,             //   sl_int         "
+    ZONES_DISTANCE_HIGH,            //   sl_int         "
+    ZONES_LARGEST_ORDER,            //    s_int         "
+    ZONES_FRAG_INDEX_COSTLY,        //     real         "
+    ZONES_FRAG_INDEX_HUGE,          //     real         "
+    ZONES_UNUSABLE_COSTLY,          //     real         "
+    ZONES_UNUSABLE_HUGE             //     real         "
+};
+
+enum zones_sort_order {
+    ZONES_SORT_ASCEND   = +1,
+    ZONES_SORT_DESCEND  = -1
+};
+
+
+struct zones_result {
+    enum zones_item item;
+    union {
+        signed int     s_int;
+        signed long    sl_int;
+        unsigned long  ul_int;
+        double         real;
+        char          *str;
+    } result;
+};
+
+struct zones_stack {
+    struct zones_result *head;
+};
+
+struct zones_reaped {
+    int total;
+    struct zones_stack **stacks;
+};
+
+struct zones_info;
+
+
+#define ZONES_GET( info, node, zone, actual_enum, type ) ( { \
+    struct zones_result *r = procps_zones_get( info, node, zone, actual_enum ); \
+    r ? r->result . type : 0; } )
+
+#define ZONES_VAL( relative_enum, type, stack ) \
+    stack -> head [ relative_enum ] . result . type
+
+
+int procps_zones_new   (struct zones_info **info);
+int procps_zones_ref   (struct zones_info  *info);
+int procps_zones_unref (struct zones_info **info);
+
+int procps_zones_huge_order (struct zones_info *info);
+
+struct zones_result *procps_zones_get (
+    struct zones_info *info,
+    int node,
+    const char *zone,
+    enum zones_item item);
+
+struct zones_reaped *procps_zones_reap (
+    struct zones_info *info,
+    enum zones_item *items,
+    int numitems);
+
+struct zones_stack *procps_zones_select (
+    struct zones_info *info,
+    int node,
+    const char *zone,
+    enum zones_item *items,
+    int numitems);
+
+struct zones_stack **procps_zones_sort (
+    struct zones_info *info,
+    struct zones_stack *stacks[],
+    int numstacked,
+    enum zones_item sortitem,
+    enum zones_sort_order order);
+
+
+#ifdef XTRA_PROCPS_DEBUG
+# include "xtra-procps-debug.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
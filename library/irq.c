@@ -0,0 +1,1108 @@
+/*
+ * irq.c - interrupt and softirq related definitions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "procps-private.h"
+#include "irq.h"
+
+#define IRQ_HARD_FILE       "/proc/interrupts"
+#define IRQ_SOFT_FILE       "/proc/softirqs"
+#define IRQ_NAME_LEN        32
+#define IRQ_DESC_LEN        128
+
+#define BUFFER_INCR         8192         // amount the file buffer grows
+#define NODES_INCR          64           // amount the nodes array grows
+#define STACKS_INCR         64           // amount reap stack allocations grow
+#define STR_COMPARE         strverscmp
+
+/* ----------------------------------------------------------------------- +
+   this provision can help ensure that our Item_table remains synchronized |
+   with the enumerators found in the associated header file. It's intended |
+   to only be used locally (& temporarily) at some point before a release! | */
+// #define ITEMTABLE_DEBUG //--------------------------------------------- |
+// ----------------------------------------------------------------------- +
+
+
+struct irq_node {
+    char name[IRQ_NAME_LEN+1];
+    int type;
+    char *desc;                        // whatever follows the counts, if anything
+    unsigned long total;
+    unsigned long old_total;
+    unsigned long *new;                // these 3 are each n_cpus long and
+    unsigned long *old;                // share a single allocation, which
+    unsigned long *delta;              // begins with 'new'
+    int hot;                           // the cpu with the largest delta
+    int max;                           // and that delta
+    int active;                        // cpus with any delta at all
+    unsigned seen;                     // the read which last found this node
+};
+
+struct stacks_extent {
+    int ext_numstacks;
+    struct stacks_extent *next;
+    struct irq_stack **stacks;
+};
+
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum irq_item *items;              // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for these extents
+};
+
+struct fetch_support {
+    struct irq_stack **anchor;         // fetch consolidated extents
+    int n_alloc;                       // number of above pointers allocated
+    int n_inuse;                       // number of above pointers occupied
+    int n_alloc_save;                  // last known reap.stacks allocation
+    struct irq_reaped results;         // count + stacks for return to caller
+};
+
+struct irq_info {
+    int refcount;
+    int hard_fd;                       // /proc/interrupts, kept open
+    int soft_fd;                       // /proc/softirqs, kept open
+    char *buf;                         // either file, read in one gulp
+    int buf_size;
+    int *cols;                         // the cpu number for each column
+    int n_cols;
+    int n_cols_alloc;
+    int n_cpus;                        // 1 + the highest cpu number yet seen
+    struct irq_node *nodes;            // in the order the files list them
+    int n_nodes;
+    int n_alloc;
+    unsigned reads;                    // to identify any vanished nodes
+    time_t stamp;                      // for procps_irq_get's granularity
+    struct ext_support select_ext;     // supports concurrent select/reap
+    struct ext_support fetch_ext;      // supports concurrent select/reap
+    struct fetch_support fetch;        // support for procps_irq_reap
+    struct irq_result get_this;        // used by procps_irq_get
+};
+
+
+// ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+#define setNAME(e) set_irq_ ## e
+#define setDECL(e) static void setNAME(e) \
+    (struct irq_result *R, struct irq_node *N)
+
+// regular assignment
+#define REG_set(e,t,x) setDECL(e) { R->result. t = N-> x; }
+// delta assignment
+#define HST_set(e,t,x) setDECL(e) { R->result. t = ( N-> x - N->old_ ## x ); }
+
+setDECL(noop)  { (void)R; (void)N; }
+setDECL(extra) { (void)N; R->result.ul_int = 0; }
+
+REG_set(NAME,                 str,     name)
+REG_set(TYPE,                 s_int,   type)
+setDECL(DESCRIPTION)          { R->result.str = N->desc ? N->desc : ""; }
+REG_set(TOTAL,                ul_int,  total)
+REG_set(CPUS,                 ul_cpus, new)
+
+HST_set(DELTA_TOTAL,          s_int,   total)
+REG_set(DELTA_CPUS,           ul_cpus, delta)
+REG_set(DELTA_CPU_HOT,        s_int,   hot)
+REG_set(DELTA_CPU_MAX,        s_int,   max)
+REG_set(DELTA_CPUS_ACTIVE,    s_int,   active)
+
+#undef setDECL
+#undef REG_set
+#undef HST_set
+
+
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum irq_sort_order order;
+};
+
+#define srtNAME(t) sort_irq_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct irq_stack **A, const struct irq_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct irq_result *a = (*A)->head + P->offset;
+    const struct irq_result *b = (*B)->head + P->offset;
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(ul_int) {
+    const struct irq_result *a = (*A)->head + P->offset;
+    const struct irq_result *b = (*B)->head + P->offset;
+    if ( a->result.ul_int > b->result.ul_int ) return P->order > 0 ?  1 : -1;
+    if ( a->result.ul_int < b->result.ul_int ) return P->order > 0 ? -1 :  1;
+    return 0;
+}
+
+srtDECL(str) {
+    const struct irq_result *a = (*A)->head + P->offset;
+    const struct irq_result *b = (*B)->head + P->offset;
+    return P->order * STR_COMPARE(a->result.str, b->result.str);
+}
+
+srtDECL(noop) {
+    (void)A; (void)B; (void)P;
+    return 0;
+}
+
+#undef srtDECL
+
+
+// ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+typedef void (*SET_t)(struct irq_result *, struct irq_node *);
+#ifdef ITEMTABLE_DEBUG
+#define RS(e) (SET_t)setNAME(e), IRQ_ ## e, STRINGIFY(IRQ_ ## e)
+#else
+#define RS(e) (SET_t)setNAME(e)
+#endif
+
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
+#define TS(t) STRINGIFY(t)
+#define TS_noop ""
+
+        /*
+         * Need it be said?
+         * This table must be kept in the exact same order as
+         * those *enum irq_item* guys ! */
+static struct {
+    SET_t setsfunc;              // the actual result setting routine
+#ifdef ITEMTABLE_DEBUG
+    int   enumnumb;              // enumerator (must match position!)
+    char *enum2str;              // enumerator name as a char* string
+#endif
+    QSR_t sortfunc;              // sort cmp func for a specific type
+    char *type2str;              // the result type as a string value
+} Item_table[] = {
+/*  setsfunc                  sortfunc     type2str
+    ------------------------  -----------  ---------- */
+  { RS(noop),                 QS(noop),    TS_noop    },
+  { RS(extra),                QS(ul_int),  TS_noop    },
+
+  { RS(NAME),                 QS(str),     TS(str)    },
+  { RS(TYPE),                 QS(s_int),   TS(s_int)  },
+  { RS(DESCRIPTION),          QS(str),     TS(str)    },
+  { RS(TOTAL),                QS(ul_int),  TS(ul_int) },
+  { RS(CPUS),                 QS(noop),    TS(ul_cpus)},
+
+  { RS(DELTA_TOTAL),          QS(s_int),   TS(s_int)  },
+  { RS(DELTA_CPUS),           QS(noop),    TS(ul_cpus)},
+  { RS(DELTA_CPU_HOT),        QS(s_int),   TS(s_int)  },
+  { RS(DELTA_CPU_MAX),        QS(s_int),   TS(s_int)  },
+  { RS(DELTA_CPUS_ACTIVE),    QS(s_int),   TS(s_int)  },
+};
+
+    /* please note,
+     * this enum MUST be 1 greater than the highest value of any enum */
+enum irq_item IRQ_logical_end = MAXTABLE(Item_table);
+
+#undef setNAME
+#undef srtNAME
+#undef RS
+#undef QS
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- irq_node specific support ----------------------------------------------
+
+static void node_free (
+        struct irq_node *node)
+{
+    free(node->new);
+    free(node->desc);
+} // end: node_free
+
+
+static struct irq_node *node_get (
+        struct irq_info *info,
+        const char *name,
+        int type,
+        int hint)
+{
+    int i;
+
+    /* the files list their rows in the same order with every read, so the
+       row following whichever was last found is nearly always the one ... */
+    if (hint < info->n_nodes
+    && info->nodes[hint].type == type
+    && !strcmp(info->nodes[hint].name, name))
+        return &info->nodes[hint];
+    for (i = 0; i < info->n_nodes; i++) {
+        if (info->nodes[i].type == type
+        && !strcmp(info->nodes[i].name, name))
+            return &info->nodes[i];
+    }
+    return NULL;
+} // end: node_get
+
+
+static struct irq_node *node_new (
+        struct irq_info *info,
+        const char *name,
+        int type)
+{
+    struct irq_node *node;
+
+    if (info->n_nodes >= info->n_alloc) {
+        if (!(node = realloc(info->nodes, sizeof(struct irq_node) * (info->n_alloc + NODES_INCR))))
+            return NULL;     // here, errno was set to ENOMEM
+        info->nodes = node;
+        info->n_alloc += NODES_INCR;
+    }
+    node = &info->nodes[info->n_nodes];
+    memset(node, 0, sizeof(struct irq_node));
+    if (!(node->new = calloc(3 * info->n_cpus, sizeof(unsigned long))))
+        return NULL;
+    node->old = node->new + info->n_cpus;
+    node->delta = node->old + info->n_cpus;
+    snprintf(node->name, sizeof(node->name), "%s", name);
+    node->type = type;
+    info->n_nodes++;
+    return node;
+} // end: node_new
+
+
+        /*
+         * Some newly seen cpu requires that every node's counts grow.
+         * Any counts for a cpu which is new are of course zero. */
+static int nodes_widen (
+        struct irq_info *info,
+        int n_cpus)
+{
+    struct irq_node *node;
+    unsigned long *p;
+    int i, was = info->n_cpus;
+
+    for (i = 0; i < info->n_nodes; i++) {
+        node = &info->nodes[i];
+        if (!(p = calloc(3 * n_cpus, sizeof(unsigned long))))
+            return 0;        // here, errno was set to ENOMEM
+        memcpy(p, node->new, sizeof(unsigned long) * was);
+        memcpy(p + n_cpus, node->old, sizeof(unsigned long) * was);
+        memcpy(p + 2 * n_cpus, node->delta, sizeof(unsigned long) * was);
+        free(node->new);
+        node->new = p;
+        node->old = p + n_cpus;
+        node->delta = p + 2 * n_cpus;
+    }
+    info->n_cpus = n_cpus;
+    return 1;
+} // end: nodes_widen
+
+
+static void node_derive (
+        struct irq_node *node,
+        int n_cpus,
+        int fresh)
+{
+    unsigned long total = 0, d;
+    int i;
+
+    // let's not distort the deltas when a new node is created ...
+    if (fresh)
+        memcpy(node->old, node->new, sizeof(unsigned long) * n_cpus);
+    node->hot = -1;
+    node->max = node->active = 0;
+    for (i = 0; i < n_cpus; i++) {
+        total += node->new[i];
+        // a counter which went backwards (a cpu went offline) isn't activity
+        d = node->delta[i] = node->new[i] > node->old[i] ? node->new[i] - node->old[i] : 0;
+        if (d) {
+            node->active++;
+            if ((int)d > node->max) {
+                node->max = (int)d;
+                node->hot = i;
+            }
+        }
+    }
+    // the few rows without per-cpu counts (ERR, MIS) have already set a total
+    if (total || !node->total)
+        node->total = total;
+    if (fresh)
+        node->old_total = node->total;
+} // end: node_derive
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- generalized support ----------------------------------------------------
+
+static inline void irq_assign_results (
+        struct irq_stack *stack,
+        struct irq_node *node)
+{
+    struct irq_result *this = stack->head;
+
+    for (;;) {
+        enum irq_item item = this->item;
+        if (item >= IRQ_logical_end)
+            break;
+        Item_table[item].setsfunc(this, node);
+        ++this;
+    }
+    return;
+} // end: irq_assign_results
+
+
+static void irq_extents_free_all (
+        struct ext_support *this)
+{
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
+        free(p);
+    };
+} // end: irq_extents_free_all
+
+
+static inline struct irq_result *irq_itemize_stack (
+        struct irq_result *p,
+        int depth,
+        enum irq_item *items)
+{
+    struct irq_result *p_sav = p;
+    int i;
+
+    for (i = 0; i < depth; i++) {
+        p->item = items[i];
+        ++p;
+    }
+    return p_sav;
+} // end: irq_itemize_stack
+
+
+static inline int irq_items_check_failed (
+        enum irq_item *items,
+        int numitems)
+{
+    int i;
+
+    /* if an enum is passed instead of an address of one or more enums, ol' gcc
+     * will silently convert it to an address (possibly NULL).  only clang will
+     * offer any sort of warning like the following:
+     *
+     * warning: incompatible integer to pointer conversion passing 'int' to parameter of type 'enum irq_item *'
+     * my_stack = procps_irq_select(info, IRQ_noop, num);
+     *                                    ^~~~~~~~
+     */
+    if (numitems < 1
+    || (void *)items < (void *)(unsigned long)(2 * IRQ_logical_end))
+        return 1;
+
+    for (i = 0; i < numitems; i++) {
+        // an irq_item is currently unsigned, but we'll protect our future
+        if (items[i] < 0)
+            return 1;
+        if (items[i] >= IRQ_logical_end)
+            return 1;
+    }
+
+    return 0;
+} // end: irq_items_check_failed
+
+
+/*
+ * irq_file_slurp:
+ *
+ * Read all of one file into our buffer.  On a host with hundreds of
+ * cpus, each line of /proc/interrupts can run to several thousand
+ * bytes, so line oriented reads are avoided.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int irq_file_slurp (
+        struct irq_info *info,
+        int *fd,
+        const char *path)
+{
+    char *buf;
+    int num, tot_read = 0;
+
+    if (*fd < 0
+    && (*fd = open(procfs_path(path), O_RDONLY | O_CLOEXEC)) < 0)
+        return 1;
+    if (!info->buf) {
+        if (!(info->buf = malloc(BUFFER_INCR)))
+            return 1;
+        info->buf_size = BUFFER_INCR;
+    }
+    for (;;) {
+        if ((num = pread(*fd, info->buf + tot_read, info->buf_size - tot_read - 1, tot_read)) < 0)
+            return 1;
+        tot_read += num;
+        if (!num || tot_read < info->buf_size - 1)
+            break;
+        if (!(buf = realloc(info->buf, info->buf_size + BUFFER_INCR)))
+            return 1;
+        info->buf = buf;
+        info->buf_size += BUFFER_INCR;
+    }
+    info->buf[tot_read] = '\0';
+    return 0;
+} // end: irq_file_slurp
+
+
+/*
+ * irq_parse_failed:
+ *
+ * Digest one of those files, now in our buffer.  Its header says which
+ * cpu each column belongs to (offline cpus are absent), after which each
+ * row holds a name, a count for every column, then maybe a description.
+ * The counts are parsed by hand, column by column, rather than by some
+ * sscanf format with hundreds of conversions.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int irq_parse_failed (
+        struct irq_info *info,
+        int type)
+{
+    char name[IRQ_NAME_LEN+1], desc[IRQ_DESC_LEN];
+    struct irq_node *node;
+    char *p = info->buf, *q;
+    unsigned long v;
+    int i, n, hint = 0, fresh, n_cpus = info->n_cpus;
+    int *cols;
+
+    // the header, "CPU0  CPU1 ..." ----------------------
+    info->n_cols = 0;
+    while (*p && *p != '\n') {
+        while (*p == ' ' || *p == '\t')
+            ++p;
+        if (strncmp(p, "CPU", 3))
+            break;
+        n = (int)strtol(p + 3, &q, 10);
+        if (q == p + 3 || n < 0) {
+            errno = ERANGE;
+            return 1;
+        }
+        p = q;
+        if (info->n_cols >= info->n_cols_alloc) {
+            if (!(cols = realloc(info->cols, sizeof(int) * (info->n_cols_alloc + NODES_INCR))))
+                return 1;
+            info->cols = cols;
+            info->n_cols_alloc += NODES_INCR;
+        }
+        info->cols[info->n_cols++] = n;
+        if (n >= n_cpus)
+            n_cpus = n + 1;
+    }
+    if (!info->n_cols) {
+        errno = ERANGE;
+        return 1;
+    }
+    if (n_cpus > info->n_cpus && !nodes_widen(info, n_cpus))
+        return 1;
+    p = strchr(p, '\n');
+
+    // then each row --------------------------------------
+    while (p && *++p) {
+        while (*p == ' ')
+            ++p;
+        if (!(q = strchr(p, ':')) || q - p > IRQ_NAME_LEN)
+            break;
+        memcpy(name, p, q - p);
+        name[q - p] = '\0';
+        p = q + 1;
+
+        fresh = 0;
+        if (!(node = node_get(info, name, type, hint))) {
+            if (!(node = node_new(info, name, type)))
+                return 1;    // here, errno was set to ENOMEM
+            fresh = 1;
+        }
+        hint = node - info->nodes + 1;
+        // remember history from last time around ...
+        memcpy(node->old, node->new, sizeof(unsigned long) * info->n_cpus);
+        node->old_total = node->total;
+        memset(node->new, 0, sizeof(unsigned long) * info->n_cpus);
+        node->total = 0;
+
+        for (i = 0; i < info->n_cols; i++) {
+            while (*p == ' ' || *p == '\t')
+                ++p;
+            if (*p < '0' || *p > '9')
+                break;
+            for (v = 0; *p >= '0' && *p <= '9'; ++p)
+                v = v * 10 + (*p - '0');
+            node->new[info->cols[i]] = v;
+            node->total += v;
+        }
+        // with a lone count (ERR, MIS), it was never a per-cpu value
+        if (i < info->n_cols)
+            memset(node->new, 0, sizeof(unsigned long) * info->n_cpus);
+
+        // whatever remains is the description, its spacing collapsed
+        for (n = 0; *p && *p != '\n'; ++p) {
+            if (*p == ' ' || *p == '\t') {
+                if (n && desc[n - 1] != ' ' && n < IRQ_DESC_LEN - 1)
+                    desc[n++] = ' ';
+                continue;
+            }
+            if (n < IRQ_DESC_LEN - 1)
+                desc[n++] = *p;
+        }
+        while (n && desc[n - 1] == ' ')
+            --n;
+        desc[n] = '\0';
+        if (n && (!node->desc || strcmp(node->desc, desc))) {
+            free(node->desc);
+            if (!(node->desc = strdup(desc)))
+                return 1;
+        }
+        node_derive(node, info->n_cpus, fresh);
+        node->seen = info->reads;
+    }
+    return 0;
+} // end: irq_parse_failed
+
+
+/*
+ * irq_read_failed:
+ *
+ * @info: info structure created at procps_irq_new
+ *
+ * Read both /proc/interrupts and /proc/softirqs, updating our nodes
+ * and discarding any which are no longer listed (a freed irq).
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int irq_read_failed (
+        struct irq_info *info)
+{
+    int i, j;
+
+    info->reads++;
+    info->stamp = time(NULL);
+
+    if (irq_file_slurp(info, &info->hard_fd, IRQ_HARD_FILE)
+    || irq_parse_failed(info, IRQ_TYPE_HARD))
+        return 1;
+    // a kernel without softirqs accounting is not an error
+    if (!irq_file_slurp(info, &info->soft_fd, IRQ_SOFT_FILE)
+    && irq_parse_failed(info, IRQ_TYPE_SOFT))
+        return 1;
+
+    for (i = j = 0; i < info->n_nodes; i++) {
+        if (info->nodes[i].seen != info->reads) {
+            node_free(&info->nodes[i]);
+            continue;
+        }
+        if (i != j)
+            info->nodes[j] = info->nodes[i];
+        j++;
+    }
+    info->n_nodes = j;
+    return 0;
+} // end: irq_read_failed
+
+
+/*
+ * irq_stacks_alloc():
+ *
+ * Allocate and initialize one or more stacks each of which is anchored in an
+ * associated context structure.
+ *
+ * All such stacks will have their result structures properly primed with
+ * 'items', while the result itself will be zeroed.
+ *
+ * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
+ */
+static struct stacks_extent *irq_stacks_alloc (
+        struct ext_support *this,
+        int maxstacks)
+{
+    struct stacks_extent *p_blob;
+    struct irq_stack **p_vect;
+    struct irq_stack *p_head;
+    size_t vect_size, head_size, list_size, blob_size;
+    void *v_head, *v_list;
+    int i;
+
+    vect_size  = sizeof(void *) * maxstacks;                        // size of the addr vectors |
+    vect_size += sizeof(void *);                                    // plus NULL addr delimiter |
+    head_size  = sizeof(struct irq_stack);                          // size of that head struct |
+    list_size  = sizeof(struct irq_result) * this->numitems;        // any single results stack |
+    blob_size  = sizeof(struct stacks_extent);                      // the extent anchor itself |
+    blob_size += vect_size;                                         // plus room for addr vects |
+    blob_size += head_size * maxstacks;                             // plus room for head thing |
+    blob_size += list_size * maxstacks;                             // plus room for our stacks |
+
+    /* note: all of our memory is allocated in one single blob, facilitating some later free(). |
+             as a minimum, it's important that all of those result structs themselves always be |
+             contiguous within every stack since they will be accessed via a relative position. | */
+    if (NULL == (p_blob = calloc(1, blob_size)))
+        return NULL;
+
+    p_blob->next = this->extents;                                   // push this extent onto... |
+    this->extents = p_blob;                                         // ...some existing extents |
+    p_vect = (void *)p_blob + sizeof(struct stacks_extent);         // prime our vector pointer |
+    p_blob->stacks = p_vect;                                        // set actual vectors start |
+    v_head = (void *)p_vect + vect_size;                            // prime head pointer start |
+    v_list = v_head + (head_size * maxstacks);                      // prime our stacks pointer |
+
+    for (i = 0; i < maxstacks; i++) {
+        p_head = (struct irq_stack *)v_head;
+        p_head->head = irq_itemize_stack((struct irq_result *)v_list, this->numitems, this->items);
+        p_blob->stacks[i] = p_head;
+        v_list += list_size;
+        v_head += head_size;
+    }
+    p_blob->ext_numstacks = maxstacks;
+    return p_blob;
+} // end: irq_stacks_alloc
+
+
+static int irq_stacks_fetch (
+        struct irq_info *info)
+{
+ #define n_alloc  info->fetch.n_alloc
+ #define n_inuse  info->fetch.n_inuse
+ #define n_saved  info->fetch.n_alloc_save
+    struct stacks_extent *ext;
+    int i;
+
+    // initialize stuff -----------------------------------
+    if (!info->fetch.anchor) {
+        if (!(info->fetch.anchor = calloc(sizeof(void *), STACKS_INCR)))
+            return -ENOMEM;
+        n_alloc = STACKS_INCR;
+    }
+    if (!info->fetch_ext.extents) {
+        if (!(ext = irq_stacks_alloc(&info->fetch_ext, n_alloc)))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * n_alloc);
+    }
+
+    // iterate stuff --------------------------------------
+    n_inuse = 0;
+    for (i = 0; i < info->n_nodes; i++) {
+        if (!(n_inuse < n_alloc)) {
+            n_alloc += STACKS_INCR;
+            if ((!(info->fetch.anchor = realloc(info->fetch.anchor, sizeof(void *) * n_alloc)))
+            || (!(ext = irq_stacks_alloc(&info->fetch_ext, STACKS_INCR))))
+                return -1;   // here, errno was set to ENOMEM
+            memcpy(info->fetch.anchor + n_inuse, ext->stacks, sizeof(void *) * STACKS_INCR);
+        }
+        irq_assign_results(info->fetch.anchor[n_inuse], &info->nodes[i]);
+        ++n_inuse;
+    }
+
+    // finalize stuff -------------------------------------
+    if (n_saved < n_inuse + 1) {
+        n_saved = n_inuse + 1;
+        if (!(info->fetch.results.stacks = realloc(info->fetch.results.stacks, sizeof(void *) * n_saved)))
+            return -1;
+    }
+    memcpy(info->fetch.results.stacks, info->fetch.anchor, sizeof(void *) * n_inuse);
+    info->fetch.results.stacks[n_inuse] = NULL;
+    info->fetch.results.total = n_inuse;
+
+    return n_inuse;
+ #undef n_alloc
+ #undef n_inuse
+ #undef n_saved
+} // end: irq_stacks_fetch
+
+
+static int irq_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum irq_item *items,
+        int numitems)
+{
+    if (irq_items_check_failed(items, numitems))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum irq_item) * numitems)) {
+        // allow for our IRQ_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum irq_item) * (numitems + 1))))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(this->items, items, sizeof(enum irq_item) * numitems);
+        this->items[numitems] = IRQ_logical_end;
+        this->numitems = numitems + 1;
+        irq_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: irq_stacks_reconfig_maybe
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_irq_new():
+ *
+ * @info: location of returned new structure
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_irq_new (
+        struct irq_info **info)
+{
+    struct irq_info *p;
+
+#ifdef ITEMTABLE_DEBUG
+    int i, failed = 0;
+    for (i = 0; i < MAXTABLE(Item_table); i++) {
+        if (i != Item_table[i].enumnumb) {
+            fprintf(stderr, "%s: enum/table error: Item_table[%d] was %s, but its value is %d\n"
+                , __FILE__, i, Item_table[i].enum2str, Item_table[i].enumnumb);
+            failed = 1;
+        }
+    }
+    if (failed) _Exit(EXIT_FAILURE);
+#endif
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct irq_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    p->hard_fd = p->soft_fd = -1;
+
+    /* do a priming read here for the following potential benefits: |
+         1) ensure there will be no problems with subsequent access |
+         2) make delta results potentially useful, even if 1st time |
+         3) elimnate need for history distortions 1st time 'switch' | */
+    if (irq_read_failed(p)) {
+        procps_irq_unref(&p);
+        return -errno;
+    }
+
+    *info = p;
+    return 0;
+} // end: procps_irq_new
+
+
+PROCPS_EXPORT int procps_irq_ref (
+        struct irq_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_irq_ref
+
+
+PROCPS_EXPORT int procps_irq_unref (
+        struct irq_info **info)
+{
+    int i;
+
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        if ((*info)->hard_fd >= 0)
+            close((*info)->hard_fd);
+        if ((*info)->soft_fd >= 0)
+            close((*info)->soft_fd);
+        for (i = 0; i < (*info)->n_nodes; i++)
+            node_free(&(*info)->nodes[i]);
+        free((*info)->nodes);
+        free((*info)->cols);
+        free((*info)->buf);
+
+        if ((*info)->select_ext.extents)
+            irq_extents_free_all((&(*info)->select_ext));
+        if ((*info)->select_ext.items)
+            free((*info)->select_ext.items);
+
+        if ((*info)->fetch.anchor)
+            free((*info)->fetch.anchor);
+        if ((*info)->fetch.results.stacks)
+            free((*info)->fetch.results.stacks);
+
+        if ((*info)->fetch_ext.extents)
+            irq_extents_free_all(&(*info)->fetch_ext);
+        if ((*info)->fetch_ext.items)
+            free((*info)->fetch_ext.items);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_irq_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+/* procps_irq_cpus():
+ *
+ * The IRQ_CPUS and IRQ_DELTA_CPUS items each point to this many
+ * counts, indexed by cpu number.  Any cpu which is offline has a
+ * count of zero.  The number only grows, with the next read after
+ * some higher numbered cpu is brought online.
+ *
+ * Returns: that number of cpus, or < 0 on error.
+ */
+PROCPS_EXPORT int procps_irq_cpus (
+        struct irq_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+    return info->n_cpus;
+} // end: procps_irq_cpus
+
+
+PROCPS_EXPORT struct irq_result *procps_irq_get (
+        struct irq_info *info,
+        const char *name,
+        enum irq_item item)
+{
+    struct irq_node *node;
+    time_t cur_secs;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL)
+        return NULL;
+    if (item < 0 || item >= IRQ_logical_end)
+        return NULL;
+    errno = 0;
+
+    /* we will NOT read the irq files with every call - rather, we'll offer
+       a granularity of 1 second between reads ... */
+    cur_secs = time(NULL);
+    if (1 <= cur_secs - info->stamp) {
+        if (irq_read_failed(info))
+            return NULL;
+    }
+
+    info->get_this.item = item;
+    //  with 'get', we must NOT honor the usual 'noop' guarantee
+    info->get_this.result.ul_int = 0;
+
+    if (!(node = node_get(info, name, IRQ_TYPE_HARD, 0))
+    && !(node = node_get(info, name, IRQ_TYPE_SOFT, 0))) {
+        errno = ENXIO;
+        return NULL;
+    }
+    Item_table[item].setsfunc(&info->get_this, node);
+
+    return &info->get_this;
+} // end: procps_irq_get
+
+
+/* procps_irq_reap():
+ *
+ * Harvest all the requested interrupt and softirq information,
+ * the hard irqs first, each in the order their file lists them.
+ * Any IRQ_CPUS or IRQ_DELTA_CPUS results remain valid only until
+ * the next reap, select or get.
+ *
+ * Returns: pointer to an irq_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct irq_reaped *procps_irq_reap (
+        struct irq_info *info,
+        enum irq_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > irq_stacks_reconfig_maybe(&info->fetch_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (irq_read_failed(info))
+        return NULL;
+    if (0 > irq_stacks_fetch(info))
+        return NULL;
+
+    return &info->fetch.results;
+} // end: procps_irq_reap
+
+
+/* procps_irq_select():
+ *
+ * Obtain all the requested information for one irq or softirq,
+ * by name, then return it in a single library provided results
+ * stack.  Should a name be both, the hard irq is chosen.
+ *
+ * Returns: pointer to an irq_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct irq_stack *procps_irq_select (
+        struct irq_info *info,
+        const char *name,
+        enum irq_item *items,
+        int numitems)
+{
+    struct irq_node *node;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL || items == NULL)
+        return NULL;
+    if (0 > irq_stacks_reconfig_maybe(&info->select_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select_ext.extents
+    && (!irq_stacks_alloc(&info->select_ext, 1)))
+       return NULL;
+
+    if (irq_read_failed(info))
+        return NULL;
+    if (!(node = node_get(info, name, IRQ_TYPE_HARD, 0))
+    && !(node = node_get(info, name, IRQ_TYPE_SOFT, 0))) {
+        errno = ENXIO;
+        return NULL;
+    }
+
+    irq_assign_results(info->select_ext.extents->stacks[0], node);
+
+    return info->select_ext.extents->stacks[0];
+} // end: procps_irq_select
+
+
+/*
+ * procps_irq_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct irq_stack **procps_irq_sort (
+        struct irq_info *info,
+        struct irq_stack *stacks[],
+        int numstacked,
+        enum irq_item sortitem,
+        enum irq_sort_order order)
+{
+    struct irq_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // an irq_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= IRQ_logical_end)
+        return NULL;
+    if (order != IRQ_SORT_ASCEND && order != IRQ_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= IRQ_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    qsort_r(stacks, numstacked, sizeof(void *), (QSR_t)Item_table[p->item].sortfunc, &parms);
+    return stacks;
+} // end: procps_irq_sort
+
+
+// --- special debugging function(s) ------------------------------------------
+/*
+ *  The following isn't part of the normal programming interface.  Rather,
+ *  it exists to validate result types referenced in application programs.
+ *
+ *  It's used only when:
+ *      1) the 'XTRA_PROCPS_DEBUG' has been defined, or
+ *      2) an #include of 'xtra-procps-debug.h' is used
+ */
+
+PROCPS_EXPORT struct irq_result *xtra_irq_get (
+        struct irq_info *info,
+        const char *name,
+        enum irq_item actual_enum,
+        const char *typestr,
+        const char *file,
+        int lineno)
+{
+    struct irq_result *r = procps_irq_get(info, name, actual_enum);
+
+    if (actual_enum < 0 || actual_enum >= IRQ_logical_end) {
+        fprintf(stderr, "%s line %d: invalid item = %d, type = %s\n"
+            , file, lineno, actual_enum, typestr);
+    }
+    if (r) {
+        char *str = Item_table[r->item].type2str;
+        if (str[0]
+        && (strcmp(typestr, str)))
+            fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return r;
+} // end: xtra_irq_get
+
+
+PROCPS_EXPORT struct irq_result *xtra_irq_val (
+        int relative_enum,
+        const char *typestr,
+        const struct irq_stack *stack,
+        const char *file,
+        int lineno)
+{
+    char *str;
+    int i;
+
+    for (i = 0; stack->head[i].item < IRQ_logical_end; i++)
+        ;
+    if (relative_enum < 0 || relative_enum >= i) {
+        fprintf(stderr, "%s line %d: invalid relative_enum = %d, valid range = 0-%d\n"
+            , file, lineno, relative_enum, i-1);
+        return NULL;
+    }
+    str = Item_table[stack->head[relative_enum].item].type2str;
+    if (str[0]
+    && (strcmp(typestr, str))) {
+        fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return &stack->head[relative_enum];
+} // end: xtra_irq_val
@@ -31,6 +31,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "misc.h"
 #include "procps-private.h"
 #include "meminfo.h"
 
@@ -140,6 +141,8 @@ struct meminfo_info {
     struct hsearch_data hashtab;
     struct meminfo_result get_this;
     time_t sav_secs;
+    int cost_yes;                      // procps_meminfo_cost was called
+    struct procps_cost cost;           // the counters it exposes
 };
 
 
@@ -662,15 +665,23 @@ static int meminfo_read_failed (
     int size;
     unsigned long *valptr;
     signed long mem_used;
+    unsigned long long began = 0;
+
+    if (info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        began = procps_cost_ns();
+    }
 
     // remember history from last time around
     memcpy(&info->hist.old, &info->hist.new, sizeof(struct meminfo_data));
     // clear out the soon to be 'current' values
     memset(&info->hist.new, 0, sizeof(struct meminfo_data));
 
-    if (-1 == info->meminfo_fd
-    && (-1 == (info->meminfo_fd = open(MEMINFO_FILE, O_RDONLY))))
-        return 1;
+    if (-1 == info->meminfo_fd) {
+        if (-1 == (info->meminfo_fd = open(procfs_path(MEMINFO_FILE), O_RDONLY)))
+            return 1;
+        info->cost.opened++;
+    }
 
     if (lseek(info->meminfo_fd, 0L, SEEK_SET) == -1)
         return 1;
@@ -688,6 +699,11 @@ static int meminfo_read_failed (
         return 1;
     }
     buf[size] = '\0';
+    if (info->cost_yes) {
+        info->cost.reads = 1;
+        info->cost.bytes = size;
+        info->cost.read_ns = procps_cost_ns() - began;
+    }
 
     head = buf;
 
@@ -739,6 +755,13 @@ static int meminfo_read_failed (
     if (mHr(SwapFree) < mHr(SwapTotal))
         mHr(derived_swap_used) = mHr(SwapTotal) - mHr(SwapFree);
 
+    if (info->cost_yes) {
+        info->cost.total_ns = procps_cost_ns() - began;
+        info->cost.parse_ns = info->cost.total_ns - info->cost.read_ns;
+        info->cost.file[PROCPS_COST_OTHER].opened = info->cost.opened;
+        info->cost.file[PROCPS_COST_OTHER].bytes = info->cost.bytes;
+        info->cost.file[PROCPS_COST_OTHER].read_ns = info->cost.read_ns;
+    }
     return 0;
  #undef mHr
 } // end: meminfo_read_failed
@@ -902,6 +925,29 @@ PROCPS_EXPORT int procps_meminfo_unref (
 
 // --- variable interface functions -------------------------------------------
 
+/* procps_meminfo_cost():
+ *
+ * Enable (on first use) the accounting of what each read of
+ * /proc/meminfo costs.
+ *
+ * Returns: pointer to the counters for the most recent read.
+ */
+PROCPS_EXPORT struct procps_cost *procps_meminfo_cost (
+        struct meminfo_info *info)
+{
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    errno = 0;
+
+    if (!info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        info->cost_yes = 1;
+    }
+    return &info->cost;
+} // end: procps_meminfo_cost
+
+
 PROCPS_EXPORT struct meminfo_result *procps_meminfo_get (
         struct meminfo_info *info,
         enum meminfo_item item)
@@ -27,7 +27,7 @@
 #include "misc.h"
 #include "procps-private.h"
 
-#define NSPATHLEN 64
+#define NSPATHLEN (PROCROOTLEN + 64)
 
 static const char *ns_names[] = {
     [PROCPS_NS_CGROUP] = "cgroup",
@@ -106,7 +106,7 @@ PROCPS_EXPORT int procps_ns_read_pid(
         return -EINVAL;
 
     for (i=0; i < PROCPS_NS_COUNT; i++) {
-        snprintf(path, NSPATHLEN, "/proc/%d/ns/%s", pid, ns_names[i]);
+        snprintf(path, NSPATHLEN, "%s/%d/ns/%s", procfs_root(), pid, ns_names[i]);
         if (0 == stat(path, &st))
             nsp->ns[i] = (unsigned long)st.st_ino;
         else
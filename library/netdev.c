@@ -0,0 +1,1158 @@
+/*
+ * netdev.c - network interface related definitions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "procps-private.h"
+#include "netdev.h"
+
+#define NETDEV_FILE         "/proc/net/dev"
+#define NETDEV_SYS_DIR      "/sys/class/net"
+#define NETDEV_NAME_LEN     16           // IFNAMSIZ, with its nul
+#define NETDEV_PROC_CNT     16           // counts per /proc/net/dev row
+#define NETDEV_SYS_CNT      7            // counts from sysfs 'statistics'
+
+#define BUFFER_INCR         4096         // amount the file buffer grows
+#define NODES_INCR          16           // amount the nodes array grows
+#define STACKS_INCR         16           // amount reap stack allocations grow
+#define STR_COMPARE         strverscmp
+
+/* ----------------------------------------------------------------------- +
+   this provision can help ensure that our Item_table remains synchronized |
+   with the enumerators found in the associated header file. It's intended |
+   to only be used locally (& temporarily) at some point before a release! | */
+// #define ITEMTABLE_DEBUG //--------------------------------------------- |
+// ----------------------------------------------------------------------- +
+
+
+        /* the /proc/net/dev columns, in the order every row lists them */
+enum proc_cnt {
+    rx_BYTES, rx_PACKETS, rx_ERRORS, rx_DROPPED,
+    rx_FIFO, rx_FRAME, rx_COMPRESSED, rx_MULTICAST,
+    tx_BYTES, tx_PACKETS, tx_ERRORS, tx_DROPPED,
+    tx_FIFO, tx_COLLISIONS, tx_CARRIER, tx_COMPRESSED
+};
+
+        /* the sysfs files, which /proc/net/dev folds into its errors */
+enum sys_cnt {
+    rx_CRC, rx_LENGTH, rx_MISSED, rx_OVER,
+    tx_ABORTED, tx_HEARTBEAT, tx_WINDOW
+};
+static const char *Sys_files[NETDEV_SYS_CNT] = {
+    "rx_crc_errors", "rx_length_errors", "rx_missed_errors", "rx_over_errors",
+    "tx_aborted_errors", "tx_heartbeat_errors", "tx_window_errors"
+};
+
+struct dev_node {
+    char name[NETDEV_NAME_LEN+1];
+    int ifindex;                       // from sysfs, 0 if unknown
+    unsigned long new[NETDEV_PROC_CNT];
+    unsigned long old[NETDEV_PROC_CNT];
+    unsigned long sys[NETDEV_SYS_CNT];
+    int sys_fd[NETDEV_SYS_CNT];        // held open once needed, -2 if absent
+    int fresh;                         // first listed by the latest read
+    unsigned seen;                     // the read which last found this node
+};
+
+struct stacks_extent {
+    int ext_numstacks;
+    struct stacks_extent *next;
+    struct netdev_stack **stacks;
+};
+
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum netdev_item *items;           // includes 'logical_end' delimiter
+    int needsys;                       // some item requires sysfs
+    struct stacks_extent *extents;     // anchor for these extents
+};
+
+struct fetch_support {
+    struct netdev_stack **anchor;      // fetch consolidated extents
+    int n_alloc;                       // number of above pointers allocated
+    int n_inuse;                       // number of above pointers occupied
+    int n_alloc_save;                  // last known reap.stacks allocation
+    struct netdev_reaped results;      // count + stacks for return to caller
+};
+
+struct netdev_info {
+    int refcount;
+    int dev_fd;                        // /proc/net/dev, kept open
+    char *buf;                         // that file, read in one gulp
+    int buf_size;
+    struct dev_node *nodes;            // in the order the file lists them
+    int n_nodes;
+    int n_alloc;
+    unsigned reads;                    // to identify any vanished nodes
+    unsigned sys_reads;                // the read which last included sysfs
+    time_t stamp;                      // for procps_netdev_get's granularity
+    struct ext_support select_ext;     // supports concurrent select/reap
+    struct ext_support fetch_ext;      // supports concurrent select/reap
+    struct fetch_support fetch;        // support for procps_netdev_reap
+    struct netdev_result get_this;     // used by procps_netdev_get
+};
+
+
+// ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+#define setNAME(e) set_netdev_ ## e
+#define setDECL(e) static void setNAME(e) \
+    (struct netdev_result *R, struct dev_node *N)
+
+// regular assignment
+#define REG_set(e,t,x) setDECL(e) { R->result. t = N-> x; }
+// /proc/net/dev assignment
+#define CNT_set(e,x) setDECL(e) { R->result.ul_int = N->new[x]; }
+// sysfs assignment
+#define SYS_set(e,x) setDECL(e) { R->result.ul_int = N->sys[x]; }
+// delta assignment (a counter reset by its driver is no activity)
+#define HST_set(e,x) setDECL(e) { R->result.ul_int = N->new[x] > N->old[x] ? N->new[x] - N->old[x] : 0; }
+
+setDECL(noop)  { (void)R; (void)N; }
+setDECL(extra) { (void)N; R->result.ul_int = 0; }
+
+REG_set(NAME,                 str,     name)
+REG_set(IFINDEX,              s_int,   ifindex)
+
+CNT_set(RX_BYTES,             rx_BYTES)
+CNT_set(RX_PACKETS,           rx_PACKETS)
+CNT_set(RX_ERRORS,            rx_ERRORS)
+CNT_set(RX_DROPPED,           rx_DROPPED)
+CNT_set(RX_FIFO,              rx_FIFO)
+CNT_set(RX_FRAME,             rx_FRAME)
+CNT_set(RX_COMPRESSED,        rx_COMPRESSED)
+CNT_set(RX_MULTICAST,         rx_MULTICAST)
+CNT_set(TX_BYTES,             tx_BYTES)
+CNT_set(TX_PACKETS,           tx_PACKETS)
+CNT_set(TX_ERRORS,            tx_ERRORS)
+CNT_set(TX_DROPPED,           tx_DROPPED)
+CNT_set(TX_FIFO,              tx_FIFO)
+CNT_set(TX_COLLISIONS,        tx_COLLISIONS)
+CNT_set(TX_CARRIER,           tx_CARRIER)
+CNT_set(TX_COMPRESSED,        tx_COMPRESSED)
+
+SYS_set(RX_CRC_ERRORS,        rx_CRC)
+SYS_set(RX_LENGTH_ERRORS,     rx_LENGTH)
+SYS_set(RX_MISSED_ERRORS,     rx_MISSED)
+SYS_set(RX_OVER_ERRORS,       rx_OVER)
+SYS_set(TX_ABORTED_ERRORS,    tx_ABORTED)
+SYS_set(TX_HEARTBEAT_ERRORS,  tx_HEARTBEAT)
+SYS_set(TX_WINDOW_ERRORS,     tx_WINDOW)
+
+HST_set(DELTA_RX_BYTES,       rx_BYTES)
+HST_set(DELTA_RX_PACKETS,     rx_PACKETS)
+HST_set(DELTA_RX_ERRORS,      rx_ERRORS)
+HST_set(DELTA_RX_DROPPED,     rx_DROPPED)
+HST_set(DELTA_TX_BYTES,       tx_BYTES)
+HST_set(DELTA_TX_PACKETS,     tx_PACKETS)
+HST_set(DELTA_TX_ERRORS,      tx_ERRORS)
+HST_set(DELTA_TX_DROPPED,     tx_DROPPED)
+
+#undef setDECL
+#undef REG_set
+#undef CNT_set
+#undef SYS_set
+#undef HST_set
+
+
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum netdev_sort_order order;
+};
+
+#define srtNAME(t) sort_netdev_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct netdev_stack **A, const struct netdev_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct netdev_result *a = (*A)->head + P->offset;
+    const struct netdev_result *b = (*B)->head + P->offset;
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(ul_int) {
+    const struct netdev_result *a = (*A)->head + P->offset;
+    const struct netdev_result *b = (*B)->head + P->offset;
+    if ( a->result.ul_int > b->result.ul_int ) return P->order > 0 ?  1 : -1;
+    if ( a->result.ul_int < b->result.ul_int ) return P->order > 0 ? -1 :  1;
+    return 0;
+}
+
+srtDECL(str) {
+    const struct netdev_result *a = (*A)->head + P->offset;
+    const struct netdev_result *b = (*B)->head + P->offset;
+    return P->order * STR_COMPARE(a->result.str, b->result.str);
+}
+
+srtDECL(noop) {
+    (void)A; (void)B; (void)P;
+    return 0;
+}
+
+#undef srtDECL
+
+
+// ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+typedef void (*SET_t)(struct netdev_result *, struct dev_node *);
+#ifdef ITEMTABLE_DEBUG
+#define RS(e) (SET_t)setNAME(e), NETDEV_ ## e, STRINGIFY(NETDEV_ ## e)
+#else
+#define RS(e) (SET_t)setNAME(e)
+#endif
+
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
+#define TS(t) STRINGIFY(t)
+#define TS_noop ""
+
+        /*
+         * Need it be said?
+         * This table must be kept in the exact same order as
+         * those *enum netdev_item* guys ! */
+static struct {
+    SET_t setsfunc;              // the actual result setting routine
+#ifdef ITEMTABLE_DEBUG
+    int   enumnumb;              // enumerator (must match position!)
+    char *enum2str;              // enumerator name as a char* string
+#endif
+    int   needsys;               // read from sysfs, not /proc/net/dev
+    QSR_t sortfunc;              // sort cmp func for a specific type
+    char *type2str;              // the result type as a string value
+} Item_table[] = {
+/*  setsfunc                     sys  sortfunc     type2str
+    ---------------------------  ---  -----------  ---------- */
+  { RS(noop),                    0,   QS(noop),    TS_noop    },
+  { RS(extra),                   0,   QS(ul_int),  TS_noop    },
+
+  { RS(NAME),                    0,   QS(str),     TS(str)    },
+  { RS(IFINDEX),                 0,   QS(s_int),   TS(s_int)  },
+
+  { RS(RX_BYTES),                0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_PACKETS),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_ERRORS),               0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_DROPPED),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_FIFO),                 0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_FRAME),                0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_COMPRESSED),           0,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_MULTICAST),            0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_BYTES),                0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_PACKETS),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_ERRORS),               0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_DROPPED),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_FIFO),                 0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_COLLISIONS),           0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_CARRIER),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_COMPRESSED),           0,   QS(ul_int),  TS(ul_int) },
+
+  { RS(RX_CRC_ERRORS),           1,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_LENGTH_ERRORS),        1,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_MISSED_ERRORS),        1,   QS(ul_int),  TS(ul_int) },
+  { RS(RX_OVER_ERRORS),          1,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_ABORTED_ERRORS),       1,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_HEARTBEAT_ERRORS),     1,   QS(ul_int),  TS(ul_int) },
+  { RS(TX_WINDOW_ERRORS),        1,   QS(ul_int),  TS(ul_int) },
+
+  { RS(DELTA_RX_BYTES),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_RX_PACKETS),        0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_RX_ERRORS),         0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_RX_DROPPED),        0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_TX_BYTES),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_TX_PACKETS),        0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_TX_ERRORS),         0,   QS(ul_int),  TS(ul_int) },
+  { RS(DELTA_TX_DROPPED),        0,   QS(ul_int),  TS(ul_int) },
+};
+
+    /* please note,
+     * this enum MUST be 1 greater than the highest value of any enum */
+enum netdev_item NETDEV_logical_end = MAXTABLE(Item_table);
+
+#undef setNAME
+#undef srtNAME
+#undef RS
+#undef QS
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- dev_node specific support ----------------------------------------------
+
+static void node_free (
+        struct dev_node *node)
+{
+    int i;
+
+    for (i = 0; i < NETDEV_SYS_CNT; i++)
+        if (node->sys_fd[i] >= 0)
+            close(node->sys_fd[i]);
+} // end: node_free
+
+
+static struct dev_node *node_get (
+        struct netdev_info *info,
+        const char *name,
+        int hint)
+{
+    int i;
+
+    /* the file lists its rows in the same order with every read, so the
+       row following whichever was last found is nearly always the one ... */
+    if (hint < info->n_nodes
+    && !strcmp(info->nodes[hint].name, name))
+        return &info->nodes[hint];
+    for (i = 0; i < info->n_nodes; i++) {
+        if (!strcmp(info->nodes[i].name, name))
+            return &info->nodes[i];
+    }
+    return NULL;
+} // end: node_get
+
+
+static int node_sys_open (
+        const char *name,
+        const char *dir,
+        const char *file)
+{
+    char path[sizeof(NETDEV_SYS_DIR) + NETDEV_NAME_LEN + 64];
+
+    snprintf(path, sizeof(path), "%s/%s/%s%s", NETDEV_SYS_DIR, name, dir, file);
+    return open(sysfs_path(path), O_RDONLY | O_CLOEXEC);
+} // end: node_sys_open
+
+
+static int node_sys_value (
+        int fd,
+        unsigned long *value)
+{
+    char buf[64];
+    int num;
+
+    if ((num = pread(fd, buf, sizeof(buf) - 1, 0)) < 0)
+        return 0;
+    buf[num] = '\0';
+    *value = strtoul(buf, NULL, 10);
+    return 1;
+} // end: node_sys_value
+
+
+static int node_sys_ifindex (
+        const char *name)
+{
+    unsigned long value = 0;
+    int fd;
+
+    if ((fd = node_sys_open(name, "", "ifindex")) >= 0) {
+        node_sys_value(fd, &value);
+        close(fd);
+    }
+    return (int)value;
+} // end: node_sys_ifindex
+
+
+static struct dev_node *node_new (
+        struct netdev_info *info,
+        const char *name)
+{
+    struct dev_node *node;
+    int i;
+
+    if (info->n_nodes >= info->n_alloc) {
+        if (!(node = realloc(info->nodes, sizeof(struct dev_node) * (info->n_alloc + NODES_INCR))))
+            return NULL;     // here, errno was set to ENOMEM
+        info->nodes = node;
+        info->n_alloc += NODES_INCR;
+    }
+    node = &info->nodes[info->n_nodes];
+    memset(node, 0, sizeof(struct dev_node));
+    snprintf(node->name, sizeof(node->name), "%s", name);
+    for (i = 0; i < NETDEV_SYS_CNT; i++)
+        node->sys_fd[i] = -1;
+    // the ifindex survives a rename, so it's read just this once
+    node->ifindex = node_sys_ifindex(name);
+    node->fresh = 1;
+    info->n_nodes++;
+    return node;
+} // end: node_new
+
+
+        /*
+         * A renamed interface is listed under its new name, as if it
+         * were new, while its old name has vanished.  Since both will
+         * share an ifindex, the counts from the old name let the new
+         * name's deltas carry on as though nothing had happened. */
+static void nodes_renamed (
+        struct netdev_info *info)
+{
+    struct dev_node *node, *gone;
+    int i, j;
+
+    for (i = 0; i < info->n_nodes; i++) {
+        node = &info->nodes[i];
+        if (!node->fresh || node->seen != info->reads || node->ifindex <= 0)
+            continue;
+        for (j = 0; j < info->n_nodes; j++) {
+            gone = &info->nodes[j];
+            if (gone->seen == info->reads || gone->ifindex != node->ifindex)
+                continue;
+            memcpy(node->old, gone->new, sizeof(node->old));
+            node->fresh = 0;
+            gone->ifindex = 0;
+            break;
+        }
+    }
+} // end: nodes_renamed
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- generalized support ----------------------------------------------------
+
+static inline void netdev_assign_results (
+        struct netdev_stack *stack,
+        struct dev_node *node)
+{
+    struct netdev_result *this = stack->head;
+
+    for (;;) {
+        enum netdev_item item = this->item;
+        if (item >= NETDEV_logical_end)
+            break;
+        Item_table[item].setsfunc(this, node);
+        ++this;
+    }
+    return;
+} // end: netdev_assign_results
+
+
+static void netdev_extents_free_all (
+        struct ext_support *this)
+{
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
+        free(p);
+    };
+} // end: netdev_extents_free_all
+
+
+static inline struct netdev_result *netdev_itemize_stack (
+        struct netdev_result *p,
+        int depth,
+        enum netdev_item *items)
+{
+    struct netdev_result *p_sav = p;
+    int i;
+
+    for (i = 0; i < depth; i++) {
+        p->item = items[i];
+        ++p;
+    }
+    return p_sav;
+} // end: netdev_itemize_stack
+
+
+static inline int netdev_items_check_failed (
+        enum netdev_item *items,
+        int numitems)
+{
+    int i;
+
+    /* if an enum is passed instead of an address of one or more enums, ol' gcc
+     * will silently convert it to an address (possibly NULL).  only clang will
+     * offer any sort of warning like the following:
+     *
+     * warning: incompatible integer to pointer conversion passing 'int' to parameter of type 'enum netdev_item *'
+     * my_stack = procps_netdev_select(info, NETDEV_noop, num);
+     *                                       ^~~~~~~~~~~
+     */
+    if (numitems < 1
+    || (void *)items < (void *)(unsigned long)(2 * NETDEV_logical_end))
+        return 1;
+
+    for (i = 0; i < numitems; i++) {
+        // a netdev_item is currently unsigned, but we'll protect our future
+        if (items[i] < 0)
+            return 1;
+        if (items[i] >= NETDEV_logical_end)
+            return 1;
+    }
+
+    return 0;
+} // end: netdev_items_check_failed
+
+
+/*
+ * netdev_file_slurp:
+ *
+ * Read all of /proc/net/dev into our buffer, through a file
+ * descriptor which is held open from one read to the next.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int netdev_file_slurp (
+        struct netdev_info *info)
+{
+    char *buf;
+    int num, tot_read = 0;
+
+    if (info->dev_fd < 0
+    && (info->dev_fd = open(procfs_path(NETDEV_FILE), O_RDONLY | O_CLOEXEC)) < 0)
+        return 1;
+    if (!info->buf) {
+        if (!(info->buf = malloc(BUFFER_INCR)))
+            return 1;
+        info->buf_size = BUFFER_INCR;
+    }
+    for (;;) {
+        if ((num = pread(info->dev_fd, info->buf + tot_read, info->buf_size - tot_read - 1, tot_read)) < 0)
+            return 1;
+        tot_read += num;
+        if (!num || tot_read < info->buf_size - 1)
+            break;
+        if (!(buf = realloc(info->buf, info->buf_size + BUFFER_INCR)))
+            return 1;
+        info->buf = buf;
+        info->buf_size += BUFFER_INCR;
+    }
+    info->buf[tot_read] = '\0';
+    return 0;
+} // end: netdev_file_slurp
+
+
+/*
+ * netdev_parse_failed:
+ *
+ * Digest /proc/net/dev, now in our buffer.  After two header lines,
+ * each row holds an interface name then its 16 counts, which are
+ * parsed by hand rather than by some sscanf format.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int netdev_parse_failed (
+        struct netdev_info *info)
+{
+    char name[NETDEV_NAME_LEN+1];
+    struct dev_node *node;
+    char *p = info->buf, *q;
+    unsigned long v;
+    int i, hint = 0;
+
+    // the two header lines ------------------------------
+    if (!(p = strchr(p, '\n')) || !(p = strchr(p + 1, '\n'))) {
+        errno = ERANGE;
+        return 1;
+    }
+
+    // then each row --------------------------------------
+    while (p && *++p) {
+        while (*p == ' ')
+            ++p;
+        if (!(q = strchr(p, ':')) || q - p > NETDEV_NAME_LEN) {
+            errno = ERANGE;
+            return 1;
+        }
+        memcpy(name, p, q - p);
+        name[q - p] = '\0';
+        p = q + 1;
+
+        if (!(node = node_get(info, name, hint))) {
+            if (!(node = node_new(info, name)))
+                return 1;    // here, errno was set to ENOMEM
+        } else {
+            // remember history from last time around ...
+            memcpy(node->old, node->new, sizeof(node->old));
+            node->fresh = 0;
+        }
+        hint = node - info->nodes + 1;
+
+        for (i = 0; i < NETDEV_PROC_CNT; i++) {
+            while (*p == ' ' || *p == '\t')
+                ++p;
+            if (*p < '0' || *p > '9') {
+                errno = ERANGE;
+                return 1;
+            }
+            for (v = 0; *p >= '0' && *p <= '9'; ++p)
+                v = v * 10 + (*p - '0');
+            node->new[i] = v;
+        }
+        // let's not distort the deltas when a new node is created ...
+        if (node->fresh)
+            memcpy(node->old, node->new, sizeof(node->old));
+        node->seen = info->reads;
+        p = strchr(p, '\n');
+    }
+    return 0;
+} // end: netdev_parse_failed
+
+
+/*
+ * netdev_sys_read:
+ *
+ * Refresh the sysfs counts for every interface, opening each of
+ * those files just once and then holding it open.  Any which are
+ * absent (some virtual interfaces) will simply remain as zero.
+ *
+ * A held file fails (ENODEV) once its interface is deleted, though
+ * one of the same name may since have been created.  So it's then
+ * reopened, just once, along with a fresh look at the ifindex.
+ */
+static void netdev_sys_read (
+        struct netdev_info *info)
+{
+    struct dev_node *node;
+    int i, j, tries, stale;
+
+    for (i = 0; i < info->n_nodes; i++) {
+        node = &info->nodes[i];
+        stale = 0;
+        for (j = 0; j < NETDEV_SYS_CNT; j++) {
+            for (tries = 0; tries < 2 && node->sys_fd[j] != -2; tries++) {
+                if (node->sys_fd[j] == -1
+                && (node->sys_fd[j] = node_sys_open(node->name, "statistics/", Sys_files[j])) < 0) {
+                    node->sys_fd[j] = -2;
+                    break;
+                }
+                if (node_sys_value(node->sys_fd[j], &node->sys[j]))
+                    break;
+                close(node->sys_fd[j]);
+                node->sys_fd[j] = -1;
+                node->sys[j] = 0;
+                stale = 1;
+            }
+        }
+        if (stale)
+            node->ifindex = node_sys_ifindex(node->name);
+    }
+    info->sys_reads = info->reads;
+} // end: netdev_sys_read
+
+
+/*
+ * netdev_read_failed:
+ *
+ * @info: info structure created at procps_netdev_new
+ * @needsys: whether the sysfs counts must also be refreshed
+ *
+ * Read /proc/net/dev, updating our nodes and discarding any
+ * which are no longer listed (a removed or renamed interface).
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int netdev_read_failed (
+        struct netdev_info *info,
+        int needsys)
+{
+    int i, j;
+
+    info->reads++;
+    info->stamp = time(NULL);
+
+    if (netdev_file_slurp(info)
+    || netdev_parse_failed(info))
+        return 1;
+    nodes_renamed(info);
+
+    for (i = j = 0; i < info->n_nodes; i++) {
+        if (info->nodes[i].seen != info->reads) {
+            node_free(&info->nodes[i]);
+            continue;
+        }
+        if (i != j)
+            info->nodes[j] = info->nodes[i];
+        j++;
+    }
+    info->n_nodes = j;
+
+    if (needsys)
+        netdev_sys_read(info);
+    return 0;
+} // end: netdev_read_failed
+
+
+/*
+ * netdev_stacks_alloc():
+ *
+ * Allocate and initialize one or more stacks each of which is anchored in an
+ * associated context structure.
+ *
+ * All such stacks will have their result structures properly primed with
+ * 'items', while the result itself will be zeroed.
+ *
+ * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
+ */
+static struct stacks_extent *netdev_stacks_alloc (
+        struct ext_support *this,
+        int maxstacks)
+{
+    struct stacks_extent *p_blob;
+    struct netdev_stack **p_vect;
+    struct netdev_stack *p_head;
+    size_t vect_size, head_size, list_size, blob_size;
+    void *v_head, *v_list;
+    int i;
+
+    vect_size  = sizeof(void *) * maxstacks;                        // size of the addr vectors |
+    vect_size += sizeof(void *);                                    // plus NULL addr delimiter |
+    head_size  = sizeof(struct netdev_stack);                          // size of that head struct |
+    list_size  = sizeof(struct netdev_result) * this->numitems;        // any single results stack |
+    blob_size  = sizeof(struct stacks_extent);                      // the extent anchor itself |
+    blob_size += vect_size;                                         // plus room for addr vects |
+    blob_size += head_size * maxstacks;                             // plus room for head thing |
+    blob_size += list_size * maxstacks;                             // plus room for our stacks |
+
+    /* note: all of our memory is allocated in one single blob, facilitating some later free(). |
+             as a minimum, it's important that all of those result structs themselves always be |
+             contiguous within every stack since they will be accessed via a relative position. | */
+    if (NULL == (p_blob = calloc(1, blob_size)))
+        return NULL;
+
+    p_blob->next = this->extents;                                   // push this extent onto... |
+    this->extents = p_blob;                                         // ...some existing extents |
+    p_vect = (void *)p_blob + sizeof(struct stacks_extent);         // prime our vector pointer |
+    p_blob->stacks = p_vect;                                        // set actual vectors start |
+    v_head = (void *)p_vect + vect_size;                            // prime head pointer start |
+    v_list = v_head + (head_size * maxstacks);                      // prime our stacks pointer |
+
+    for (i = 0; i < maxstacks; i++) {
+        p_head = (struct netdev_stack *)v_head;
+        p_head->head = netdev_itemize_stack((struct netdev_result *)v_list, this->numitems, this->items);
+        p_blob->stacks[i] = p_head;
+        v_list += list_size;
+        v_head += head_size;
+    }
+    p_blob->ext_numstacks = maxstacks;
+    return p_blob;
+} // end: netdev_stacks_alloc
+
+
+static int netdev_stacks_fetch (
+        struct netdev_info *info)
+{
+ #define n_alloc  info->fetch.n_alloc
+ #define n_inuse  info->fetch.n_inuse
+ #define n_saved  info->fetch.n_alloc_save
+    struct stacks_extent *ext;
+    int i;
+
+    // initialize stuff -----------------------------------
+    if (!info->fetch.anchor) {
+        if (!(info->fetch.anchor = calloc(sizeof(void *), STACKS_INCR)))
+            return -ENOMEM;
+        n_alloc = STACKS_INCR;
+    }
+    if (!info->fetch_ext.extents) {
+        if (!(ext = netdev_stacks_alloc(&info->fetch_ext, n_alloc)))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * n_alloc);
+    }
+
+    // iterate stuff --------------------------------------
+    n_inuse = 0;
+    for (i = 0; i < info->n_nodes; i++) {
+        if (!(n_inuse < n_alloc)) {
+            n_alloc += STACKS_INCR;
+            if ((!(info->fetch.anchor = realloc(info->fetch.anchor, sizeof(void *) * n_alloc)))
+            || (!(ext = netdev_stacks_alloc(&info->fetch_ext, STACKS_INCR))))
+                return -1;   // here, errno was set to ENOMEM
+            memcpy(info->fetch.anchor + n_inuse, ext->stacks, sizeof(void *) * STACKS_INCR);
+        }
+        netdev_assign_results(info->fetch.anchor[n_inuse], &info->nodes[i]);
+        ++n_inuse;
+    }
+
+    // finalize stuff -------------------------------------
+    if (n_saved < n_inuse + 1) {
+        n_saved = n_inuse + 1;
+        if (!(info->fetch.results.stacks = realloc(info->fetch.results.stacks, sizeof(void *) * n_saved)))
+            return -1;
+    }
+    memcpy(info->fetch.results.stacks, info->fetch.anchor, sizeof(void *) * n_inuse);
+    info->fetch.results.stacks[n_inuse] = NULL;
+    info->fetch.results.total = n_inuse;
+
+    return n_inuse;
+ #undef n_alloc
+ #undef n_inuse
+ #undef n_saved
+} // end: netdev_stacks_fetch
+
+
+static int netdev_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum netdev_item *items,
+        int numitems)
+{
+    int i;
+
+    if (netdev_items_check_failed(items, numitems))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum netdev_item) * numitems)) {
+        // allow for our NETDEV_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum netdev_item) * (numitems + 1))))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(this->items, items, sizeof(enum netdev_item) * numitems);
+        this->items[numitems] = NETDEV_logical_end;
+        this->numitems = numitems + 1;
+        for (i = 0, this->needsys = 0; i < numitems; i++)
+            this->needsys |= Item_table[items[i]].needsys;
+        netdev_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: netdev_stacks_reconfig_maybe
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_netdev_new():
+ *
+ * @info: location of returned new structure
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_netdev_new (
+        struct netdev_info **info)
+{
+    struct netdev_info *p;
+
+#ifdef ITEMTABLE_DEBUG
+    int i, failed = 0;
+    for (i = 0; i < MAXTABLE(Item_table); i++) {
+        if (i != Item_table[i].enumnumb) {
+            fprintf(stderr, "%s: enum/table error: Item_table[%d] was %s, but its value is %d\n"
+                , __FILE__, i, Item_table[i].enum2str, Item_table[i].enumnumb);
+            failed = 1;
+        }
+    }
+    if (failed) _Exit(EXIT_FAILURE);
+#endif
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct netdev_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    p->dev_fd = -1;
+
+    /* do a priming read here for the following potential benefits: |
+         1) ensure there will be no problems with subsequent access |
+         2) make delta results potentially useful, even if 1st time |
+         3) elimnate need for history distortions 1st time 'switch' | */
+    if (netdev_read_failed(p, 0)) {
+        procps_netdev_unref(&p);
+        return -errno;
+    }
+
+    *info = p;
+    return 0;
+} // end: procps_netdev_new
+
+
+PROCPS_EXPORT int procps_netdev_ref (
+        struct netdev_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_netdev_ref
+
+
+PROCPS_EXPORT int procps_netdev_unref (
+        struct netdev_info **info)
+{
+    int i;
+
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        if ((*info)->dev_fd >= 0)
+            close((*info)->dev_fd);
+        for (i = 0; i < (*info)->n_nodes; i++)
+            node_free(&(*info)->nodes[i]);
+        free((*info)->nodes);
+        free((*info)->buf);
+
+        if ((*info)->select_ext.extents)
+            netdev_extents_free_all((&(*info)->select_ext));
+        if ((*info)->select_ext.items)
+            free((*info)->select_ext.items);
+
+        if ((*info)->fetch.anchor)
+            free((*info)->fetch.anchor);
+        if ((*info)->fetch.results.stacks)
+            free((*info)->fetch.results.stacks);
+
+        if ((*info)->fetch_ext.extents)
+            netdev_extents_free_all(&(*info)->fetch_ext);
+        if ((*info)->fetch_ext.items)
+            free((*info)->fetch_ext.items);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_netdev_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+PROCPS_EXPORT struct netdev_result *procps_netdev_get (
+        struct netdev_info *info,
+        const char *name,
+        enum netdev_item item)
+{
+    struct dev_node *node;
+    time_t cur_secs;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL)
+        return NULL;
+    if (item < 0 || item >= NETDEV_logical_end)
+        return NULL;
+    errno = 0;
+
+    /* we will NOT read /proc/net/dev with every call - rather, we'll offer
+       a granularity of 1 second between reads ... */
+    cur_secs = time(NULL);
+    if (1 <= cur_secs - info->stamp) {
+        if (netdev_read_failed(info, Item_table[item].needsys))
+            return NULL;
+    } else if (Item_table[item].needsys && info->sys_reads != info->reads)
+        netdev_sys_read(info);
+
+    info->get_this.item = item;
+    //  with 'get', we must NOT honor the usual 'noop' guarantee
+    info->get_this.result.ul_int = 0;
+
+    if (!(node = node_get(info, name, 0))) {
+        errno = ENXIO;
+        return NULL;
+    }
+    Item_table[item].setsfunc(&info->get_this, node);
+
+    return &info->get_this;
+} // end: procps_netdev_get
+
+
+/* procps_netdev_reap():
+ *
+ * Harvest all the requested network interface information,
+ * in the order /proc/net/dev lists those interfaces.
+ *
+ * Returns: pointer to an netdev_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct netdev_reaped *procps_netdev_reap (
+        struct netdev_info *info,
+        enum netdev_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > netdev_stacks_reconfig_maybe(&info->fetch_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (netdev_read_failed(info, info->fetch_ext.needsys))
+        return NULL;
+    if (0 > netdev_stacks_fetch(info))
+        return NULL;
+
+    return &info->fetch.results;
+} // end: procps_netdev_reap
+
+
+/* procps_netdev_select():
+ *
+ * Obtain all the requested information for one network interface,
+ * by name, then return it in a single library provided results
+ * stack.
+ *
+ * Returns: pointer to an netdev_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct netdev_stack *procps_netdev_select (
+        struct netdev_info *info,
+        const char *name,
+        enum netdev_item *items,
+        int numitems)
+{
+    struct dev_node *node;
+
+    errno = EINVAL;
+    if (info == NULL || name == NULL || items == NULL)
+        return NULL;
+    if (0 > netdev_stacks_reconfig_maybe(&info->select_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select_ext.extents
+    && (!netdev_stacks_alloc(&info->select_ext, 1)))
+       return NULL;
+
+    if (netdev_read_failed(info, info->select_ext.needsys))
+        return NULL;
+    if (!(node = node_get(info, name, 0))) {
+        errno = ENXIO;
+        return NULL;
+    }
+
+    netdev_assign_results(info->select_ext.extents->stacks[0], node);
+
+    return info->select_ext.extents->stacks[0];
+} // end: procps_netdev_select
+
+
+/*
+ * procps_netdev_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct netdev_stack **procps_netdev_sort (
+        struct netdev_info *info,
+        struct netdev_stack *stacks[],
+        int numstacked,
+        enum netdev_item sortitem,
+        enum netdev_sort_order order)
+{
+    struct netdev_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // a netdev_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= NETDEV_logical_end)
+        return NULL;
+    if (order != NETDEV_SORT_ASCEND && order != NETDEV_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= NETDEV_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    qsort_r(stacks, numstacked, sizeof(void *), (QSR_t)Item_table[p->item].sortfunc, &parms);
+    return stacks;
+} // end: procps_netdev_sort
+
+
+// --- special debugging function(s) ------------------------------------------
+/*
+ *  The following isn't part of the normal programming interface.  Rather,
+ *  it exists to validate result types referenced in application programs.
+ *
+ *  It's used only when:
+ *      1) the 'XTRA_PROCPS_DEBUG' has been defined, or
+ *      2) an #include of 'xtra-procps-debug.h' is used
+ */
+
+PROCPS_EXPORT struct netdev_result *xtra_netdev_get (
+        struct netdev_info *info,
+        const char *name,
+        enum netdev_item actual_enum,
+        const char *typestr,
+        const char *file,
+        int lineno)
+{
+    struct netdev_result *r = procps_netdev_get(info, name, actual_enum);
+
+    if (actual_enum < 0 || actual_enum >= NETDEV_logical_end) {
+        fprintf(stderr, "%s line %d: invalid item = %d, type = %s\n"
+            , file, lineno, actual_enum, typestr);
+    }
+    if (r) {
+        char *str = Item_table[r->item].type2str;
+        if (str[0]
+        && (strcmp(typestr, str)))
+            fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return r;
+} // end: xtra_netdev_get
+
+
+PROCPS_EXPORT struct netdev_result *xtra_netdev_val (
+        int relative_enum,
+        const char *typestr,
+        const struct netdev_stack *stack,
+        const char *file,
+        int lineno)
+{
+    char *str;
+    int i;
+
+    for (i = 0; stack->head[i].item < NETDEV_logical_end; i++)
+        ;
+    if (relative_enum < 0 || relative_enum >= i) {
+        fprintf(stderr, "%s line %d: invalid relative_enum = %d, valid range = 0-%d\n"
+            , file, lineno, relative_enum, i-1);
+        return NULL;
+    }
+    str = Item_table[stack->head[relative_enum].item].type2str;
+    if (str[0]
+    && (strcmp(typestr, str))) {
+        fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return &stack->head[relative_enum];
+} // end: xtra_netdev_val
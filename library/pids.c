@@ -26,6 +26,7 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -50,7 +51,7 @@
 #define STACKS_INIT  1024              // amount of initial stack allocation
 #define STACKS_GROW  128               // amount reap stack allocations grow
 #define NEWOLD_INIT  1024              // amount for initial hist allocation
-#define NEWOLD_GROW  128               // amt by which hist allocations grow
+#define HHASH_INIT   4096              // initial hash buckets (a power of 2)
 
 /* ------------------------------------------------------------------------- +
    this provision can be used to ensure that our Item_table was synchronized |
@@ -66,6 +67,38 @@ struct stacks_extent {
     struct pids_stack **stacks;
 };
 
+enum pids_retain {                     // the sources procps_pids_max_age governs
+    RETAIN_SMAPS,
+    RETAIN_ENVIRON,
+    RETAIN_CGROUP,
+    RETAIN_NS,
+    RETAIN_EXE,
+    RETAIN_SYSTEMD,
+    RETAIN_COUNT                       // fencepost
+};
+
+struct stack_private {                 // what each of our pids_stacks really is
+    struct pids_stack stack;           // all the caller knows about, so first
+    struct esc_meta *esc;              // one per result, see procps_pids_str_cols
+    int tid;                           // whose results, see procps_pids_sort_hinted
+    float age[RETAIN_COUNT];           // secs since each was read, see procps_pids_age
+};
+
+struct sort_rank {
+    int tid;                           // zero when this slot is unused
+    int rank;                          // where it was after the last sort
+};
+
+struct pids_sort_hint {                // opaque, for procps_pids_sort_hinted
+    struct pids_sort_hint *next;       // all of them are owned by a pids_info
+    struct sort_rank *ranks;           // open addressed, by tid, 'mask + 1' slots
+    unsigned mask;                     // one less than that power of 2
+    int numranked;                     // stacks sorted the last time around
+    struct pids_stack **work;          // a place to seed, then merge, stacks
+    int *runs;                         // where each natural run begins
+    int n_alloc;                       // stacks those last two can hold
+};
+
 struct fetch_support {
     struct pids_stack **anchor;        // reap/select consolidated extents
     int n_alloc;                       // number of above pointers allocated
@@ -90,6 +123,7 @@ struct pids_info {
     unsigned pgs2k_shift;              // to convert some proc vaules
     unsigned oldflags;                 // the old library PROC_FILL flagss
     PROCTAB *fetch_PT;                 // oldlib interface for 'select' & 'reap'
+    unsigned fetch_flags;              // the flags with which fetch_PT was opened
     unsigned long hertz;               // for the 'TIME' & 'UTILIZATION' calculations
     unsigned long long boot_tics;      // for TIME_ELAPSED & 'UTILIZATION' calculations
     PROCTAB *get_PT;                   // oldlib interface for active 'get'
@@ -100,6 +134,19 @@ struct pids_info {
     proc_t fetch_proc;                 // the proc_t used by pids_stacks_fetch
     SET_t *func_array;                 // extracted Item_table 'setsfunc' pointers
     int containers_yes;                // need to call pids_containers_check
+    int slab_yes;                      // getenv LIBPROC_STRING_SLAB was set
+    struct slab_s *fetch_slab;         // owns 'str' results for select & reap
+    struct slab_s *get_slab;           // owns 'str' results for procps_pids_get
+    struct slab_s *slab;               // whichever of the above is now active
+    int cost_yes;                      // procps_pids_cost was called
+    struct procps_cost cost;           // the counters it exposes
+    double snap_boot;                  // a boot time lent by procps_snapshot_take
+    struct esc_meta *esc;              // where an ESC_set leaves what escape_str knew
+    struct pids_sort_hint *hints;      // those given out by procps_pids_sort_hinted
+    double max_age[RETAIN_COUNT];      // secs each may be retained, < 0 = task life
+    unsigned retain_yes;               // the flags of any being retained just now
+    unsigned retain_skip;              // what the PROCTAB was told not to read
+    float retain_age[RETAIN_COUNT];    // for pids_assign_results, as to each age
 };
 
 
@@ -115,6 +162,27 @@ static void freNAME(strv) (struct pids_result *R) {
     if (R->result.strv && *R->result.strv) free(*R->result.strv);
 }
 
+/* with a slab, each 'str' & 'strv' result is released wholesale at the next fetch */
+static inline void pids_free_str (struct pids_info *I, struct pids_result *R) {
+    if (!I->slab_yes) freNAME(str)(R);
+}
+
+static inline void pids_free_strv (struct pids_info *I, struct pids_result *R) {
+    if (!I->slab_yes) freNAME(strv)(R);
+}
+
+static inline char *pids_strdup (struct pids_info *I, const char *str) {
+    if (I->slab_yes) return slab_strdup(I->slab, str);
+    if (I->cost_yes) I->cost.allocs++;
+    return strdup(str);
+}
+
+static inline char **pids_vectorize (struct pids_info *I, const char *str) {
+    if (I->slab_yes) return slab_vectorize(I->slab, str);
+    if (I->cost_yes) I->cost.allocs++;
+    return vectorize_this_str(str);
+}
+
 
 // ___ Special Suppott Funtion(s) |||||||||||||||||||||||||||||||||||||||||||||
 
@@ -151,24 +219,31 @@ static const char *pids_sched_to_classstr (
     R->result. t = (long)(P-> x) << I -> pgs2k_shift; }
 /* strdup of a static char array */
 #define DUP_set(e,x) setDECL(e) { \
-    freNAME(str)(R); \
-    if (!(R->result.str = strdup(P-> x))) I->seterr = 1; }
+    pids_free_str(I, R); \
+    if (!(R->result.str = pids_strdup(I, P-> x))) I->seterr = 1; }
 /* regular assignment copy */
 #define REG_set(e,t,x) setDECL(e) { \
     (void)I; R->result. t = P-> x; }
 /* take ownership of a normal single string if possible, else return
    some sort of hint that they duplicated this char * item ... */
 #define STR_set(e,x) setDECL(e) { \
-    freNAME(str)(R); \
+    pids_free_str(I, R); \
     if (NULL != P-> x) { R->result.str = P-> x; P-> x = NULL; } \
-    else { R->result.str = strdup("[ duplicate " STRINGIFY(e) " ]"); \
+    else { R->result.str = pids_strdup(I, "[ duplicate " STRINGIFY(e) " ]"); \
+      if (!R->result.str) I->seterr = 1; } }
+/* as STR_set, but also keep what escape_str learned of that string ... */
+#define ESC_set(e,x) setDECL(e) { \
+    pids_free_str(I, R); \
+    if (NULL != P-> x) { R->result.str = P-> x; P-> x = NULL; *I->esc = P-> x ## _esc; } \
+    else { R->result.str = pids_strdup(I, "[ duplicate " STRINGIFY(e) " ]"); \
+      I->esc->cols = -1; I->esc->ascii = 0; \
       if (!R->result.str) I->seterr = 1; } }
 /* take ownership of true vectorized strings if possible, else return
    some sort of hint that they duplicated this char ** item ... */
 #define VEC_set(e,x) setDECL(e) { \
-    freNAME(strv)(R); \
+    pids_free_strv(I, R); \
     if (NULL != P-> x) { R->result.strv = P-> x;  P-> x = NULL; } \
-    else { R->result.strv = vectorize_this_str("[ duplicate " STRINGIFY(e) " ]"); \
+    else { R->result.strv = pids_vectorize(I, "[ duplicate " STRINGIFY(e) " ]"); \
       if (!R->result.strv) I->seterr = 1; } }
 
 
@@ -182,17 +257,17 @@ REG_set(ADDR_CURR_ESP,    ul_int,  kstk_esp)
 REG_set(ADDR_STACK_START, ul_int,  start_stack)
 REG_set(AUTOGRP_ID,       s_int,   autogrp_id)
 REG_set(AUTOGRP_NICE,     s_int,   autogrp_nice)
-STR_set(CGNAME,                    cgname)
-STR_set(CGROUP,                    cgroup)
+ESC_set(CGNAME,                    cgname)
+ESC_set(CGROUP,                    cgroup)
 VEC_set(CGROUP_V,                  cgroup_v)
-STR_set(CMD,                       cmd)
-STR_set(CMDLINE,                   cmdline)
+ESC_set(CMD,                       cmd)
+ESC_set(CMDLINE,                   cmdline)
 VEC_set(CMDLINE_V,                 cmdline_v)
 REG_set(DOCKER_ID,        str,     dockerid)
 REG_set(DOCKER_ID_64,     str,     dockerid_64)
-STR_set(ENVIRON,                   environ)
+ESC_set(ENVIRON,                   environ)
 VEC_set(ENVIRON_V,                 environ_v)
-STR_set(EXE,                       exe)
+ESC_set(EXE,                       exe)
 REG_set(EXIT_SIGNAL,      s_int,   exit_signal)
 REG_set(FLAGS,            ul_int,  flags)
 REG_set(FLT_MAJ,          ul_int,  maj_flt)
@@ -316,12 +391,13 @@ setDECL(TIME_ALL_C)     { R->result.real = ((double)P->utime + P->stime + P->cut
 setDECL(TIME_ELAPSED)   { double t = (double)I->boot_tics - P->start_time; if (t > 0) R->result.real = t / I->hertz; }
 setDECL(TIME_START)     { R->result.real = (double)P->start_time / I->hertz; }
 REG_set(TTY,              s_int,   tty)
-setDECL(TTY_NAME)       { char buf[64]; freNAME(str)(R); dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV); if (!(R->result.str = strdup(buf))) I->seterr = 1; }
-setDECL(TTY_NUMBER)     { char buf[64]; freNAME(str)(R); dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV|ABBREV_TTY|ABBREV_PTS); if (!(R->result.str = strdup(buf))) I->seterr = 1; }
+setDECL(TTY_NAME)       { char buf[64]; pids_free_str(I, R); dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV); if (!(R->result.str = pids_strdup(I, buf))) I->seterr = 1; }
+setDECL(TTY_NUMBER)     { char buf[64]; pids_free_str(I, R); dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV|ABBREV_TTY|ABBREV_PTS); if (!(R->result.str = pids_strdup(I, buf))) I->seterr = 1; }
 setDECL(UTILIZATION)    { double t = (double)I->boot_tics - P->start_time; if (t > 0) R->result.real = ((P->utime + P->stime) * 100.0f) / t; }
 setDECL(UTILIZATION_C)  { double t = (double)I->boot_tics - P->start_time; if (t > 0) R->result.real = ((P->utime + P->stime + P->cutime + P->cstime) * 100.0f) / t; }
 REG_set(VM_DATA,          ul_int,  vm_data)
 REG_set(VM_EXE,           ul_int,  vm_exe)
+REG_set(VM_HUGETLB,       ul_int,  vm_hugetlb)
 REG_set(VM_LIB,           ul_int,  vm_lib)
 REG_set(VM_RSS,           ul_int,  vm_rss)
 REG_set(VM_RSS_ANON,      ul_int,  vm_rss_anon)
@@ -333,11 +409,12 @@ REG_set(VM_STACK,         ul_int,  vm_stack)
 REG_set(VM_SWAP,          ul_int,  vm_swap)
 setDECL(VM_USED)        { (void)I; R->result.ul_int = P->vm_swap + P->vm_rss; }
 REG_set(VSIZE_BYTES,      ul_int,  vsize)
-setDECL(WCHAN_NAME)     { freNAME(str)(R); if (!(R->result.str = strdup(lookup_wchan(P->tid)))) I->seterr = 1; }
+setDECL(WCHAN_NAME)     { pids_free_str(I, R); if (!(R->result.str = pids_strdup(I, lookup_wchan(P->tid)))) I->seterr = 1; }
 
 #undef setDECL
 #undef CVT_set
 #undef DUP_set
+#undef ESC_set
 #undef REG_set
 #undef STR_set
 #undef VEC_set
@@ -348,6 +425,8 @@ setDECL(WCHAN_NAME)     { freNAME(str)(R); if (!(R->result.str = strdup(lookup_w
 struct sort_parms {
     int offset;
     enum pids_sort_order order;
+    int (*func)(const void *, const void *, void *);
+    unsigned long compares;            // when counted, how often 'func' was called
 };
 
 #define srtNAME(t) sort_pids_ ## t
@@ -618,6 +697,7 @@ static struct {
     { RS(UTILIZATION_C),     f_stat,     NULL,      QS(real),      0,        TS(real)    },
     { RS(VM_DATA),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(VM_EXE),            f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(VM_HUGETLB),        f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(VM_LIB),            f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(VM_RSS),            f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(VM_RSS_ANON),       f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
@@ -674,57 +754,81 @@ enum pids_item PIDS_logical_end = MAXTABLE(Item_table);
 // ___ History Support Private Functions ||||||||||||||||||||||||||||||||||||||
 //   ( stolen from top when he wasn't looking ) -------------------------------
 
-#define HHASH_SIZE  4096
-#define _HASH_PID_(K) (K & (HHASH_SIZE - 1))
+#define _HASH_PID_(K) (K & (Hr(HHash_siz) - 1))
 
 #define Hr(x)  info->hist->x           // 'hist ref', minimize stolen impact
 
 typedef unsigned long long TIC_t;
 
+#define SMAPS_NUM  (int)((offsetof(proc_t, smap_Locked) - offsetof(proc_t, smap_Rss)) \
+    / sizeof(unsigned long) + 1)
+
+static const unsigned Retain_flags[RETAIN_COUNT] = {
+    PROC_FILLSMAPS, PROC_EDITENVRCVT, PROC_EDITCGRPCVT,
+    PROC_FILLNS, PROC_FILL_EXE, PROC_FILLSYSTEMD
+};
+
+static const size_t Retain_sd[] = {
+    offsetof(proc_t, sd_mach),  offsetof(proc_t, sd_ouid), offsetof(proc_t, sd_seat),
+    offsetof(proc_t, sd_sess),  offsetof(proc_t, sd_slice),
+    offsetof(proc_t, sd_unit),  offsetof(proc_t, sd_uunit)
+};
+
+struct retain_s {                      // what's kept for a procps_pids_max_age
+    TIC_t read[RETAIN_COUNT];          // when each was last read (0 = never)
+    unsigned long smaps[SMAPS_NUM];    // the proc_t smap_Rss thru smap_Locked
+    struct procps_ns ns;
+    char *environ, *cgroup, *cgname, *exe;
+    struct esc_meta environ_esc, cgroup_esc, cgname_esc, exe_esc;
+    char *sd[MAXTABLE(Retain_sd)];     // the proc_t sd_mach thru sd_uunit
+};
+
 typedef struct HST_t {
     TIC_t tics;                        // last frame's tics count
     unsigned long maj, min;            // last frame's maj/min_flt counts
-    int pid;                           // record 'key'
+    unsigned long long start;          // start_time, so a reused pid's a new task
+    int pid;                           // record 'key' (along with the above)
     int lnk;                           // next on hash chain
+    struct retain_s *kept;             // anything being retained, else NULL
 } HST_t;
 
 
 struct history_info {
     int    num_tasks;                  // used as index (tasks tallied)
+    int    num_saved;                  // tasks tallied in the prior frame
     int    HHist_siz;                  // max number of HST_t structs
     HST_t *PHist_sav;                  // alternating 'old/new' HST_t anchors
     HST_t *PHist_new;
-    int    HHash_one [HHASH_SIZE];     // the actual hash tables
-    int    HHash_two [HHASH_SIZE];     // (accessed via PHash_sav/PHash_new)
-    int    HHash_nul [HHASH_SIZE];     // an 'empty' hash table image
+    int    HHash_siz;                  // buckets in each hash table (power of 2)
     int   *PHash_sav;                  // alternating 'old/new' hash tables
-    int   *PHash_new;                  // (aka. the 'one/two' actual tables)
+    int   *PHash_new;
 };
 
 
-static void pids_config_history (
+static int pids_config_history (
         struct pids_info *info)
 {
-    int i;
-
-    for (i = 0; i < HHASH_SIZE; i++)   // make the 'empty' table image
-        Hr(HHash_nul[i]) = -1;
-    memcpy(Hr(HHash_one), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
-    memcpy(Hr(HHash_two), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
-    Hr(PHash_sav) = Hr(HHash_one);     // alternating 'old/new' hash tables
-    Hr(PHash_new) = Hr(HHash_two);
+    Hr(HHash_siz) = HHASH_INIT;
+    if (!(Hr(PHash_sav) = malloc(sizeof(int) * HHASH_INIT))
+    || (!(Hr(PHash_new) = malloc(sizeof(int) * HHASH_INIT))))
+        return 0;
+    memset(Hr(PHash_sav), -1, sizeof(int) * HHASH_INIT);
+    memset(Hr(PHash_new), -1, sizeof(int) * HHASH_INIT);
+    return 1;
 } // end: pids_config_history
 
 
 static inline HST_t *pids_histget (
         struct pids_info *info,
-        int pid)
+        int pid,
+        unsigned long long start)
 {
     int V = Hr(PHash_sav[_HASH_PID_(pid)]);
 
     while (-1 < V) {
         if (Hr(PHist_sav[V].pid) == pid)
-            return &Hr(PHist_sav[V]);
+            // a pid recycled since the last frame must not inherit that history
+            return Hr(PHist_sav[V].start) == start ? &Hr(PHist_sav[V]) : NULL;
         V = Hr(PHist_sav[V].lnk);
     }
     return NULL;
@@ -733,15 +837,209 @@ static inline HST_t *pids_histget (
 
 static inline void pids_histput (
         struct pids_info *info,
+        HST_t *hist,
+        int *hash,
         unsigned this)
 {
-    int V = _HASH_PID_(Hr(PHist_new[this].pid));
+    int V = _HASH_PID_(hist[this].pid);
 
-    Hr(PHist_new[this].lnk) = Hr(PHash_new[V]);
-    Hr(PHash_new[V] = this);
+    hist[this].lnk = hash[V];
+    hash[V] = this;
 } // end: pids_histput
 
-#undef _HASH_PID_
+
+        /*
+         * Both history arrays double whenever a frame outgrows them (as in
+         * a fork storm), and the hash tables then follow so as to keep one
+         * bucket per HST_t. Since their 'lnk' chains depend on that size,
+         * the prior frame's entries as well as those already tallied for
+         * this frame are rehashed. */
+static int pids_grow_hist (
+        struct pids_info *info)
+{
+    HST_t *sav, *new;
+    int *hsav, *hnew, i;
+
+    if (Hr(HHist_siz) >= INT_MAX / 2)
+        return 0;
+    if (!(sav = realloc(Hr(PHist_sav), sizeof(HST_t) * Hr(HHist_siz) * 2)))
+        return 0;
+    Hr(PHist_sav) = sav;
+    if (!(new = realloc(Hr(PHist_new), sizeof(HST_t) * Hr(HHist_siz) * 2)))
+        return 0;
+    Hr(PHist_new) = new;
+    Hr(HHist_siz) *= 2;
+
+    if (Hr(HHash_siz) >= Hr(HHist_siz))
+        return 1;
+    if (!(hsav = realloc(Hr(PHash_sav), sizeof(int) * Hr(HHist_siz))))
+        return 0;
+    Hr(PHash_sav) = hsav;
+    if (!(hnew = realloc(Hr(PHash_new), sizeof(int) * Hr(HHist_siz))))
+        return 0;
+    Hr(PHash_new) = hnew;
+    Hr(HHash_siz) = Hr(HHist_siz);
+
+    memset(hsav, -1, sizeof(int) * Hr(HHash_siz));
+    memset(hnew, -1, sizeof(int) * Hr(HHash_siz));
+    for (i = 0; i < Hr(num_saved); i++)
+        pids_histput(info, sav, hsav, i);
+    for (i = 0; i < Hr(num_tasks); i++)
+        pids_histput(info, new, hnew, i);
+    return 1;
+} // end: pids_grow_hist
+
+
+static void pids_retain_free (
+        struct retain_s **kept)
+{
+    int i;
+
+    if (!*kept)
+        return;
+    free((*kept)->environ);
+    free((*kept)->cgroup);
+    free((*kept)->cgname);
+    free((*kept)->exe);
+    for (i = 0; i < MAXTABLE(Retain_sd); i++)
+        free((*kept)->sd[i]);
+    free(*kept);
+    *kept = NULL;
+} // end: pids_retain_free
+
+
+        /*
+         * Either keep a private copy of a string just read, or hand
+         * what was kept back to the proc_t as if it had been read. */
+static int pids_retain_str (
+        struct pids_info *info,
+        char **kept,
+        char **str,
+        int reuse)
+{
+    if (reuse)
+        return !*kept || (*str = pids_strdup(info, *kept));
+    free(*kept);
+    *kept = NULL;
+    if (!*str)
+        return 1;
+    if (info->cost_yes)
+        info->cost.allocs++;
+    return NULL != (*kept = strdup(*str));
+} // end: pids_retain_str
+
+
+static int pids_retain_copy (
+        struct pids_info *info,
+        struct retain_s *k,
+        proc_t *p,
+        enum pids_retain which,
+        int reuse)
+{
+ #define cpyVAL(kept,val) ( reuse ? memcpy(&(val), &(kept), sizeof(kept)) \
+    : memcpy(&(kept), &(val), sizeof(kept)) )
+ #define cpySTR(x) ( cpyVAL(k-> x ## _esc, p-> x ## _esc), \
+    pids_retain_str(info, &k-> x, &p-> x, reuse) )
+    int i;
+
+    switch (which) {
+        case RETAIN_SMAPS:
+            if (reuse)
+                memcpy(&p->smap_Rss, k->smaps, sizeof(k->smaps));
+            else
+                memcpy(k->smaps, &p->smap_Rss, sizeof(k->smaps));
+            return 1;
+        case RETAIN_ENVIRON:
+            return cpySTR(environ);
+        case RETAIN_CGROUP:
+            return cpySTR(cgroup) && cpySTR(cgname);
+        case RETAIN_NS:
+            cpyVAL(k->ns, p->ns);
+            return 1;
+        case RETAIN_EXE:
+            return cpySTR(exe);
+        case RETAIN_SYSTEMD:
+            for (i = 0; i < MAXTABLE(Retain_sd); i++)
+                if (!pids_retain_str(info, &k->sd[i], (char **)((char *)p + Retain_sd[i]), reuse))
+                    return 0;
+            return 1;
+        default:
+            return 1;
+    }
+ #undef cpyVAL
+ #undef cpySTR
+} // end: pids_retain_copy
+
+
+        /*
+         * Our PROCTAB's 'retained' callback, once a task's stat is read.
+         * Whatever was read recently enough (or at all, for those to be
+         * kept for the life of a task) needn't be read again this time. */
+static unsigned pids_retain_check (
+        PROCTAB *PT,
+        const proc_t *p)
+{
+    struct pids_info *info = PT->retain_data;
+    HST_t *h;
+    int i;
+
+    info->retain_skip = 0;
+    if (!(h = pids_histget(info, p->tid, p->start_time)) || !h->kept)
+        return 0;
+    for (i = 0; i < RETAIN_COUNT; i++) {
+        if (!(info->retain_yes & Retain_flags[i]) || !h->kept->read[i])
+            continue;
+        if (info->max_age[i] < 0
+        || info->boot_tics - h->kept->read[i] < info->max_age[i] * info->hertz)
+            info->retain_skip |= Retain_flags[i];
+    }
+    return info->retain_skip;
+} // end: pids_retain_check
+
+
+        /*
+         * Carry forward what a task had kept, then either refresh it from
+         * what was just read, or fill in the proc_t from what was kept. */
+static int pids_retain_keep (
+        struct pids_info *info,
+        proc_t *p,
+        HST_t *new,
+        HST_t *old)
+{
+    struct retain_s *k;
+    int i;
+
+    if (old && old->kept) {
+        k = old->kept;
+        old->kept = NULL;
+    } else {
+        if (!(k = calloc(1, sizeof(struct retain_s))))
+            return 0;
+        if (info->cost_yes)
+            info->cost.allocs++;
+    }
+    new->kept = k;
+
+    for (i = 0; i < RETAIN_COUNT; i++) {
+        info->retain_age[i] = 0;
+        if (!(info->retain_yes & Retain_flags[i])) {
+            // should it be retained again, this would no longer be current
+            k->read[i] = 0;
+            continue;
+        }
+        if (info->retain_skip & Retain_flags[i]) {
+            info->retain_age[i] = (float)(info->boot_tics - k->read[i]) / info->hertz;
+            if (!pids_retain_copy(info, k, p, i, 1))
+                return 0;
+        } else {
+            k->read[i] = info->boot_tics ? info->boot_tics : 1;
+            if (!pids_retain_copy(info, k, p, i, 0))
+                return 0;
+        }
+    }
+    info->retain_skip = 0;
+    return 1;
+} // end: pids_retain_keep
 
 
 static inline int pids_make_hist (
@@ -752,25 +1050,27 @@ static inline int pids_make_hist (
     HST_t *h;
     int slot = info->hist->num_tasks;
 
-    if (slot + 1 >= Hr(HHist_siz)) {
-        Hr(HHist_siz) += NEWOLD_GROW;
-        Hr(PHist_sav) = realloc(Hr(PHist_sav), sizeof(HST_t) * Hr(HHist_siz));
-        Hr(PHist_new) = realloc(Hr(PHist_new), sizeof(HST_t) * Hr(HHist_siz));
-        if (!Hr(PHist_sav) || !Hr(PHist_new))
-            return 0;
-    }
-    Hr(PHist_new[slot].pid)  = p->tid;
-    Hr(PHist_new[slot].maj)  = p->maj_flt;
-    Hr(PHist_new[slot].min)  = p->min_flt;
-    Hr(PHist_new[slot].tics) = tics = (p->utime + p->stime);
+    if (slot + 1 >= Hr(HHist_siz)
+    && !pids_grow_hist(info))
+        return 0;
+    Hr(PHist_new[slot].pid)   = p->tid;
+    Hr(PHist_new[slot].start) = p->start_time;
+    Hr(PHist_new[slot].maj)   = p->maj_flt;
+    Hr(PHist_new[slot].min)   = p->min_flt;
+    Hr(PHist_new[slot].tics)  = tics = (p->utime + p->stime);
+
+    Hr(PHist_new[slot].kept)  = NULL;
 
-    pids_histput(info, slot);
+    pids_histput(info, Hr(PHist_new), Hr(PHash_new), slot);
 
-    if ((h = pids_histget(info, p->tid))) {
+    if ((h = pids_histget(info, p->tid, p->start_time))) {
         tics -= h->tics;
         p->maj_delta = p->maj_flt - h->maj;
         p->min_delta = p->min_flt - h->min;
     }
+    if (info->retain_yes
+    && !pids_retain_keep(info, p, &Hr(PHist_new[slot]), h))
+        return 0;
     /* here we're saving elapsed tics, which will include any
        tasks not previously seen via that pids_histget() guy! */
     p->pcpu = tics;
@@ -784,6 +1084,11 @@ static inline void pids_toggle_history (
         struct pids_info *info)
 {
     void *v;
+    int i;
+
+    // whatever the prior frame kept, yet this one didn't claim, is now gone
+    for (i = 0; i < Hr(num_saved); i++)
+        pids_retain_free(&Hr(PHist_sav[i].kept));
 
     v = Hr(PHist_sav);
     Hr(PHist_sav) = Hr(PHist_new);
@@ -792,22 +1097,25 @@ static inline void pids_toggle_history (
     v = Hr(PHash_sav);
     Hr(PHash_sav) = Hr(PHash_new);
     Hr(PHash_new) = v;
-    memcpy(Hr(PHash_new), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
+    memset(Hr(PHash_new), -1, sizeof(int) * Hr(HHash_siz));
 
+    info->hist->num_saved = info->hist->num_tasks;
     info->hist->num_tasks = 0;
 } // end: pids_toggle_history
 
+#undef _HASH_PID_
+
 
 #ifdef UNREF_RPTHASH
 static void pids_unref_rpthash (
         struct pids_info *info)
 {
     int i, j, pop, total_occupied, maxdepth, maxdepth_sav, numdepth
-        , cross_foot, sz = HHASH_SIZE * (int)sizeof(int)
+        , cross_foot, sz = Hr(HHash_siz) * (int)sizeof(int)
         , hsz = (int)sizeof(HST_t) * Hr(HHist_siz);
-    int depths[HHASH_SIZE];
+    int depths[Hr(HHash_siz)];
 
-    for (i = 0, total_occupied = 0, maxdepth = 0; i < HHASH_SIZE; i++) {
+    for (i = 0, total_occupied = 0, maxdepth = 0; i < Hr(HHash_siz); i++) {
         int V = Hr(PHash_new[i]);
         j = 0;
         if (-1 < V) {
@@ -827,7 +1135,7 @@ static void pids_unref_rpthash (
         "\n\tHST_t size = %d, total allocated = %d,"
         "\n\tthus PHist_new & PHist_sav consumed %dk (%d) total bytes."
         "\n"
-        "\n\tTwo hash tables provide for %d entries each + 1 extra 'empty' image,"
+        "\n\tTwo hash tables provide for %d entries each,"
         "\n\tthus %dk (%d) bytes per table for %dk (%d) total bytes."
         "\n"
         "\n\tGrand total = %dk (%d) bytes."
@@ -839,16 +1147,16 @@ static void pids_unref_rpthash (
         "\n\n"
         , (int)sizeof(HST_t),  Hr(HHist_siz)
         , hsz / 1024, hsz
-        , HHASH_SIZE
-        , sz / 1024, sz, (sz * 3) / 1024, sz * 3
-        , (hsz + (sz * 3)) / 1024, hsz + (sz * 3)
+        , Hr(HHash_siz)
+        , sz / 1024, sz, (sz * 2) / 1024, sz * 2
+        , (hsz + (sz * 2)) / 1024, hsz + (sz * 2)
         , info->hist->num_tasks
-        , total_occupied, (total_occupied * 100) / HHASH_SIZE
+        , total_occupied, (total_occupied * 100) / Hr(HHash_siz)
         , maxdepth);
 
     if (total_occupied) {
         for (pop = total_occupied, cross_foot = 0; maxdepth; maxdepth--) {
-            for (i = 0, numdepth = 0; i < HHASH_SIZE; i++)
+            for (i = 0, numdepth = 0; i < Hr(HHash_siz); i++)
                 if (depths[i] == maxdepth) ++numdepth;
             if (numdepth) fprintf(stderr,
                 "\t %5d (%3d%%) hash table entries at depth %d\n"
@@ -868,7 +1176,7 @@ static void pids_unref_rpthash (
 
         if (maxdepth_sav > 1) {
             fprintf(stderr, "\n    PIDs at max depth: ");
-            for (i = 0; i < HHASH_SIZE; i++)
+            for (i = 0; i < Hr(HHash_siz); i++)
                 if (depths[i] == maxdepth_sav) {
                     j = Hr(PHash_new[i]);
                     fprintf(stderr, "\n\tpos %4d:  %05d", i, Hr(PHist_new[j].pid));
@@ -884,7 +1192,6 @@ static void pids_unref_rpthash (
 #endif // UNREF_RPTHASH
 
 #undef Hr
-#undef HHASH_SIZE
 
 
 // ___ Unique/Specialized Private Function(s) |||||||||||||||||||||||||||||||||
@@ -925,8 +1232,13 @@ static inline int pids_assign_results (
     SET_t *that = &info->func_array[0];
 
     info->seterr = 0;
+    info->esc = ((struct stack_private *)stack)->esc;
+    ((struct stack_private *)stack)->tid = p->tid;
+    memcpy(((struct stack_private *)stack)->age, info->retain_age, sizeof(info->retain_age));
+    memset(info->retain_age, 0, sizeof(info->retain_age));
     while (*that) {
         (*that)(info, this, p);
+        ++info->esc;
         ++this;
         ++that;
     }
@@ -935,13 +1247,15 @@ static inline int pids_assign_results (
 
 
 static inline void pids_cleanup_stack (
+        struct pids_info *info,
         struct pids_result *this)
 {
     for (;;) {
         enum pids_item item = this->item;
         if (item >= PIDS_logical_end)
             break;
-        if (Item_table[item].freefunc)
+        // any slab owns both the 'str' and the 'strv' results
+        if (Item_table[item].freefunc && !info->slab_yes)
             Item_table[item].freefunc(this);
         this->result.ull_int = 0;
         ++this;
@@ -957,7 +1271,7 @@ static inline void pids_cleanup_stacks_all (
 
     while (ext) {
         for (i = 0; ext->stacks[i]; i++)
-            pids_cleanup_stack(ext->stacks[i]->head);
+            pids_cleanup_stack(info, ext->stacks[i]->head);
         ext = ext->next;
     };
 } // end: pids_cleanup_stacks_all
@@ -1065,6 +1379,15 @@ static inline void pids_libflags_set (
         info->oldflags |= Item_table[e].oldflags;
         info->history_yes |= Item_table[e].needhist;
     }
+    info->retain_yes = 0;
+    for (i = 0; i < RETAIN_COUNT; i++)
+        if (info->max_age[i] && (info->oldflags & Retain_flags[i]))
+            info->retain_yes |= Retain_flags[i];
+    if (info->retain_yes) {
+        // what's retained is found (by pid & start time) in our history
+        info->oldflags |= f_stat;
+        info->history_yes = 1;
+    }
     if (info->oldflags & f_either) {
         if (!(info->oldflags & (f_stat | f_status)))
             info->oldflags |= f_stat;
@@ -1107,6 +1430,32 @@ static inline int pids_oldproc_open (
 } // end: pids_oldproc_open
 
 
+    /* the fetch PROCTAB is retained across select & reap calls, sparing an
+       openproc (with its allocations) each time, as long as the flags stay
+       unchanged -- then we need only rewind it and refresh any pids/uids */
+static inline int pids_oldproc_fetch (
+        struct pids_info *info,
+        unsigned flags,
+        unsigned *ids,
+        int num)
+{
+    if (info->fetch_PT && info->fetch_flags != flags)
+        pids_oldproc_close(&info->fetch_PT);
+    if (info->fetch_PT == NULL) {
+        info->fetch_flags = flags;
+        return pids_oldproc_open(&info->fetch_PT, flags, ids, num);
+    }
+    rewindproc(info->fetch_PT);
+    if (flags & PROC_PID)
+        info->fetch_PT->pids = (pid_t *)ids;
+    else if (flags & PROC_UID) {
+        info->fetch_PT->uids = (uid_t *)ids;
+        info->fetch_PT->nuid = num;
+    }
+    return 1;
+} // end: pids_oldproc_fetch
+
+
 static int pids_prep_func_array (
         struct pids_info *info)
 {
@@ -1159,6 +1508,298 @@ static inline int pids_proc_tally (
 } // end: pids_proc_tally
 
 
+static int pids_sort_counted (
+        const void *A,
+        const void *B,
+        void *P)
+{
+    struct sort_parms *parms = P;
+
+    parms->compares++;
+    return parms->func(A, B, P);
+} // end: pids_sort_counted
+
+
+static inline int pids_sort_cmp (
+        struct sort_parms *parms,
+        struct pids_stack *a,
+        struct pids_stack *b)
+{
+    parms->compares++;
+    return parms->func(&a, &b, parms);
+} // end: pids_sort_cmp
+
+
+/*
+ * pids_sort_gallop():
+ *
+ * Return the index of the first of vec[lo..hi) which should follow
+ * 'key' (or when 'ties' is zero, the first not preceding 'key').
+ * The search gallops outward from 'lo' before bisecting, so finding
+ * that only a few elements precede 'key' costs only a few compares.
+ */
+static int pids_sort_gallop (
+        struct sort_parms *parms,
+        struct pids_stack *key,
+        struct pids_stack **vec,
+        int lo,
+        int hi,
+        int ties)
+{
+ #define precedes(i)  (ties ? pids_sort_cmp(parms, vec[i], key) <= 0 \
+                            : pids_sort_cmp(parms, vec[i], key) < 0)
+    int probe = lo, step = 1, mid;
+
+    while (probe < hi && precedes(probe)) {
+        lo = probe + 1;
+        probe += step;
+        step <<= 1;
+    }
+    if (probe > hi)
+        probe = hi;
+    while (lo < probe) {
+        mid = lo + (probe - lo) / 2;
+        if (precedes(mid))
+            lo = mid + 1;
+        else
+            probe = mid;
+    }
+    return lo;
+ #undef precedes
+} // end: pids_sort_gallop
+
+
+static int pids_sort_grow (
+        struct pids_sort_hint *hint,
+        int numstacked)
+{
+    struct pids_stack **work;
+    int *runs;
+
+    if (numstacked <= hint->n_alloc)
+        return 1;
+    /* either may fail, leaving the other one larger than n_alloc implies,
+       which is harmless. but n_alloc itself waits until both succeeded. */
+    if (!(work = realloc(hint->work, sizeof(void *) * numstacked)))
+        return 0;
+    hint->work = work;
+    if (!(runs = realloc(hint->runs, sizeof(int) * (numstacked + 1))))
+        return 0;
+    hint->runs = runs;
+    hint->n_alloc = numstacked;
+    return 1;
+} // end: pids_sort_grow
+
+
+/*
+ * pids_sort_merge():
+ *
+ * Stably merge the adjacent sorted runs vec[lo..mid) & vec[mid..hi).
+ * Whatever of the first run already precedes the second, or of the
+ * second already follows the first, is left in place.  The rest is
+ * merged by galloping, so runs which barely interleave are cheap.
+ */
+static void pids_sort_merge (
+        struct sort_parms *parms,
+        struct pids_stack **vec,
+        struct pids_stack **buf,
+        int lo,
+        int mid,
+        int hi)
+{
+    int a, b, n, na;
+
+    lo = pids_sort_gallop(parms, vec[mid], vec, lo, mid, 1);
+    if (lo == mid)
+        return;
+    hi = pids_sort_gallop(parms, vec[mid - 1], vec, mid, hi, 0);
+
+    na = mid - lo;
+    memcpy(buf, vec + lo, sizeof(void *) * na);
+    a = 0;
+    b = mid;
+    while (a < na && b < hi) {
+        // those of the second run which precede the first's next ...
+        n = pids_sort_gallop(parms, buf[a], vec, b, hi, 0) - b;
+        memmove(vec + lo, vec + b, sizeof(void *) * n);
+        lo += n;
+        b += n;
+        if (b >= hi)
+            break;
+        // then those of the first run which precede (or tie) the second's next
+        n = pids_sort_gallop(parms, vec[b], buf, a, na, 1) - a;
+        memcpy(vec + lo, buf + a, sizeof(void *) * n);
+        lo += n;
+        a += n;
+    }
+    memcpy(vec + lo, buf + a, sizeof(void *) * (na - a));
+} // end: pids_sort_merge
+
+
+/*
+ * pids_sort_natural():
+ *
+ * Sort the stacks by merging the runs already present in them.
+ * Returns zero without any merging if those runs were too many
+ * for this to beat a qsort (like when no hint could be applied).
+ */
+static int pids_sort_natural (
+        struct pids_sort_hint *hint,
+        struct sort_parms *parms,
+        struct pids_stack *stacks[],
+        int numstacked)
+{
+ #define MAXRUNS(n)  ((n) / 8)
+    int *runs = hint->runs;
+    int i, j, numruns;
+
+    numruns = 0;
+    runs[numruns++] = 0;
+    for (i = 1; i < numstacked; i++) {
+        if (pids_sort_cmp(parms, stacks[i - 1], stacks[i]) > 0) {
+            if (numruns > MAXRUNS(numstacked))
+                return 0;
+            runs[numruns++] = i;
+        }
+    }
+    runs[numruns] = numstacked;
+
+    while (numruns > 1) {
+        for (i = j = 0; i + 1 < numruns; i += 2) {
+            pids_sort_merge(parms, stacks, hint->work, runs[i], runs[i + 1], runs[i + 2]);
+            runs[j++] = runs[i];
+        }
+        if (i < numruns)
+            runs[j++] = runs[i];
+        runs[j] = numstacked;
+        numruns = j;
+    }
+    return 1;
+ #undef MAXRUNS
+} // end: pids_sort_natural
+
+
+/*
+ * pids_sort_remember():
+ *
+ * Note where each task landed, for seeding the next sort.
+ */
+static int pids_sort_remember (
+        struct pids_sort_hint *hint,
+        struct pids_stack *stacks[],
+        int numstacked)
+{
+    unsigned size = 64, slot;
+    int i, tid;
+
+    while (size < 2u * numstacked)
+        size <<= 1;
+    if (size != hint->mask + 1) {
+        free(hint->ranks);
+        hint->mask = 0;
+        if (!(hint->ranks = malloc(sizeof(struct sort_rank) * size)))
+            return 0;
+        hint->mask = size - 1;
+    }
+    memset(hint->ranks, 0, sizeof(struct sort_rank) * size);
+    for (i = 0; i < numstacked; i++) {
+        tid = ((struct stack_private *)stacks[i])->tid;
+        for (slot = tid & hint->mask; hint->ranks[slot].tid; slot = (slot + 1) & hint->mask)
+            ;
+        hint->ranks[slot].tid = tid;
+        hint->ranks[slot].rank = i;
+    }
+    hint->numranked = numstacked;
+    return 1;
+} // end: pids_sort_remember
+
+
+/*
+ * pids_sort_seed():
+ *
+ * Put the stacks back in the order they were last sorted into.
+ * Any tasks new since then simply follow the rest.
+ */
+static void pids_sort_seed (
+        struct pids_sort_hint *hint,
+        struct pids_stack *stacks[],
+        int numstacked)
+{
+    struct pids_stack **work = hint->work;
+    int i, tid, rank, numnew, numold;
+    unsigned slot;
+
+    /* the newcomers are gathered at the front of 'stacks', where they're only |
+       ever written over stacks already examined, then moved behind the rest.  | */
+    memset(work, 0, sizeof(void *) * hint->numranked);
+    numnew = 0;
+    for (i = 0; i < numstacked; i++) {
+        tid = ((struct stack_private *)stacks[i])->tid;
+        rank = -1;
+        for (slot = tid & hint->mask; hint->ranks[slot].tid; slot = (slot + 1) & hint->mask) {
+            if (hint->ranks[slot].tid == tid) {
+                rank = hint->ranks[slot].rank;
+                break;
+            }
+        }
+        if (rank >= 0 && !work[rank])
+            work[rank] = stacks[i];
+        else
+            stacks[numnew++] = stacks[i];
+    }
+    memmove(stacks + numstacked - numnew, stacks, sizeof(void *) * numnew);
+    for (i = numold = 0; i < hint->numranked; i++)
+        if (work[i])
+            stacks[numold++] = work[i];
+} // end: pids_sort_seed
+
+
+/*
+ * pids_sort_setup():
+ *
+ * Validate what's common to both of our sort functions, then find
+ * the offset (and thus the compare function) of the sort item.
+ * With fewer than two stacks, there's nothing more to find.
+ */
+static int pids_sort_setup (
+        struct pids_info *info,
+        struct pids_stack *stacks[],
+        int numstacked,
+        enum pids_item sortitem,
+        enum pids_sort_order order,
+        struct sort_parms *parms)
+{
+    struct pids_result *p;
+    int offset;
+
+    // a pids_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0  || sortitem >= PIDS_logical_end)
+        return 0;
+    if (order != PIDS_SORT_ASCEND && order != PIDS_SORT_DESCEND)
+        return 0;
+    if (numstacked < 2)
+        return 1;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (offset >= info->maxitems)
+            return 0;
+        if (p->item >= PIDS_logical_end)
+            return 0;
+        ++p;
+    }
+    parms->offset = offset;
+    parms->order = order;
+    parms->func = Item_table[p->item].sortfunc;
+    parms->compares = 0;
+    return 1;
+} // end: pids_sort_setup
+
+
 /*
  * pids_stacks_alloc():
  *
@@ -1176,25 +1817,29 @@ static struct stacks_extent *pids_stacks_alloc (
 {
     struct stacks_extent *p_blob;
     struct pids_stack **p_vect;
-    struct pids_stack *p_head;
-    size_t vect_size, head_size, list_size, blob_size;
-    void *v_head, *v_list;
+    struct stack_private *p_head;
+    size_t vect_size, head_size, list_size, esc_size, blob_size;
+    void *v_head, *v_list, *v_esc;
     int i;
 
     vect_size  = sizeof(void *) * maxstacks;                   // size of the addr vectors |
     vect_size += sizeof(void *);                               // plus NULL addr delimiter |
-    head_size  = sizeof(struct pids_stack);                    // size of that head struct |
+    head_size  = sizeof(struct stack_private);                 // size of that head struct |
     list_size  = sizeof(struct pids_result) * info->maxitems;  // any single results stack |
+    esc_size   = sizeof(struct esc_meta) * info->maxitems;     // and its escape_str notes |
     blob_size  = sizeof(struct stacks_extent);                 // the extent anchor itself |
     blob_size += vect_size;                                    // plus room for addr vects |
     blob_size += head_size * maxstacks;                        // plus room for head thing |
     blob_size += list_size * maxstacks;                        // plus room for our stacks |
+    blob_size += esc_size * maxstacks;                         // plus room for their notes |
 
     /* note: all of our memory is allocated in a single blob, facilitating a later free(). |
              as a minimum, it is important that the result structures themselves always be |
              contiguous for every stack since they are accessed through relative position. | */
     if (NULL == (p_blob = calloc(1, blob_size)))
         return NULL;
+    if (info->cost_yes)
+        info->cost.allocs++;
 
     p_blob->next = info->extents;                              // push this extent onto... |
     info->extents = p_blob;                                    // ...some existing extents |
@@ -1202,13 +1847,16 @@ static struct stacks_extent *pids_stacks_alloc (
     p_blob->stacks = p_vect;                                   // set actual vectors start |
     v_head = (void *)p_vect + vect_size;                       // prime head pointer start |
     v_list = v_head + (head_size * maxstacks);                 // prime our stacks pointer |
+    v_esc = v_list + (list_size * maxstacks);                  // prime the notes pointer  |
 
     for (i = 0; i < maxstacks; i++) {
-        p_head = (struct pids_stack *)v_head;
-        p_head->head = pids_itemize_stack((struct pids_result *)v_list, info->maxitems, info->items);
-        p_blob->stacks[i] = p_head;
+        p_head = (struct stack_private *)v_head;
+        p_head->stack.head = pids_itemize_stack((struct pids_result *)v_list, info->maxitems, info->items);
+        p_head->esc = (struct esc_meta *)v_esc;
+        p_blob->stacks[i] = &p_head->stack;
         v_list += list_size;
         v_head += head_size;
+        v_esc += esc_size;
     }
     p_blob->ext_numstacks = maxstacks;
     return p_blob;
@@ -1234,6 +1882,14 @@ static int pids_stacks_fetch (
     }
     pids_toggle_history(info);
     memset(&info->fetch.counts, 0, sizeof(struct pids_counts));
+    if (info->slab_yes) {
+        // this invalidates every 'str' result from the prior select/reap
+        slab_reset(info->fetch_slab);
+        info->fetch_PT->slab = info->slab = info->fetch_slab;
+    }
+    info->fetch_PT->cost = info->cost_yes ? &info->cost : NULL;
+    info->fetch_PT->retained = info->retain_yes ? pids_retain_check : NULL;
+    info->fetch_PT->retain_data = info;
 
     // iterate stuff --------------------------------------
     n_inuse = 0;
@@ -1361,18 +2017,36 @@ PROCPS_EXPORT int procps_pids_new (
 
     if (!(p->hist = calloc(1, sizeof(struct history_info)))
     || (!(p->hist->PHist_new = calloc(NEWOLD_INIT, sizeof(HST_t))))
-    || (!(p->hist->PHist_sav = calloc(NEWOLD_INIT, sizeof(HST_t))))) {
+    || (!(p->hist->PHist_sav = calloc(NEWOLD_INIT, sizeof(HST_t))))
+    || (!pids_config_history(p))) {
         free(p->items);
         if (p->hist) {
             free(p->hist->PHist_sav);  // this & next might be NULL ...
             free(p->hist->PHist_new);
+            free(p->hist->PHash_sav);
+            free(p->hist->PHash_new);
             free(p->hist);
         }
         free(p);
         return -ENOMEM;
     }
     p->hist->HHist_siz = NEWOLD_INIT;
-    pids_config_history(p);
+
+    if (getenv("LIBPROC_STRING_SLAB")) {
+        if (!(p->fetch_slab = slab_new())
+        || (!(p->get_slab = slab_new()))) {
+            slab_free(p->fetch_slab);
+            free(p->items);
+            free(p->hist->PHist_sav);
+            free(p->hist->PHist_new);
+            free(p->hist->PHash_sav);
+            free(p->hist->PHash_new);
+            free(p->hist);
+            free(p);
+            return -ENOMEM;
+        }
+        p->slab_yes = 1;
+    }
 
     pgsz = getpagesize();
     while (pgsz > 1024) { pgsz >>= 1; p->pgs2k_shift++; }
@@ -1423,7 +2097,7 @@ PROCPS_EXPORT int procps_pids_unref (
             struct stacks_extent *nextext, *ext = (*info)->otherexts;
             while (ext) {
                 nextext = ext->next;
-                pids_cleanup_stack(ext->stacks[0]->head);
+                pids_cleanup_stack(*info, ext->stacks[0]->head);
                 free(ext);
                 ext = nextext;
             };
@@ -1436,17 +2110,37 @@ PROCPS_EXPORT int procps_pids_unref (
         if ((*info)->items)
             free((*info)->items);
         if ((*info)->hist) {
+            int i;
+            for (i = 0; i < (*info)->hist->num_saved; i++)
+                pids_retain_free(&(*info)->hist->PHist_sav[i].kept);
+            for (i = 0; i < (*info)->hist->num_tasks; i++)
+                pids_retain_free(&(*info)->hist->PHist_new[i].kept);
             free((*info)->hist->PHist_sav);
             free((*info)->hist->PHist_new);
+            free((*info)->hist->PHash_sav);
+            free((*info)->hist->PHash_new);
             free((*info)->hist);
         }
 
         if ((*info)->get_ext)
            pids_oldproc_close(&(*info)->get_PT);
+        pids_oldproc_close(&(*info)->fetch_PT);
 
         if ((*info)->func_array)
             free((*info)->func_array);
 
+        slab_free((*info)->fetch_slab);
+        slab_free((*info)->get_slab);
+
+        while ((*info)->hints) {
+            struct pids_sort_hint *h = (*info)->hints;
+            (*info)->hints = h->next;
+            free(h->ranks);
+            free(h->work);
+            free(h->runs);
+            free(h);
+        }
+
         numa_uninit();
 
         free(*info);
@@ -1479,10 +2173,57 @@ PROCPS_EXPORT struct pids_stack *fatal_proc_unmounted (
 } // end: fatal_proc_unmounted
 
 
+/* procps_pids_age():
+ *
+ * Report how long ago a result was actually read, should it have been
+ * retained under a procps_pids_max_age policy rather than read anew.
+ *
+ * Returns: the age in seconds, else 0 (as with any current result).
+ */
+PROCPS_EXPORT double procps_pids_age (
+        const struct pids_stack *stack,
+        int relative_enum)
+{
+    enum pids_item item;
+    int i;
+
+    if (stack == NULL || relative_enum < 0)
+        return 0;
+    if ((item = stack->head[relative_enum].item) >= PIDS_logical_end)
+        return 0;
+    for (i = 0; i < RETAIN_COUNT; i++)
+        if (Item_table[item].oldflags & Retain_flags[i])
+            return ((const struct stack_private *)stack)->age[i];
+    return 0;
+} // end: procps_pids_age
+
+
+/* procps_pids_cost():
+ *
+ * Enable (on first use) the accounting of what each reap, select and
+ * get costs.  Reap and select start the counters anew, while get adds
+ * to them.
+ *
+ * Returns: pointer to the counters for the most recent cycle.
+ */
+PROCPS_EXPORT struct procps_cost *procps_pids_cost (
+        struct pids_info *info)
+{
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    errno = 0;
+
+    info->cost_yes = 1;
+    return &info->cost;
+} // end: procps_pids_cost
+
+
 PROCPS_EXPORT struct pids_stack *procps_pids_get (
         struct pids_info *info,
         enum pids_fetch_type which)
 {
+    unsigned long long began;
     struct timespec ts;
 
     errno = EINVAL;
@@ -1518,14 +2259,58 @@ fresh_start:
     if (0 >= clock_gettime(CLOCK_BOOTTIME, &ts))
         info->boot_tics = (ts.tv_sec + ts.tv_nsec * 1.0e-9) * info->hertz;
 
+    if (info->slab_yes) {
+        // this invalidates every 'str' result from the prior get
+        slab_reset(info->get_slab);
+        info->get_PT->slab = info->slab = info->get_slab;
+    }
+    info->get_PT->cost = info->cost_yes ? &info->cost : NULL;
+    began = info->cost_yes ? procps_cost_ns() : 0;
     if (NULL == info->read_something(info->get_PT, &info->get_proc))
         return NULL;
     if (!pids_assign_results(info, info->get_ext->stacks[0], &info->get_proc))
         return NULL;
+    if (info->cost_yes)
+        info->cost.total_ns += procps_cost_ns() - began;
     return info->get_ext->stacks[0];
 } // end: procps_pids_get
 
 
+/* procps_pids_max_age():
+ *
+ * Allow some costly (yet seldom changing) results to be retained by reap
+ * and select for up to 'seconds', rather than being read for every task
+ * every time.  A negative 'seconds' retains them until the task itself is
+ * replaced (as by a reused pid), while zero (the default) always reads.
+ *
+ * Such a policy covers every item from the same source as 'item': the
+ * PIDS_SMAP_* items, PIDS_ENVIRON, PIDS_CGNAME & PIDS_CGROUP, the PIDS_NS_*
+ * items, PIDS_EXE, and the PIDS_SD_* items.  Their vectorized forms are
+ * always read.  See procps_pids_age for how old any given result is.
+ *
+ * Returns: 0 on success, else -EINVAL for an item not from such a source.
+ */
+PROCPS_EXPORT int procps_pids_max_age (
+        struct pids_info *info,
+        enum pids_item item,
+        double seconds)
+{
+    int i;
+
+    if (info == NULL || item < 0 || item >= PIDS_logical_end)
+        return -EINVAL;
+    for (i = 0; i < RETAIN_COUNT; i++)
+        if (Item_table[item].oldflags & Retain_flags[i])
+            break;
+    if (i >= RETAIN_COUNT)
+        return -EINVAL;
+    info->max_age[i] = seconds;
+    if (info->maxitems)
+        pids_libflags_set(info);
+    return 0;
+} // end: procps_pids_max_age
+
+
 /* procps_pids_reap():
  *
  * Harvest all the available tasks/threads and provide the result
@@ -1537,6 +2322,7 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_reap (
         struct pids_info *info,
         enum pids_fetch_type which)
 {
+    unsigned long long began = 0;
     struct timespec ts;
     int rc;
 
@@ -1554,17 +2340,25 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_reap (
     if (info->containers_yes)
         pids_containers_check();
 
-    if (!pids_oldproc_open(&info->fetch_PT, info->oldflags))
+    if (info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        began = procps_cost_ns();
+    }
+    if (!pids_oldproc_fetch(info, info->oldflags, NULL, 0))
         return NULL;
     info->read_something = which ? readeither : readproc;
 
     info->boot_tics = 0;
-    if (0 >= clock_gettime(CLOCK_BOOTTIME, &ts))
+    if (info->snap_boot) {
+        info->boot_tics = info->snap_boot * info->hertz;
+        info->snap_boot = 0;
+    } else if (0 >= clock_gettime(CLOCK_BOOTTIME, &ts))
         info->boot_tics = (ts.tv_sec + ts.tv_nsec * 1.0e-9) * info->hertz;
 
     rc = pids_stacks_fetch(info);
 
-    pids_oldproc_close(&info->fetch_PT);
+    if (info->cost_yes)
+        info->cost.total_ns = procps_cost_ns() - began;
     // we better have found at least 1 pid
     return (rc > 0) ? &info->fetch.results : NULL;
 } // end: procps_pids_reap
@@ -1638,6 +2432,7 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_select (
         enum pids_select_type which)
 {
     unsigned ids[FILL_ID_MAX + 1];
+    unsigned long long began = 0;
     struct timespec ts;
     int rc;
 
@@ -1662,7 +2457,11 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_select (
     memcpy(ids, these, sizeof(unsigned) * numthese);
     ids[numthese] = 0;
 
-    if (!pids_oldproc_open(&info->fetch_PT, (info->oldflags | which), ids, numthese))
+    if (info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        began = procps_cost_ns();
+    }
+    if (!pids_oldproc_fetch(info, (info->oldflags | which), ids, numthese))
         return NULL;
     info->read_something = (which & PIDS_FETCH_THREADS_TOO) ? readeither : readproc;
 
@@ -1672,7 +2471,8 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_select (
 
     rc = pids_stacks_fetch(info);
 
-    pids_oldproc_close(&info->fetch_PT);
+    if (info->cost_yes)
+        info->cost.total_ns = procps_cost_ns() - began;
     // no guarantee any pids/uids were found
     return (rc >= 0) ? &info->fetch.results : NULL;
 } // end: procps_pids_select
@@ -1696,40 +2496,138 @@ PROCPS_EXPORT struct pids_stack **procps_pids_sort (
         enum pids_sort_order order)
 {
     struct sort_parms parms;
-    struct pids_result *p;
-    int offset;
 
     errno = EINVAL;
     if (info == NULL || stacks == NULL)
         return NULL;
-    // a pids_item is currently unsigned, but we'll protect our future
-    if (sortitem < 0  || sortitem >= PIDS_logical_end)
+    if (!pids_sort_setup(info, stacks, numstacked, sortitem, order, &parms))
         return NULL;
-    if (order != PIDS_SORT_ASCEND && order != PIDS_SORT_DESCEND)
+    if (numstacked < 2)
+        return stacks;
+    errno = 0;
+
+    if (info->cost_yes) {
+        qsort_r(stacks, numstacked, sizeof(void *), pids_sort_counted, &parms);
+        info->cost.compares += parms.compares;
+    } else
+        qsort_r(stacks, numstacked, sizeof(void *), parms.func, &parms);
+    return stacks;
+} // end: procps_pids_sort
+
+
+/*
+ * procps_pids_sort_hinted():
+ *
+ * Sort stacks just as procps_pids_sort would, but for a caller who
+ * repeatedly sorts much the same tasks.  The order each task ended up
+ * in is remembered in the hint, then used to arrange the stacks before
+ * the next sort.  Since few tasks change places from one refresh to
+ * the next, that sort is then a merge of a few long runs, needing far
+ * fewer compares.  Tasks with equal keys also keep their places.
+ *
+ * A caller should keep one hint (initially NULL) for each ordering it
+ * maintains.  Hints belong to the info and are freed along with it.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: the stacks must all have been returned by this library.
+ */
+PROCPS_EXPORT struct pids_stack **procps_pids_sort_hinted (
+        struct pids_info *info,
+        struct pids_sort_hint **hint,
+        struct pids_stack *stacks[],
+        int numstacked,
+        enum pids_item sortitem,
+        enum pids_sort_order order)
+{
+    struct sort_parms parms;
+    struct pids_sort_hint *h;
+
+    errno = EINVAL;
+    if (info == NULL || hint == NULL || stacks == NULL)
+        return NULL;
+    if (!pids_sort_setup(info, stacks, numstacked, sortitem, order, &parms))
         return NULL;
     if (numstacked < 2)
         return stacks;
 
-    offset = 0;
-    p = stacks[0]->head;
-    for (;;) {
-        if (p->item == sortitem)
-            break;
-        ++offset;
-        if (offset >= info->maxitems)
-            return NULL;
-        if (p->item >= PIDS_logical_end)
+    if (!(h = *hint)) {
+        if (!(h = calloc(1, sizeof(struct pids_sort_hint))))
             return NULL;
-        ++p;
+        h->next = info->hints;
+        info->hints = *hint = h;
     }
+    if (!pids_sort_grow(h, numstacked > h->numranked ? numstacked : h->numranked))
+        return NULL;
     errno = 0;
 
-    parms.offset = offset;
-    parms.order = order;
+    if (h->ranks)
+        pids_sort_seed(h, stacks, numstacked);
+    if (!pids_sort_natural(h, &parms, stacks, numstacked))
+        qsort_r(stacks, numstacked, sizeof(void *), pids_sort_counted, &parms);
+    if (info->cost_yes)
+        info->cost.compares += parms.compares;
 
-    qsort_r(stacks, numstacked, sizeof(void *), (QSR_t)Item_table[p->item].sortfunc, &parms);
+    // should this fail, we'll merely lose the advantage next time
+    if (!pids_sort_remember(h, stacks, numstacked))
+        h->numranked = 0;
     return stacks;
-} // end: procps_pids_sort
+} // end: procps_pids_sort_hinted
+
+
+/* procps_pids_str_cols():
+ *
+ * Report what was learned about a string result while it was being
+ * escaped: the screen columns it needs and whether it's pure ASCII.
+ * This is known only for PIDS_CGNAME, PIDS_CGROUP, PIDS_CMD,
+ * PIDS_CMDLINE, PIDS_ENVIRON and PIDS_EXE, and then only for
+ * those stacks returned by this library.
+ *
+ * Returns: the columns needed, or -1 if not known (*ascii is then 0).
+ */
+PROCPS_EXPORT int procps_pids_str_cols (
+        const struct pids_stack *stack,
+        int relative_enum,
+        int *ascii)
+{
+    const struct esc_meta *esc;
+
+    if (ascii)
+        *ascii = 0;
+    if (stack == NULL || relative_enum < 0)
+        return -1;
+    switch (stack->head[relative_enum].item) {
+        case PIDS_CGNAME:
+        case PIDS_CGROUP:
+        case PIDS_CMD:
+        case PIDS_CMDLINE:
+        case PIDS_ENVIRON:
+        case PIDS_EXE:
+            break;
+        default:
+            return -1;
+    }
+    esc = &((const struct stack_private *)stack)->esc[relative_enum];
+    if (ascii)
+        *ascii = esc->ascii;
+    return esc->cols;
+} // end: procps_pids_str_cols
+
+
+// --- library private function(s) -------------------------------------------
+
+/*
+ * pids_snapshot_boot():
+ *
+ * Lend our next reap the boot time recorded by procps_snapshot_take,
+ * so that TIME_ELAPSED & 'UTILIZATION' share its single timestamp.
+ */
+void pids_snapshot_boot (
+        struct pids_info *info,
+        double boottime)
+{
+    info->snap_boot = boottime;
+} // end: pids_snapshot_boot
 
 
 // --- special debugging function(s) ------------------------------------------
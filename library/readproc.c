@@ -47,6 +47,7 @@
 #include "devname.h"
 #include "escape.h"
 #include "misc.h"
+#include "procps-private.h"
 #include "pwcache.h"
 #include "readproc.h"
 
@@ -78,13 +79,195 @@ struct utlbuf_s {
 
 static int task_dir_missing;
 
+// the slab (if any) from the PROCTAB currently being read
+static __thread struct slab_s *str_slab;
+
+// the cost accounting (if any) from the PROCTAB currently being read
+static __thread struct procps_cost *io_cost;
+
+
+///////////////////////////////////////////////////////////////////////////
+// cost accounting support, active only when a caller has placed a struct
+// procps_cost in PROCTAB.cost (after openproc) -- otherwise each of these
+// guys amounts to a single test of the io_cost pointer
+
+static inline unsigned long long cost_began (void) {
+    return io_cost ? procps_cost_ns() : 0;
+}
+
+static inline void cost_alloc (void) {
+    if (io_cost) io_cost->allocs++;
+}
+
+static inline void cost_vanished (void) {
+    if (io_cost) io_cost->vanished++;
+}
+
+static int cost_file_type (const char *what) {
+    switch (what[0]) {
+        case 'c':
+            return what[1] == 'm' ? PROCPS_COST_CMDLINE : PROCPS_COST_CGROUP;
+        case 'e':
+            return PROCPS_COST_ENVIRON;
+        case 'i':
+            return PROCPS_COST_IO;
+        case 'o':
+            return PROCPS_COST_OOM;
+        case 's':
+            if (!strcmp(what, "stat"))   return PROCPS_COST_STAT;
+            if (!strcmp(what, "statm"))  return PROCPS_COST_STATM;
+            if (!strcmp(what, "status")) return PROCPS_COST_STATUS;
+            if (what[1] == 'm')          return PROCPS_COST_SMAPS;
+    }
+    return PROCPS_COST_OTHER;
+}
+
+    // charge one successfully opened file (and its reads) to io_cost
+static void cost_charge (const char *what, unsigned long long began, int reads, long bytes) {
+    unsigned long long ns;
+    int i;
+
+    if (!io_cost) return;
+    ns = procps_cost_ns() - began;
+    i = cost_file_type(what);
+    io_cost->opened++;
+    io_cost->reads += reads;
+    io_cost->bytes += bytes;
+    io_cost->read_ns += ns;
+    io_cost->file[i].opened++;
+    io_cost->file[i].bytes += bytes;
+    io_cost->file[i].read_ns += ns;
+}
+
+    // charge whatever time a reader spent, beyond its file reads, as parsing
+static void cost_parsed (unsigned long long began, unsigned long long read_ns) {
+    if (!io_cost) return;
+    io_cost->parse_ns += (procps_cost_ns() - began) - (io_cost->read_ns - read_ns);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+// slab support, where strings are carved from large chunks which are only
+// ever released wholesale (and then reused) via slab_reset()
+
+#define SLAB_CHUNK (1024*64)
+
+struct slab_chunk {
+    struct slab_chunk *next;
+    size_t size;                 // bytes available in data
+    size_t used;                 // bytes already carved
+    char data[];
+};
+
+struct slab_s {
+    struct slab_chunk *head;     // every chunk ever allocated
+    struct slab_chunk *curr;     // the chunk now being carved
+};
+
+struct slab_s *slab_new (void) {
+    return calloc(1, sizeof(struct slab_s));
+}
+
+void slab_free (struct slab_s *slab) {
+    struct slab_chunk *c, *next;
+
+    if (!slab) return;
+    for (c = slab->head; c; c = next) {
+        next = c->next;
+        free(c);
+    }
+    free(slab);
+}
+
+void slab_reset (struct slab_s *slab) {
+    struct slab_chunk *c;
+
+    for (c = slab->head; c; c = c->next)
+        c->used = 0;
+    slab->curr = slab->head;
+}
+
+static void *slab_alloc (struct slab_s *slab, size_t size) {
+    struct slab_chunk *c = slab->curr, **link;
+    void *v;
+
+    // try any chunks retained from an earlier reset before growing
+    while (c && c->size - c->used < size)
+        c = c->next;
+    if (!c) {
+        size_t want = size > SLAB_CHUNK ? size : SLAB_CHUNK;
+        if (!(c = malloc(sizeof(struct slab_chunk) + want)))
+            return NULL;
+        cost_alloc();
+        c->next = NULL;
+        c->size = want;
+        c->used = 0;
+        for (link = &slab->head; *link; link = &(*link)->next)
+            ;
+        *link = c;
+    }
+    slab->curr = c;
+    v = c->data + c->used;
+    c->used += size;
+    return v;
+}
+
+    // as above, but aligned for the char ** found in vectorized strings
+static void *slab_alloc_vec (struct slab_s *slab, size_t size) {
+    uintptr_t v;
+
+    if (!(v = (uintptr_t)slab_alloc(slab, size + sizeof(char*) - 1)))
+        return NULL;
+    return (void *)((v + sizeof(char*) - 1) & ~(uintptr_t)(sizeof(char*) - 1));
+}
+
+char *slab_strdup (struct slab_s *slab, const char *str) {
+    size_t len = strlen(str) + 1;
+    char *s;
+
+    if ((s = slab_alloc(slab, len)))
+        memcpy(s, str, len);
+    return s;
+}
+
+#undef SLAB_CHUNK
+
+    // strdup, unless the current PROCTAB carries a slab
+static inline char *str_dup (const char *str) {
+    if (str_slab) return slab_strdup(str_slab, str);
+    cost_alloc();
+    return strdup(str);
+}
+
+    // malloc for a vectorized string, unless the current PROCTAB carries a slab
+static inline void *vec_alloc (size_t size) {
+    if (str_slab) return slab_alloc_vec(str_slab, size);
+    cost_alloc();
+    return malloc(size);
+}
+
+#if defined(WITH_SYSTEMD) || defined(WITH_ELOGIND)
+    // move a string allocated elsewhere into the slab, if there is one
+static inline int str_adopt (char **str) {
+    char *s;
+
+    if (!str_slab || !*str) return 0;
+    s = slab_strdup(str_slab, *str);
+    free(*str);
+    *str = s;
+    return s == NULL;
+}
+#endif
+
 
 // free any additional dynamically acquired storage associated with a proc_t
 static inline void free_acquired (proc_t *p) {
     /*
      * here we free those items that might exist even when not explicitly |
      * requested by our caller.  it is expected that pid.c will then free |
-     * any remaining dynamic memory which might be dangling off a proc_t. | */
+     * any remaining dynamic memory which might be dangling off a proc_t. |
+     * when a slab is present it owns these strings, so we just forget. | */
+    if (str_slab) goto forget;
     if (p->cgname)   free(p->cgname);
     if (p->cgroup)   free(p->cgroup);
     if (p->cmd)      free(p->cmd);
@@ -96,7 +279,7 @@ static inline void free_acquired (proc_t *p) {
     if (p->sd_unit)  free(p->sd_unit);
     if (p->sd_uunit) free(p->sd_uunit);
     if (p->supgid)   free(p->supgid);
-
+forget:
     memset(p, '\0', sizeof(proc_t));
 }
 
@@ -104,7 +287,7 @@ static inline void free_acquired (proc_t *p) {
 ///////////////////////////////////////////////////////////////////////////
 
 typedef struct status_table_struct {
-    unsigned char name[8];        // /proc/*/status field name
+    unsigned char name[16];       // /proc/*/status field name
     unsigned char len;            // name length
 #ifdef LABEL_OFFSET
     long offset;                  // jump address offset
@@ -156,7 +339,7 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
       101, 101, 101, 101, 101, 101, 101, 101, 101, 101,
       101, 101, 101, 101, 101, 101, 101, 101,   6, 101,
       101, 101, 101, 101, 101,  45,  55,  25,  31,  50,
-       50,  10,   0,  35, 101, 101,  21, 101,  30, 101,
+       50,  10,   2,  35, 101, 101,  21, 101,  30, 101,
        20,  36,   0,   5,   0,  40,   0,   0, 101, 101,
       101, 101, 101, 101, 101, 101, 101,  30, 101,  15,
         0,   1, 101,  10, 101,  10, 101, 101, 101,  25,
@@ -165,15 +348,18 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
     };
 
     static const status_table_struct table[GPERF_TABLE_SIZE] = {
-      F(VmHWM)
+      NUL
       F(Threads)
-      NUL NUL NUL
+      F(VmHWM)
+      NUL NUL
       F(VmRSS)
       F(VmSwap)
       NUL NUL NUL
       F(Tgid)
       F(VmStk)
-      NUL NUL NUL
+      NUL
+      F(HugetlbPages)
+      NUL
       F(VmSize)
       F(Gid)
       NUL NUL NUL
@@ -276,8 +462,8 @@ ENTER(0x220);
         if (!IS_THREAD(P)) {
 #endif
         if (!P->cmd) {
-            escape_str(buf, raw, sizeof(buf));
-            if (!(P->cmd = strdup(buf))) return 1;
+            escape_str(buf, raw, sizeof(buf), &P->cmd_esc);
+            if (!(P->cmd = str_dup(buf))) return 1;
         }
 #ifdef FALSE_THREADS
         }
@@ -365,6 +551,9 @@ ENTER(0x220);
     case_VmSwap: // Linux 2.6.34
         P->vm_swap = (unsigned long)strtol(S,&S,10);
         continue;
+    case_HugetlbPages: // Linux 4.4
+        P->vm_hugetlb = (unsigned long)strtol(S,&S,10);
+        continue;
     case_Groups:
     {   char *ss = S, *nl = strchr(S, '\n');
         size_t j;
@@ -376,7 +565,8 @@ ENTER(0x220);
         if (ss >= nl) continue;
         j = nl ? (size_t)(nl - ss) : strlen(ss);
         if (j > 0 && j < INT_MAX) {
-            P->supgid = malloc(j+1);        // +1 in case space disappears
+            // +1 in case space disappears
+            P->supgid = str_slab ? slab_alloc(str_slab, j+1) : malloc(j+1);
             if (!P->supgid)
                 return 1;
             memcpy(P->supgid, ss, j);
@@ -432,7 +622,7 @@ ENTER(0x220);
     if (!IS_THREAD(P)) {
 #endif
     if (!P->supgid) {
-        P->supgid = strdup("-");
+        P->supgid = str_dup("-");
         if (!P->supgid)
             return 1;
     }
@@ -446,17 +636,18 @@ LEAVE(0x220);
 
 
 static int supgrps_from_supgids (proc_t *p) {
+    static __thread struct utlbuf_s ub = { NULL, 0 };
     char *g, *s;
     int t;
 
 #ifdef FALSE_THREADS
     if (IS_THREAD(p)) return 0;
 #endif
+    t = 0;
     if (!p->supgid || '-' == *p->supgid)
         goto wrap_up;
 
     s = p->supgid;
-    t = 0;
     do {
         const int max = P_G_SZ+2;
         char *end = NULL;
@@ -469,19 +660,20 @@ static int supgrps_from_supgids (proc_t *p) {
         s = end;
         g = pwcache_get_group(gid);
 
-        if ((t >= INT_MAX - max)
-        || (!(p->supgrp = realloc(p->supgrp, t + max))))
+        if (t >= INT_MAX / 2 - max)
+            return 1;
+        if (t + max > ub.siz
+        && (!(ub.buf = realloc(ub.buf, (ub.siz = (t + max) * 2)))))
             return 1;
 
-        len = snprintf(p->supgrp+t, max, "%s%s", t ? "," : "", g);
-        if (len <= 0) (p->supgrp+t)[len = 0] = '\0';
+        len = snprintf(ub.buf+t, max, "%s%s", t ? "," : "", g);
+        if (len <= 0) (ub.buf+t)[len = 0] = '\0';
         else if (len >= max) len = max-1;
         t += len;
     } while (*s);
 
 wrap_up:
-    if (!p->supgrp
-    && !(p->supgrp = strdup("-")))
+    if (!(p->supgrp = str_dup(t ? ub.buf : "-")))
         return 1;
     return 0;
 }
@@ -508,50 +700,55 @@ static int sd2proc (proc_t *restrict p) {
     uid_t uid;
 
     if (0 > sd_pid_get_machine_name(p->tid, &p->sd_mach)) {
-        if (!(p->sd_mach = strdup("-")))
+        if (!(p->sd_mach = str_dup("-")))
             return 1;
     }
     if (0 > sd_pid_get_owner_uid(p->tid, &uid)) {
-        if (!(p->sd_ouid = strdup("-")))
+        if (!(p->sd_ouid = str_dup("-")))
             return 1;
     } else {
         snprintf(buf, sizeof(buf), "%d", (int)uid);
-        if (!(p->sd_ouid = strdup(buf)))
+        if (!(p->sd_ouid = str_dup(buf)))
             return 1;
     }
     if (0 > sd_pid_get_session(p->tid, &p->sd_sess)) {
-        if (!(p->sd_sess = strdup("-")))
+        if (!(p->sd_sess = str_dup("-")))
             return 1;
-        if (!(p->sd_seat = strdup("-")))
+        if (!(p->sd_seat = str_dup("-")))
             return 1;
     } else {
         if (0 > sd_session_get_seat(p->sd_sess, &p->sd_seat))
-            if (!(p->sd_seat = strdup("-")))
+            if (!(p->sd_seat = str_dup("-")))
                 return 1;
     }
     if (0 > sd_pid_get_slice(p->tid, &p->sd_slice))
-        if (!(p->sd_slice = strdup("-")))
+        if (!(p->sd_slice = str_dup("-")))
             return 1;
     if (0 > sd_pid_get_unit(p->tid, &p->sd_unit))
-        if (!(p->sd_unit = strdup("-")))
+        if (!(p->sd_unit = str_dup("-")))
             return 1;
     if (0 > sd_pid_get_user_unit(p->tid, &p->sd_uunit))
-        if (!(p->sd_uunit = strdup("-")))
+        if (!(p->sd_uunit = str_dup("-")))
             return 1;
+    // those that sd-login allocated must still join any slab
+    if (str_adopt(&p->sd_mach) || str_adopt(&p->sd_sess)
+    || str_adopt(&p->sd_seat) || str_adopt(&p->sd_slice)
+    || str_adopt(&p->sd_unit) || str_adopt(&p->sd_uunit))
+        return 1;
 #else
-    if (!(p->sd_mach  = strdup("?")))
+    if (!(p->sd_mach  = str_dup("?")))
         return 1;
-    if (!(p->sd_ouid  = strdup("?")))
+    if (!(p->sd_ouid  = str_dup("?")))
         return 1;
-    if (!(p->sd_seat  = strdup("?")))
+    if (!(p->sd_seat  = str_dup("?")))
         return 1;
-    if (!(p->sd_sess  = strdup("?")))
+    if (!(p->sd_sess  = str_dup("?")))
         return 1;
-    if (!(p->sd_slice = strdup("?")))
+    if (!(p->sd_slice = str_dup("?")))
         return 1;
-    if (!(p->sd_unit  = strdup("?")))
+    if (!(p->sd_unit  = str_dup("?")))
         return 1;
-    if (!(p->sd_uunit = strdup("?")))
+    if (!(p->sd_uunit = str_dup("?")))
         return 1;
 #endif
     return 0;
@@ -587,8 +784,8 @@ ENTER(0x160);
        num = tmp - S;
        memcpy(raw, S, num);
        raw[num] = '\0';
-       escape_str(buf, raw, sizeof(buf));
-       if (!(P->cmd = strdup(buf))) return 1;
+       escape_str(buf, raw, sizeof(buf), &P->cmd_esc);
+       if (!(P->cmd = str_dup(buf))) return 1;
     }
 #ifdef FALSE_THREADS
      }
@@ -722,7 +919,8 @@ static void smaps2proc (const char *s, proc_t *restrict P) {
 static int file2str(const char *directory, const char *what, struct utlbuf_s *ub) {
  #define buffGRW 1024
     char path[PROCPATHLEN];
-    int fd, num, tot_read = 0, len;
+    int fd, num, tot_read = 0, len, reads = 0;
+    unsigned long long began;
 
     /* on first use we preallocate a buffer of minimum size to emulate
        former 'local static' behavior -- even if this read fails, that
@@ -732,11 +930,13 @@ static int file2str(const char *directory, const char *what, struct utlbuf_s *ub
     else {
         ub->buf = calloc(1, (ub->siz = buffGRW));
         if (!ub->buf) return -1;
+        cost_alloc();
     }
     len = snprintf(path, sizeof path, "%s/%s", directory, what);
     if (len <= 0 || (size_t)len >= sizeof path) return -1;
+    began = cost_began();
     if (-1 == (fd = open(path, O_RDONLY, 0))) return -1;
-    while (0 < (num = read(fd, ub->buf + tot_read, ub->siz - tot_read))) {
+    while (++reads, 0 < (num = read(fd, ub->buf + tot_read, ub->siz - tot_read))) {
         tot_read += num;
         if (tot_read < ub->siz) break;
         if (ub->siz >= INT_MAX - buffGRW) {
@@ -747,9 +947,11 @@ static int file2str(const char *directory, const char *what, struct utlbuf_s *ub
             close(fd);
             return -1;
         }
+        cost_alloc();
     };
     ub->buf[tot_read] = '\0';
     close(fd);
+    cost_charge(what, began, reads, tot_read);
     if (tot_read < 1) return -1;
     return tot_read;
  #undef buffGRW
@@ -757,59 +959,55 @@ static int file2str(const char *directory, const char *what, struct utlbuf_s *ub
 
 
 static char **file2strvec(const char *directory, const char *what) {
-    char buf[2048];     /* read buf bytes at a time */
-    char *p, *rbuf = 0, *endbuf, **q, **ret, *strp;
-    int fd, tot = 0, n, c, end_of_file = 0;
+ #define buffGRW 2048
+    /* ARG_LEN is our guesstimated median length of a command-line argument
+       or environment variable (the minimum is 1, the maximum is 131072) */
+ #define ARG_LEN 64
+ #define totMAX  ( INT_MAX / (ARG_LEN + (int)sizeof(char*)) * ARG_LEN )
+    static __thread struct utlbuf_s ub = { NULL, 0 };
+    char path[PROCPATHLEN];
+    char *p, *rbuf, *endbuf, **q, **ret, *strp;
+    int fd, tot = 0, n = 0, c, reads = 0;
     int align;
+    unsigned long long began;
 
-    const int len = snprintf(buf, sizeof buf, "%s/%s", directory, what);
-    if(len <= 0 || (size_t)len >= sizeof buf) return NULL;
-    fd = open(buf, O_RDONLY, 0);
+    const int len = snprintf(path, sizeof path, "%s/%s", directory, what);
+    if(len <= 0 || (size_t)len >= sizeof path) return NULL;
+    began = cost_began();
+    fd = open(path, O_RDONLY, 0);
     if(fd==-1) return NULL;
 
-    /* read whole file into a memory buffer, allocating as we go */
-    while ((n = read(fd, buf, sizeof buf - 1)) >= 0) {
-        if (n < (int)(sizeof buf - 1))
-            end_of_file = 1;
-        if (n <= 0 && tot <= 0) {  /* nothing read now, nothing read before */
-            break;                 /* process died between our open and read */
-        }
-        /* ARG_LEN is our guesstimated median length of a command-line argument
-           or environment variable (the minimum is 1, the maximum is 131072) */
-        #define ARG_LEN 64
-        if (tot >= INT_MAX / (ARG_LEN + (int)sizeof(char*)) * ARG_LEN - n) {
-            end_of_file = 1;       /* integer overflow: null-terminate and break */
-            n = 0;                 /* but tot > 0 */
-        }
-        #undef ARG_LEN
-        if (end_of_file &&
-            ((n > 0 && buf[n-1] != '\0') ||     /* last read char not null */
-             (n <= 0 && rbuf && rbuf[tot-1] != '\0')))  /* last read char not null */
-
-            buf[n++] = '\0';                    /* so append null-terminator */
-
-        if (n <= 0) break;         /* unneeded (end_of_file = 1) but avoid realloc */
-        rbuf = realloc(rbuf, tot + n);          /* allocate more memory */
-        if (!rbuf) {
-            close(fd);
-            return NULL;
+    /* read whole file into a buffer that's retained across calls, doubling
+       it as needed (thus rarely), while leaving room for a null terminator */
+    for (;;) {
+        if (ub.siz - tot < 2) {
+            if (ub.siz >= totMAX / 2)
+                break;             /* integer overflow: just null-terminate */
+            if (!(ub.buf = realloc(ub.buf, (ub.siz = ub.siz ? ub.siz * 2 : buffGRW)))) {
+                ub.siz = 0;
+                close(fd);
+                return NULL;
+            }
+            cost_alloc();
         }
-        memcpy(rbuf + tot, buf, n);             /* copy buffer into it */
-        tot += n;                               /* increment total byte ctr */
-        if (end_of_file)
-            break;
+        ++reads;
+        n = read(fd, ub.buf + tot, ub.siz - tot - 1);
+        if (n <= 0) break;
+        tot += n;
+        if (n < ub.siz - (tot - n) - 1)
+            break;                 /* a short read implies end of file */
     }
     close(fd);
-    if (n < 0 || tot <= 0) {       /* error, or nothing read */
-        if (rbuf) free(rbuf);
-        return NULL;               /* read error */
-    }
+    cost_charge(what, began, reads, tot);
+    if (n < 0 || tot <= 0)         /* error, or nothing read (process died?) */
+        return NULL;
 
-    rbuf[tot-1] = '\0';            /* belt and suspenders (the while loop did it, too) */
-    endbuf = rbuf + tot;           /* count space for pointers */
+    if (ub.buf[tot-1] != '\0')     /* last read char not null */
+        ub.buf[tot++] = '\0';      /* so append null-terminator */
+    endbuf = ub.buf + tot;         /* count space for pointers */
     align = (sizeof(char*)-1) - ((tot + sizeof(char*)-1) & (sizeof(char*)-1));
     c = sizeof(char*);             /* one extra for NULL term */
-    for (p = rbuf; p < endbuf; p++) {
+    for (p = ub.buf; p < endbuf; p++) {
         if (!*p || *p == '\n') {
             if (c >= INT_MAX - (tot + (int)sizeof(char*) + align)) break;
             c += sizeof(char*);
@@ -818,8 +1016,10 @@ static char **file2strvec(const char *directory, const char *what) {
             *p = 0;
     }
 
-    rbuf = realloc(rbuf, tot + c + align);      /* make room for ptrs AT END */
-    if (!rbuf) return NULL;
+    /* now a single allocation, whose ptrs are AT END, is all we need */
+    if (!(rbuf = vec_alloc(tot + c + align)))
+        return NULL;
+    memcpy(rbuf, ub.buf, tot);
     endbuf = rbuf + tot;                        /* addr just past data buf */
     q = ret = (char**) (endbuf+align);          /* ==> free(*ret) to dealloc */
     for (strp = p = rbuf; p < endbuf; p++) {
@@ -832,6 +1032,9 @@ static char **file2strvec(const char *directory, const char *what) {
     }
     *q = 0;                                     /* null ptr list terminator */
     return ret;
+ #undef buffGRW
+ #undef ARG_LEN
+ #undef totMAX
 }
 
 
@@ -840,8 +1043,9 @@ static char **file2strvec(const char *directory, const char *what) {
     //     PROC_EDITCGRPCVT, PROC_EDITCMDLCVT and PROC_EDITENVRCVT
 static int read_unvectored(char *restrict const dst, unsigned sz, const char *whom, const char *what, char sep) {
     char path[PROCPATHLEN];
-    int fd, len;
+    int fd, len, reads = 0;
     unsigned n = 0;
+    unsigned long long began;
 
     if(sz <= 0) return 0;
     if(sz >= INT_MAX) sz = INT_MAX-1;
@@ -849,11 +1053,13 @@ static int read_unvectored(char *restrict const dst, unsigned sz, const char *wh
 
     len = snprintf(path, sizeof(path), "%s/%s", whom, what);
     if(len <= 0 || (size_t)len >= sizeof(path)) return 0;
+    began = cost_began();
     fd = open(path, O_RDONLY);
     if(fd==-1) return 0;
 
     for(;;){
         ssize_t r = read(fd,dst+n,sz-n);
+        ++reads;
         if(r==-1){
             if(errno==EINTR) continue;
             break;
@@ -866,6 +1072,7 @@ static int read_unvectored(char *restrict const dst, unsigned sz, const char *wh
         }
     }
     close(fd);
+    cost_charge(what, began, reads, n);
     if(n){
         unsigned i = n;
         while(i && dst[i-1]=='\0') --i; // skip trailing zeroes
@@ -878,7 +1085,8 @@ static int read_unvectored(char *restrict const dst, unsigned sz, const char *wh
 }
 
 
-char **vectorize_this_str (const char *src) {
+    // the guts of vectorize_this_str, which will honor a slab if passed
+static char **vectorize_str (struct slab_s *slab, const char *src) {
  #define pSZ  (sizeof(char*))
     char *cpy, **vec;
     size_t adj, tot;
@@ -886,7 +1094,10 @@ char **vectorize_this_str (const char *src) {
     tot = strlen(src) + 1;                       // prep for our vectors
     if (tot < 1 || tot >= INT_MAX) tot = INT_MAX-1; // integer overflow?
     adj = (pSZ-1) - ((tot + pSZ-1) & (pSZ-1));   // calc alignment bytes
-    cpy = calloc(1, tot + adj + (2 * pSZ));      // get new larger buffer
+    if (slab)                                    // get new larger buffer
+        cpy = slab_alloc_vec(slab, tot + adj + (2 * pSZ));
+    else
+        cpy = calloc(1, tot + adj + (2 * pSZ));
     if (!cpy) return NULL;                       // oops, looks like ENOMEM
     snprintf(cpy, tot, "%s", src);               // duplicate their string
     vec = (char**)(cpy + tot + adj);             // prep pointer to pointers
@@ -896,11 +1107,19 @@ char **vectorize_this_str (const char *src) {
  #undef pSZ
 }
 
+char **vectorize_this_str (const char *src) {
+    return vectorize_str(NULL, src);
+}
+
+char **slab_vectorize (struct slab_s *slab, const char *src) {
+    return vectorize_str(slab, src);
+}
+
 
     // This littl' guy just serves those true vectorized fields
     // ( when a /proc source field didn't exist )
 static int vectorize_dash_rc (char ***vec) {
-    if (!(*vec = vectorize_this_str("-")))
+    if (!(*vec = vectorize_str(str_slab, "-")))
         return 1;
     return 0;
 }
@@ -910,10 +1129,13 @@ static int vectorize_dash_rc (char ***vec) {
     // guarantees the caller a valid proc_t.cgroup pointer.
 static int fill_cgroup_cvt (const char *directory, proc_t *restrict p) {
  #define vMAX ( MAX_BUFSZ - (int)(dst - dst_buffer) )
+    struct esc_meta meta;
     char *src, *dst, *grp, *eob, *name;
     int tot, x, len;
 
     *(dst = dst_buffer) = '\0';                  // empty destination
+    p->cgroup_esc.cols = 0;
+    p->cgroup_esc.ascii = 1;
     tot = read_unvectored(src_buffer, MAX_BUFSZ, directory, "cgroup", '\0');
     for (src = src_buffer, eob = src_buffer + tot; src < eob; src += x) {
         x = 1;                                   // loop assist
@@ -927,14 +1149,22 @@ static int fill_cgroup_cvt (const char *directory, proc_t *restrict p) {
         len = snprintf(dst, vMAX, "%s", (dst > dst_buffer) ? "," : "");
         if (len < 0 || len >= vMAX) break;
         dst += len;
-        dst += escape_str(dst, grp, vMAX);
+        p->cgroup_esc.cols += len;
+        dst += escape_str(dst, grp, vMAX, &meta);
+        p->cgroup_esc.cols += meta.cols;
+        p->cgroup_esc.ascii &= meta.ascii;
     }
-    if (!(p->cgroup = strdup(dst_buffer[0] ? dst_buffer : "-")))
+    if (!dst_buffer[0])
+        p->cgroup_esc.cols = 1;
+    if (!(p->cgroup = str_dup(dst_buffer[0] ? dst_buffer : "-")))
         return 1;
     name = strstr(p->cgroup, ":name=");
     if (name && *(name+6)) name += 6; else name = p->cgroup;
-    if (!(p->cgname = strdup(name)))
+    if (!(p->cgname = str_dup(name)))
         return 1;
+    // any part of an ascii string is ascii, otherwise we'd have to look
+    p->cgname_esc.ascii = p->cgroup_esc.ascii;
+    p->cgname_esc.cols = p->cgroup_esc.ascii ? (int)strlen(p->cgname) : -1;
     return 0;
  #undef vMAX
 }
@@ -946,10 +1176,14 @@ static int fill_cgroup_cvt (const char *directory, proc_t *restrict p) {
 static int fill_cmdline_cvt (const char *directory, proc_t *restrict p) {
  #define uFLG ( ESC_BRACKETS | ESC_DEFUNCT )
     if (read_unvectored(src_buffer, MAX_BUFSZ, directory, "cmdline", ' '))
-        escape_str(dst_buffer, src_buffer, MAX_BUFSZ);
+        escape_str(dst_buffer, src_buffer, MAX_BUFSZ, &p->cmdline_esc);
     else
-        escape_command(dst_buffer, p, MAX_BUFSZ, uFLG);
-    p->cmdline = strdup(dst_buffer[0] ? dst_buffer : "?");
+        escape_command(dst_buffer, p, MAX_BUFSZ, uFLG, &p->cmdline_esc);
+    if (!dst_buffer[0]) {
+        p->cmdline_esc.cols = 1;
+        p->cmdline_esc.ascii = 1;
+    }
+    p->cmdline = str_dup(dst_buffer[0] ? dst_buffer : "?");
     if (!p->cmdline)
         return 1;
     return 0;
@@ -962,8 +1196,12 @@ static int fill_cmdline_cvt (const char *directory, proc_t *restrict p) {
 static int fill_environ_cvt (const char *directory, proc_t *restrict p) {
     dst_buffer[0] = '\0';
     if (read_unvectored(src_buffer, MAX_BUFSZ, directory, "environ", ' '))
-        escape_str(dst_buffer, src_buffer, MAX_BUFSZ);
-    p->environ = strdup(dst_buffer[0] ? dst_buffer : "-");
+        escape_str(dst_buffer, src_buffer, MAX_BUFSZ, &p->environ_esc);
+    if (!dst_buffer[0]) {
+        p->environ_esc.cols = 1;
+        p->environ_esc.ascii = 1;
+    }
+    p->environ = str_dup(dst_buffer[0] ? dst_buffer : "-");
     if (!p->environ)
         return 1;
     return 0;
@@ -1139,7 +1377,7 @@ static int login_uid (const char *path) {
 }
 
 
-static char *readlink_exe (const char *path){
+static char *readlink_exe (const char *path, struct esc_meta *meta){
     char buf[PROCPATHLEN];
     int in;
 
@@ -1147,10 +1385,12 @@ static char *readlink_exe (const char *path){
     in = (int)readlink(buf, src_buffer, MAX_BUFSZ-1);
     if (in > 0) {
         src_buffer[in] = '\0';
-        escape_str(dst_buffer, src_buffer, MAX_BUFSZ);
-        return strdup(dst_buffer);
+        escape_str(dst_buffer, src_buffer, MAX_BUFSZ, meta);
+        return str_dup(dst_buffer);
     }
-    return strdup("-");
+    meta->cols = 1;
+    meta->ascii = 1;
+    return str_dup("-");
 }
 
 
@@ -1219,8 +1459,10 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
     unsigned flags = PT->flags;
     int rc = 0;
 
-    if (stat(path, &sb) == -1)                  /* no such dirent (anymore) */
+    if (stat(path, &sb) == -1) {                /* no such dirent (anymore) */
+        cost_vanished();
         goto next_proc;
+    }
 
     if ((flags & PROC_UID) && !XinLN(uid_t, sb.st_uid, PT->uids, PT->nuid))
         goto next_proc;                      /* not one of the requested uids */
@@ -1229,11 +1471,16 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
     p->egid = sb.st_gid;                        /* need a way to get real gid */
 
     if (flags & PROC_FILLSTAT) {                // read /proc/#/stat
-        if (file2str(path, "stat", &ub) == -1)
+        if (file2str(path, "stat", &ub) == -1) {
+            cost_vanished();
             goto next_proc;
+        }
         rc += stat2proc(ub.buf, p);
     }
 
+    if (PT->retained)                           // some values may be reused
+        flags &= ~PT->retained(PT, p);
+
     if (flags & PROC_FILLIO) {                  // read /proc/#/io
         if (file2str(path, "io", &ub) != -1)
             io2proc(ub.buf, p);
@@ -1325,7 +1572,7 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
         p->luid = login_uid(path);
 
     if (flags & PROC_FILL_EXE) {
-        if (!(p->exe = readlink_exe(path)))
+        if (!(p->exe = readlink_exe(path, &p->exe_esc)))
             rc += 1;
     }
 
@@ -1359,8 +1606,10 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
     unsigned flags = PT->flags;
     int rc = 0;
 
-    if (stat(path, &sb) == -1)                  /* no such dirent (anymore) */
+    if (stat(path, &sb) == -1) {                /* no such dirent (anymore) */
+        cost_vanished();
         goto next_task;
+    }
 
 //  if ((flags & PROC_UID) && !XinLN(uid_t, sb.st_uid, PT->uids, PT->nuid))
 //      goto next_task;                      /* not one of the requested uids */
@@ -1369,11 +1618,16 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
     t->egid = sb.st_gid;                        /* need a way to get real gid */
 
     if (flags & PROC_FILLSTAT) {                // read /proc/#/task/#/stat
-        if (file2str(path, "stat", &ub) == -1)
+        if (file2str(path, "stat", &ub) == -1) {
+            cost_vanished();
             goto next_task;
+        }
         rc += stat2proc(ub.buf, t);
     }
 
+    if (PT->retained)                           // some values may be reused
+        flags &= ~PT->retained(PT, t);
+
     if (flags & PROC_FILLIO) {                  // read /proc/#/task/#/io
         if (file2str(path, "io", &ub) != -1)
             io2proc(ub.buf, t);
@@ -1439,7 +1693,7 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
         rc += sd2proc(t);
 
     if (flags & PROC_FILL_EXE) {
-        if (!(t->exe = readlink_exe(path)))
+        if (!(t->exe = readlink_exe(path, &t->exe_esc)))
             rc += 1;
     }
 #ifdef FALSE_THREADS
@@ -1503,7 +1757,7 @@ static int simple_nextpid(PROCTAB *restrict const PT, proc_t *restrict const p)
             p->tgid = strtoul(ent->d_name, NULL, 10);
             if (errno == 0) {
                 p->tid = p->tgid;
-                snprintf(path, PROCPATHLEN, "/proc/%d", p->tgid);
+                snprintf(path, PROCPATHLEN, "%s/%d", procfs_root(), p->tgid);
                 return 1;
             }
         }
@@ -1522,7 +1776,7 @@ static int simple_nexttid(PROCTAB *restrict const PT, const proc_t *restrict con
       closedir(PT->taskdir);
     }
     // use "path" as some tmp space
-    snprintf(path, PROCPATHLEN, "/proc/%d/task", p->tgid);
+    snprintf(path, PROCPATHLEN, "%s/%d/task", procfs_root(), p->tgid);
     PT->taskdir = opendir(path);
     if(!PT->taskdir) return 0;
     PT->taskdir_user = p->tgid;
@@ -1535,7 +1789,7 @@ static int simple_nexttid(PROCTAB *restrict const PT, const proc_t *restrict con
   t->tid = strtoul(ent->d_name, NULL, 10);
   t->tgid = p->tgid;
 //t->ppid = p->ppid;  // cover for kernel behavior? we want both actually...?
-  snprintf(path, PROCPATHLEN, "/proc/%d/task/%.10s", p->tgid, ent->d_name);
+  snprintf(path, PROCPATHLEN, "%s/%d/task/%.10s", procfs_root(), p->tgid, ent->d_name);
   return 1;
 }
 
@@ -1549,7 +1803,7 @@ static int listed_nextpid (PROCTAB *PT, proc_t *p) {
   char *path = PT->path;
 
   if (pid) {
-    snprintf(path, PROCPATHLEN, "/proc/%d", pid);
+    snprintf(path, PROCPATHLEN, "%s/%d", procfs_root(), pid);
     p->tid = p->tgid = pid;        // this tgid may be a huge fib |
 
     /* the 'status' directory is the only place where we find the |
@@ -1579,8 +1833,11 @@ static int listed_nextpid (PROCTAB *PT, proc_t *p) {
  * fairly complex, but it does try to not to do any unnecessary work.
  */
 proc_t *readproc(PROCTAB *restrict const PT, proc_t *restrict p) {
+  unsigned long long began, read_ns;
   proc_t *ret;
 
+  str_slab = PT->slab;
+  io_cost = PT->cost;
   free_acquired(p);
 
   for(;;){
@@ -1588,7 +1845,10 @@ proc_t *readproc(PROCTAB *restrict const PT, proc_t *restrict p) {
     if (!PT->finder(PT,p)) goto out;
 
     // go read the process data
+    began = cost_began();
+    read_ns = io_cost ? io_cost->read_ns : 0;
     ret = PT->reader(PT,p);
+    cost_parsed(began, read_ns);
     if(ret) return ret;
   }
 
@@ -1606,8 +1866,11 @@ proc_t *readeither (PROCTAB *restrict const PT, proc_t *restrict x) {
     static __thread proc_t *new_p;    // for process/task transitions
     static __thread int canary;
     char path[PROCPATHLEN];
+    unsigned long long began, read_ns;
     proc_t *ret;
 
+    str_slab = PT->slab;
+    io_cost = PT->cost;
     free_acquired(x);
 
     if (new_p) {
@@ -1621,15 +1884,23 @@ next_proc:
         // fills in the PT->path, plus skel_p.tid and skel_p.tgid
         if (!PT->finder(PT,&skel_p)) goto end_procs;       // simple_nextpid
         if (!task_dir_missing) break;
-        if ((ret = PT->reader(PT,x))) return ret;          // simple_readproc
+        began = cost_began();
+        read_ns = io_cost ? io_cost->read_ns : 0;
+        ret = PT->reader(PT,x);                            // simple_readproc
+        cost_parsed(began, read_ns);
+        if (ret) return ret;
     }
 
 next_task:
     // fills in our path, plus x->tid and x->tgid
-    if ((!(PT->taskfinder(PT,&skel_p,x,path)))             // simple_nexttid
-    || (!(ret = PT->taskreader(PT,x,path)))) {             // simple_readtask
+    if (!(PT->taskfinder(PT,&skel_p,x,path)))              // simple_nexttid
+        goto next_proc;
+    began = cost_began();
+    read_ns = io_cost ? io_cost->read_ns : 0;
+    ret = PT->taskreader(PT,x,path);                       // simple_readtask
+    cost_parsed(began, read_ns);
+    if (!ret)
         goto next_proc;
-    }
     if (!new_p) {
         new_p = ret;
         canary = new_p->tid;
@@ -1656,7 +1927,7 @@ PROCTAB *openproc(unsigned flags, ...) {
     if (hide_kernel < 0)
         hide_kernel = (NULL != getenv("LIBPROC_HIDE_KERNEL"));
     if (!did_stat){
-        task_dir_missing = stat("/proc/self/task", &sbuf);
+        task_dir_missing = stat(procfs_path("/proc/self/task"), &sbuf);
         did_stat = 1;
     }
     PT->taskdir = NULL;
@@ -1669,7 +1940,7 @@ PROCTAB *openproc(unsigned flags, ...) {
         PT->procfs = NULL;
         PT->finder = listed_nextpid;
     }else{
-        PT->procfs = opendir("/proc");
+        PT->procfs = opendir(procfs_root());
         if (!PT->procfs) { free(PT); return NULL; }
         PT->finder = simple_nextpid;
     }
@@ -1719,12 +1990,25 @@ void closeproc(PROCTAB *PT) {
 }
 
 
+// restart a process table scan, retaining the PROCTAB (and its storage)
+void rewindproc(PROCTAB *PT) {
+    if (PT){
+        if (PT->procfs) rewinddir(PT->procfs);
+        if (PT->taskdir) closedir(PT->taskdir);
+        PT->taskdir = NULL;
+        PT->taskdir_user = -1;
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////
 int look_up_our_self(void) {
     struct utlbuf_s ub = { NULL, 0 };
     int rc = 0;
     proc_t p;
 
+    str_slab = NULL;
+    io_cost = NULL;
     memset(&p, 0, sizeof(proc_t));
     if(file2str("/proc/self", "stat", &ub) == -1){
         fprintf(stderr, "Error, do this: mount -t proc proc /proc\n");
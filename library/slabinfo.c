@@ -485,7 +485,7 @@ static int slabinfo_read_failed (
     info->nodes_used = 0;
 
     if (NULL == info->slabinfo_fp
-    && (info->slabinfo_fp = fopen(SLABINFO_FILE, "r")) == NULL)
+    && (info->slabinfo_fp = fopen(procfs_path(SLABINFO_FILE), "r")) == NULL)
         return 1;
 
     if (fseek(info->slabinfo_fp, 0L, SEEK_SET) < 0)
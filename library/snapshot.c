@@ -0,0 +1,310 @@
+/*
+ * snapshot.c - frame coherent sampling functions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "procps-private.h"
+#include "snapshot.h"
+
+
+struct snapshot_info {
+    int refcount;
+    struct stat_info *stat;            // each of these is optional, but when
+    struct meminfo_info *meminfo;      // present we'll hold a reference for |
+    struct pids_info *pids;            // as long as we ourselves survive    |
+    enum stat_reap_type stat_what;
+    enum stat_item *stat_items;
+    int stat_numitems;
+    enum meminfo_item *mem_items;
+    int mem_numitems;
+    enum pids_fetch_type pids_which;
+    struct snapshot_result results;    // what's returned by procps_snapshot_take
+};
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+static inline double snapshot_boottime (void) {
+    struct timespec ts;
+
+    if (0 > clock_gettime(CLOCK_BOOTTIME, &ts))
+        return 0;
+    return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+} // end: snapshot_boottime
+
+
+static void *snapshot_items_dup (
+        const void *items,
+        int numitems,
+        size_t size)
+{
+    void *new;
+
+    if (!(new = malloc(size * numitems)))
+        return NULL;
+    return memcpy(new, items, size * numitems);
+} // end: snapshot_items_dup
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_snapshot_new:
+ *
+ * Create a new container through which those pids, stat and meminfo
+ * contexts subsequently added can all be sampled together.
+ *
+ * The initial refcount is 1, and needs to be decremented
+ * to release the resources of the structure.
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_snapshot_new (
+        struct snapshot_info **info)
+{
+    struct snapshot_info *p;
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct snapshot_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+
+    *info = p;
+    return 0;
+} // end: procps_snapshot_new
+
+
+PROCPS_EXPORT int procps_snapshot_ref (
+        struct snapshot_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_snapshot_ref
+
+
+PROCPS_EXPORT int procps_snapshot_unref (
+        struct snapshot_info **info)
+{
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        if ((*info)->stat)
+            procps_stat_unref(&(*info)->stat);
+        if ((*info)->meminfo)
+            procps_meminfo_unref(&(*info)->meminfo);
+        if ((*info)->pids)
+            procps_pids_unref(&(*info)->pids);
+        free((*info)->stat_items);
+        free((*info)->mem_items);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_snapshot_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+/*
+ * procps_snapshot_add_meminfo:
+ *
+ * Have each snapshot include a procps_meminfo_select of these items.
+ * Any prior meminfo context is released in favor of this one, while
+ * a NULL meminfo just drops it from subsequent snapshots.
+ *
+ * Returns: < 0 on failure, 0 on success
+ */
+PROCPS_EXPORT int procps_snapshot_add_meminfo (
+        struct snapshot_info *info,
+        struct meminfo_info *meminfo,
+        enum meminfo_item *items,
+        int numitems)
+{
+    enum meminfo_item *dup = NULL;
+
+    if (info == NULL)
+        return -EINVAL;
+    if (meminfo && (items == NULL || numitems < 1))
+        return -EINVAL;
+    if (meminfo
+    && !(dup = snapshot_items_dup(items, numitems, sizeof(enum meminfo_item))))
+        return -ENOMEM;
+
+    if (info->meminfo)
+        procps_meminfo_unref(&info->meminfo);
+    info->meminfo = NULL;
+    free(info->mem_items);
+    info->mem_items = dup;
+    info->mem_numitems = 0;
+    info->results.meminfo = NULL;
+    if (meminfo) {
+        procps_meminfo_ref(meminfo);
+        info->meminfo = meminfo;
+        info->mem_numitems = numitems;
+    }
+    return 0;
+} // end: procps_snapshot_add_meminfo
+
+
+/*
+ * procps_snapshot_add_pids:
+ *
+ * Have each snapshot include a procps_pids_reap of those items
+ * already established for this pids context.  Any prior pids
+ * context is released in favor of this one, while a NULL pids
+ * just drops it from subsequent snapshots.
+ *
+ * Returns: < 0 on failure, 0 on success
+ */
+PROCPS_EXPORT int procps_snapshot_add_pids (
+        struct snapshot_info *info,
+        struct pids_info *pids,
+        enum pids_fetch_type which)
+{
+    if (info == NULL)
+        return -EINVAL;
+    if (pids && which != PIDS_FETCH_TASKS_ONLY && which != PIDS_FETCH_THREADS_TOO)
+        return -EINVAL;
+
+    if (info->pids)
+        procps_pids_unref(&info->pids);
+    info->pids = NULL;
+    info->results.pids = NULL;
+    if (pids) {
+        procps_pids_ref(pids);
+        info->pids = pids;
+        info->pids_which = which;
+    }
+    return 0;
+} // end: procps_snapshot_add_pids
+
+
+/*
+ * procps_snapshot_add_stat:
+ *
+ * Have each snapshot include a procps_stat_reap of these items.
+ * Any prior stat context is released in favor of this one, while
+ * a NULL stat just drops it from subsequent snapshots.
+ *
+ * Returns: < 0 on failure, 0 on success
+ */
+PROCPS_EXPORT int procps_snapshot_add_stat (
+        struct snapshot_info *info,
+        struct stat_info *stat,
+        enum stat_reap_type what,
+        enum stat_item *items,
+        int numitems)
+{
+    enum stat_item *dup = NULL;
+
+    if (info == NULL)
+        return -EINVAL;
+    if (stat && (items == NULL || numitems < 1))
+        return -EINVAL;
+    if (stat && what != STAT_REAP_CPUS_ONLY && what != STAT_REAP_NUMA_NODES_TOO)
+        return -EINVAL;
+    if (stat
+    && !(dup = snapshot_items_dup(items, numitems, sizeof(enum stat_item))))
+        return -ENOMEM;
+
+    if (info->stat)
+        procps_stat_unref(&info->stat);
+    info->stat = NULL;
+    free(info->stat_items);
+    info->stat_items = dup;
+    info->stat_numitems = 0;
+    info->results.stat = NULL;
+    if (stat) {
+        procps_stat_ref(stat);
+        info->stat = stat;
+        info->stat_what = what;
+        info->stat_numitems = numitems;
+    }
+    return 0;
+} // end: procps_snapshot_add_stat
+
+
+/*
+ * procps_snapshot_take:
+ *
+ * Sample every context that's been added, one immediately after the
+ * other, under a single CLOCK_BOOTTIME timestamp.  The system wide
+ * files are read first, since the pids reap is much more lengthy.
+ *
+ * Any deltas (like STAT_TIC_DELTA_USER or PIDS_TICS_DELTA) are then
+ * best converted to rates using the one 'elapsed' value provided,
+ * assuming those contexts are sampled only through this interface.
+ *
+ * Returns: pointer to a snapshot_result struct on success
+ *          NULL on error
+ */
+PROCPS_EXPORT struct snapshot_result *procps_snapshot_take (
+        struct snapshot_info *info)
+{
+    struct snapshot_result *r;
+    double now;
+
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    if (!info->stat && !info->meminfo && !info->pids)
+        return NULL;
+    errno = 0;
+    r = &info->results;
+
+    now = snapshot_boottime();
+    r->elapsed = (r->boottime && now > r->boottime) ? now - r->boottime : 0;
+    r->boottime = now;
+
+    if (info->stat
+    && !(r->stat = procps_stat_reap(info->stat, info->stat_what, info->stat_items, info->stat_numitems)))
+        return NULL;
+    if (info->meminfo
+    && !(r->meminfo = procps_meminfo_select(info->meminfo, info->mem_items, info->mem_numitems)))
+        return NULL;
+    if (info->pids) {
+        pids_snapshot_boot(info->pids, now);
+        if (!(r->pids = procps_pids_reap(info->pids, info->pids_which)))
+            return NULL;
+    }
+
+    r->skew = snapshot_boottime() - now;
+    if (r->skew < 0)
+        r->skew = 0;
+    return r;
+} // end: procps_snapshot_take
@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "misc.h"
 #include "numa.h"
 
 #include "procps-private.h"
@@ -38,11 +39,17 @@
 
 #define STAT_FILE "/proc/stat"
 #define CORE_FILE "/proc/cpuinfo"
+#define CPUS_DIR  "/sys/devices/system/cpu"
 
 #define CORE_BUFSIZ   1024             // buf size for line of /proc/cpuinfo
 #define BUFFER_INCR   8192             // amount i/p buffer allocations grow
 #define STACKS_INCR   64               // amount reap stack allocations grow
 #define NEWOLD_INCR   64               // amount jiffs hist allocations grow
+#define IDLE_STATES   16               // most cpuidle states tracked per cpu
+
+#define SYSFS_REAP    1                // sysfs_yes, a reap wants those items
+#define SYSFS_SELECT  2                //  "  a select wants those items
+#define SYSFS_GET     4                //  "  a get once wanted one of them
 
 #define ECORE_BEGIN   10               // PRETEND_E_CORES begin at this cpu#
 
@@ -105,12 +112,30 @@ struct hist_sys {
     struct stat_data old;
 };
 
+struct stat_sysfs {
+    int freqs;                         // number of cpus reporting a frequency
+    unsigned long cur, max;            // kHz, summed across those 'freqs'
+    unsigned long long idle, deep;     // cpuidle residency usecs, this interval
+    unsigned long thrt, thrt_delta;    // thermal throttle counts
+};
+
+struct stat_cpufs {
+    int cur_fd;                        // held open once needed, -2 if absent
+    int thr_fd;                        //  "
+    int idle_fd[IDLE_STATES];          //  "
+    int primed;                        // the 'last time around' values are valid
+    unsigned long max;                 // read when cur_fd is (re)opened
+    unsigned long long idle, deep;     // last time around
+    unsigned long thrt;                //  "
+};
+
 struct hist_tic {
     int id;
     int numa_node;
     int count;
     struct stat_jifs new;
     struct stat_jifs old;
+    struct stat_sysfs sysfs;           // only valued once a sysfs item is used
 #ifdef CPU_IDLE_FORCED
     unsigned long edge;                // only valued/valid with cpu summary
 #endif
@@ -168,6 +193,11 @@ struct stat_info {
     struct item_support select_items;  // items unique to select
     time_t sav_secs;                   // used by procps_stat_get to limit i/o
     struct stat_core *cores;           // linked list, also linked from hist_tic
+    int cost_yes;                      // procps_stat_cost was called
+    struct procps_cost cost;           // the counters it exposes
+    int sysfs_yes;                     // who wants STAT_TIC_CPUFREQ_CUR+ items
+    int cpufs_alloc;                   // number of below structs allocated
+    struct stat_cpufs *cpufs;          // held sysfs fds, indexed by cpu id
 };
 
 // ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -245,6 +275,13 @@ SYSsetH(SYS_DELTA_PROC_BLOCKED,   s_int,    procs_blocked)
 SYSsetH(SYS_DELTA_PROC_CREATED,   s_int,    procs_created)
 SYSsetH(SYS_DELTA_PROC_RUNNING,   s_int,    procs_running)
 
+setDECL(TIC_CPUFREQ_CUR)        { (void)S; R->result.ul_int = (T->sysfs.freqs) ? T->sysfs.cur / T->sysfs.freqs : 0; }
+setDECL(TIC_CPUFREQ_MAX)        { (void)S; R->result.ul_int = (T->sysfs.freqs) ? T->sysfs.max / T->sysfs.freqs : 0; }
+setDECL(TIC_DELTA_CPUIDLE)      { (void)S; R->result.ull_int = T->sysfs.idle; }
+setDECL(TIC_DELTA_CPUIDLE_DEEP) { (void)S; R->result.ull_int = T->sysfs.deep; }
+setDECL(TIC_THROTTLES)          { (void)S; R->result.ul_int = T->sysfs.thrt; }
+setDECL(TIC_DELTA_THROTTLES)    { (void)S; R->result.sl_int = T->sysfs.thrt_delta; }
+
 #undef setDECL
 #undef TIC_set
 #undef SYS_set
@@ -383,14 +420,23 @@ static struct {
   { RS(SYS_DELTA_PROC_BLOCKED),  QS(s_int),    TS(s_int)   },
   { RS(SYS_DELTA_PROC_CREATED),  QS(s_int),    TS(s_int)   },
   { RS(SYS_DELTA_PROC_RUNNING),  QS(s_int),    TS(s_int)   },
+
+  { RS(TIC_CPUFREQ_CUR),         QS(ul_int),   TS(ul_int)  },
+  { RS(TIC_CPUFREQ_MAX),         QS(ul_int),   TS(ul_int)  },
+  { RS(TIC_DELTA_CPUIDLE),       QS(ull_int),  TS(ull_int) },
+  { RS(TIC_DELTA_CPUIDLE_DEEP),  QS(ull_int),  TS(ull_int) },
+  { RS(TIC_THROTTLES),           QS(ul_int),   TS(ul_int)  },
+  { RS(TIC_DELTA_THROTTLES),     QS(sl_int),   TS(sl_int)  },
 };
 
     /* please note,
      * 1st enum MUST be kept in sync with highest TIC type
-     * 2nd enum MUST be 1 greater than the highest value of any enum */
+     * 2nd enum MUST be the first of those TIC types sourced from sysfs
+     * 3rd enum MUST be 1 greater than the highest value of any enum */
 #ifdef ENFORCE_LOGICAL
 enum stat_item STAT_TIC_highest = STAT_TIC_DELTA_GUEST_NICE;
 #endif
+enum stat_item STAT_TIC_sysfs = STAT_TIC_CPUFREQ_CUR;
 enum stat_item STAT_logical_end = MAXTABLE(Item_table);
 
 #undef setNAME
@@ -517,7 +563,7 @@ static int stat_cores_verify (
     FILE *fp;
 
     // be tolerant of a missing CORE_FILE ...
-    if (!(fp = fopen(CORE_FILE, "r")))
+    if (!(fp = fopen(procfs_path(CORE_FILE), "r")))
         return 1;
     for (;;) {
         if (NULL == fgets(buf, sizeof(buf), fp))
@@ -649,6 +695,168 @@ static inline int stat_items_check_failed (
 } // end: stat_items_check_failed
 
 
+static struct stat_cpufs *stat_sysfs_cpu (
+        struct stat_info *info,
+        int id)
+{
+    struct stat_cpufs *fs;
+    int i, j;
+
+    if (id >= info->cpufs_alloc) {
+        if (!(fs = realloc(info->cpufs, (id + NEWOLD_INCR) * sizeof(struct stat_cpufs))))
+            return NULL;
+        info->cost.allocs++;
+        for (i = info->cpufs_alloc; i < id + NEWOLD_INCR; i++) {
+            memset(&fs[i], 0, sizeof(struct stat_cpufs));
+            fs[i].cur_fd = fs[i].thr_fd = -1;
+            for (j = 0; j < IDLE_STATES; j++)
+                fs[i].idle_fd[j] = -1;
+        }
+        info->cpufs = fs;
+        info->cpufs_alloc = id + NEWOLD_INCR;
+    }
+    return &info->cpufs[id];
+} // end: stat_sysfs_cpu
+
+
+static inline void stat_sysfs_add (
+        struct stat_sysfs *this,
+        struct stat_sysfs *cpu)
+{
+    this->freqs += cpu->freqs;
+    this->cur += cpu->cur;
+    this->max += cpu->max;
+    this->idle += cpu->idle;
+    this->deep += cpu->deep;
+    this->thrt += cpu->thrt;
+    this->thrt_delta += cpu->thrt_delta;
+} // end: stat_sysfs_add
+
+
+static void stat_sysfs_want (
+        struct stat_info *info,
+        int want)
+{
+    int i;
+
+    // after a time without them, forget the 'last time around' values
+    if (!info->sysfs_yes) {
+        for (i = 0; i < info->cpufs_alloc; i++)
+            info->cpufs[i].primed = 0;
+    }
+    info->sysfs_yes = want;
+} // end: stat_sysfs_want
+
+
+        /*
+         * Value one of a cpu's sysfs files through its held fd, opening
+         * it first if need be.  A file found to be absent is never tried
+         * again, but one which can't be read (say that cpu went offline
+         * and then returned) is closed and given one chance to reopen. */
+static int stat_sysfs_value (
+        struct stat_info *info,
+        int *fd,
+        int id,
+        const char *file,
+        unsigned long long *value)
+{
+    char buf[sizeof(CPUS_DIR) + 64];
+    int num, tries;
+
+    for (tries = 0; tries < 2 && *fd != -2; tries++) {
+        if (*fd == -1) {
+            snprintf(buf, sizeof(buf), "%s/cpu%d/%s", CPUS_DIR, id, file);
+            if ((*fd = open(sysfs_path(buf), O_RDONLY | O_CLOEXEC)) < 0) {
+                *fd = -2;
+                break;
+            }
+            info->cost.opened++;
+        }
+        info->cost.reads++;
+        if ((num = pread(*fd, buf, sizeof(buf) - 1, 0)) > 0) {
+            buf[num] = '\0';
+            info->cost.bytes += num;
+            *value = strtoull(buf, NULL, 10);
+            return 1;
+        }
+        close(*fd);
+        *fd = -1;
+    }
+    return 0;
+} // end: stat_sysfs_value
+
+
+        /*
+         * Refresh the sysfs based items for every cpu just read from the
+         * /proc/stat file, then total them for the cpu summary.  After the
+         * first time around, only preads against held fds are involved. */
+static int stat_sysfs_read (
+        struct stat_info *info)
+{
+    struct hist_tic *sum_ptr, *cpu_ptr;
+    struct stat_cpufs *fs;
+    unsigned long long val, idle, deep;
+    char file[32];
+    int i, j, fresh;
+
+    sum_ptr = &info->cpu_hist;
+    memset(&sum_ptr->sysfs, 0, sizeof(struct stat_sysfs));
+
+    for (i = 0; i < info->cpus.hist.n_inuse; i++) {
+        cpu_ptr = info->cpus.hist.tics + i;
+        memset(&cpu_ptr->sysfs, 0, sizeof(struct stat_sysfs));
+        if (!(fs = stat_sysfs_cpu(info, cpu_ptr->id)))
+            return 1;
+
+        fresh = (fs->cur_fd == -1);
+        if (stat_sysfs_value(info, &fs->cur_fd, cpu_ptr->id, "cpufreq/scaling_cur_freq", &val)) {
+            cpu_ptr->sysfs.freqs = 1;
+            cpu_ptr->sysfs.cur = val;
+            if (fresh) {
+                int fd = -1;
+                fs->max = 0;
+                if (stat_sysfs_value(info, &fd, cpu_ptr->id, "cpufreq/cpuinfo_max_freq", &val))
+                    fs->max = val;
+                if (fd >= 0)
+                    close(fd);
+            }
+            cpu_ptr->sysfs.max = fs->max;
+        }
+
+        // the deepest state is simply the last one found to exist
+        idle = deep = 0;
+        for (j = 0; j < IDLE_STATES; j++) {
+            snprintf(file, sizeof(file), "cpuidle/state%d/time", j);
+            if (!stat_sysfs_value(info, &fs->idle_fd[j], cpu_ptr->id, file, &val))
+                break;
+            idle += val;
+            deep = val;
+        }
+        // don't distort results when cpus are brought back online
+        if (!fs->primed || idle < fs->idle || deep < fs->deep) {
+            fs->idle = idle;
+            fs->deep = deep;
+        }
+        cpu_ptr->sysfs.idle = idle - fs->idle;
+        cpu_ptr->sysfs.deep = deep - fs->deep;
+        fs->idle = idle;
+        fs->deep = deep;
+
+        if (stat_sysfs_value(info, &fs->thr_fd, cpu_ptr->id, "thermal_throttle/core_throttle_count", &val)) {
+            if (!fs->primed || val < fs->thrt)
+                fs->thrt = val;
+            cpu_ptr->sysfs.thrt = val;
+            cpu_ptr->sysfs.thrt_delta = val - fs->thrt;
+            fs->thrt = val;
+        }
+        fs->primed = 1;
+
+        stat_sysfs_add(&sum_ptr->sysfs, &cpu_ptr->sysfs);
+    }
+    return 0;
+} // end: stat_sysfs_read
+
+
 static int stat_make_numa_hist (
         struct stat_info *info)
 {
@@ -700,6 +908,8 @@ static int stat_make_numa_hist (
             nod_ptr->new.xbsy += cpu_ptr->new.xbsy;  nod_ptr->old.xbsy += cpu_ptr->old.xbsy;
             nod_ptr->new.xtot += cpu_ptr->new.xtot;  nod_ptr->old.xtot += cpu_ptr->old.xtot;
 
+            stat_sysfs_add(&nod_ptr->sysfs, &cpu_ptr->sysfs);
+
             cpu_ptr->numa_node = nod_ptr->numa_node = node;
             nod_ptr->count++;
         }
@@ -715,8 +925,12 @@ static int stat_read_failed (
     struct hist_tic *sum_ptr, *cpu_ptr;
     char *bp, *b;
     int i, rc, num, tot_read;
-    unsigned long long llnum;
+    unsigned long long llnum, began = 0;
 
+    if (info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        began = procps_cost_ns();
+    }
     if (!info->cpus.hist.n_alloc) {
         info->cpus.hist.tics = calloc(NEWOLD_INCR, sizeof(struct hist_tic));
         if (!(info->cpus.hist.tics))
@@ -725,9 +939,11 @@ static int stat_read_failed (
         info->cpus.hist.n_inuse = 0;
     }
 
-    if (!info->stat_fp
-    && (!(info->stat_fp = fopen(STAT_FILE, "r"))))
-        return 1;
+    if (!info->stat_fp) {
+        if (!(info->stat_fp = fopen(procfs_path(STAT_FILE), "r")))
+            return 1;
+        info->cost.opened++;
+    }
     fflush(info->stat_fp);
     rewind(info->stat_fp);
 
@@ -741,11 +957,13 @@ static int stat_read_failed (
     tot_read = 0;
     while ((0 < (num = fread(curPOS, 1, curSIZ, info->stat_fp)))) {
         tot_read += num;
+        info->cost.reads++;
         if (tot_read < maxSIZ)
             break;
         maxSIZ += BUFFER_INCR;
         if (!(info->stat_buf = realloc(info->stat_buf, maxSIZ)))
             return 1;
+        info->cost.allocs++;
     };
  #undef maxSIZ
  #undef curSIZ
@@ -757,6 +975,10 @@ static int stat_read_failed (
     }
     info->stat_buf[tot_read] = '\0';
     bp = info->stat_buf;
+    if (info->cost_yes) {
+        info->cost.bytes = tot_read;
+        info->cost.read_ns = procps_cost_ns() - began;
+    }
 
     sum_ptr = &info->cpu_hist;
     // remember summary from last time around
@@ -896,6 +1118,16 @@ reap_em_again:
         llnum--; //exclude itself
     info->sys_hist.new.procs_running = llnum;
 
+    if (info->sysfs_yes && stat_sysfs_read(info))
+        return 1;
+
+    if (info->cost_yes) {
+        info->cost.total_ns = procps_cost_ns() - began;
+        info->cost.parse_ns = info->cost.total_ns - info->cost.read_ns;
+        info->cost.file[PROCPS_COST_OTHER].opened = info->cost.opened;
+        info->cost.file[PROCPS_COST_OTHER].bytes = info->cost.bytes;
+        info->cost.file[PROCPS_COST_OTHER].read_ns = info->cost.read_ns;
+    }
     return 0;
 } // end: stat_read_failed
 
@@ -1013,12 +1245,25 @@ static int stat_stacks_fetch (
 
 
 static int stat_stacks_reconfig_maybe (
+        struct stat_info *info,
         struct ext_support *this,
         enum stat_item *items,
         int numitems)
 {
+    int i, bit, want;
+
     if (stat_items_check_failed(numitems, items))
         return -1;
+    /* while any of those sysfs items are requested by a reap or select |
+       (or were ever requested by a get), they'll be refreshed with each |
+       read of /proc/stat. otherwise they won't cost us anything at all. | */
+    bit = (this == &info->select) ? SYSFS_SELECT : SYSFS_REAP;
+    want = info->sysfs_yes & ~bit;
+    for (i = 0; i < numitems; i++) {
+        if (items[i] >= STAT_TIC_sysfs)
+            want |= bit;
+    }
+    stat_sysfs_want(info, want);
     /* is this the first time or have things changed since we were last called?
        if so, gotta' redo all of our stacks stuff ... */
     if (this->items->num != numitems + 1
@@ -1181,6 +1426,23 @@ PROCPS_EXPORT int procps_stat_unref (
         if ((*info)->select_items.enums)
             free((*info)->select_items.enums);
 
+        if ((*info)->cpufs) {
+            struct stat_cpufs *fs;
+            int i, j;
+            for (i = 0; i < (*info)->cpufs_alloc; i++) {
+                fs = &(*info)->cpufs[i];
+                if (fs->cur_fd >= 0)
+                    close(fs->cur_fd);
+                if (fs->thr_fd >= 0)
+                    close(fs->thr_fd);
+                for (j = 0; j < IDLE_STATES; j++) {
+                    if (fs->idle_fd[j] >= 0)
+                        close(fs->idle_fd[j]);
+                }
+            }
+            free((*info)->cpufs);
+        }
+
         if ((*info)->cores) {
             struct stat_core *next, *this = (*info)->cores;
             while (this) {
@@ -1204,6 +1466,29 @@ PROCPS_EXPORT int procps_stat_unref (
 
 // --- variable interface functions -------------------------------------------
 
+/* procps_stat_cost():
+ *
+ * Enable (on first use) the accounting of what each read of
+ * /proc/stat costs.
+ *
+ * Returns: pointer to the counters for the most recent read.
+ */
+PROCPS_EXPORT struct procps_cost *procps_stat_cost (
+        struct stat_info *info)
+{
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    errno = 0;
+
+    if (!info->cost_yes) {
+        memset(&info->cost, 0, sizeof(struct procps_cost));
+        info->cost_yes = 1;
+    }
+    return &info->cost;
+} // end: procps_stat_cost
+
+
 PROCPS_EXPORT struct stat_result *procps_stat_get (
         struct stat_info *info,
         enum stat_item item)
@@ -1217,6 +1502,12 @@ PROCPS_EXPORT struct stat_result *procps_stat_get (
         return NULL;
     errno = 0;
 
+    // the first sysfs item also forces a read, to open those files
+    if (item >= STAT_TIC_sysfs && !(info->sysfs_yes & SYSFS_GET)) {
+        stat_sysfs_want(info, info->sysfs_yes | SYSFS_GET);
+        info->sav_secs = 0;
+    }
+
     /* we will NOT read the source file with every call - rather, we'll offer
        a granularity of 1 second between reads ... */
     cur_secs = time(NULL);
@@ -1260,12 +1551,12 @@ PROCPS_EXPORT struct stat_reaped *procps_stat_reap (
 {   int i;
     // those STAT_SYS_type enum's make sense only to 'select' ...
     for (i = 0; i < numitems; i++) {
-        if (items[i] > STAT_TIC_highest)
+        if (items[i] > STAT_TIC_highest && items[i] < STAT_TIC_sysfs)
             return NULL;
     }
 }
 #endif
-    if (0 > (rc = stat_stacks_reconfig_maybe(&info->cpu_summary, items, numitems)))
+    if (0 > (rc = stat_stacks_reconfig_maybe(info, &info->cpu_summary, items, numitems)))
         return NULL;         // here, errno may be overridden with ENOMEM
     if (rc) {
         stat_extents_free_all(&info->cpus.fetch);
@@ -1325,7 +1616,7 @@ PROCPS_EXPORT struct stat_stack *procps_stat_select (
     errno = EINVAL;
     if (info == NULL || items == NULL)
         return NULL;
-    if (0 > stat_stacks_reconfig_maybe(&info->select, items, numitems))
+    if (0 > stat_stacks_reconfig_maybe(info, &info->select, items, numitems))
         return NULL;         // here, errno may be overridden with ENOMEM
     errno = 0;
 
@@ -26,19 +26,30 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <locale.h>
 #include <errno.h>
 
 #include <unistd.h>
 #include <fcntl.h>
+#include <pthread.h>
 #ifdef __CYGWIN__
 #include <sys/param.h>
 #endif
 #include "misc.h"
 #include "procps-private.h"
+#include "sysinfo.h"
 
 
 #define LOADAVG_FILE "/proc/loadavg"
+#define UPTIME_FILE  "/proc/uptime"
+#define PIDMAX_FILE  "/proc/sys/kernel/pid_max"
+
+struct sysinfo_info {
+    int refcount;
+    int loadavg_fd;                    // each of these is opened when first
+    int uptime_fd;                     // needed then simply re-read (pread)
+    int pidmax_fd;                     // with every procps_sysinfo_read
+    struct sysinfo_result results;     // what's returned by that guy
+};
 
 /* evals 'x' twice */
 #define SET_IF_DESIRED(x,y) do{  if(x) *(x) = (y); }while(0)
@@ -77,6 +88,272 @@ PROCPS_EXPORT long procps_hertz_get(void)
     return 100;
 }
 
+// ___ Sysinfo Private Functions ||||||||||||||||||||||||||||||||||||||||||||||
+
+/*
+ * Locale independent, fixed point conversions of the 'nnn[.ddd]' values
+ * found in /proc/uptime and /proc/loadavg, along with their integers.
+ * Each returns a pointer just past what was converted, or NULL.
+ */
+static const char *sysinfo_fixed (
+        const char *p,
+        double *d)
+{
+    unsigned long long whole = 0, frac = 0, scale = 1;
+
+    while (*p == ' ')
+        ++p;
+    if (*p < '0' || *p > '9')
+        return NULL;
+    while (*p >= '0' && *p <= '9')
+        whole = whole * 10 + (*p++ - '0');
+    if (*p == '.') {
+        for (++p; *p >= '0' && *p <= '9'; p++) {
+            if (scale >= 1000000000ull)
+                continue;
+            frac = frac * 10 + (*p - '0');
+            scale *= 10;
+        }
+    }
+    *d = whole + (double)frac / scale;
+    return p;
+}
+
+static const char *sysinfo_int (
+        const char *p,
+        int *i)
+{
+    double d;
+
+    if (!(p = sysinfo_fixed(p, &d)))
+        return NULL;
+    *i = d;
+    return p;
+}
+
+
+/*
+ * Read a small file from its start, opening it first if need be.
+ * Returns the length read, or -errno after closing any fd.
+ */
+static int sysinfo_pread (
+        int *fd,
+        const char *path,
+        char *buf,
+        int size)
+{
+    int n, errsv;
+
+    if (*fd < 0
+    && (*fd = open(procfs_path(path), O_RDONLY | O_CLOEXEC)) < 0)
+        return -errno;
+    if ((n = pread(*fd, buf, size - 1, 0)) < 0) {
+        errsv = errno;
+        close(*fd);
+        *fd = -1;
+        return -errsv;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+
+static int sysinfo_read_loadavg (
+        struct sysinfo_info *info)
+{
+    struct sysinfo_result *r = &info->results;
+    char buf[128];
+    const char *p;
+    int rc;
+
+    // eg. "0.19 0.27 0.26 2/1181 4327"
+    if ((rc = sysinfo_pread(&info->loadavg_fd, LOADAVG_FILE, buf, sizeof(buf))) < 0)
+        return rc;
+    r->av1 = r->av5 = r->av15 = 0;
+    if (!(p = sysinfo_fixed(buf, &r->av1))
+    || !(p = sysinfo_fixed(p, &r->av5))
+    || !(p = sysinfo_fixed(p, &r->av15)))
+        return -ERANGE;
+    // the rest is new with linux 2.6, so we'll not insist upon it
+    if (!(p = sysinfo_int(p, &r->runnable)) || *p++ != '/'
+    || !(p = sysinfo_int(p, &r->tasks))
+    || !(p = sysinfo_int(p, &r->last_pid)))
+        r->runnable = r->tasks = r->last_pid = 0;
+    return 0;
+}
+
+
+static int sysinfo_read_uptime (
+        struct sysinfo_info *info)
+{
+    struct sysinfo_result *r = &info->results;
+    char buf[128];
+    const char *p;
+    int rc;
+
+    // eg. "350735.47 234388.90"
+    if ((rc = sysinfo_pread(&info->uptime_fd, UPTIME_FILE, buf, sizeof(buf))) < 0)
+        return rc;
+    r->uptime = r->idle = 0;
+    if (!(p = sysinfo_fixed(buf, &r->uptime))
+    || !(p = sysinfo_fixed(p, &r->idle)))
+        return -ERANGE;
+    return 0;
+}
+
+
+static void sysinfo_read_pidmax (
+        struct sysinfo_info *info)
+{
+    char buf[32];
+
+    // some containers hide /proc/sys, so this one is strictly optional
+    if (sysinfo_pread(&info->pidmax_fd, PIDMAX_FILE, buf, sizeof(buf)) < 0
+    || !sysinfo_int(buf, &info->results.pid_max))
+        info->results.pid_max = 0;
+}
+
+
+static pthread_key_t sysinfo_key;
+static pthread_once_t sysinfo_once = PTHREAD_ONCE_INIT;
+
+static void sysinfo_self_free (
+        void *self)
+{
+    struct sysinfo_info *info = self;
+
+    procps_sysinfo_unref(&info);
+}
+
+
+static void sysinfo_self_key (void)
+{
+    pthread_key_create(&sysinfo_key, sysinfo_self_free);
+}
+
+
+/*
+ * The context behind procps_loadavg and procps_uptime, kept for the
+ * life of each calling thread so those files are only opened once.
+ * The key's destructor releases it (and its fds) as the thread exits,
+ * leaving no other reference to it behind.
+ */
+static struct sysinfo_info *sysinfo_self (void)
+{
+    struct sysinfo_info *self;
+
+    pthread_once(&sysinfo_once, sysinfo_self_key);
+    if (!(self = pthread_getspecific(sysinfo_key))) {
+        if (procps_sysinfo_new(&self) < 0)
+            return NULL;
+        if (pthread_setspecific(sysinfo_key, self)) {
+            procps_sysinfo_unref(&self);
+            return NULL;
+        }
+    }
+    return self;
+}
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+/*
+ * procps_sysinfo_new:
+ *
+ * Create a new container to hold the files read by procps_sysinfo_read.
+ *
+ * The initial refcount is 1, and needs to be decremented
+ * to release the resources of the structure.
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_sysinfo_new (
+        struct sysinfo_info **info)
+{
+    struct sysinfo_info *p;
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct sysinfo_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    p->loadavg_fd = p->uptime_fd = p->pidmax_fd = -1;
+
+    *info = p;
+    return 0;
+} // end: procps_sysinfo_new
+
+
+PROCPS_EXPORT int procps_sysinfo_ref (
+        struct sysinfo_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_sysinfo_ref
+
+
+PROCPS_EXPORT int procps_sysinfo_unref (
+        struct sysinfo_info **info)
+{
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        if ((*info)->loadavg_fd >= 0)
+            close((*info)->loadavg_fd);
+        if ((*info)->uptime_fd >= 0)
+            close((*info)->uptime_fd);
+        if ((*info)->pidmax_fd >= 0)
+            close((*info)->pidmax_fd);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_sysinfo_unref
+
+
+/*
+ * procps_sysinfo_read:
+ *
+ * Re-read /proc/uptime, /proc/loadavg and /proc/sys/kernel/pid_max
+ * through those descriptors held open by this context.
+ *
+ * Returns: pointer to a sysinfo_result struct on success
+ *          NULL on error, with the reason found in errno
+ */
+PROCPS_EXPORT struct sysinfo_result *procps_sysinfo_read (
+        struct sysinfo_info *info)
+{
+    int rc;
+
+    errno = EINVAL;
+    if (info == NULL)
+        return NULL;
+    errno = 0;
+
+    if ((rc = sysinfo_read_uptime(info)) < 0
+    || (rc = sysinfo_read_loadavg(info)) < 0) {
+        errno = -rc;
+        return NULL;
+    }
+    sysinfo_read_pidmax(info);
+    return &info->results;
+} // end: procps_sysinfo_read
+
+
 /*
  * procps_loadavg:
  * @av1: location to store 1 minute load average
@@ -92,30 +369,104 @@ PROCPS_EXPORT int procps_loadavg(
         double *restrict av5,
         double *restrict av15)
 {
-    double avg_1=0, avg_5=0, avg_15=0;
-    locale_t tmplocale;
-    int retval=0;
-    FILE *fp;
+    struct sysinfo_info *self;
+    int retval;
 
-    if ((fp = fopen(LOADAVG_FILE, "r")) == NULL)
-        return -errno;
+    if (!(self = sysinfo_self()))
+        return -ENOMEM;
+    retval = sysinfo_read_loadavg(self);
+    if (retval == -ERANGE || retval == 0) {
+        SET_IF_DESIRED(av1,  self->results.av1);
+        SET_IF_DESIRED(av5,  self->results.av5);
+        SET_IF_DESIRED(av15, self->results.av15);
+    }
+    return retval;
+}
+
+/*
+ * sysinfo_uptime
+ *
+ * The guts of procps_uptime (see uptime.c).
+ */
+int sysinfo_uptime(
+        double *restrict uptime_secs,
+        double *restrict idle_secs)
+{
+    struct sysinfo_info *self;
+    int retval;
 
-    tmplocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
-    uselocale(tmplocale);
-    if (fscanf(fp, "%lf %lf %lf", &avg_1, &avg_5, &avg_15) < 3)
-        retval = -ERANGE;
-
-    fclose(fp);
-    uselocale(LC_GLOBAL_LOCALE);
-    freelocale(tmplocale);
-    SET_IF_DESIRED(av1,  avg_1);
-    SET_IF_DESIRED(av5,  avg_5);
-    SET_IF_DESIRED(av15, avg_15);
+    if (!(self = sysinfo_self()))
+        return -ENOMEM;
+    retval = sysinfo_read_uptime(self);
+    if (retval == -ERANGE || retval == 0) {
+        SET_IF_DESIRED(uptime_secs, self->results.uptime);
+        SET_IF_DESIRED(idle_secs,   self->results.idle);
+    }
     return retval;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
+/*
+ * procfs_root
+ *
+ * Return the directory serving as "/proc", which can be redirected
+ * (as to a synthetic tree for benchmarks) with LIBPROC_PROC_ROOT.
+ */
+const char *procfs_root(void)
+{
+    static __thread const char *root;
+
+    if (!root) {
+        root = getenv("LIBPROC_PROC_ROOT");
+        if (!root || !*root || strlen(root) >= PROCROOTLEN)
+            root = "/proc";
+    }
+    return root;
+}
+
+/*
+ * procfs_path
+ *
+ * Return a "/proc/..." path as relocated under any procfs_root.
+ * Any relocated result is only valid until the next call.
+ */
+const char *procfs_path(const char *path)
+{
+    static __thread char buf[PROCROOTLEN + 64];
+    const char *root = procfs_root();
+
+    if (!strcmp(root, "/proc") || strncmp(path, "/proc", 5))
+        return path;
+    snprintf(buf, sizeof(buf), "%s%s", root, path + 5);
+    return buf;
+}
+
+/*
+ * sysfs_path
+ *
+ * Return a "/sys/..." path as relocated under any LIBPROC_SYS_ROOT,
+ * the sysfs counterpart to procfs_path.
+ * Any relocated result is only valid until the next call.
+ */
+const char *sysfs_path(const char *path)
+{
+    static __thread const char *root;
+    static __thread char buf[PROCROOTLEN + 128];
+
+    if (!root) {
+        root = getenv("LIBPROC_SYS_ROOT");
+        if (!root || !*root || strlen(root) >= PROCROOTLEN)
+            root = "/sys";
+    }
+    if (!strcmp(root, "/sys") || strncmp(path, "/sys", 4))
+        return path;
+    snprintf(buf, sizeof(buf), "%s%s", root, path + 4);
+    return buf;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 #define PROCFS_PID_MAX "/proc/sys/kernel/pid_max"
 #define DEFAULT_PID_LENGTH 5
 
@@ -137,7 +488,7 @@ PROCPS_EXPORT unsigned int procps_pid_length(void)
         return pid_length;
 
     pid_length = DEFAULT_PID_LENGTH;
-    if ((fp = fopen(PROCFS_PID_MAX, "r")) != NULL) {
+    if ((fp = fopen(procfs_path(PROCFS_PID_MAX), "r")) != NULL) {
         if (fgets(pidbuf, sizeof(pidbuf), fp) != NULL) {
             pid_length = strlen(pidbuf);
             if (pidbuf[pid_length-1] == '\n')
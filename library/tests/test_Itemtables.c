@@ -20,11 +20,14 @@
 #include <stdlib.h>
 
 #include "diskstats.h"
+#include "irq.h"
 #include "meminfo.h"
+#include "netdev.h"
 #include "pids.h"
 #include "slabinfo.h"
 #include "stat.h"
 #include "vmstat.h"
+#include "zones.h"
 
 #include "tests.h"
 
@@ -36,6 +39,14 @@ static int check_diskstats (void *data) {
     return 1;
 }
 
+static int check_irq (void *data) {
+    struct irq_info *ctx = NULL;
+    testname = "Itemtable check, irq";
+    if (0 == procps_irq_new(&ctx))
+        procps_irq_unref(&ctx);
+    return 1;
+}
+
 static int check_meminfo (void *data) {
     struct meminfo_info *ctx = NULL;
     testname = "Itemtable check, meminfo";
@@ -44,6 +55,14 @@ static int check_meminfo (void *data) {
     return 1;
 }
 
+static int check_netdev (void *data) {
+    struct netdev_info *ctx = NULL;
+    testname = "Itemtable check, netdev";
+    if (0 == procps_netdev_new(&ctx))
+        procps_netdev_unref(&ctx);
+    return 1;
+}
+
 static int check_pids (void *data) {
     struct pids_info *ctx = NULL;
     testname = "Itemtable check, pids";
@@ -76,13 +95,24 @@ static int check_vmstat (void *data) {
     return 1;
 }
 
+static int check_zones (void *data) {
+    struct zones_info *ctx = NULL;
+    testname = "Itemtable check, zones";
+    if (0 == procps_zones_new(&ctx))
+        procps_zones_unref(&ctx);
+    return 1;
+}
+
 static TestFunction test_funcs[] = {
     check_diskstats,
+    check_irq,
     check_meminfo,
+    check_netdev,
     check_pids,
     check_slabinfo,
     check_stat,
     check_vmstat,
+    check_zones,
     NULL
 };
 
@@ -16,6 +16,7 @@
  * License along with this library; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
+#include <locale.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -114,9 +115,13 @@ int check_esc_ctl(void *data)
         { "\x80\xbf\x41 I", "??A I"} // wrong continuation bytes
     };
 
+    struct esc_meta meta;
+
     testname = "esc_ctl()";
     for (i=0; i < MAXTBL(test_strs); i++) {
-        esc_ctl(test_strs[i][0],strlen(test_strs[i][0]));
+        meta.cols = 0;
+        meta.ascii = 1;
+        esc_ctl(test_strs[i][0],strlen(test_strs[i][0]), &meta);
         //printf("Is: \"%s\"==\"%s\"\n", test_strs[i][0], test_strs[i][1]);
         if (strcmp(test_strs[i][0], test_strs[i][1]) != 0) {
             // Leaks memory but process will exit
@@ -127,11 +132,47 @@ int check_esc_ctl(void *data)
     return 1;
 };
 
+/*
+ * While escaping, the screen columns and any non-ascii bytes are noted
+ */
+int check_esc_meta(void *data)
+{
+    int i, utf8;
+    struct esc_meta meta;
+    char buf[20];
+
+    // input, expected columns (if the locale knows the widths), ascii
+    struct { const char *str; int cols; int ascii; } test_strs[] = {
+        { "", 0, 1 },
+        { "plain", 5, 1 },
+        { "\x7f B", 3, 1 },                        // DEL, now a '?'
+        { "\x90\x20\x70 D", 5, 1 },                // C1 controls, now a '?'
+        { "\xe2\x82\xac C", 3, 0 },                // Euro symbol
+        { "\xF0\x9F\x98\x8A E", 4, 0 },            // smilie, double wide
+    };
+
+    testname = "escape: check esc_ctl() meta";
+    utf8 = (NULL != setlocale(LC_CTYPE, "C.UTF-8"));
+    for (i=0; i < MAXTBL(test_strs); i++) {
+        snprintf(buf, sizeof(buf), "%s", test_strs[i].str);
+        meta.cols = 0;
+        meta.ascii = 1;
+        esc_ctl((unsigned char *)buf, strlen(buf), &meta);
+        if (meta.ascii != test_strs[i].ascii
+        || (meta.ascii && meta.cols != (int)strlen(buf))
+        || (utf8 && meta.cols != test_strs[i].cols))
+            return 0;
+    }
+    setlocale(LC_CTYPE, "C");
+    return 1;
+}
+
 TestFunction test_funcs[] = {
     check_size_ascii,
     check_size_strlen,
     check_size_negative,
     check_esc_ctl,
+    check_esc_meta,
     NULL
 };
 
@@ -0,0 +1,235 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for irq library calls
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "tests.h"
+
+/*
+ * These tests reap a synthetic /proc/interrupts and /proc/softirqs
+ * fixture, where cpu 1 is offline and so has no column.
+ */
+
+enum irq_item items[] = {
+    IRQ_NAME, IRQ_TYPE, IRQ_DESCRIPTION, IRQ_TOTAL, IRQ_CPUS,
+    IRQ_DELTA_TOTAL, IRQ_DELTA_CPUS, IRQ_DELTA_CPU_HOT };
+enum rel_items { EU_NAME, EU_TYPE, EU_DESC, EU_TOT, EU_CPUS, EU_DTOT, EU_DCPUS, EU_HOT };
+#define NUMITEMS  (int)(sizeof(items) / sizeof(items[0]))
+
+#define HEADER  "           CPU0       CPU2       CPU3       \n"
+
+struct row {
+    const char *name;
+    unsigned long cpu0, cpu2, cpu3;
+    const char *desc;
+};
+
+static int put_irqs (const char *file, const char *header, const struct row *rows, int n)
+{
+    FILE *fp;
+    int i;
+
+    if (!(fp = fixture_open(file)))
+        return 0;
+    fputs(header, fp);
+    for (i = 0; i < n; i++)
+        fprintf(fp, "%4s: %10lu %10lu %10lu   %s\n"
+            , rows[i].name, rows[i].cpu0, rows[i].cpu2, rows[i].cpu3, rows[i].desc);
+    return (0 == fclose(fp));
+}
+
+// these rows have but a single count, and no per-cpu values at all
+static int put_hard (const struct row *rows, int n, unsigned long err, unsigned long mis)
+{
+    FILE *fp;
+
+    if (!put_irqs("interrupts", HEADER, rows, n)
+    || !(fp = fopen(fixture_path("interrupts"), "a")))
+        return 0;
+    fprintf(fp, "ERR: %10lu\nMIS: %10lu\n", err, mis);
+    return (0 == fclose(fp));
+}
+
+static struct irq_stack *find_irq (struct irq_reaped *r, const char *name, int type)
+{
+    int i;
+
+    for (i = 0; i < r->total; i++)
+        if (!strcmp(IRQ_VAL(EU_NAME, str, r->stacks[i]), name)
+        && IRQ_VAL(EU_TYPE, s_int, r->stacks[i]) == type)
+            return r->stacks[i];
+    return NULL;
+}
+
+int check_irq_new (void *data)
+{
+    struct irq_info *info = NULL;
+    struct row rows[] = { { "0", 5, 0, 7, "IO-APIC   2-edge      timer" } };
+    testname = "procps_irq_new()";
+
+    if (!put_hard(rows, 1, 0, 0)
+    || procps_irq_new(&info) < 0)
+        return 0;
+    return (procps_irq_unref(&info) == 0 && info == NULL);
+}
+
+int check_irq_offline_cpus (void *data)
+{
+    struct irq_info *info = NULL;
+    struct irq_reaped *r;
+    struct irq_stack *s;
+    unsigned long *cpus, *delta;
+    struct row rows[] = { { "0", 5, 0, 7, "IO-APIC   2-edge      timer" } };
+    testname = "procps_irq_reap() columns for cpus 0, 2 and 3 (1 offline)";
+
+    if (!put_hard(rows, 1, 0, 0)
+    || procps_irq_new(&info) < 0
+    || procps_irq_cpus(info) != 4)
+        return 0;
+    rows[0].cpu2 = 4;
+    rows[0].cpu3 = 17;
+    if (!put_hard(rows, 1, 0, 0)
+    || !(r = procps_irq_reap(info, items, NUMITEMS))
+    || !(s = find_irq(r, "0", IRQ_TYPE_HARD)))
+        return 0;
+    cpus = IRQ_VAL(EU_CPUS, ul_cpus, s);
+    delta = IRQ_VAL(EU_DCPUS, ul_cpus, s);
+    // the description has its spacing collapsed
+    return (cpus[0] == 5 && cpus[1] == 0 && cpus[2] == 4 && cpus[3] == 17
+        && delta[1] == 0 && delta[2] == 4 && delta[3] == 10
+        && IRQ_VAL(EU_TOT, ul_int, s) == 26
+        && IRQ_VAL(EU_DTOT, s_int, s) == 14
+        && IRQ_VAL(EU_HOT, s_int, s) == 3
+        && !strcmp(IRQ_VAL(EU_DESC, str, s), "IO-APIC 2-edge timer")
+        && procps_irq_unref(&info) == 0);
+}
+
+int check_irq_err_mis (void *data)
+{
+    struct irq_info *info = NULL;
+    struct irq_reaped *r;
+    struct irq_stack *err, *mis;
+    unsigned long *cpus;
+    struct row rows[] = { { "0", 5, 0, 7, "IO-APIC   2-edge      timer" } };
+    testname = "procps_irq_reap() ERR and MIS, a lone count";
+
+    if (!put_hard(rows, 1, 3, 0)
+    || procps_irq_new(&info) < 0)
+        return 0;
+    if (!put_hard(rows, 1, 8, 0)
+    || !(r = procps_irq_reap(info, items, NUMITEMS))
+    || r->total != 3
+    || !(err = find_irq(r, "ERR", IRQ_TYPE_HARD))
+    || !(mis = find_irq(r, "MIS", IRQ_TYPE_HARD)))
+        return 0;
+    cpus = IRQ_VAL(EU_CPUS, ul_cpus, err);
+    return (IRQ_VAL(EU_TOT, ul_int, err) == 8
+        && IRQ_VAL(EU_DTOT, s_int, err) == 5
+        && !cpus[0] && !cpus[2] && !cpus[3]
+        && IRQ_VAL(EU_HOT, s_int, err) == -1
+        && IRQ_VAL(EU_TOT, ul_int, mis) == 0
+        && IRQ_VAL(EU_DTOT, s_int, mis) == 0
+        && procps_irq_unref(&info) == 0);
+}
+
+int check_irq_softirqs (void *data)
+{
+    struct irq_info *info = NULL;
+    struct irq_reaped *r;
+    struct irq_stack *s;
+    struct row hard[] = { { "0", 5, 0, 7, "IO-APIC   2-edge      timer" } };
+    struct row soft[] = { { "HI", 1, 0, 0, "" }, { "TIMER", 100, 200, 300, "" } };
+    testname = "procps_irq_reap() softirqs, listed after the hard irqs";
+
+    if (!put_hard(hard, 1, 0, 0)
+    || !put_irqs("softirqs", "         " HEADER, soft, 2)
+    || procps_irq_new(&info) < 0)
+        return 0;
+    soft[1].cpu2 = 260;
+    if (!put_irqs("softirqs", "         " HEADER, soft, 2)
+    || !(r = procps_irq_reap(info, items, NUMITEMS))
+    || r->total != 5
+    || IRQ_VAL(EU_TYPE, s_int, r->stacks[0]) != IRQ_TYPE_HARD
+    || !(s = find_irq(r, "TIMER", IRQ_TYPE_SOFT))
+    || r->stacks[4] != s)
+        return 0;
+    return (IRQ_VAL(EU_TOT, ul_int, s) == 660
+        && IRQ_VAL(EU_DTOT, s_int, s) == 60
+        && IRQ_VAL(EU_HOT, s_int, s) == 2
+        && IRQ_GET(info, "TIMER", IRQ_TYPE, s_int) == IRQ_TYPE_SOFT
+        && procps_irq_unref(&info) == 0);
+}
+
+int check_irq_vanished (void *data)
+{
+    struct irq_info *info = NULL;
+    struct irq_reaped *r;
+    struct irq_stack *s;
+    struct row rows[] = {
+        { "0", 5, 0, 7, "IO-APIC   2-edge      timer" },
+        { "24", 1000, 2000, 3000, "PCI-MSI 524288-edge nvme0q0" } };
+    testname = "procps_irq_reap() an irq freed, then requested anew";
+
+    // without any softirqs, since that file is optional
+    if (remove(fixture_path("softirqs"))
+    || !put_hard(rows, 2, 0, 0)
+    || procps_irq_new(&info) < 0)
+        return 0;
+    // freed between reaps, so it's gone
+    if (!put_hard(rows, 1, 0, 0)
+    || !(r = procps_irq_reap(info, items, NUMITEMS))
+    || r->total != 3
+    || find_irq(r, "24", IRQ_TYPE_HARD))
+        return 0;
+    // and when back, with counts restarted, it has no history
+    rows[1].cpu0 = 3;
+    rows[1].cpu2 = rows[1].cpu3 = 0;
+    if (!put_hard(rows, 2, 0, 0)
+    || !(r = procps_irq_reap(info, items, NUMITEMS))
+    || r->total != 4
+    || !(s = find_irq(r, "24", IRQ_TYPE_HARD)))
+        return 0;
+    return (IRQ_VAL(EU_TOT, ul_int, s) == 3
+        && IRQ_VAL(EU_DTOT, s_int, s) == 0
+        && IRQ_VAL(EU_HOT, s_int, s) == -1
+        && procps_irq_unref(&info) == 0);
+}
+
+TestFunction test_funcs[] = {
+    check_irq_new,
+    check_irq_offline_cpus,
+    check_irq_err_mis,
+    check_irq_softirqs,
+    check_irq_vanished,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    int rc;
+
+    if (!fixture_root()) {
+        perror("fixture");
+        return EXIT_FAILURE;
+    }
+    rc = run_tests(test_funcs, NULL);
+    fixture_cleanup();
+    return rc;
+}
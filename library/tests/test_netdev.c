@@ -0,0 +1,217 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for netdev library calls
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "netdev.h"
+#include "tests.h"
+
+/*
+ * These tests reap a synthetic /proc/net/dev plus /sys/class/net fixture,
+ * with no network at all.
+ */
+
+enum netdev_item items[] = {
+    NETDEV_NAME, NETDEV_RX_BYTES, NETDEV_DELTA_RX_BYTES,
+    NETDEV_DELTA_TX_PACKETS, NETDEV_RX_CRC_ERRORS };
+enum rel_items { EU_NAME, EU_RXB, EU_DRXB, EU_DTXP, EU_CRC };
+
+struct dev {
+    const char *name;
+    unsigned long rx_bytes, tx_packets;
+};
+
+static int put_dev (const struct dev *devs, int n)
+{
+    FILE *fp;
+    int i;
+
+    if (!(fp = fixture_open("net/dev")))
+        return 0;
+    fputs("Inter-|   Receive                                                |  Transmit\n"
+          " face |bytes    packets errs drop fifo frame compressed multicast|"
+          "bytes    packets errs drop fifo colls carrier compressed\n", fp);
+    for (i = 0; i < n; i++)
+        fprintf(fp, "%6s: %7lu %7lu    0    0    0     0          0         0 "
+            "%8lu %7lu    0    0    0     0       0          0\n"
+            , devs[i].name, devs[i].rx_bytes, devs[i].rx_bytes / 100
+            , devs[i].rx_bytes, devs[i].tx_packets);
+    return (0 == fclose(fp));
+}
+
+static int put_sys (const char *name, const char *file, unsigned long value)
+{
+    char path[128];
+
+    snprintf(path, sizeof(path), "sys/class/net/%s/%s", name, file);
+    return fixture_put(path, "%lu\n", value);
+}
+
+static struct netdev_stack *find_dev (struct netdev_reaped *r, const char *name)
+{
+    int i;
+
+    for (i = 0; i < r->total; i++)
+        if (!strcmp(NETDEV_VAL(EU_NAME, str, r->stacks[i]), name))
+            return r->stacks[i];
+    return NULL;
+}
+
+static int check_deltas (struct netdev_reaped *r, const char *name, unsigned long rxb, unsigned long txp)
+{
+    struct netdev_stack *s;
+
+    if (!(s = find_dev(r, name)))
+        return 0;
+    return (NETDEV_VAL(EU_DRXB, ul_int, s) == rxb
+        && NETDEV_VAL(EU_DTXP, ul_int, s) == txp);
+}
+
+int check_netdev_new (void *data)
+{
+    struct netdev_info *info = NULL;
+    struct dev devs[] = { { "lo", 1000, 10 } };
+    testname = "procps_netdev_new()";
+
+    if (!put_dev(devs, 1)
+    || procps_netdev_new(&info) < 0)
+        return 0;
+    return (procps_netdev_unref(&info) == 0 && info == NULL);
+}
+
+int check_netdev_deltas (void *data)
+{
+    struct netdev_info *info = NULL;
+    struct netdev_reaped *r;
+    struct dev devs[] = { { "lo", 1000, 10 }, { "eth0", 50000, 300 } };
+    testname = "procps_netdev_reap() deltas, one counter reset";
+
+    if (!put_dev(devs, 2)
+    || procps_netdev_new(&info) < 0)
+        return 0;
+    devs[0].rx_bytes = 1500;  devs[0].tx_packets = 12;
+    devs[1].rx_bytes = 20;    devs[1].tx_packets = 305;
+    if (!put_dev(devs, 2)
+    || !(r = procps_netdev_reap(info, items, 4))
+    || r->total != 2)
+        return 0;
+    // a counter which went backwards (a driver reset) is no activity
+    return (check_deltas(r, "lo", 500, 2)
+        && check_deltas(r, "eth0", 0, 5)
+        && NETDEV_VAL(EU_RXB, ul_int, find_dev(r, "eth0")) == 20
+        && procps_netdev_unref(&info) == 0);
+}
+
+int check_netdev_add_remove (void *data)
+{
+    struct netdev_info *info = NULL;
+    struct netdev_reaped *r;
+    struct dev devs[] = { { "lo", 1000, 10 }, { "veth1", 7000, 70 } };
+    testname = "procps_netdev_reap() interfaces added and removed";
+
+    if (!put_dev(devs, 1)
+    || procps_netdev_new(&info) < 0)
+        return 0;
+    devs[1].rx_bytes = 9000;
+    // the new one has no history, so no deltas
+    if (!put_dev(devs, 2)
+    || !(r = procps_netdev_reap(info, items, 4))
+    || r->total != 2
+    || !check_deltas(r, "veth1", 0, 0))
+        return 0;
+    // and now the old one vanishes
+    devs[1].rx_bytes = 9100;
+    if (!put_dev(&devs[1], 1)
+    || !(r = procps_netdev_reap(info, items, 4))
+    || r->total != 1)
+        return 0;
+    return (check_deltas(r, "veth1", 100, 0)
+        && !find_dev(r, "lo")
+        && procps_netdev_unref(&info) == 0);
+}
+
+int check_netdev_rename (void *data)
+{
+    struct netdev_info *info = NULL;
+    struct netdev_reaped *r;
+    struct dev devs[] = { { "eth1", 40000, 400 } };
+    testname = "procps_netdev_reap() interface renamed, same ifindex";
+
+    if (!put_sys("eth1", "ifindex", 7)
+    || !put_sys("wan0", "ifindex", 7)
+    || !put_dev(devs, 1)
+    || procps_netdev_new(&info) < 0)
+        return 0;
+    devs[0].name = "wan0";
+    devs[0].rx_bytes = 40800;
+    devs[0].tx_packets = 401;
+    if (!put_dev(devs, 1)
+    || !(r = procps_netdev_reap(info, items, 4))
+    || r->total != 1)
+        return 0;
+    return (check_deltas(r, "wan0", 800, 1)
+        && NETDEV_GET(info, "wan0", NETDEV_IFINDEX, s_int) == 7
+        && procps_netdev_unref(&info) == 0);
+}
+
+int check_netdev_sysfs (void *data)
+{
+    struct netdev_info *info = NULL;
+    struct netdev_reaped *r;
+    struct dev devs[] = { { "eth2", 100, 1 }, { "tun0", 100, 1 } };
+    testname = "procps_netdev_reap() sysfs statistics, held open";
+
+    if (!put_sys("eth2", "statistics/rx_crc_errors", 3)
+    || !put_dev(devs, 2)
+    || procps_netdev_new(&info) < 0
+    || !(r = procps_netdev_reap(info, items, 5))
+    || NETDEV_VAL(EU_CRC, ul_int, find_dev(r, "eth2")) != 3
+    || NETDEV_VAL(EU_CRC, ul_int, find_dev(r, "tun0")) != 0)
+        return 0;
+    // rewritten in place, as the kernel would, since it's held open
+    if (!put_sys("eth2", "statistics/rx_crc_errors", 5)
+    || !(r = procps_netdev_reap(info, items, 5)))
+        return 0;
+    return (NETDEV_VAL(EU_CRC, ul_int, find_dev(r, "eth2")) == 5
+        && procps_netdev_unref(&info) == 0);
+}
+
+TestFunction test_funcs[] = {
+    check_netdev_new,
+    check_netdev_deltas,
+    check_netdev_add_remove,
+    check_netdev_rename,
+    check_netdev_sysfs,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    int rc;
+
+    if (!fixture_root()
+    || !fixture_mkdir("net")
+    || !fixture_mkdir("sys/class/net")) {
+        perror("fixture");
+        return EXIT_FAILURE;
+    }
+    rc = run_tests(test_funcs, NULL);
+    fixture_cleanup();
+    return rc;
+}
@@ -19,12 +19,18 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
 
+#include "misc.h"
 #include "pids.h"
 #include "tests.h"
 
 enum pids_item items[] = { PIDS_ID_PID, PIDS_ID_PID };
 enum pids_item items2[] = { PIDS_ID_PID, PIDS_VM_RSS };
+enum pids_item items3[] = { PIDS_ID_PID, PIDS_CMD, PIDS_EXE };
+enum pids_item items4[] = { PIDS_ID_PID, PIDS_SMAP_RSS, PIDS_EXE };
 
 int check_pids_new_nullinfo(void *data)
 {
@@ -60,11 +66,141 @@ int check_fatal_proc_unmounted(void *data)
 	    ( PIDS_VAL(1, ul_int, stack) > 0));
 }
 
+int check_pids_cost(void *data)
+{
+    struct pids_info *info = NULL;
+    struct procps_cost *cost;
+    struct pids_fetch *fetch;
+    testname = "procps_pids_cost counts a reap";
+
+    return ( (procps_pids_cost(NULL) == NULL) &&
+             (procps_pids_new(&info, items2, 2) == 0) &&
+             ( (cost = procps_pids_cost(info)) != NULL) &&
+             ( (fetch = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)) != NULL) &&
+             (cost->file[PROCPS_COST_STATUS].opened >= (unsigned long)fetch->counts->total) &&
+             (cost->opened >= cost->file[PROCPS_COST_STATUS].opened) &&
+             (cost->bytes > 0) &&
+             (cost->total_ns >= cost->read_ns + cost->parse_ns) &&
+             (procps_pids_unref(&info) == 0));
+}
+
+int check_pids_str_cols(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_stack *stack;
+    int ascii;
+    testname = "procps_pids_str_cols knows escaped strings only";
+
+    // our own command name is plain ascii, while a pid is no string at all
+    return ( (procps_pids_new(&info, items3, 3) == 0) &&
+             ( (stack = fatal_proc_unmounted(info, 1)) != NULL) &&
+             (procps_pids_str_cols(stack, 0, &ascii) == -1) && !ascii &&
+             (procps_pids_str_cols(stack, 1, &ascii) == (int)strlen(PIDS_VAL(1, str, stack))) &&
+             ascii &&
+             (procps_pids_str_cols(stack, 2, NULL) > 0) &&
+             (procps_pids_str_cols(NULL, 1, &ascii) == -1) &&
+             (procps_pids_unref(&info) == 0));
+}
+
+static int sorted_by_rss(struct pids_stack **stacks, int num)
+{
+    int i;
+
+    for (i = 1; i < num; i++)
+        if (PIDS_VAL(1, ul_int, stacks[i - 1]) < PIDS_VAL(1, ul_int, stacks[i]))
+            return 0;
+    return 1;
+}
+
+int check_pids_sort_hinted(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_sort_hint *hint = NULL;
+    struct pids_fetch *fetch;
+    struct procps_cost *cost;
+    unsigned long first;
+    int i, num;
+    testname = "procps_pids_sort_hinted resorts with fewer compares";
+
+    if (procps_pids_new(&info, items2, 2) < 0
+    || !(cost = procps_pids_cost(info))
+    || !(fetch = procps_pids_reap(info, PIDS_FETCH_THREADS_TOO))
+    || (num = fetch->counts->total) < 2
+    || !procps_pids_sort_hinted(info, &hint, fetch->stacks, num, PIDS_VM_RSS, PIDS_SORT_DESCEND)
+    || !hint || !sorted_by_rss(fetch->stacks, num))
+        return 0;
+    first = cost->compares;
+    // a few tasks now change places, as they might by the next refresh
+    for (i = 0; i < num; i += 31)
+        PIDS_VAL(1, ul_int, fetch->stacks[i]) += (i & 1) ? 1000 : -PIDS_VAL(1, ul_int, fetch->stacks[i]);
+    // the stacks arrive in a different order, as they would from a reap
+    for (i = 0; i < num / 2; i++) {
+        struct pids_stack *swap = fetch->stacks[i];
+        fetch->stacks[i] = fetch->stacks[num - 1 - i];
+        fetch->stacks[num - 1 - i] = swap;
+    }
+    if (!procps_pids_sort_hinted(info, &hint, fetch->stacks, num, PIDS_VM_RSS, PIDS_SORT_DESCEND)
+    || !sorted_by_rss(fetch->stacks, num))
+        return 0;
+    return ( (num < 64 || cost->compares - first < first) &&
+             (procps_pids_sort_hinted(info, NULL, fetch->stacks, num, PIDS_VM_RSS, PIDS_SORT_DESCEND) == NULL) &&
+             (procps_pids_unref(&info) == 0));
+}
+
+static struct pids_stack *reap_self(struct pids_info *info)
+{
+    struct pids_fetch *fetch;
+    int i;
+
+    if (!(fetch = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)))
+        return NULL;
+    for (i = 0; i < fetch->counts->total; i++)
+        if (PIDS_VAL(0, s_int, fetch->stacks[i]) == getpid())
+            return fetch->stacks[i];
+    return NULL;
+}
+
+int check_pids_max_age(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_stack *stack;
+    unsigned long rss;
+    char exe[PATH_MAX];
+    testname = "procps_pids_max_age retains results, procps_pids_age tells";
+
+    if (procps_pids_new(&info, items4, 3) < 0
+    || procps_pids_max_age(info, PIDS_ID_PID, 1) != -EINVAL
+    || procps_pids_max_age(NULL, PIDS_EXE, 1) != -EINVAL
+    || procps_pids_max_age(info, PIDS_SMAP_RSS, 60) != 0
+    || procps_pids_max_age(info, PIDS_EXE, -1) != 0
+    || !(stack = reap_self(info))
+    || procps_pids_age(stack, 1) != 0 || procps_pids_age(stack, 2) != 0)
+        return 0;
+    rss = PIDS_VAL(1, ul_int, stack);
+    snprintf(exe, sizeof(exe), "%s", PIDS_VAL(2, str, stack));
+    usleep(50000);
+    // the values are kept, even should this process have grown meanwhile
+    if (!(stack = reap_self(info))
+    || procps_pids_age(stack, 0) != 0
+    || procps_pids_age(stack, 1) < 0.03 || procps_pids_age(stack, 2) < 0.03
+    || PIDS_VAL(1, ul_int, stack) != rss || strcmp(PIDS_VAL(2, str, stack), exe))
+        return 0;
+    // while a zero age always reads anew
+    return ( (procps_pids_max_age(info, PIDS_SMAP_PSS, 0) == 0) &&
+             ( (stack = reap_self(info)) != NULL) &&
+             (procps_pids_age(stack, 1) == 0) && (procps_pids_age(stack, 2) > 0) &&
+             (procps_pids_unref(&info) == 0));
+}
+
 TestFunction test_funcs[] = {
     check_pids_new_nullinfo,
     // skipped, ask Jim check_pids_new_toomany,
     check_pids_new_and_unref,
     check_fatal_proc_unmounted,
+    check_pids_cost,
+    check_pids_str_cols,
+    check_pids_sort_hinted,
+    check_pids_max_age,
     NULL };
 
 int main(int argc, char *argv[])
@@ -0,0 +1,161 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for pids library allocations in the steady state
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "misc.h"
+#include "pids.h"
+#include "tests.h"
+
+#define ITERATIONS 10
+
+enum pids_item items[] = {
+    PIDS_ID_PID, PIDS_ID_EUSER, PIDS_STATE, PIDS_TICS_ALL_DELTA, PIDS_MEM_RES,
+    PIDS_TTY_NAME, PIDS_CMD, PIDS_CMDLINE, PIDS_CMDLINE_V, PIDS_ENVIRON_V,
+    PIDS_CGROUP_V };
+
+#ifdef __GLIBC__
+/*
+ * Every malloc, calloc and realloc (including those made within libc itself
+ * on the library's behalf, as with opendir or strdup) is counted while the
+ * 'counting' switch is on.
+ */
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static int counting, allocs;
+
+void *malloc (size_t size) {
+    if (counting) ++allocs;
+    return __libc_malloc(size);
+}
+
+void *calloc (size_t nmemb, size_t size) {
+    if (counting) ++allocs;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc (void *ptr, size_t size) {
+    if (counting) ++allocs;
+    return __libc_realloc(ptr, size);
+}
+
+static struct pids_info *alloc_new (void)
+{
+    struct pids_info *info = NULL;
+
+    // only with a slab can a caller's 'str' results avoid allocations
+    setenv("LIBPROC_STRING_SLAB", "1", 1);
+    if (procps_pids_new(&info, items, sizeof(items) / sizeof(items[0])) < 0)
+        return NULL;
+    return info;
+}
+
+int check_pids_select_allocs(void *data)
+{
+    static char name[256];
+    struct pids_info *info;
+    unsigned pid = getpid();
+    int i, worst = 0;
+
+    testname = "procps_pids_select() steady state allocations";
+    if (!(info = alloc_new()))
+        return 0;
+    for (i = 0; i < ITERATIONS; i++) {
+        allocs = 0;
+        counting = 1;
+        if (!procps_pids_select(info, &pid, 1, PIDS_SELECT_PID)) {
+            counting = 0;
+            return 0;
+        }
+        counting = 0;
+        // the first two iterations are allowed to warm up
+        if (i > 1 && allocs > worst)
+            worst = allocs;
+    }
+    snprintf(name, sizeof(name)
+        , "procps_pids_select() steady state allocations, %d after warm-up", worst);
+    testname = name;
+    return (worst == 0 && procps_pids_unref(&info) == 0);
+}
+
+/*
+ * Since the live task set might change between any two reaps, only those
+ * iterations which find exactly the tasks found by the one prior count.
+ */
+int check_pids_reap_allocs(void *data)
+{
+    static char name[256];
+    struct pids_info *info;
+    struct pids_fetch *f;
+    unsigned long sig, prev_sig = 0;
+    int i, j, worst = 0, stable = 0;
+
+    testname = "procps_pids_reap() steady state allocations";
+    if (!(info = alloc_new()))
+        return 0;
+    for (i = 0; i < ITERATIONS; i++) {
+        allocs = 0;
+        counting = 1;
+        if (!(f = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY))) {
+            counting = 0;
+            return 0;
+        }
+        counting = 0;
+        sig = f->counts->total;
+        for (j = 0; j < f->counts->total; j++)
+            sig = sig * 31 + PIDS_VAL(0, s_int, f->stacks[j]);
+        if (i > 1 && sig == prev_sig) {
+            if (allocs > worst)
+                worst = allocs;
+            ++stable;
+        }
+        prev_sig = sig;
+    }
+    snprintf(name, sizeof(name)
+        , "procps_pids_reap() steady state allocations, %d after warm-up (%d of %d compared)"
+        , worst, stable, ITERATIONS - 2);
+    testname = name;
+    return (worst == 0 && procps_pids_unref(&info) == 0);
+}
+#else
+int check_pids_select_allocs(void *data)
+{
+    testname = "procps_pids_select() steady state allocations (skipped, needs glibc)";
+    return 1;
+}
+
+int check_pids_reap_allocs(void *data)
+{
+    testname = "procps_pids_reap() steady state allocations (skipped, needs glibc)";
+    return 1;
+}
+#endif
+
+TestFunction test_funcs[] = {
+    check_pids_select_allocs,
+    check_pids_reap_allocs,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    return run_tests(test_funcs, NULL);
+}
@@ -0,0 +1,187 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for pids library history (the DELTA items)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "misc.h"
+#include "pids.h"
+#include "tests.h"
+
+/*
+ * These tests reap a synthetic /proc fixture where only a stat file
+ * exists for each task. Between reaps, a pid is 'reused' simply
+ * by giving it a new start_time along with smaller counts.
+ */
+
+#define STORM 6000                     // beyond the initial history & hash
+
+enum pids_item items[] = {
+    PIDS_ID_PID, PIDS_TICS_ALL_DELTA, PIDS_FLT_MAJ_DELTA, PIDS_FLT_MIN_DELTA };
+enum rel_items { EU_PID, EU_TICS, EU_MAJ, EU_MIN };
+
+static int put_stat (int pid, unsigned long start, unsigned long tics, unsigned long flts)
+{
+    char name[32];
+
+    snprintf(name, sizeof(name), "%d/stat", pid);
+    // utime and stime split the tics, majflt gets a tenth of the faults
+    return fixture_put(name, "%d (hist) S 1 %d %d 0 -1 4194560 %lu 0 %lu 0 %lu %lu 0 0 "
+        "20 0 1 0 %lu 1000000 100 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 "
+        "17 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+        , pid, pid, pid, flts, flts / 10, tics / 2, tics - tics / 2, start);
+}
+
+static void del_stat (int pid)
+{
+    char name[32];
+
+    snprintf(name, sizeof(name), "%d/stat", pid);
+    unlink(fixture_path(name));
+    snprintf(name, sizeof(name), "%d", pid);
+    rmdir(fixture_path(name));
+}
+
+static struct pids_stack *find_pid (struct pids_fetch *f, int pid)
+{
+    int i;
+
+    for (i = 0; i < f->counts->total; i++)
+        if (PIDS_VAL(EU_PID, s_int, f->stacks[i]) == pid)
+            return f->stacks[i];
+    return NULL;
+}
+
+static int check_deltas (struct pids_fetch *f, int pid, unsigned tics, int maj, int min)
+{
+    struct pids_stack *s;
+
+    if (!(s = find_pid(f, pid)))
+        return 0;
+    return (PIDS_VAL(EU_TICS, u_int, s) == tics
+        && PIDS_VAL(EU_MAJ, s_int, s) == maj
+        && PIDS_VAL(EU_MIN, s_int, s) == min);
+}
+
+int check_hist_same_task(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *f;
+    testname = "procps_pids_reap() history, same pid and start time";
+
+    if (!put_stat(100, 5000, 500, 1000)
+    || procps_pids_new(&info, items, 4) < 0
+    || !procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)
+    || !put_stat(100, 5000, 600, 1200)
+    || !(f = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)))
+        return 0;
+    del_stat(100);
+    return (check_deltas(f, 100, 100, 20, 200)
+        && procps_pids_unref(&info) == 0);
+}
+
+int check_hist_pid_reused(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *f;
+    testname = "procps_pids_reap() history, pid reused with new start time";
+
+    if (!put_stat(100, 5000, 500, 1000)
+    || procps_pids_new(&info, items, 4) < 0
+    || !procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)
+    || !put_stat(100, 9000, 7, 50)
+    || !(f = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)))
+        return 0;
+    del_stat(100);
+    // a new task, so no underflow: all its tics are new and no fault deltas
+    return (check_deltas(f, 100, 7, 0, 0)
+        && procps_pids_unref(&info) == 0);
+}
+
+int check_hist_fork_storm(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *f;
+    int pid, ok = 1;
+    testname = "procps_pids_reap() history, fork storm with reused pids";
+
+    // a modest first frame ...
+    for (pid = 200; pid < 300; pid++)
+        if (!put_stat(pid, 1000, 1000, 1000))
+            return 0;
+    if (procps_pids_new(&info, items, 4) < 0
+    || !procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY))
+        return 0;
+    // ... then a storm, where the odd pids of that first frame are reused
+    for (pid = 200; pid < 200 + STORM; pid++) {
+        if (pid < 300 && !(pid & 1))
+            ok = put_stat(pid, 1000, 1100, 1100);
+        else
+            ok = put_stat(pid, 2000, 3, 10);
+        if (!ok)
+            return 0;
+    }
+    if (!(f = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY))
+    || f->counts->total != STORM)
+        return 0;
+    for (pid = 200; ok && pid < 200 + STORM; pid++) {
+        if (pid < 300 && !(pid & 1))
+            ok = check_deltas(f, pid, 100, 10, 100);
+        else
+            ok = check_deltas(f, pid, 3, 0, 0);
+    }
+    if (!ok)
+        return 0;
+    // and after the history has grown, one more frame with everybody known
+    for (pid = 200; pid < 200 + STORM; pid += 7)
+        if (!put_stat(pid, pid < 300 && !(pid & 1) ? 1000 : 2000, 1200, 1200))
+            return 0;
+    if (!(f = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)))
+        return 0;
+    for (pid = 200; ok && pid < 200 + STORM; pid++) {
+        if (pid % 7 == 200 % 7)
+            ok = (pid < 300 && !(pid & 1))
+                ? check_deltas(f, pid, 100, 10, 100)
+                : check_deltas(f, pid, 1197, 119, 1190);
+        else
+            ok = check_deltas(f, pid, 0, 0, 0);
+    }
+    for (pid = 200; pid < 200 + STORM; pid++)
+        del_stat(pid);
+    return (ok && procps_pids_unref(&info) == 0);
+}
+
+TestFunction test_funcs[] = {
+    check_hist_same_task,
+    check_hist_pid_reused,
+    check_hist_fork_storm,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    int rc;
+
+    if (!fixture_root()) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    rc = run_tests(test_funcs, NULL);
+    fixture_cleanup();
+    return rc;
+}
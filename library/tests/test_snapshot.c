@@ -0,0 +1,198 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for snapshot library calls
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "misc.h"
+#include "snapshot.h"
+#include "tests.h"
+
+#define SAMPLES  20
+#define SPINNERS 2
+
+enum pids_item pids_items[] = { PIDS_ID_PID, PIDS_TIME_START, PIDS_TIME_ELAPSED };
+enum stat_item stat_items[] = { STAT_TIC_ID, STAT_TIC_DELTA_USER };
+enum meminfo_item mem_items[] = { MEMINFO_MEM_FREE };
+
+static struct snapshot_info *snap_all (void)
+{
+    struct snapshot_info *snap = NULL;
+    struct pids_info *pids = NULL;
+    struct stat_info *stat = NULL;
+    struct meminfo_info *mem = NULL;
+
+    if (procps_snapshot_new(&snap) < 0
+    || procps_pids_new(&pids, pids_items, 3) < 0
+    || procps_stat_new(&stat) < 0
+    || procps_meminfo_new(&mem) < 0
+    || procps_snapshot_add_pids(snap, pids, PIDS_FETCH_TASKS_ONLY) < 0
+    || procps_snapshot_add_stat(snap, stat, STAT_REAP_CPUS_ONLY, stat_items, 2) < 0
+    || procps_snapshot_add_meminfo(snap, mem, mem_items, 1) < 0)
+        return NULL;
+    // the snapshot now holds the only references we need
+    procps_pids_unref(&pids);
+    procps_stat_unref(&stat);
+    procps_meminfo_unref(&mem);
+    return snap;
+}
+
+int check_snapshot_new_nullinfo(void *data)
+{
+    testname = "procps_snapshot_new() info=NULL returns -EINVAL";
+    return (procps_snapshot_new(NULL) == -EINVAL);
+}
+
+int check_snapshot_take_empty(void *data)
+{
+    struct snapshot_info *snap = NULL;
+    testname = "procps_snapshot_take() with no modules returns NULL";
+
+    return ( (procps_snapshot_new(&snap) == 0) &&
+             (procps_snapshot_take(snap) == NULL) &&
+             (errno == EINVAL) &&
+             (procps_snapshot_unref(&snap) == 0) &&
+             snap == NULL);
+}
+
+int check_snapshot_take(void *data)
+{
+    struct snapshot_info *snap;
+    struct snapshot_result *r;
+    double first;
+    testname = "procps_snapshot_take() samples every module";
+
+    if (!(snap = snap_all())
+    || !(r = procps_snapshot_take(snap))
+    || !r->pids || !r->stat || !r->meminfo
+    || r->elapsed != 0 || r->boottime <= 0)
+        return 0;
+    first = r->boottime;
+    usleep(20000);
+    if (!(r = procps_snapshot_take(snap))
+    || r->boottime <= first
+    || fabs(r->elapsed - (r->boottime - first)) > 1e-9
+    || r->elapsed < 0.02)
+        return 0;
+    return (procps_snapshot_unref(&snap) == 0);
+}
+
+int check_snapshot_drop(void *data)
+{
+    struct snapshot_info *snap;
+    struct snapshot_result *r;
+    testname = "procps_snapshot_add_meminfo() NULL drops that module";
+
+    if (!(snap = snap_all())
+    || procps_snapshot_add_meminfo(snap, NULL, NULL, 0) < 0
+    || !(r = procps_snapshot_take(snap))
+    || r->meminfo || !r->stat || !r->pids)
+        return 0;
+    // and with every module dropped, there's nothing left to take
+    if (procps_snapshot_add_stat(snap, NULL, 0, NULL, 0) < 0
+    || procps_snapshot_add_pids(snap, NULL, 0) < 0
+    || procps_snapshot_take(snap) != NULL || errno != EINVAL)
+        return 0;
+    return (procps_snapshot_unref(&snap) == 0);
+}
+
+int check_snapshot_boottime(void *data)
+{
+    struct snapshot_info *snap;
+    struct snapshot_result *r;
+    struct pids_stack *s;
+    int i;
+    testname = "procps_snapshot_take() pids share its boottime";
+
+    if (!(snap = snap_all())
+    || !(r = procps_snapshot_take(snap)))
+        return 0;
+    // TIME_ELAPSED must agree with that one timestamp (within a tic)
+    for (i = 0; i < r->pids->counts->total; i++) {
+        s = r->pids->stacks[i];
+        if (fabs(PIDS_VAL(2, real, s) - (r->boottime - PIDS_VAL(1, real, s)))
+        > 1.0 / procps_hertz_get() + 1e-6)
+            return 0;
+    }
+    return (procps_snapshot_unref(&snap) == 0);
+}
+
+/*
+ * Quantify how far apart the module reads land while the system is busy.
+ * Each snapshot shares a single timestamp, so the skew is the most that
+ * any module's actual sample time can differ from it.
+ */
+int check_snapshot_jitter(void *data)
+{
+    static char name[256];
+    struct snapshot_info *snap;
+    struct snapshot_result *r;
+    pid_t kids[SPINNERS];
+    double max = 0, sum = 0;
+    int i, ok = 1;
+
+    testname = "procps_snapshot_take() jitter under load";
+    for (i = 0; i < SPINNERS; i++) {
+        if (0 == (kids[i] = fork()))
+            for (;;) ;
+        if (kids[i] < 0)
+            return 0;
+    }
+    if (!(snap = snap_all()))
+        ok = 0;
+    for (i = 0; ok && i < SAMPLES; i++) {
+        if (!(r = procps_snapshot_take(snap))) {
+            ok = 0;
+            break;
+        }
+        if (r->skew > max) max = r->skew;
+        sum += r->skew;
+        usleep(10000);
+    }
+    for (i = 0; i < SPINNERS; i++) {
+        kill(kids[i], SIGKILL);
+        waitpid(kids[i], NULL, 0);
+    }
+    if (!ok)
+        return 0;
+    snprintf(name, sizeof(name)
+        , "procps_snapshot_take() jitter under load, skew mean %.3f / max %.3f ms"
+        , sum / SAMPLES * 1000.0, max * 1000.0);
+    testname = name;
+    // however loaded, reading everything should never approach a second
+    return (max < 1.0 && procps_snapshot_unref(&snap) == 0);
+}
+
+TestFunction test_funcs[] = {
+    check_snapshot_new_nullinfo,
+    check_snapshot_take_empty,
+    check_snapshot_take,
+    check_snapshot_drop,
+    check_snapshot_boottime,
+    check_snapshot_jitter,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    return run_tests(test_funcs, NULL);
+}
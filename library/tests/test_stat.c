@@ -0,0 +1,138 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for stat library calls
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "misc.h"
+#include "stat.h"
+#include "tests.h"
+
+/*
+ * These tests reap a synthetic /proc/stat fixture plus the per-cpu
+ * cpufreq, cpuidle and thermal_throttle files under its /sys.
+ */
+
+enum stat_item items[] = {
+    STAT_TIC_ID, STAT_TIC_CPUFREQ_CUR, STAT_TIC_CPUFREQ_MAX,
+    STAT_TIC_DELTA_CPUIDLE, STAT_TIC_DELTA_CPUIDLE_DEEP,
+    STAT_TIC_THROTTLES, STAT_TIC_DELTA_THROTTLES };
+enum rel_items {
+    EU_ID, EU_CUR, EU_MAX,
+    EU_IDLE, EU_DEEP,
+    EU_THRT, EU_THRTD };
+
+static int put_file (const char *name, unsigned long value)
+{
+    return fixture_put(name, "%lu\n", value);
+}
+
+static int put_cpus (unsigned long step)
+{
+    if (!fixture_put("stat", "cpu  %lu 0 %lu %lu 0 0 0 0 0 0\n"
+                             "cpu0 %lu 0 %lu %lu 0 0 0 0 0 0\n"
+                             "cpu1 %lu 0 %lu %lu 0 0 0 0 0 0\n"
+                             "intr 1\nctxt 2\nbtime 3\nprocesses 4\n"
+                             "procs_running 1\nprocs_blocked 0\n"
+        , 2 * step, 2 * step, 2 * step, step, step, step, step, step, step))
+        return 0;
+    // cpu0 has it all, cpu1 a frequency only
+    return (put_file("sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", 800000 + step)
+        && put_file("sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", 3500000)
+        && put_file("sys/devices/system/cpu/cpu0/cpuidle/state0/time", 10 * step)
+        && put_file("sys/devices/system/cpu/cpu0/cpuidle/state1/time", 100 * step)
+        && put_file("sys/devices/system/cpu/cpu0/thermal_throttle/core_throttle_count", step)
+        && put_file("sys/devices/system/cpu/cpu1/cpufreq/scaling_cur_freq", 3400000 + step)
+        && put_file("sys/devices/system/cpu/cpu1/cpufreq/cpuinfo_max_freq", 3500000));
+}
+
+int check_stat_sysfs (void *data)
+{
+    struct stat_info *info = NULL;
+    struct stat_reaped *r;
+    struct stat_stack *c0, *c1;
+    testname = "procps_stat_reap() cpufreq, cpuidle and throttles";
+
+    if (!put_cpus(1000)
+    || procps_stat_new(&info) < 0
+    || !procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 7)
+    || !put_cpus(3000)
+    || !(r = procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 7))
+    || r->cpus->total != 2)
+        return 0;
+    c0 = r->cpus->stacks[0];
+    c1 = r->cpus->stacks[1];
+    if (STAT_VAL(EU_CUR, ul_int, c0) != 803000
+    || STAT_VAL(EU_MAX, ul_int, c0) != 3500000
+    || STAT_VAL(EU_IDLE, ull_int, c0) != 2000 * 110
+    || STAT_VAL(EU_DEEP, ull_int, c0) != 2000 * 100
+    || STAT_VAL(EU_THRT, ul_int, c0) != 3000
+    || STAT_VAL(EU_THRTD, sl_int, c0) != 2000
+    || STAT_VAL(EU_CUR, ul_int, c1) != 3403000
+    || STAT_VAL(EU_IDLE, ull_int, c1) != 0
+    || STAT_VAL(EU_THRTD, sl_int, c1) != 0)
+        return 0;
+    // the summary averages frequencies, but totals everything else
+    return (STAT_VAL(EU_CUR, ul_int, r->summary) == (803000 + 3403000) / 2
+        && STAT_VAL(EU_IDLE, ull_int, r->summary) == 2000 * 110
+        && STAT_VAL(EU_THRT, ul_int, r->summary) == 3000
+        && procps_stat_unref(&info) == 0);
+}
+
+int check_stat_sysfs_held (void *data)
+{
+    struct stat_info *info = NULL;
+    struct procps_cost *cost;
+    testname = "procps_stat_reap() sysfs refresh, no opens, then none";
+
+    if (!put_cpus(1000)
+    || procps_stat_new(&info) < 0
+    || !(cost = procps_stat_cost(info))
+    || !procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 7)
+    || cost->opened != 5 + 2)
+        return 0;
+    // a pread each for cpu0's freq, 2 states & throttles, and cpu1's freq
+    if (!put_cpus(2000)
+    || !procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 7)
+    || cost->opened != 0
+    || cost->reads != 1 + 5)
+        return 0;
+    // without any of those items, it's back to just the /proc/stat read
+    return (procps_stat_reap(info, STAT_REAP_CPUS_ONLY, items, 1)
+        && cost->reads == 1
+        && STAT_GET(info, STAT_TIC_CPUFREQ_CUR, ul_int) == (802000 + 3402000) / 2
+        && procps_stat_unref(&info) == 0);
+}
+
+TestFunction test_funcs[] = {
+    check_stat_sysfs,
+    check_stat_sysfs_held,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    int rc;
+
+    if (!fixture_root()) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    rc = run_tests(test_funcs, NULL);
+    fixture_cleanup();
+    return rc;
+}
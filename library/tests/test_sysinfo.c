@@ -18,8 +18,13 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <errno.h>
+#include <math.h>
+#include <dirent.h>
+#include <pthread.h>
 
 #include "misc.h"
+#include "sysinfo.h"
 #include "tests.h"
 
 int check_hertz(void *data)
@@ -49,10 +54,113 @@ int check_loadavg_null(void *data)
     return 0;
 }
 
+int check_sysinfo_new_nullinfo(void *data)
+{
+    testname = "procps_sysinfo_new() info=NULL returns -EINVAL";
+    return (procps_sysinfo_new(NULL) == -EINVAL);
+}
+
+int check_sysinfo_read(void *data)
+{
+    struct sysinfo_info *info = NULL;
+    struct sysinfo_result *r;
+    double a, b, c, up;
+    int run, tot, last;
+    FILE *fp;
+    testname = "procps_sysinfo_read() agrees with /proc";
+
+    if (procps_sysinfo_new(&info) < 0
+    || !(r = procps_sysinfo_read(info)))
+        return 0;
+    if (!(fp = fopen("/proc/loadavg", "r")))
+        return 0;
+    if (fscanf(fp, "%lf %lf %lf %d/%d %d", &a, &b, &c, &run, &tot, &last) < 6)
+        return 0;
+    fclose(fp);
+    if (!(fp = fopen("/proc/uptime", "r")))
+        return 0;
+    if (fscanf(fp, "%lf", &up) < 1)
+        return 0;
+    fclose(fp);
+    // the load averages change only every 5 seconds
+    if (fabs(r->av1 - a) > 0.5 || fabs(r->av5 - b) > 0.5 || fabs(r->av15 - c) > 0.5)
+        return 0;
+    if (r->tasks < 1 || r->runnable < 0 || r->runnable > r->tasks || r->last_pid < 1)
+        return 0;
+    if (r->pid_max && r->pid_max < r->last_pid)
+        return 0;
+    if (up < r->uptime || up - r->uptime > 1.0)
+        return 0;
+    return (procps_sysinfo_unref(&info) == 0 && info == NULL);
+}
+
+static int count_fds(void)
+{
+    DIR *dir;
+    int n = 0;
+
+    if (!(dir = opendir("/proc/self/fd")))
+        return -1;
+    while (readdir(dir))
+        n++;
+    closedir(dir);
+    return n;
+}
+
+int check_sysinfo_persistent(void *data)
+{
+    struct sysinfo_info *info = NULL;
+    struct sysinfo_result *r;
+    double prev = 0;
+    int i, fds;
+    testname = "procps_sysinfo_read() re-reads the same files";
+
+    if (procps_sysinfo_new(&info) < 0
+    || !procps_sysinfo_read(info))
+        return 0;
+    fds = count_fds();
+    for (i = 0; i < 100; i++) {
+        if (!(r = procps_sysinfo_read(info)) || r->uptime < prev)
+            return 0;
+        prev = r->uptime;
+    }
+    if (count_fds() != fds)
+        return 0;
+    // and the files are closed with the context
+    return (procps_sysinfo_unref(&info) == 0 && count_fds() < fds);
+}
+
+static void *loadavg_thread(void *arg)
+{
+    double a;
+
+    return (procps_loadavg(&a, NULL, NULL) == 0) ? arg : NULL;
+}
+
+int check_loadavg_threads(void *data)
+{
+    pthread_t tid;
+    int i, fds;
+    testname = "procps_loadavg() releases each thread's files";
+
+    fds = count_fds();
+    for (i = 0; i < 50; i++) {
+        void *ok = NULL;
+        if (pthread_create(&tid, NULL, loadavg_thread, &i)
+        || pthread_join(tid, &ok) || !ok)
+            return 0;
+    }
+    return (count_fds() == fds);
+}
+
 TestFunction test_funcs[] = {
     check_hertz,
     check_loadavg,
     check_loadavg_null,
+    check_sysinfo_new_nullinfo,
+    check_sysinfo_read,
+    check_sysinfo_persistent,
+    check_loadavg_threads,
     NULL,
 };
 
@@ -0,0 +1,230 @@
+/*
+ * libprocps - Library to read proc filesystem
+ * Tests for zones library calls
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "zones.h"
+#include "tests.h"
+
+/*
+ * These tests reap a synthetic /proc/zoneinfo, buddyinfo and pagetypeinfo
+ * fixture, plus a thp size under its /sys.
+ */
+
+enum zones_item items[] = {
+    ZONES_NODE, ZONES_NAME, ZONES_PAGES_FREE, ZONES_DISTANCE_LOW,
+    ZONES_LARGEST_ORDER, ZONES_FRAG_INDEX_COSTLY, ZONES_UNUSABLE_COSTLY,
+    ZONES_FRAG_INDEX_HUGE, ZONES_UNUSABLE_HUGE, ZONES_FREE_MOVABLE };
+enum rel_items {
+    EU_NODE, EU_NAME, EU_FREE, EU_DLOW,
+    EU_LARGE, EU_FRAGC, EU_UNUSC,
+    EU_FRAGH, EU_UNUSH, EU_MOVABLE };
+
+struct zone {
+    int node;
+    const char *name;
+    unsigned long free, low, present;
+    const char *blocks;
+};
+
+static struct zone zones[] = {
+    { 0, "DMA32",   3000,   100, 4000, "0 0 0 0 0 0 0 0 0 1 1" },
+    { 0, "Normal",  2048,   900, 8000, "512 0 0 0 0 0 0 0 0 1 1" },
+    { 0, "Movable",    0,    32,    0, NULL },
+    { 1, "Normal",   200,   300, 8000, "100 50 0 0 0 0 0 0 0 0 0" },
+    { 1, "HighMem",    0,    10, 1000, "0 0 0 0 0 0 0 0 0 0 0" },
+};
+
+static int put_zones (int n)
+{
+    FILE *zi, *bi;
+    int i, node = -1;
+
+    if (!(zi = fixture_open("zoneinfo"))
+    || !(bi = fixture_open("buddyinfo")))
+        return 0;
+    for (i = 0; i < n; i++) {
+        const struct zone *z = &zones[i];
+
+        fprintf(zi, "Node %d, zone %8s\n", z->node, z->name);
+        // the first zone of every node is preceded by per-node stats
+        if (z->node != node)
+            fprintf(zi, "  per-node stats\n      nr_inactive_anon 44333\n"
+                        "      nr_active_anon 5\n");
+        node = z->node;
+        fprintf(zi, "  pages free     %lu\n        boost    0\n"
+                    "        min      %lu\n        low      %lu\n"
+                    "        high     %lu\n        spanned  %lu\n"
+                    "        present  %lu\n        managed  %lu\n"
+                    "        protection: (0, 0, 0, 0, 0)\n"
+                    "      nr_free_pages %lu\n"
+            , z->free, z->low / 2, z->low, z->low * 2
+            , z->present, z->present, z->present, z->free);
+        // then the pagesets, with a deceptive "high" or two
+        if (z->present)
+            fprintf(zi, "  pagesets\n    cpu: 0\n              count:    1\n"
+                        "              high:     999999\n    cpu: 1\n"
+                        "              high:     999999\n"
+                        "  vm stats threshold: 12\n  start_pfn:           4096\n");
+        if (z->blocks)
+            fprintf(bi, "Node %d, zone %8s %s \n", z->node, z->name, z->blocks);
+    }
+    return (0 == fclose(zi) && 0 == fclose(bi));
+}
+
+static int put_types (void)
+{
+    FILE *fp;
+    int i;
+
+    if (!(fp = fixture_open("pagetypeinfo")))
+        return 0;
+    fputs("Page block order: 9\nPages per block:  512\n\n"
+          "Free pages count per migrate type at order       0      1      2\n", fp);
+    for (i = 0; i < (int)(sizeof(zones) / sizeof(zones[0])); i++) {
+        if (!zones[i].blocks)
+            continue;
+        // node 1 has more free than the kernel will count
+        fprintf(fp, "Node %4d, zone %8s, type    Unmovable      1      0      0\n"
+                    "Node %4d, zone %8s, type      Movable %6s      2      1\n"
+            , zones[i].node, zones[i].name, zones[i].node, zones[i].name
+            , zones[i].node ? ">100000" : "3");
+    }
+    // the blocks table which follows mustn't be mistaken for free pages
+    fputs("\nNumber of blocks type     Unmovable      Movable\n"
+          "Node 0, zone    DMA32            7           99\n", fp);
+    return (0 == fclose(fp));
+}
+
+static int near (double a, double b)
+{
+    return (a - b) < 0.0001 && (b - a) < 0.0001;
+}
+
+int check_zones_reap (void *data)
+{
+    struct zones_info *info = NULL;
+    struct zones_reaped *r;
+    testname = "procps_zones_reap() zones, watermarks, no empty zones";
+
+    if (!put_zones(4)
+    || procps_zones_new(&info) < 0
+    || !(r = procps_zones_reap(info, items, 4))
+    || r->total != 3)
+        return 0;
+    return (ZONES_VAL(EU_NODE, s_int, r->stacks[2]) == 1
+        && !strcmp(ZONES_VAL(EU_NAME, str, r->stacks[1]), "Normal")
+        && ZONES_VAL(EU_FREE, ul_int, r->stacks[0]) == 3000
+        && ZONES_VAL(EU_DLOW, sl_int, r->stacks[0]) == 2900
+        && ZONES_VAL(EU_DLOW, sl_int, r->stacks[2]) == -100
+        && ZONES_GET(info, 0, "Normal", ZONES_PAGES_HIGH, ul_int) == 1800
+        && procps_zones_unref(&info) == 0);
+}
+
+int check_zones_fragmentation (void *data)
+{
+    struct zones_info *info = NULL;
+    struct zones_reaped *r;
+    testname = "procps_zones_reap() fragmentation indexes";
+
+    if (!put_zones(5)
+    || procps_zones_new(&info) < 0
+    || procps_zones_huge_order(info) != 9
+    || !(r = procps_zones_reap(info, items, 9)))
+        return 0;
+    // 512 pages of order 0, 1536 in order 9 blocks: 1/4 unusable for thp
+    if (ZONES_VAL(EU_LARGE, s_int, r->stacks[1]) != 10
+    || !near(ZONES_VAL(EU_FRAGH, real, r->stacks[1]), -1)
+    || !near(ZONES_VAL(EU_UNUSH, real, r->stacks[1]), 0.25))
+        return 0;
+    // 200 pages in 150 blocks, none of order 3: 1 - (1 + 200/8) / 150
+    return (ZONES_VAL(EU_LARGE, s_int, r->stacks[2]) == 1
+        && near(ZONES_VAL(EU_FRAGC, real, r->stacks[2]), 1 - 26.0 / 150)
+        && near(ZONES_VAL(EU_UNUSC, real, r->stacks[2]), 1)
+        // and with nothing free, nothing's fragmented but it's all unusable
+        && near(ZONES_VAL(EU_FRAGH, real, r->stacks[3]), 0)
+        && near(ZONES_VAL(EU_UNUSH, real, r->stacks[3]), 1)
+        && procps_zones_unref(&info) == 0);
+}
+
+int check_zones_pagetypeinfo (void *data)
+{
+    struct zones_info *info = NULL;
+    struct zones_reaped *r;
+    testname = "procps_zones_reap() pagetypeinfo, then unreadable";
+
+    if (!put_zones(4)
+    || !put_types()
+    || procps_zones_new(&info) < 0
+    || !(r = procps_zones_reap(info, items, 10))
+    || ZONES_VAL(EU_MOVABLE, ul_int, r->stacks[0]) != 3 + 2 * 2 + 1 * 4
+    || ZONES_VAL(EU_MOVABLE, ul_int, r->stacks[1]) != 11
+    || ZONES_VAL(EU_MOVABLE, ul_int, r->stacks[2]) != 100000 + 2 * 2 + 1 * 4
+    || procps_zones_unref(&info) != 0)
+        return 0;
+    // root only with newer kernels, which must not be an error
+    if (remove(fixture_path("pagetypeinfo")) != 0
+    || procps_zones_new(&info) < 0
+    || !(r = procps_zones_reap(info, items, 10)))
+        return 0;
+    return (ZONES_VAL(EU_MOVABLE, ul_int, r->stacks[0]) == 0
+        && procps_zones_unref(&info) == 0);
+}
+
+int check_zones_offline (void *data)
+{
+    struct zones_info *info = NULL;
+    struct zones_reaped *r;
+    testname = "procps_zones_reap() a node taken offline";
+
+    if (!put_zones(4)
+    || procps_zones_new(&info) < 0
+    || !put_zones(3)
+    || !(r = procps_zones_reap(info, items, 4))
+    || r->total != 2)
+        return 0;
+    return (!procps_zones_get(info, 1, "Normal", ZONES_PAGES_FREE)
+        && errno == ENXIO
+        && procps_zones_unref(&info) == 0);
+}
+
+TestFunction test_funcs[] = {
+    check_zones_reap,
+    check_zones_fragmentation,
+    check_zones_pagetypeinfo,
+    check_zones_offline,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    int rc;
+
+    if (!fixture_root()
+    || !fixture_put("sys/kernel/mm/transparent_hugepage/hpage_pmd_size"
+        , "%ld\n", 512L * getpagesize())) {
+        perror("fixture");
+        return EXIT_FAILURE;
+    }
+    rc = run_tests(test_funcs, NULL);
+    fixture_cleanup();
+    return rc;
+}
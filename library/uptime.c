@@ -24,7 +24,6 @@
  */
 
 #include <errno.h>
-#include <locale.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -44,8 +43,6 @@
 #include "procps-private.h"
 #include "pids.h"
 
-#define UPTIME_FILE "/proc/uptime"
-
 #define UPTIME_BUFLEN 256
 static __thread char upbuf[UPTIME_BUFLEN];
 static __thread char shortbuf[UPTIME_BUFLEN];
@@ -116,7 +113,8 @@ PROCPS_EXPORT int procps_users(void)
  *
  * Find the uptime and idle time of the system.
  * These numbers are found in /proc/uptime
- * Unlike other procps functions this closes the file each time
+ * Unlike most procps functions, that file is kept open (per thread)
+ * and simply re-read with each call (see sysinfo.c)
  * Either uptime_secs or idle_secs can be null
  *
  * Returns: 0 on success and <0 on failure
@@ -125,29 +123,7 @@ PROCPS_EXPORT int procps_uptime(
         double *restrict uptime_secs,
         double *restrict idle_secs)
 {
-    double up=0, idle=0;
-    locale_t tmplocale;
-    FILE *fp;
-    int rc;
-
-    if ((fp = fopen(UPTIME_FILE, "r")) == NULL)
-        return -errno;
-
-    tmplocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
-    uselocale(tmplocale);
-    rc = fscanf(fp, "%lf %lf", &up, &idle);
-    fclose(fp);
-    uselocale(LC_GLOBAL_LOCALE);
-    freelocale(tmplocale);
-
-    if (uptime_secs)
-        *uptime_secs = up;
-    if (idle_secs)
-        *idle_secs = idle;
-
-    if (rc < 2)
-        return -ERANGE;
-    return 0;
+    return sysinfo_uptime(uptime_secs, idle_secs);
 }
 
 /*
@@ -1172,7 +1172,7 @@ static int vmstat_read_failed (
 
 #ifndef __CYGWIN__ /* /proc/vmstat does not exist */
     if (-1 == info->vmstat_fd
-    && (-1 == (info->vmstat_fd = open(VMSTAT_FILE, O_RDONLY))))
+    && (-1 == (info->vmstat_fd = open(procfs_path(VMSTAT_FILE), O_RDONLY))))
         return 1;
 
     if (lseek(info->vmstat_fd, 0L, SEEK_SET) == -1)
@@ -25,17 +25,19 @@
 #include <unistd.h>
 #include <sys/stat.h>
 
+#include "procps-private.h"
 #include "wchan.h"  // to verify prototype
 
 
 const char *lookup_wchan (int pid) {
    static __thread char buf[64];
+   char path[PROCROOTLEN + 32];
    const char *ret = buf;
    ssize_t num;
    int fd;
 
-   snprintf(buf, sizeof buf, "/proc/%d/wchan", pid);
-   fd = open(buf, O_RDONLY);
+   snprintf(path, sizeof path, "%s/%d/wchan", procfs_root(), pid);
+   fd = open(path, O_RDONLY);
    if (fd==-1) return "?";
 
    num = read(fd, buf, sizeof buf - 1);
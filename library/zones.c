@@ -0,0 +1,1307 @@
+/*
+ * zones.c - memory zone and fragmentation related definitions for libproc2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "procps-private.h"
+#include "zones.h"
+
+#define ZONES_ZONE_FILE     "/proc/zoneinfo"
+#define ZONES_BUDDY_FILE    "/proc/buddyinfo"
+#define ZONES_TYPE_FILE     "/proc/pagetypeinfo"
+#define ZONES_HUGE_FILE     "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"
+#define ZONES_NAME_LEN      15
+#define ZONES_ORDERS        16           // more than any kernel's NR_PAGE_ORDERS
+#define ZONES_COSTLY_ORDER  3            // the kernel's PAGE_ALLOC_COSTLY_ORDER
+#define ZONES_HUGE_ORDER    9            // absent thp, that of 2M with 4K pages
+
+#define BUFFER_INCR         65536        // amount the file buffer grows
+#define NODES_INCR          16           // amount the nodes array grows
+#define STACKS_INCR         16           // amount reap stack allocations grow
+#define STR_COMPARE         strverscmp
+
+/* ----------------------------------------------------------------------- +
+   this provision can help ensure that our Item_table remains synchronized |
+   with the enumerators found in the associated header file. It's intended |
+   to only be used locally (& temporarily) at some point before a release! | */
+// #define ITEMTABLE_DEBUG //--------------------------------------------- |
+// ----------------------------------------------------------------------- +
+
+        /*
+         * The migrate types, as named by /proc/pagetypeinfo, in the
+         * same order as those ZONES_FREE_ enumerators. */
+static const char *Migrate_types[] = {
+    "Unmovable", "Movable", "Reclaimable", "HighAtomic", "CMA", "Isolate"
+};
+#define MIGRATE_TYPES  (int)(sizeof(Migrate_types) / sizeof(Migrate_types[0]))
+
+
+struct zone_node {
+    int node;
+    char name[ZONES_NAME_LEN+1];
+    unsigned long free;                // these 7 are from /proc/zoneinfo
+    unsigned long min;
+    unsigned long low;
+    unsigned long high;
+    unsigned long spanned;
+    unsigned long present;
+    unsigned long managed;
+    unsigned long blocks[ZONES_ORDERS];  // free blocks, by order
+    unsigned long types[MIGRATE_TYPES];  // free pages, by migrate type
+    int largest;                       // highest order with a free block
+    double frag_costly;                // these 4 are as the kernel's own
+    double frag_huge;                  // extfrag_index and unusable_index
+    double unus_costly;                // of debugfs, though expressed as
+    double unus_huge;                  // fractions rather than thousandths
+    unsigned seen;                     // the read which last found this node
+};
+
+struct stacks_extent {
+    int ext_numstacks;
+    struct stacks_extent *next;
+    struct zones_stack **stacks;
+};
+
+struct ext_support {
+    int numitems;                      // includes 'logical_end' delimiter
+    enum zones_item *items;            // includes 'logical_end' delimiter
+    struct stacks_extent *extents;     // anchor for these extents
+    int needtype;                      // some item requires pagetypeinfo
+};
+
+struct fetch_support {
+    struct zones_stack **anchor;       // fetch consolidated extents
+    int n_alloc;                       // number of above pointers allocated
+    int n_inuse;                       // number of above pointers occupied
+    int n_alloc_save;                  // last known reap.stacks allocation
+    struct zones_reaped results;       // count + stacks for return to caller
+};
+
+struct zones_info {
+    int refcount;
+    int zone_fd;                       // /proc/zoneinfo, kept open
+    int buddy_fd;                      // /proc/buddyinfo, kept open
+    int type_fd;                       // /proc/pagetypeinfo (-2 = unreadable)
+    char *buf;                         // any file, read in one gulp
+    int buf_size;
+    int huge_order;                    // for the ZONES_ _HUGE items
+    struct zone_node *nodes;           // in the order zoneinfo lists them
+    int n_nodes;
+    int n_alloc;
+    unsigned reads;                    // to identify any vanished nodes
+    unsigned type_reads;               // the read which last wanted pagetypeinfo
+    time_t stamp;                      // for procps_zones_get's granularity
+    struct ext_support select_ext;     // supports concurrent select/reap
+    struct ext_support fetch_ext;      // supports concurrent select/reap
+    struct fetch_support fetch;        // support for procps_zones_reap
+    struct zones_result get_this;      // used by procps_zones_get
+};
+
+
+// ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+#define setNAME(e) set_zones_ ## e
+#define setDECL(e) static void setNAME(e) \
+    (struct zones_result *R, struct zone_node *N)
+
+// regular assignment
+#define REG_set(e,t,x) setDECL(e) { R->result. t = N-> x; }
+// buddyinfo order assignment
+#define BLK_set(e,n)   setDECL(e) { R->result.ul_int = N->blocks[n]; }
+// pagetypeinfo migrate type assignment
+#define TYP_set(e,n)   setDECL(e) { R->result.ul_int = N->types[n]; }
+// watermark distance assignment
+#define DST_set(e,x)   setDECL(e) { R->result.sl_int = (long)N->free - (long)N-> x; }
+
+setDECL(noop)  { (void)R; (void)N; }
+setDECL(extra) { (void)N; R->result.ul_int = 0; }
+
+REG_set(NODE,                 s_int,   node)
+REG_set(NAME,                 str,     name)
+REG_set(PAGES_FREE,           ul_int,  free)
+REG_set(PAGES_MIN,            ul_int,  min)
+REG_set(PAGES_LOW,            ul_int,  low)
+REG_set(PAGES_HIGH,           ul_int,  high)
+REG_set(PAGES_SPANNED,        ul_int,  spanned)
+REG_set(PAGES_PRESENT,        ul_int,  present)
+REG_set(PAGES_MANAGED,        ul_int,  managed)
+
+BLK_set(BLOCKS_ORDER_0,       0)
+BLK_set(BLOCKS_ORDER_1,       1)
+BLK_set(BLOCKS_ORDER_2,       2)
+BLK_set(BLOCKS_ORDER_3,       3)
+BLK_set(BLOCKS_ORDER_4,       4)
+BLK_set(BLOCKS_ORDER_5,       5)
+BLK_set(BLOCKS_ORDER_6,       6)
+BLK_set(BLOCKS_ORDER_7,       7)
+BLK_set(BLOCKS_ORDER_8,       8)
+BLK_set(BLOCKS_ORDER_9,       9)
+BLK_set(BLOCKS_ORDER_10,      10)
+
+TYP_set(FREE_UNMOVABLE,       0)
+TYP_set(FREE_MOVABLE,         1)
+TYP_set(FREE_RECLAIMABLE,     2)
+TYP_set(FREE_HIGHATOMIC,      3)
+TYP_set(FREE_CMA,             4)
+TYP_set(FREE_ISOLATE,         5)
+
+DST_set(DISTANCE_MIN,         min)
+DST_set(DISTANCE_LOW,         low)
+DST_set(DISTANCE_HIGH,        high)
+REG_set(LARGEST_ORDER,        s_int,   largest)
+REG_set(FRAG_INDEX_COSTLY,    real,    frag_costly)
+REG_set(FRAG_INDEX_HUGE,      real,    frag_huge)
+REG_set(UNUSABLE_COSTLY,      real,    unus_costly)
+REG_set(UNUSABLE_HUGE,        real,    unus_huge)
+
+#undef setDECL
+#undef REG_set
+#undef BLK_set
+#undef TYP_set
+#undef DST_set
+
+
+// ___ Sorting Support ||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct sort_parms {
+    int offset;
+    enum zones_sort_order order;
+};
+
+#define srtNAME(t) sort_zones_ ## t
+#define srtDECL(t) static int srtNAME(t) \
+    (const struct zones_stack **A, const struct zones_stack **B, struct sort_parms *P)
+
+srtDECL(s_int) {
+    const struct zones_result *a = (*A)->head + P->offset;
+    const struct zones_result *b = (*B)->head + P->offset;
+    return P->order * (a->result.s_int - b->result.s_int);
+}
+
+srtDECL(sl_int) {
+    const struct zones_result *a = (*A)->head + P->offset;
+    const struct zones_result *b = (*B)->head + P->offset;
+    if ( a->result.sl_int > b->result.sl_int ) return P->order > 0 ?  1 : -1;
+    if ( a->result.sl_int < b->result.sl_int ) return P->order > 0 ? -1 :  1;
+    return 0;
+}
+
+srtDECL(ul_int) {
+    const struct zones_result *a = (*A)->head + P->offset;
+    const struct zones_result *b = (*B)->head + P->offset;
+    if ( a->result.ul_int > b->result.ul_int ) return P->order > 0 ?  1 : -1;
+    if ( a->result.ul_int < b->result.ul_int ) return P->order > 0 ? -1 :  1;
+    return 0;
+}
+
+srtDECL(real) {
+    const struct zones_result *a = (*A)->head + P->offset;
+    const struct zones_result *b = (*B)->head + P->offset;
+    if ( a->result.real > b->result.real ) return P->order > 0 ?  1 : -1;
+    if ( a->result.real < b->result.real ) return P->order > 0 ? -1 :  1;
+    return 0;
+}
+
+srtDECL(str) {
+    const struct zones_result *a = (*A)->head + P->offset;
+    const struct zones_result *b = (*B)->head + P->offset;
+    return P->order * STR_COMPARE(a->result.str, b->result.str);
+}
+
+srtDECL(noop) {
+    (void)A; (void)B; (void)P;
+    return 0;
+}
+
+#undef srtDECL
+
+
+// ___ Controlling Table ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+typedef void (*SET_t)(struct zones_result *, struct zone_node *);
+#ifdef ITEMTABLE_DEBUG
+#define RS(e) (SET_t)setNAME(e), ZONES_ ## e, STRINGIFY(ZONES_ ## e)
+#else
+#define RS(e) (SET_t)setNAME(e)
+#endif
+
+typedef int  (*QSR_t)(const void *, const void *, void *);
+#define QS(t) (QSR_t)srtNAME(t)
+
+#define TS(t) STRINGIFY(t)
+#define TS_noop ""
+
+        /*
+         * Need it be said?
+         * This table must be kept in the exact same order as
+         * those *enum zones_item* guys ! */
+static struct {
+    SET_t setsfunc;              // the actual result setting routine
+#ifdef ITEMTABLE_DEBUG
+    int   enumnumb;              // enumerator (must match position!)
+    char *enum2str;              // enumerator name as a char* string
+#endif
+    int   needtype;              // read from /proc/pagetypeinfo
+    QSR_t sortfunc;              // sort cmp func for a specific type
+    char *type2str;              // the result type as a string value
+} Item_table[] = {
+/*  setsfunc                     typ  sortfunc     type2str
+    ---------------------------  ---  -----------  ---------- */
+  { RS(noop),                    0,   QS(noop),    TS_noop    },
+  { RS(extra),                   0,   QS(ul_int),  TS_noop    },
+
+  { RS(NODE),                    0,   QS(s_int),   TS(s_int)  },
+  { RS(NAME),                    0,   QS(str),     TS(str)    },
+  { RS(PAGES_FREE),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(PAGES_MIN),               0,   QS(ul_int),  TS(ul_int) },
+  { RS(PAGES_LOW),               0,   QS(ul_int),  TS(ul_int) },
+  { RS(PAGES_HIGH),              0,   QS(ul_int),  TS(ul_int) },
+  { RS(PAGES_SPANNED),           0,   QS(ul_int),  TS(ul_int) },
+  { RS(PAGES_PRESENT),           0,   QS(ul_int),  TS(ul_int) },
+  { RS(PAGES_MANAGED),           0,   QS(ul_int),  TS(ul_int) },
+
+  { RS(BLOCKS_ORDER_0),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_1),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_2),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_3),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_4),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_5),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_6),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_7),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_8),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_9),          0,   QS(ul_int),  TS(ul_int) },
+  { RS(BLOCKS_ORDER_10),         0,   QS(ul_int),  TS(ul_int) },
+
+  { RS(FREE_UNMOVABLE),          1,   QS(ul_int),  TS(ul_int) },
+  { RS(FREE_MOVABLE),            1,   QS(ul_int),  TS(ul_int) },
+  { RS(FREE_RECLAIMABLE),        1,   QS(ul_int),  TS(ul_int) },
+  { RS(FREE_HIGHATOMIC),         1,   QS(ul_int),  TS(ul_int) },
+  { RS(FREE_CMA),                1,   QS(ul_int),  TS(ul_int) },
+  { RS(FREE_ISOLATE),            1,   QS(ul_int),  TS(ul_int) },
+
+  { RS(DISTANCE_MIN),            0,   QS(sl_int),  TS(sl_int) },
+  { RS(DISTANCE_LOW),            0,   QS(sl_int),  TS(sl_int) },
+  { RS(DISTANCE_HIGH),           0,   QS(sl_int),  TS(sl_int) },
+  { RS(LARGEST_ORDER),           0,   QS(s_int),   TS(s_int)  },
+  { RS(FRAG_INDEX_COSTLY),       0,   QS(real),    TS(real)   },
+  { RS(FRAG_INDEX_HUGE),         0,   QS(real),    TS(real)   },
+  { RS(UNUSABLE_COSTLY),         0,   QS(real),    TS(real)   },
+  { RS(UNUSABLE_HUGE),           0,   QS(real),    TS(real)   },
+};
+
+    /* please note,
+     * this enum MUST be 1 greater than the highest value of any enum */
+enum zones_item ZONES_logical_end = MAXTABLE(Item_table);
+
+#undef setNAME
+#undef srtNAME
+#undef RS
+#undef QS
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- zone_node specific support ---------------------------------------------
+
+static struct zone_node *node_get (
+        struct zones_info *info,
+        int node,
+        const char *name,
+        int hint)
+{
+    int i;
+
+    /* each file lists its zones in the same order, every read, so the
+       zone following whichever was last found is nearly always the one ... */
+    if (hint < info->n_nodes
+    && info->nodes[hint].node == node
+    && !strcmp(info->nodes[hint].name, name))
+        return &info->nodes[hint];
+    for (i = 0; i < info->n_nodes; i++) {
+        if (info->nodes[i].node == node
+        && !strcmp(info->nodes[i].name, name))
+            return &info->nodes[i];
+    }
+    return NULL;
+} // end: node_get
+
+
+static struct zone_node *node_new (
+        struct zones_info *info,
+        int node,
+        const char *name)
+{
+    struct zone_node *this;
+
+    if (info->n_nodes >= info->n_alloc) {
+        if (!(this = realloc(info->nodes, sizeof(struct zone_node) * (info->n_alloc + NODES_INCR))))
+            return NULL;     // here, errno was set to ENOMEM
+        info->nodes = this;
+        info->n_alloc += NODES_INCR;
+    }
+    this = &info->nodes[info->n_nodes];
+    memset(this, 0, sizeof(struct zone_node));
+    this->node = node;
+    snprintf(this->name, sizeof(this->name), "%s", name);
+    info->n_nodes++;
+    return this;
+} // end: node_new
+
+
+        /*
+         * The kernel's own fragmentation_index and unusable_free_index,
+         * for some order, from the free blocks of every order.  The former
+         * nears 1 when an allocation would fail due to fragmentation and 0
+         * when it's due to a real lack of memory, but is -1 should there be
+         * a suitable block already.  The latter is the fraction of all free
+         * pages unusable for such an allocation, so 1 with none free at all. */
+static void node_indexes (
+        struct zone_node *node,
+        int order,
+        double *frag,
+        double *unusable)
+{
+    unsigned long total = 0, suitable = 0;
+    double pages = 0;
+    int o;
+
+    for (o = 0; o < ZONES_ORDERS; o++) {
+        total += node->blocks[o];
+        pages += (double)node->blocks[o] * (1UL << o);
+        if (o >= order)
+            suitable += node->blocks[o] << (o - order);
+    }
+    *frag = 0;
+    if (suitable)
+        *frag = -1;
+    else if (total)
+        *frag = 1 - (1 + pages / (1UL << order)) / total;
+    *unusable = 1;
+    if (pages)
+        *unusable = (pages - (double)suitable * (1UL << order)) / pages;
+} // end: node_indexes
+
+
+static void node_derive (
+        struct zone_node *node,
+        int huge_order)
+{
+    int o;
+
+    node->largest = -1;
+    for (o = 0; o < ZONES_ORDERS; o++)
+        if (node->blocks[o])
+            node->largest = o;
+    node_indexes(node, ZONES_COSTLY_ORDER, &node->frag_costly, &node->unus_costly);
+    node_indexes(node, huge_order, &node->frag_huge, &node->unus_huge);
+} // end: node_derive
+
+
+// ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// --- generalized support ----------------------------------------------------
+
+static inline void zones_assign_results (
+        struct zones_stack *stack,
+        struct zone_node *node)
+{
+    struct zones_result *this = stack->head;
+
+    for (;;) {
+        enum zones_item item = this->item;
+        if (item >= ZONES_logical_end)
+            break;
+        Item_table[item].setsfunc(this, node);
+        ++this;
+    }
+    return;
+} // end: zones_assign_results
+
+
+static void zones_extents_free_all (
+        struct ext_support *this)
+{
+    while (this->extents) {
+        struct stacks_extent *p = this->extents;
+        this->extents = this->extents->next;
+        free(p);
+    };
+} // end: zones_extents_free_all
+
+
+static inline struct zones_result *zones_itemize_stack (
+        struct zones_result *p,
+        int depth,
+        enum zones_item *items)
+{
+    struct zones_result *p_sav = p;
+    int i;
+
+    for (i = 0; i < depth; i++) {
+        p->item = items[i];
+        ++p;
+    }
+    return p_sav;
+} // end: zones_itemize_stack
+
+
+static inline int zones_items_check_failed (
+        enum zones_item *items,
+        int numitems)
+{
+    int i;
+
+    /* if an enum is passed instead of an address of one or more enums, ol' gcc
+     * will silently convert it to an address (possibly NULL).  only clang will
+     * offer any sort of warning like the following:
+     *
+     * warning: incompatible integer to pointer conversion passing 'int' to parameter of type 'enum zones_item *'
+     * my_stack = procps_zones_select(info, 0, "Normal", ZONES_noop, num);
+     *                                                   ^~~~~~~~~~
+     */
+    if (numitems < 1
+    || (void *)items < (void *)(unsigned long)(2 * ZONES_logical_end))
+        return 1;
+
+    for (i = 0; i < numitems; i++) {
+        // a zones_item is currently unsigned, but we'll protect our future
+        if (items[i] < 0)
+            return 1;
+        if (items[i] >= ZONES_logical_end)
+            return 1;
+    }
+
+    return 0;
+} // end: zones_items_check_failed
+
+
+/*
+ * zones_huge_order:
+ *
+ * The order of a transparent huge page, which is also the order of
+ * a pageblock and thus what compaction strives for.  Without thp
+ * we'll assume the 2M pages of 4K x86.
+ */
+static int zones_huge_order (void)
+{
+    char buf[32];
+    unsigned long size, page = getpagesize();
+    int fd, n, order = ZONES_HUGE_ORDER;
+
+    if ((fd = open(sysfs_path(ZONES_HUGE_FILE), O_RDONLY | O_CLOEXEC)) < 0)
+        return order;
+    if ((n = read(fd, buf, sizeof(buf) - 1)) > 0) {
+        buf[n] = '\0';
+        size = strtoul(buf, NULL, 10);
+        for (n = 0; n < ZONES_ORDERS; n++)
+            if ((page << n) == size)
+                order = n;
+    }
+    close(fd);
+    return order;
+} // end: zones_huge_order
+
+
+/*
+ * zones_file_slurp:
+ *
+ * Read all of one file into our buffer.  On a host with many nodes
+ * and hundreds of cpus, /proc/zoneinfo can run to megabytes (nearly
+ * all of it per-cpu pagesets), so line oriented reads are avoided.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int zones_file_slurp (
+        struct zones_info *info,
+        int *fd,
+        const char *path)
+{
+    char *buf;
+    int num, tot_read = 0;
+
+    if (*fd < 0
+    && (*fd = open(procfs_path(path), O_RDONLY | O_CLOEXEC)) < 0)
+        return 1;
+    if (!info->buf) {
+        if (!(info->buf = malloc(BUFFER_INCR)))
+            return 1;
+        info->buf_size = BUFFER_INCR;
+    }
+    for (;;) {
+        if ((num = pread(*fd, info->buf + tot_read, info->buf_size - tot_read - 1, tot_read)) < 0)
+            return 1;
+        tot_read += num;
+        if (!num || tot_read < info->buf_size - 1)
+            break;
+        if (!(buf = realloc(info->buf, info->buf_size + BUFFER_INCR)))
+            return 1;
+        info->buf = buf;
+        info->buf_size += BUFFER_INCR;
+    }
+    info->buf[tot_read] = '\0';
+    return 0;
+} // end: zones_file_slurp
+
+
+        /*
+         * Each of our files identifies a zone as "Node 0, zone   Normal",
+         * perhaps followed by a comma.  Here, 'p' follows that "Node ".
+         * Returns the address following the zone name, or NULL. */
+static char *zones_head (
+        char *p,
+        int *node,
+        char *name)
+{
+    char *q;
+    int n;
+
+    while (*p == ' ')
+        ++p;
+    *node = (int)strtol(p, &q, 10);
+    if (q == p || strncmp(q, ", zone", 6))
+        return NULL;
+    for (p = q + 6; *p == ' '; ++p)
+        ;
+    for (n = 0; *p && *p != ' ' && *p != ',' && *p != '\n'; ++p)
+        if (n < ZONES_NAME_LEN)
+            name[n++] = *p;
+    name[n] = '\0';
+    return n ? p : NULL;
+} // end: zones_head
+
+
+/*
+ * zones_parse_zoneinfo:
+ *
+ * Digest /proc/zoneinfo, now in our buffer, in one pass.  For every
+ * zone only the few lines following "pages free" are of interest.
+ * The per-node stats ahead of those lines and the per-cpu pagesets
+ * after them (the vast bulk of this file) are just skipped over.
+ * Zones with no memory present aren't of interest either.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int zones_parse_zoneinfo (
+        struct zones_info *info)
+{
+    static const struct {
+        const char *key;
+        int len;
+        size_t offset;
+    } keys[] = {
+        { "min",     3, offsetof(struct zone_node, min)     },
+        { "low",     3, offsetof(struct zone_node, low)     },
+        { "high",    4, offsetof(struct zone_node, high)    },
+        { "spanned", 7, offsetof(struct zone_node, spanned) },
+        { "present", 7, offsetof(struct zone_node, present) },
+        { "managed", 7, offsetof(struct zone_node, managed) }
+    };
+    char name[ZONES_NAME_LEN+1], *p = info->buf, *q, *next, *pf;
+    struct zone_node this, *node;
+    int i, nd, hint = 0;
+
+    if (strncmp(p, "Node ", 5)) {
+        errno = ERANGE;
+        return 1;
+    }
+    for ( ; p; p = next ? next + 1 : NULL) {
+        if (!(q = zones_head(p + 5, &nd, name))) {
+            errno = ERANGE;
+            return 1;
+        }
+        next = strstr(q, "\nNode ");
+        if (!(pf = strstr(q, "\n  pages free"))
+        || (next && pf > next))
+            continue;
+
+        memset(&this, 0, sizeof(this));
+        this.free = strtoul(pf + 13, &q, 10);
+        // then those "        min      42" sort of lines ...
+        while ((q = strchr(q, '\n')) && !strncmp(q, "\n        ", 9)) {
+            q += 9;
+            if (!strncmp(q, "protection:", 11))
+                break;
+            for (i = 0; i < (int)(sizeof(keys) / sizeof(keys[0])); i++) {
+                if (!strncmp(q, keys[i].key, keys[i].len) && q[keys[i].len] == ' ') {
+                    *(unsigned long *)((char *)&this + keys[i].offset)
+                        = strtoul(q + keys[i].len, &q, 10);
+                    break;
+                }
+            }
+        }
+        if (!this.present)
+            continue;
+
+        if (!(node = node_get(info, nd, name, hint))
+        && !(node = node_new(info, nd, name)))
+            return 1;        // here, errno was set to ENOMEM
+        hint = node - info->nodes + 1;
+        // the other files will refresh (or not) blocks and types ...
+        this.node = node->node;
+        memcpy(this.name, node->name, sizeof(this.name));
+        this.seen = info->reads;
+        *node = this;
+    }
+    return 0;
+} // end: zones_parse_zoneinfo
+
+
+/*
+ * zones_parse_buddyinfo:
+ *
+ * Digest /proc/buddyinfo, now in our buffer, where each zone's line
+ * holds a count of free blocks for every order.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int zones_parse_buddyinfo (
+        struct zones_info *info)
+{
+    char name[ZONES_NAME_LEN+1], *p = info->buf;
+    struct zone_node *node;
+    unsigned long v;
+    int o, nd, hint = 0;
+
+    while (!strncmp(p, "Node ", 5)) {
+        if (!(p = zones_head(p + 5, &nd, name))) {
+            errno = ERANGE;
+            return 1;
+        }
+        if ((node = node_get(info, nd, name, hint)))
+            hint = node - info->nodes + 1;
+        for (o = 0; ; o++) {
+            while (*p == ' ' || *p == '\t')
+                ++p;
+            if (*p < '0' || *p > '9')
+                break;
+            for (v = 0; *p >= '0' && *p <= '9'; ++p)
+                v = v * 10 + (*p - '0');
+            if (node && o < ZONES_ORDERS)
+                node->blocks[o] = v;
+        }
+        if (!(p = strchr(p, '\n')))
+            break;
+        ++p;
+    }
+    return 0;
+} // end: zones_parse_buddyinfo
+
+
+/*
+ * zones_parse_pagetypeinfo:
+ *
+ * Digest /proc/pagetypeinfo, now in our buffer.  Only its first table
+ * is of interest, where each line holds the free blocks for every order
+ * of one zone's migrate type.  Those are totaled here as free pages,
+ * with any count the kernel gave up on taken as its lower bound.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int zones_parse_pagetypeinfo (
+        struct zones_info *info)
+{
+    char name[ZONES_NAME_LEN+1], *p, *q;
+    struct zone_node *node;
+    unsigned long v, pages;
+    int i, o, nd, hint = 0;
+
+    if (!(p = strstr(info->buf, "\nFree pages count per migrate type"))
+    || !(p = strchr(p + 1, '\n'))) {
+        errno = ERANGE;
+        return 1;
+    }
+    while (!strncmp(++p, "Node ", 5)) {
+        if (!(p = zones_head(p + 5, &nd, name))
+        || strncmp(p, ", type", 6)) {
+            errno = ERANGE;
+            return 1;
+        }
+        for (p += 6; *p == ' '; ++p)
+            ;
+        for (q = p; *q && *q != ' ' && *q != '\n'; ++q)
+            ;
+        for (i = 0; i < MIGRATE_TYPES; i++)
+            if (q - p == (int)strlen(Migrate_types[i])
+            && !strncmp(p, Migrate_types[i], q - p))
+                break;
+        if ((node = node_get(info, nd, name, hint)))
+            hint = node - info->nodes;
+        for (pages = 0, o = 0, p = q; ; o++) {
+            while (*p == ' ' || *p == '\t')
+                ++p;
+            // counts the kernel stopped at are shown as ">100000"
+            if (*p == '>')
+                ++p;
+            if (*p < '0' || *p > '9')
+                break;
+            for (v = 0; *p >= '0' && *p <= '9'; ++p)
+                v = v * 10 + (*p - '0');
+            if (o < ZONES_ORDERS)
+                pages += v << o;
+        }
+        if (node && i < MIGRATE_TYPES)
+            node->types[i] = pages;
+        if (!(p = strchr(p, '\n')))
+            break;
+    }
+    return 0;
+} // end: zones_parse_pagetypeinfo
+
+
+/*
+ * zones_read_failed:
+ *
+ * @info: info structure created at procps_zones_new
+ * @needtype: whether /proc/pagetypeinfo must also be read
+ *
+ * Read /proc/zoneinfo and /proc/buddyinfo, plus /proc/pagetypeinfo
+ * if need be, updating our nodes and discarding any no longer listed
+ * (a node taken offline).  Since newer kernels restrict pagetypeinfo
+ * to root, it being unreadable is not treated as an error.
+ *
+ * Returns: 0 on success, 1 on error
+ */
+static int zones_read_failed (
+        struct zones_info *info,
+        int needtype)
+{
+    int i, j;
+
+    info->reads++;
+    info->stamp = time(NULL);
+
+    if (zones_file_slurp(info, &info->zone_fd, ZONES_ZONE_FILE)
+    || zones_parse_zoneinfo(info))
+        return 1;
+    if (zones_file_slurp(info, &info->buddy_fd, ZONES_BUDDY_FILE)
+    || zones_parse_buddyinfo(info))
+        return 1;
+    if (needtype) {
+        // once found unreadable (it's root only), its items remain zero
+        if (info->type_fd != -2) {
+            if (zones_file_slurp(info, &info->type_fd, ZONES_TYPE_FILE)) {
+                if (info->type_fd >= 0)
+                    return 1;
+                info->type_fd = -2;
+            } else if (zones_parse_pagetypeinfo(info))
+                return 1;
+        }
+        // either way, procps_zones_get needn't read everything again
+        info->type_reads = info->reads;
+    }
+
+    for (i = j = 0; i < info->n_nodes; i++) {
+        if (info->nodes[i].seen != info->reads)
+            continue;
+        if (i != j)
+            info->nodes[j] = info->nodes[i];
+        node_derive(&info->nodes[j], info->huge_order);
+        j++;
+    }
+    info->n_nodes = j;
+    return 0;
+} // end: zones_read_failed
+
+
+/*
+ * zones_stacks_alloc():
+ *
+ * Allocate and initialize one or more stacks each of which is anchored in an
+ * associated context structure.
+ *
+ * All such stacks will have their result structures properly primed with
+ * 'items', while the result itself will be zeroed.
+ *
+ * Returns a stacks_extent struct anchoring the 'heads' of each new stack.
+ */
+static struct stacks_extent *zones_stacks_alloc (
+        struct ext_support *this,
+        int maxstacks)
+{
+    struct stacks_extent *p_blob;
+    struct zones_stack **p_vect;
+    struct zones_stack *p_head;
+    size_t vect_size, head_size, list_size, blob_size;
+    void *v_head, *v_list;
+    int i;
+
+    vect_size  = sizeof(void *) * maxstacks;                        // size of the addr vectors |
+    vect_size += sizeof(void *);                                    // plus NULL addr delimiter |
+    head_size  = sizeof(struct zones_stack);                        // size of that head struct |
+    list_size  = sizeof(struct zones_result) * this->numitems;      // any single results stack |
+    blob_size  = sizeof(struct stacks_extent);                      // the extent anchor itself |
+    blob_size += vect_size;                                         // plus room for addr vects |
+    blob_size += head_size * maxstacks;                             // plus room for head thing |
+    blob_size += list_size * maxstacks;                             // plus room for our stacks |
+
+    /* note: all of our memory is allocated in one single blob, facilitating some later free(). |
+             as a minimum, it's important that all of those result structs themselves always be |
+             contiguous within every stack since they will be accessed via a relative position. | */
+    if (NULL == (p_blob = calloc(1, blob_size)))
+        return NULL;
+
+    p_blob->next = this->extents;                                   // push this extent onto... |
+    this->extents = p_blob;                                         // ...some existing extents |
+    p_vect = (void *)p_blob + sizeof(struct stacks_extent);         // prime our vector pointer |
+    p_blob->stacks = p_vect;                                        // set actual vectors start |
+    v_head = (void *)p_vect + vect_size;                            // prime head pointer start |
+    v_list = v_head + (head_size * maxstacks);                      // prime our stacks pointer |
+
+    for (i = 0; i < maxstacks; i++) {
+        p_head = (struct zones_stack *)v_head;
+        p_head->head = zones_itemize_stack((struct zones_result *)v_list, this->numitems, this->items);
+        p_blob->stacks[i] = p_head;
+        v_list += list_size;
+        v_head += head_size;
+    }
+    p_blob->ext_numstacks = maxstacks;
+    return p_blob;
+} // end: zones_stacks_alloc
+
+
+static int zones_stacks_fetch (
+        struct zones_info *info)
+{
+ #define n_alloc  info->fetch.n_alloc
+ #define n_inuse  info->fetch.n_inuse
+ #define n_saved  info->fetch.n_alloc_save
+    struct stacks_extent *ext;
+    int i;
+
+    // initialize stuff -----------------------------------
+    if (!info->fetch.anchor) {
+        if (!(info->fetch.anchor = calloc(sizeof(void *), STACKS_INCR)))
+            return -ENOMEM;
+        n_alloc = STACKS_INCR;
+    }
+    if (!info->fetch_ext.extents) {
+        if (!(ext = zones_stacks_alloc(&info->fetch_ext, n_alloc)))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * n_alloc);
+    }
+
+    // iterate stuff --------------------------------------
+    n_inuse = 0;
+    for (i = 0; i < info->n_nodes; i++) {
+        if (!(n_inuse < n_alloc)) {
+            n_alloc += STACKS_INCR;
+            if ((!(info->fetch.anchor = realloc(info->fetch.anchor, sizeof(void *) * n_alloc)))
+            || (!(ext = zones_stacks_alloc(&info->fetch_ext, STACKS_INCR))))
+                return -1;   // here, errno was set to ENOMEM
+            memcpy(info->fetch.anchor + n_inuse, ext->stacks, sizeof(void *) * STACKS_INCR);
+        }
+        zones_assign_results(info->fetch.anchor[n_inuse], &info->nodes[i]);
+        ++n_inuse;
+    }
+
+    // finalize stuff -------------------------------------
+    if (n_saved < n_inuse + 1) {
+        n_saved = n_inuse + 1;
+        if (!(info->fetch.results.stacks = realloc(info->fetch.results.stacks, sizeof(void *) * n_saved)))
+            return -1;
+    }
+    memcpy(info->fetch.results.stacks, info->fetch.anchor, sizeof(void *) * n_inuse);
+    info->fetch.results.stacks[n_inuse] = NULL;
+    info->fetch.results.total = n_inuse;
+
+    return n_inuse;
+ #undef n_alloc
+ #undef n_inuse
+ #undef n_saved
+} // end: zones_stacks_fetch
+
+
+static int zones_stacks_reconfig_maybe (
+        struct ext_support *this,
+        enum zones_item *items,
+        int numitems)
+{
+    int i;
+
+    if (zones_items_check_failed(items, numitems))
+        return -1;
+    /* is this the first time or have things changed since we were last called?
+       if so, gotta' redo all of our stacks stuff ... */
+    if (this->numitems != numitems + 1
+    || memcmp(this->items, items, sizeof(enum zones_item) * numitems)) {
+        // allow for our ZONES_logical_end
+        if (!(this->items = realloc(this->items, sizeof(enum zones_item) * (numitems + 1))))
+            return -1;       // here, errno was set to ENOMEM
+        memcpy(this->items, items, sizeof(enum zones_item) * numitems);
+        this->items[numitems] = ZONES_logical_end;
+        this->numitems = numitems + 1;
+        for (i = 0, this->needtype = 0; i < numitems; i++)
+            this->needtype |= Item_table[items[i]].needtype;
+        zones_extents_free_all(this);
+        return 1;
+    }
+    return 0;
+} // end: zones_stacks_reconfig_maybe
+
+
+// ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+// --- standard required functions --------------------------------------------
+
+/*
+ * procps_zones_new():
+ *
+ * @info: location of returned new structure
+ *
+ * Returns: < 0 on failure, 0 on success along with
+ *          a pointer to a new context struct
+ */
+PROCPS_EXPORT int procps_zones_new (
+        struct zones_info **info)
+{
+    struct zones_info *p;
+
+#ifdef ITEMTABLE_DEBUG
+    int i, failed = 0;
+    for (i = 0; i < MAXTABLE(Item_table); i++) {
+        if (i != Item_table[i].enumnumb) {
+            fprintf(stderr, "%s: enum/table error: Item_table[%d] was %s, but its value is %d\n"
+                , __FILE__, i, Item_table[i].enum2str, Item_table[i].enumnumb);
+            failed = 1;
+        }
+    }
+    if (failed) _Exit(EXIT_FAILURE);
+#endif
+
+    if (info == NULL || *info != NULL)
+        return -EINVAL;
+    if (!(p = calloc(1, sizeof(struct zones_info))))
+        return -ENOMEM;
+
+    p->refcount = 1;
+    p->zone_fd = p->buddy_fd = p->type_fd = -1;
+    p->huge_order = zones_huge_order();
+
+    // do a priming read, to ensure there'll be no problems with subsequent access
+    if (zones_read_failed(p, 0)) {
+        procps_zones_unref(&p);
+        return -errno;
+    }
+
+    *info = p;
+    return 0;
+} // end: procps_zones_new
+
+
+PROCPS_EXPORT int procps_zones_ref (
+        struct zones_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->refcount++;
+    return info->refcount;
+} // end: procps_zones_ref
+
+
+PROCPS_EXPORT int procps_zones_unref (
+        struct zones_info **info)
+{
+    if (info == NULL || *info == NULL)
+        return -EINVAL;
+
+    (*info)->refcount--;
+
+    if ((*info)->refcount < 1) {
+        int errno_sav = errno;
+
+        if ((*info)->zone_fd >= 0)
+            close((*info)->zone_fd);
+        if ((*info)->buddy_fd >= 0)
+            close((*info)->buddy_fd);
+        if ((*info)->type_fd >= 0)
+            close((*info)->type_fd);
+        free((*info)->nodes);
+        free((*info)->buf);
+
+        if ((*info)->select_ext.extents)
+            zones_extents_free_all((&(*info)->select_ext));
+        if ((*info)->select_ext.items)
+            free((*info)->select_ext.items);
+
+        if ((*info)->fetch.anchor)
+            free((*info)->fetch.anchor);
+        if ((*info)->fetch.results.stacks)
+            free((*info)->fetch.results.stacks);
+
+        if ((*info)->fetch_ext.extents)
+            zones_extents_free_all(&(*info)->fetch_ext);
+        if ((*info)->fetch_ext.items)
+            free((*info)->fetch_ext.items);
+
+        free(*info);
+        *info = NULL;
+
+        errno = errno_sav;
+        return 0;
+    }
+    return (*info)->refcount;
+} // end: procps_zones_unref
+
+
+// --- variable interface functions -------------------------------------------
+
+/* procps_zones_huge_order():
+ *
+ * The ZONES_FRAG_INDEX_HUGE and ZONES_UNUSABLE_HUGE items concern
+ * allocations of this order, that of a transparent huge page.  The
+ * COSTLY items concern order 3, beyond which the kernel tries less
+ * hard to satisfy an allocation.
+ *
+ * Returns: that order, or < 0 on error.
+ */
+PROCPS_EXPORT int procps_zones_huge_order (
+        struct zones_info *info)
+{
+    if (info == NULL)
+        return -EINVAL;
+    return info->huge_order;
+} // end: procps_zones_huge_order
+
+
+PROCPS_EXPORT struct zones_result *procps_zones_get (
+        struct zones_info *info,
+        int node,
+        const char *zone,
+        enum zones_item item)
+{
+    struct zone_node *this;
+    time_t cur_secs;
+
+    errno = EINVAL;
+    if (info == NULL || zone == NULL)
+        return NULL;
+    if (item < 0 || item >= ZONES_logical_end)
+        return NULL;
+    errno = 0;
+
+    /* we will NOT read the zone files with every call - rather, we'll offer
+       a granularity of 1 second between reads ... */
+    cur_secs = time(NULL);
+    if (1 <= cur_secs - info->stamp
+    || (Item_table[item].needtype && info->type_reads != info->reads)) {
+        if (zones_read_failed(info, Item_table[item].needtype))
+            return NULL;
+    }
+
+    info->get_this.item = item;
+    //  with 'get', we must NOT honor the usual 'noop' guarantee
+    info->get_this.result.ul_int = 0;
+
+    if (!(this = node_get(info, node, zone, 0))) {
+        errno = ENXIO;
+        return NULL;
+    }
+    Item_table[item].setsfunc(&info->get_this, this);
+
+    return &info->get_this;
+} // end: procps_zones_get
+
+
+/* procps_zones_reap():
+ *
+ * Harvest all the requested zone information, for every zone with
+ * any memory present, node by node as /proc/zoneinfo lists them.
+ *
+ * Returns: pointer to a zones_reaped struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct zones_reaped *procps_zones_reap (
+        struct zones_info *info,
+        enum zones_item *items,
+        int numitems)
+{
+    errno = EINVAL;
+    if (info == NULL || items == NULL)
+        return NULL;
+    if (0 > zones_stacks_reconfig_maybe(&info->fetch_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (zones_read_failed(info, info->fetch_ext.needtype))
+        return NULL;
+    if (0 > zones_stacks_fetch(info))
+        return NULL;
+
+    return &info->fetch.results;
+} // end: procps_zones_reap
+
+
+/* procps_zones_select():
+ *
+ * Obtain all the requested information for one zone of one node,
+ * by name, then return it in a single library provided results stack.
+ *
+ * Returns: pointer to a zones_stack struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct zones_stack *procps_zones_select (
+        struct zones_info *info,
+        int node,
+        const char *zone,
+        enum zones_item *items,
+        int numitems)
+{
+    struct zone_node *this;
+
+    errno = EINVAL;
+    if (info == NULL || zone == NULL || items == NULL)
+        return NULL;
+    if (0 > zones_stacks_reconfig_maybe(&info->select_ext, items, numitems))
+        return NULL;         // here, errno may be overridden with ENOMEM
+    errno = 0;
+
+    if (!info->select_ext.extents
+    && (!zones_stacks_alloc(&info->select_ext, 1)))
+       return NULL;
+
+    if (zones_read_failed(info, info->select_ext.needtype))
+        return NULL;
+    if (!(this = node_get(info, node, zone, 0))) {
+        errno = ENXIO;
+        return NULL;
+    }
+
+    zones_assign_results(info->select_ext.extents->stacks[0], this);
+
+    return info->select_ext.extents->stacks[0];
+} // end: procps_zones_select
+
+
+/*
+ * procps_zones_sort():
+ *
+ * Sort stacks anchored in the passed stack pointers array
+ * based on the designated sort enumerator and specified order.
+ *
+ * Returns those same addresses sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct zones_stack **procps_zones_sort (
+        struct zones_info *info,
+        struct zones_stack *stacks[],
+        int numstacked,
+        enum zones_item sortitem,
+        enum zones_sort_order order)
+{
+    struct zones_result *p;
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL)
+        return NULL;
+    // a zones_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0 || sortitem >= ZONES_logical_end)
+        return NULL;
+    if (order != ZONES_SORT_ASCEND && order != ZONES_SORT_DESCEND)
+        return NULL;
+    if (numstacked < 2)
+        return stacks;
+
+    offset = 0;
+    p = stacks[0]->head;
+    for (;;) {
+        if (p->item == sortitem)
+            break;
+        ++offset;
+        if (p->item >= ZONES_logical_end)
+            return NULL;
+        ++p;
+    }
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    qsort_r(stacks, numstacked, sizeof(void *), (QSR_t)Item_table[p->item].sortfunc, &parms);
+    return stacks;
+} // end: procps_zones_sort
+
+
+// --- special debugging function(s) ------------------------------------------
+/*
+ *  The following isn't part of the normal programming interface.  Rather,
+ *  it exists to validate result types referenced in application programs.
+ *
+ *  It's used only when:
+ *      1) the 'XTRA_PROCPS_DEBUG' has been defined, or
+ *      2) an #include of 'xtra-procps-debug.h' is used
+ */
+
+PROCPS_EXPORT struct zones_result *xtra_zones_get (
+        struct zones_info *info,
+        int node,
+        const char *zone,
+        enum zones_item actual_enum,
+        const char *typestr,
+        const char *file,
+        int lineno)
+{
+    struct zones_result *r = procps_zones_get(info, node, zone, actual_enum);
+
+    if (actual_enum < 0 || actual_enum >= ZONES_logical_end) {
+        fprintf(stderr, "%s line %d: invalid item = %d, type = %s\n"
+            , file, lineno, actual_enum, typestr);
+    }
+    if (r) {
+        char *str = Item_table[r->item].type2str;
+        if (str[0]
+        && (strcmp(typestr, str)))
+            fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return r;
+} // end: xtra_zones_get
+
+
+PROCPS_EXPORT struct zones_result *xtra_zones_val (
+        int relative_enum,
+        const char *typestr,
+        const struct zones_stack *stack,
+        const char *file,
+        int lineno)
+{
+    char *str;
+    int i;
+
+    for (i = 0; stack->head[i].item < ZONES_logical_end; i++)
+        ;
+    if (relative_enum < 0 || relative_enum >= i) {
+        fprintf(stderr, "%s line %d: invalid relative_enum = %d, valid range = 0-%d\n"
+            , file, lineno, relative_enum, i-1);
+        return NULL;
+    }
+    str = Item_table[stack->head[relative_enum].item].type2str;
+    if (str[0]
+    && (strcmp(typestr, str))) {
+        fprintf(stderr, "%s line %d: was %s, expected %s\n", file, lineno, typestr, str);
+    }
+    return &stack->head[relative_enum];
+} // end: xtra_zones_val
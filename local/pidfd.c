@@ -0,0 +1,274 @@
+/*
+ * pidfd.c - signal the tasks found by a /proc scan, safe from pid reuse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#ifdef ENABLE_PIDWAIT
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#endif
+
+#include "pidfd.h"
+
+#define BLIND_POLL_MS  100      // how often tasks without a pidfd are checked
+#define MAX_EVENTS     32
+
+#if defined(ENABLE_PIDWAIT) && !defined(HAVE_PIDFD_OPEN)
+int pidfd_open (pid_t pid, unsigned int flags)
+{
+	return syscall(__NR_pidfd_open, pid, flags);
+}
+#endif
+
+/*
+ * Read the state and start time (field 22) of a task from its stat file.
+ * Returns -1 with errno ESRCH if it's gone.
+ */
+static int task_began(pid_t pid, unsigned long long *began, char *state)
+{
+	char path[64], buf[1024], *p;
+	ssize_t n;
+	int fd;
+
+	snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+		errno = ESRCH;
+		return -1;
+	}
+	n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (n <= 0) {
+		errno = ESRCH;
+		return -1;
+	}
+	buf[n] = '\0';
+	// the command could hold anything, including a ')'
+	if (!(p = strrchr(buf, ')'))
+	|| 2 != sscanf(p + 1, " %c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u"
+	                      " %*d %*d %*d %*d %*d %*d %llu", state, began)) {
+		errno = ESRCH;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * When matching thousands of tasks, the soft limit on open files
+ * may be too small to hold a pidfd for each one.
+ */
+static int raise_nofile(void)
+{
+	struct rlimit rl;
+
+	if (getrlimit(RLIMIT_NOFILE, &rl) < 0 || rl.rlim_cur >= rl.rlim_max)
+		return 0;
+	rl.rlim_cur = rl.rlim_max;
+	return (setrlimit(RLIMIT_NOFILE, &rl) == 0);
+}
+
+/*
+ * Obtain a pidfd for the task which started at 'began' (or for whatever
+ * now runs as 'pid' when that's zero).  The start time is only checked
+ * after the pidfd is opened, since by then the pid can not be recycled.
+ *
+ * Without pidfd support, or once out of descriptors, the task is still
+ * validated but then is signalled by pid, leaving a far smaller window.
+ *
+ * A bare pid (as given to kill) need not be visible under /proc, as in
+ * a chroot or with hidepid.  Its start time is then left unknown (zero)
+ * and it's simply signalled, through any pidfd or else by pid.
+ */
+int pidfd_task_open(struct pidfd_task *task, pid_t pid, unsigned long long began)
+{
+	unsigned long long now;
+	char state;
+
+	task->pid = pid;
+	task->fd = -1;
+	task->began = began;
+#ifdef ENABLE_PIDWAIT
+	task->fd = pidfd_open(pid, 0);
+	if (task->fd < 0 && errno == EMFILE && raise_nofile())
+		task->fd = pidfd_open(pid, 0);
+	if (task->fd < 0 && errno == ESRCH) {
+		task->pid = 0;
+		return -1;
+	}
+#endif
+	if (!began) {
+		if (task_began(pid, &now, &state) == 0)
+			task->began = now;
+		return 0;
+	}
+	if (task_began(pid, &now, &state) < 0 || now != began) {
+		pidfd_task_close(task);
+		errno = ESRCH;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Tasks without a pidfd can't be waited upon, so they're polled instead.
+ * A zombie is as good as gone, since there's nothing left to signal.
+ * One whose start time is unknown can only be probed by its pid.
+ */
+static int task_gone(const struct pidfd_task *task)
+{
+	unsigned long long now;
+	char state;
+
+	if (!task->began)
+		return (kill(task->pid, 0) < 0 && errno == ESRCH);
+	return (task_began(task->pid, &now, &state) < 0
+	|| now != task->began || state == 'Z');
+}
+
+int pidfd_task_signal(const struct pidfd_task *task, int sig, const union sigval *value)
+{
+	unsigned long long now;
+	char state;
+
+#ifdef ENABLE_PIDWAIT
+	if (task->fd >= 0) {
+		siginfo_t info, *infop = NULL;
+
+		if (value) {
+			memset(&info, 0, sizeof(info));
+			info.si_signo = sig;
+			info.si_code = SI_QUEUE;
+			info.si_pid = getpid();
+			info.si_uid = getuid();
+			info.si_value = *value;
+			infop = &info;
+		}
+		return syscall(__NR_pidfd_send_signal, task->fd, sig, infop, 0);
+	}
+#endif
+	if (task->began
+	&& (task_began(task->pid, &now, &state) < 0 || now != task->began)) {
+		errno = ESRCH;
+		return -1;
+	}
+	if (value)
+		return sigqueue(task->pid, sig, *value);
+	return kill(task->pid, sig);
+}
+
+/*
+ * Forget a task, and release its pidfd.  A zeroed (calloc'd) task
+ * is taken as one already forgotten.
+ */
+void pidfd_task_close(struct pidfd_task *task)
+{
+	if (task->pid && task->fd >= 0)
+		close(task->fd);
+	task->fd = -1;
+	task->pid = 0;
+}
+
+/*
+ * Wait up to 'secs' for every task still held to exit, forgetting
+ * (closing) each one as it does.  Any left can then be escalated.
+ */
+int pidfd_tasks_wait(struct pidfd_task *tasks, int num, double secs)
+{
+	struct timespec now, end;
+	int i, n, ms, left = 0, blind = 0;
+#ifdef ENABLE_PIDWAIT
+	struct epoll_event ev, events[MAX_EVENTS];
+	int epollfd = epoll_create1(EPOLL_CLOEXEC);
+#endif
+
+	for (i = 0; i < num; i++) {
+		if (!tasks[i].pid)
+			continue;
+		left++;
+#ifdef ENABLE_PIDWAIT
+		ev.events = EPOLLIN;
+		ev.data.u32 = i;
+		if (epollfd >= 0 && tasks[i].fd >= 0
+		&& 0 == epoll_ctl(epollfd, EPOLL_CTL_ADD, tasks[i].fd, &ev))
+			continue;
+		if (tasks[i].fd >= 0) {
+			close(tasks[i].fd);
+			tasks[i].fd = -1;
+		}
+#endif
+		blind++;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	end.tv_sec += (time_t)secs;
+	end.tv_nsec += (long)((secs - (time_t)secs) * 1e9);
+	if (end.tv_nsec >= 1000000000L) {
+		end.tv_sec++;
+		end.tv_nsec -= 1000000000L;
+	}
+
+	while (left) {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		ms = (end.tv_sec - now.tv_sec) * 1000
+		   + (end.tv_nsec - now.tv_nsec) / 1000000;
+		if (ms <= 0)
+			break;
+		if (blind && ms > BLIND_POLL_MS)
+			ms = BLIND_POLL_MS;
+#ifdef ENABLE_PIDWAIT
+		if (epollfd >= 0 && left > blind)
+			n = epoll_wait(epollfd, events, MAX_EVENTS, ms);
+		else
+#endif
+			n = poll(NULL, 0, ms);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+#ifdef ENABLE_PIDWAIT
+		for (i = 0; i < n; i++) {
+			struct pidfd_task *t = &tasks[events[i].data.u32];
+
+			epoll_ctl(epollfd, EPOLL_CTL_DEL, t->fd, NULL);
+			pidfd_task_close(t);
+			left--;
+		}
+#endif
+		if (!blind)
+			continue;
+		for (i = 0; i < num; i++) {
+			if (!tasks[i].pid || tasks[i].fd >= 0 || !task_gone(&tasks[i]))
+				continue;
+			pidfd_task_close(&tasks[i]);
+			left--;
+			blind--;
+		}
+	}
+#ifdef ENABLE_PIDWAIT
+	if (epollfd >= 0)
+		close(epollfd);
+#endif
+	return left;
+}
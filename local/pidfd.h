@@ -0,0 +1,29 @@
+#ifndef PROCPS_PROC_PIDFD_H
+#define PROCPS_PROC_PIDFD_H
+
+#include <signal.h>
+#include <sys/types.h>
+
+/*
+ * A task found during a /proc scan, held (when the kernel allows)
+ * through a pidfd so that it can't be confused with a recycled pid.
+ * A pid of zero means there is nothing left to be signalled.
+ */
+struct pidfd_task {
+    pid_t pid;
+    int fd;                         // -1 when no pidfd could be had
+    unsigned long long began;       // start time, in tics since boot (0 = unknown)
+};
+
+#if defined(ENABLE_PIDWAIT) && !defined(HAVE_PIDFD_OPEN)
+extern int pidfd_open(pid_t pid, unsigned int flags);
+#endif
+
+/* return -1 (errno ESRCH) if the task is gone or its pid was reused */
+extern int pidfd_task_open(struct pidfd_task *task, pid_t pid, unsigned long long began);
+extern int pidfd_task_signal(const struct pidfd_task *task, int sig, const union sigval *value);
+extern void pidfd_task_close(struct pidfd_task *task);
+/* return how many tasks are still running after 'secs' */
+extern int pidfd_tasks_wait(struct pidfd_task *tasks, int num, double secs);
+
+#endif
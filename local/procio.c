@@ -46,6 +46,13 @@ static ssize_t proc_read(void *, char *, size_t);
 static ssize_t proc_write(void *, const char *, size_t);
 static int proc_close(void *);
 
+/*
+ * A buffer retained by proc_close for the next fprocopen, so that a
+ * caller like 'sysctl -a' reuses one large buffer across every key.
+ */
+static char	*spare_buf;
+static size_t	 spare_count;
+
 __extension__
 static cookie_io_functions_t procio = {
     .read  = proc_read,
@@ -111,8 +118,14 @@ FILE *fprocopen(const char *path, const char *mode)
 	cookie = (pcookie_t *)malloc(sizeof(pcookie_t));
 	if (!cookie)
 		goto out;
-	cookie->count = BUFSIZ;
-	cookie->buf = (char *)malloc(cookie->count);
+	if (spare_buf) {
+		cookie->buf = spare_buf;
+		cookie->count = spare_count;
+		spare_buf = NULL;
+	} else {
+		cookie->count = BUFSIZ;
+		cookie->buf = (char *)malloc(cookie->count);
+	}
 	if (!cookie->buf) {
 		int errsv = errno;
 		free(cookie);
@@ -161,8 +174,29 @@ ssize_t proc_read(void *c, char *buf, size_t count)
 		cookie->count = count;
 	}
 
+	/*
+	 * Read the whole file, continuing from where the prior read ended
+	 * and doubling the buffer when it fills (leaving room for a '\0').
+	 * After growing, the file is read again from the start since some
+	 * sysctls (the int vectors and bitmaps) report EOF for any offset
+	 * other than 0.  With doubling, that's still linear in file size.
+	 */
 	while (!cookie->final) {
-		len = read(cookie->fd, cookie->buf, cookie->count);
+		if (cookie->count - cookie->length < 2) {
+			if (cookie->count > SSIZE_MAX / 2) {
+				errno = EFBIG;
+				goto out;
+			}
+			ptr = realloc(cookie->buf, cookie->count * 2);
+			if (!ptr)
+				goto out;
+			cookie->buf = ptr;
+			cookie->count *= 2;
+			cookie->length = 0;	/* reset for a retry */
+		}
+
+		len = pread(cookie->fd, cookie->buf + cookie->length,
+			    cookie->count - cookie->length - 1, cookie->length);
 
 		if (len <= 0) {
 			if (len == 0) {
@@ -171,22 +205,12 @@ ssize_t proc_read(void *c, char *buf, size_t count)
 				cookie->buf[cookie->length] = '\0';
 				break;
 			}
+			if (errno == EINTR)
+				continue;
 			goto out;		/* error or done */
 		}
 
-		cookie->length = len;
-
-		if (cookie->length < cookie->count)
-			continue;
-
-		/* Likly to small buffer here */
-
-		lseek(cookie->fd, 0, SEEK_SET);	/* reset for a retry */
-
-		ptr = realloc(cookie->buf, cookie->count += BUFSIZ);
-		if (!ptr)
-			goto out;
-		cookie->buf = ptr;
+		cookie->length += len;
 	}
 
 	len = count;
@@ -286,7 +310,13 @@ int proc_close(void *c)
 {
 	pcookie_t *cookie = c;
 	close(cookie->fd);
-	free(cookie->buf);
+	if (spare_buf && spare_count >= cookie->count)
+		free(cookie->buf);
+	else {
+		free(spare_buf);
+		spare_buf = cookie->buf;
+		spare_count = cookie->count;
+	}
 	free(cookie);
 	return 0;
 }
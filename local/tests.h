@@ -2,8 +2,13 @@
 #ifndef PROCPS_NG_TESTS_H
 #define PROCPS_NG_TESTS_H
 
+#include <errno.h>
+#include <ftw.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 
 typedef int (*TestFunction)(void *data);
 
@@ -27,4 +32,91 @@ static inline int run_tests(TestFunction *list, void *data)
     }
     return EXIT_SUCCESS;
 }
+
+/*
+ * Some tests reap synthetic files from a scratch directory standing in
+ * for /proc, with its "sys" subdirectory standing in for /sys.  The
+ * first fixture_root creates it and points LIBPROC_PROC_ROOT and
+ * LIBPROC_SYS_ROOT there, fixture_put (re)writes one of its files and
+ * fixture_cleanup removes the lot.  Since the library may hold those
+ * files open, they are always rewritten in place.
+ */
+static inline const char *fixture_root(void)
+{
+    static char root[] = "/tmp/procps_tests.XXXXXX";
+    static int made;
+    char path[sizeof(root) + 8];
+
+    if (!made) {
+        if (!mkdtemp(root))
+            return NULL;
+        made = 1;
+        snprintf(path, sizeof(path), "%s/sys", root);
+        mkdir(path, 0755);
+        setenv("LIBPROC_PROC_ROOT", root, 1);
+        setenv("LIBPROC_SYS_ROOT", path, 1);
+    }
+    return root;
+}
+
+/* Return the path of a fixture, valid until the next call. */
+static inline const char *fixture_path(const char *name)
+{
+    static char path[256];
+
+    snprintf(path, sizeof(path), "%s/%s", fixture_root(), name);
+    return path;
+}
+
+/* Make a fixture directory, along with any missing parents. */
+static inline int fixture_mkdir(const char *name)
+{
+    char path[256], *p;
+
+    snprintf(path, sizeof(path), "%s", fixture_path(name));
+    for (p = path + strlen(fixture_root()) + 1; (p = strchr(p, '/')); *p++ = '/') {
+        *p = '\0';
+        mkdir(path, 0755);
+    }
+    return (0 == mkdir(path, 0755) || errno == EEXIST);
+}
+
+/* Open a fixture for writing, making any missing directories. */
+static inline FILE *fixture_open(const char *name)
+{
+    char dir[256], *p;
+
+    snprintf(dir, sizeof(dir), "%s", name);
+    if ((p = strrchr(dir, '/'))) {
+        *p = '\0';
+        if (!fixture_mkdir(dir))
+            return NULL;
+    }
+    return fopen(fixture_path(name), "w");
+}
+
+__attribute__((format(printf, 2, 3)))
+static inline int fixture_put(const char *name, const char *fmt, ...)
+{
+    va_list ap;
+    FILE *fp;
+
+    if (!(fp = fixture_open(name)))
+        return 0;
+    va_start(ap, fmt);
+    vfprintf(fp, fmt, ap);
+    va_end(ap);
+    return (0 == fclose(fp));
+}
+
+static inline int fixture_del(const char *path, const struct stat *sb, int flag, struct FTW *ftw)
+{
+    (void)sb; (void)flag; (void)ftw;
+    return remove(path);
+}
+
+static inline void fixture_cleanup(void)
+{
+    nftw(fixture_root(), fixture_del, 8, FTW_DEPTH | FTW_PHYS);
+}
 #endif
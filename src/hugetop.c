@@ -48,11 +48,17 @@
 #include "pids.h"
 #include "strutils.h"
 #include "units.h"
+#include "xalloc.h"
 
 struct hg_state {
 	unsigned long size;	/* KB */
 	unsigned long nr_hugepages;
 	unsigned long free_hugepages;
+	unsigned long surplus_hugepages;
+	unsigned long resv_hugepages;		/* system wide only */
+	unsigned long nr_overcommit_hugepages;	/* system wide only */
+	int nr_fd, free_fd, surplus_fd;		/* held open, re-read via pread */
+	int resv_fd, overcommit_fd;		/* -1 when per NUMA node */
 };
 
 struct node_hg_states {
@@ -77,6 +83,27 @@ static int human;
 static struct termios saved_tty;
 static long delay = 3;
 
+/* the huge page layout is scanned once, then its attribute files are held open */
+static struct nodes_hg_states Nodes;
+static struct node_hg_states System;
+
+/* a cheap /proc/<pid>/status pass finds candidates for the costly smaps_rollup */
+static struct pids_info *Pre_ctx;
+static struct pids_info *Pids_ctx;
+static int prefilter;
+static unsigned *Pre_pids;
+static int Pre_alloc;
+
+enum pids_item Pre_items[] = {
+	PIDS_ID_PID,
+	PIDS_VM_HUGETLB
+};
+#define PRE_ITEMS_COUNT (sizeof Pre_items / sizeof *Pre_items)
+
+enum pre_rel_items {
+	PRE_PID, PRE_VM_HUGETLB
+};
+
 enum pids_item Items[] = {
 	PIDS_ID_PID,
 	PIDS_CMD,
@@ -91,6 +118,7 @@ enum rel_items {
 
 #define PIDS_GETINT(e) PIDS_VAL(EU_ ## e, s_int, stack)
 #define PIDS_GETUNT(e) PIDS_VAL(EU_ ## e, u_int, stack)
+#define PIDS_GETUL(e)  PIDS_VAL(EU_ ## e, ul_int, stack)
 #define PIDS_GETULL(e) PIDS_VAL(EU_ ## e, ull_int, stack)
 #define PIDS_GETSTR(e) PIDS_VAL(EU_ ## e, str, stack)
 #define PIDS_GETSCH(e) PIDS_VAL(EU_ ## e, s_ch, stack)
@@ -129,6 +157,33 @@ static void setup_hugepage()
 	}
 }
 
+/*
+ * the HugetlbPages line of /proc/<pid>/status arrived with Linux-v4.4,
+ * without it every task's smaps_rollup must be read
+ */
+static void setup_procs(void)
+{
+	char *line = NULL;
+	size_t len = 0;
+	FILE *fp;
+
+	if ((fp = fopen("/proc/self/status", "r"))) {
+		while (getline(&line, &len, fp) != -1) {
+			if (!strncmp(line, "HugetlbPages:", 13)) {
+				prefilter = 1;
+				break;
+			}
+		}
+		free(line);
+		fclose(fp);
+	}
+
+	if (prefilter && procps_pids_new(&Pre_ctx, Pre_items, PRE_ITEMS_COUNT) < 0)
+		xerrx(EXIT_FAILURE, _("Unable to create pid info structure"));
+	if (procps_pids_new(&Pids_ctx, Items, ITEMS_COUNT) < 0)
+		xerrx(EXIT_FAILURE, _("Unable to create pid info structure"));
+}
+
 /*
  * term_size - set the globals 'cols' and 'rows' to the current terminal size
  */
@@ -171,30 +226,37 @@ static void parse_input(char c)
 }
 
 #define SYS_NODES "/sys/devices/system/node"
+#define SYS_HUGEPAGES "/sys/kernel/mm/hugepages"
 
-static unsigned long hg_read_attribute(const char *dir, const char *hg, const char *attr)
+static int hg_open_attribute(const char *dir, const char *hg, const char *attr)
 {
 	char path[PATH_MAX] = { 0 };
-	char buf[64] = { 0 };
 	int fd;
 
 	snprintf(path, sizeof(path), "%s/%s/%s", dir, hg, attr);
 	fd = open(path, O_RDONLY);
 	if (fd == -1) {
 		printf("Failed to open %s\n", path);
-		resizeterm(rows, cols);
 		exit(errno);
 	}
 
-	if (read(fd, buf, sizeof(buf)) == -1) {
-		printf("Failed to read %s\n", path);
+	return fd;
+}
+
+static unsigned long hg_read_attribute(int fd)
+{
+	char buf[64] = { 0 };
+
+	if (fd == -1)
+		return 0;
+
+	if (pread(fd, buf, sizeof(buf) - 1, 0) == -1) {
+		printf("Failed to read huge page attribute\n");
 		resizeterm(rows, cols);
 		exit(errno);
 	}
 
-	close(fd);
-
-	return atol(buf);
+	return strtoul(buf, NULL, 10);
 }
 
 static int hg_state_cmp(const void *p1, const void *p2)
@@ -205,22 +267,23 @@ static int hg_state_cmp(const void *p1, const void *p2)
 	return state1->size > state2->size;
 }
 
-static void hg_states_one_node(struct node_hg_states *node, const char *name)
+/*
+ * scan one hugepages directory, holding open each hugepages-<size> attribute,
+ * where the reserved and overcommit counters exist only system wide
+ */
+static void hg_states_one_dir(struct node_hg_states *node, const char *name,
+			      const char *path, int system_wide)
 {
 	DIR *hg_dir;
 	struct dirent *hg;
-	char path[PATH_MAX] = { 0 };
 	struct hg_state *state;
 
 	memset(node, 0x00, sizeof(*node));
 	strncpy(node->node, name, sizeof(node->node) - 1);
 
-	/* Ex, scan /sys/devices/system/node/node0/hugepages */
-	snprintf(path, sizeof(path), "%s/%s/hugepages", SYS_NODES, name);
 	hg_dir = opendir(path);
 	if (!hg_dir) {
 		printf("Failed to open %s\n", path);
-		resizeterm(rows, cols);
 		exit(errno);
 	}
 
@@ -228,14 +291,21 @@ static void hg_states_one_node(struct node_hg_states *node, const char *name)
 		if (memcmp(hg->d_name, "hugepages-", 10))
 			continue;
 
-		node->state = realloc(node->state,
+		node->state = xrealloc(node->state,
 					sizeof(struct hg_state) * (node->nr_hg_state + 1));
 		state = &node->state[node->nr_hg_state];
 		node->nr_hg_state++;
 
-		sscanf(hg->d_name, "hugepages-%ldkB", &state->size);
-		state->nr_hugepages = hg_read_attribute(path, hg->d_name, "nr_hugepages");
-		state->free_hugepages = hg_read_attribute(path, hg->d_name, "free_hugepages");
+		memset(state, 0x00, sizeof(*state));
+		sscanf(hg->d_name, "hugepages-%lukB", &state->size);
+		state->nr_fd = hg_open_attribute(path, hg->d_name, "nr_hugepages");
+		state->free_fd = hg_open_attribute(path, hg->d_name, "free_hugepages");
+		state->surplus_fd = hg_open_attribute(path, hg->d_name, "surplus_hugepages");
+		state->resv_fd = state->overcommit_fd = -1;
+		if (system_wide) {
+			state->resv_fd = hg_open_attribute(path, hg->d_name, "resv_hugepages");
+			state->overcommit_fd = hg_open_attribute(path, hg->d_name, "nr_overcommit_hugepages");
+		}
 	}
 
 	/* make sure the result in order */
@@ -247,17 +317,18 @@ static void hg_states_one_node(struct node_hg_states *node, const char *name)
 
 /*
  * scan /sys/devices/system/node/node<ID>/hugepages/hugepages-<size>/
+ * plus /sys/kernel/mm/hugepages/hugepages-<size>/ for the system wide view
  */
-static void hg_states_new(struct nodes_hg_states *nodes)
+static void hg_states_new(struct nodes_hg_states *nodes, struct node_hg_states *system)
 {
 	DIR *nodes_dir;
 	struct dirent *dirent;
 	struct node_hg_states *node;
+	char path[PATH_MAX] = { 0 };
 
 	nodes_dir = opendir(SYS_NODES);
 	if (!nodes_dir) {
 		fputs("Failed to open " SYS_NODES, stdout);
-		resizeterm(rows, cols);
 		exit(errno);
 	}
 
@@ -265,49 +336,63 @@ static void hg_states_new(struct nodes_hg_states *nodes)
 		if ((dirent->d_type != DT_DIR) || memcmp(dirent->d_name, "node", 4))
 			continue;
 
-		nodes->nodes = realloc(nodes->nodes,
+		nodes->nodes = xrealloc(nodes->nodes,
 					 sizeof(struct node_hg_states) * (nodes->nr_nodes + 1));
 		node = &nodes->nodes[nodes->nr_nodes];
 		nodes->nr_nodes++;
 
-		/* Ex, scan  /sys/devices/system/node/node0 */
-		hg_states_one_node(node, dirent->d_name);
+		/* Ex, scan /sys/devices/system/node/node0/hugepages */
+		snprintf(path, sizeof(path), "%s/%s/hugepages", SYS_NODES, dirent->d_name);
+		hg_states_one_dir(node, dirent->d_name, path, 0);
 	}
 
 	closedir(nodes_dir);
+
+	hg_states_one_dir(system, "node(s)", SYS_HUGEPAGES, 1);
 }
 
-static void hg_states_free(struct nodes_hg_states *states)
+static void hg_states_read(struct node_hg_states *node)
 {
-	for (int n = 0; n < states->nr_nodes; n++) {
-		struct node_hg_states *node = &states->nodes[n];
+	for (int i = 0; i < node->nr_hg_state; i++) {
+		struct hg_state *state = &node->state[i];
 
-		free(node->state);
+		state->nr_hugepages = hg_read_attribute(state->nr_fd);
+		state->free_hugepages = hg_read_attribute(state->free_fd);
+		state->surplus_hugepages = hg_read_attribute(state->surplus_fd);
+		state->resv_hugepages = hg_read_attribute(state->resv_fd);
+		state->nr_overcommit_hugepages = hg_read_attribute(state->overcommit_fd);
 	}
-
-	free(states->nodes);
 }
 
 #define PRINT_line(fmt, ...) if (run_once) printf(fmt, __VA_ARGS__); else printw(fmt, __VA_ARGS__)
 
-static void print_node(struct node_hg_states *node, int numa)
+static void print_node(struct node_hg_states *node, int system_wide)
 {
 	struct hg_state *state;
 	char *line = calloc(cols, sizeof(char));
 	int bytes;
 
 	/* start build per node huge pages line. 'nodeX:' or 'node(s):' */
-	if (numa)
-		bytes = snprintf(line, cols, "%s:", node->node);
-	else
-		bytes = snprintf(line, cols, "node(s):");
+	bytes = snprintf(line, cols, "%s:", node->node);
 
-	/* append ' 2.0Mi - xxx/yyy, 1.0Gi - mmm/nnn' */
+	/* append ' 2.0Mi - xxx/yyy (surp s, resv r, over o), 1.0Gi - mmm/nnn (surp s, ...)' */
 	for (int i = 0; i < node->nr_hg_state; i++) {
 		state = &node->state[i];
-		bytes += snprintf(line + bytes, cols - bytes, " %s - %ld/%ld",
+		bytes += snprintf(line + bytes, cols - bytes, " %s - %lu/%lu (surp %lu",
 				scale_size(state->size, 3, 0, 1),
-				state->free_hugepages, state->nr_hugepages);
+				state->free_hugepages, state->nr_hugepages,
+				state->surplus_hugepages);
+		if (bytes >= cols)
+			break;
+
+		if (system_wide) {
+			bytes += snprintf(line + bytes, cols - bytes, ", resv %lu, over %lu",
+					state->resv_hugepages, state->nr_overcommit_hugepages);
+			if (bytes >= cols)
+				break;
+		}
+
+		bytes += snprintf(line + bytes, cols - bytes, ")");
 		if (bytes >= cols)
 			break;
 
@@ -325,38 +410,23 @@ static void print_node(struct node_hg_states *node, int numa)
 
 static void print_summary(void)
 {
-	struct nodes_hg_states nodes = { 0 };
-	struct node_hg_states *node, *node0;
+	struct node_hg_states *node;
 	time_t now;
 
 	now = time(NULL);
 	PRINT_line("%s - %s", program_invocation_short_name, ctime(&now));
 
-	hg_states_new(&nodes);
-
 	if (numa) {
-		for (int n = 0; n < nodes.nr_nodes; n++) {
-			node = &nodes.nodes[n];
-			print_node(node, numa);
+		for (int n = 0; n < Nodes.nr_nodes; n++) {
+			node = &Nodes.nodes[n];
+			hg_states_read(node);
+			print_node(node, 0);
 		}
 	} else {
-		/* merge node[1-n] into node[0] */
-		node0 = &nodes.nodes[0];
-		for (int n = 1; n < nodes.nr_nodes; n++) {
-			node = &nodes.nodes[n];
-			for (int i = 0; i < node->nr_hg_state; i++) {
-				struct hg_state *state = &node->state[i];
-				struct hg_state *state0 = &node0->state[i];
-
-				state0->nr_hugepages += state->nr_hugepages;
-				state0->free_hugepages += state->free_hugepages;
-			}
-		}
-
-		print_node(node0, numa);
+		/* the system wide counters are already the sum of every node */
+		hg_states_read(&System);
+		print_node(&System, 1);
 	}
-
-	hg_states_free(&nodes);
 }
 
 static void print_headings(void)
@@ -364,19 +434,58 @@ static void print_headings(void)
 	PRINT_line("%-78s\n", _("     PID     SHARED    PRIVATE COMMAND"));
 }
 
+/*
+ * only tasks with a non-zero HugetlbPages in /proc/<pid>/status are worth a
+ * smaps_rollup read, which walks each of their page tables
+ */
+static struct pids_fetch *fetch_procs(void)
+{
+	struct pids_fetch *pre;
+	struct pids_stack *stack;
+	int n = 0;
+
+	if (!prefilter)
+		return procps_pids_reap(Pids_ctx, PIDS_FETCH_TASKS_ONLY);
+
+	if (!(pre = procps_pids_reap(Pre_ctx, PIDS_FETCH_TASKS_ONLY)))
+		return NULL;
+
+	for (int i = 0; i < pre->counts->total; i++) {
+		stack = pre->stacks[i];
+		if (!PIDS_VAL(PRE_VM_HUGETLB, ul_int, stack))
+			continue;
+		if (n >= Pre_alloc) {
+			Pre_alloc = Pre_alloc ? Pre_alloc * 2 : 64;
+			Pre_pids = xrealloc(Pre_pids, sizeof(*Pre_pids) * Pre_alloc);
+		}
+		Pre_pids[n++] = PIDS_VAL(PRE_PID, s_int, stack);
+	}
+
+	/* nothing uses huge pages, so there's nothing else to read */
+	if (!n)
+		return NULL;
+
+	return procps_pids_select(Pids_ctx, Pre_pids, n, PIDS_SELECT_PID);
+}
+
 static void print_procs(void)
 {
-	struct pids_info *info = NULL;
+	struct pids_fetch *fetch;
 	struct pids_stack *stack;
-	unsigned long long shared_hugepages;
-	unsigned long long private_hugepages;
+	unsigned long shared_hugepages;
+	unsigned long private_hugepages;
 	char *line = calloc(cols, sizeof(char));
 	int bytes = 0;
 
-	procps_pids_new(&info, Items, ITEMS_COUNT);
-	while ((stack = procps_pids_get(info, PIDS_FETCH_TASKS_ONLY))) {
-		shared_hugepages = PIDS_GETULL(SMAP_HUGE_TLBSHR);
-		private_hugepages = PIDS_GETULL(SMAP_HUGE_TLBPRV);
+	if (!(fetch = fetch_procs())) {
+		free(line);
+		return;
+	}
+
+	for (int i = 0; i < fetch->counts->total; i++) {
+		stack = fetch->stacks[i];
+		shared_hugepages = PIDS_GETUL(SMAP_HUGE_TLBSHR);
+		private_hugepages = PIDS_GETUL(SMAP_HUGE_TLBPRV);
 
 		/* no huge pages in use, skip it */
 		if (shared_hugepages + private_hugepages == 0)
@@ -394,7 +503,6 @@ static void print_procs(void)
 
 		PRINT_line("%s\n", line);
 	}
-	procps_pids_unref(&info);
 
 	free(line);
 }
@@ -470,6 +578,9 @@ int main(int argc, char **argv)
 	}
 
 	setup_hugepage();
+	/* the directory layout doesn't change, so scan it just once */
+	hg_states_new(&Nodes, &System);
+	setup_procs();
 
 	if (!run_once) {
 		is_tty = isatty(STDIN_FILENO);
@@ -529,5 +640,7 @@ int main(int argc, char **argv)
 		endwin();
 	}
 
+	procps_pids_unref(&Pre_ctx);
+	procps_pids_unref(&Pids_ctx);
 	return 0;
 }
@@ -28,9 +28,11 @@
 #include <ctype.h>
 
 #include "c.h"
+#include "pidfd.h"
 #include "signals.h"
 #include "strutils.h"
 #include "nls.h"
+#include "xalloc.h"
 
 /* kill help */
 static void __attribute__ ((__noreturn__)) print_usage(FILE * out)
@@ -43,6 +45,8 @@ static void __attribute__ ((__noreturn__)) print_usage(FILE * out)
     fputs(_(" -<signal>, -s, --signal <signal>\n"
         "                        specify the <signal> to be sent\n"), out);
     fputs(_(" -q, --queue <value>    integer value to be sent with the signal\n"), out);
+    fputs(_("     --kill-after <secs>\n"
+        "                        send SIGKILL to any <pid> still running after secs\n"), out);
     fputs(_(" -l, --list=[<signal>]  list all signal names, or convert one to a name\n"), out);
     fputs(_(" -L, --table            list all signal names in a nice table\n"), out);
     fputs(USAGE_SEPARATOR, out);
@@ -64,12 +68,17 @@ int main(int argc, char **argv)
 {
     int signo, i;
     long pid;
+    struct pidfd_task *tasks;
+    double kill_after = -1;
     int exitvalue = EXIT_SUCCESS;
     int optindex;
     union sigval sigval;
     bool use_sigqueue = false;
     char *sig_option;
 
+    enum {
+        KILL_AFTER_OPTION = CHAR_MAX + 1
+    };
     static const struct option longopts[] = {
         {"list", optional_argument, NULL, 'l'},
         {"table", no_argument, NULL, 'L'},
@@ -77,6 +86,7 @@ int main(int argc, char **argv)
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'V'},
         {"queue", required_argument, NULL, 'q'},
+        {"kill-after", required_argument, NULL, KILL_AFTER_OPTION},
         {NULL, 0, NULL, 0}
     };
 
@@ -127,6 +137,11 @@ int main(int argc, char **argv)
             sigval.sival_int = strtol_or_err(optarg, _("must be an integer value to be passed with the signal."));
 	    use_sigqueue = true;
 	    break;
+        case KILL_AFTER_OPTION:
+            kill_after = strtod_or_err(optarg, _("invalid number of seconds"));
+            if (kill_after < 0)
+                xerrx(EXIT_FAILURE, _("invalid number of seconds"));
+            break;
         case '?':
             if (!isdigit(optopt)) {
                 xwarnx(_("invalid argument %c"), optopt);
@@ -150,14 +165,29 @@ int main(int argc, char **argv)
     if (argc < 1)
         print_usage(stderr);
 
+    /* a pidfd keeps each pid from being recycled while it's being waited upon */
+    tasks = xcalloc(argc, sizeof *tasks);
     for (i = 0; i < argc; i++) {
         pid = strtol_or_err(argv[i], _("failed to parse argument"));
-        if (!execute_kill((pid_t) pid, signo, use_sigqueue, sigval))
+        if (pid > 0) {
+            if (!pidfd_task_open(&tasks[i], (pid_t) pid, 0)
+            && !pidfd_task_signal(&tasks[i], signo, use_sigqueue ? &sigval : NULL))
+                continue;
+        } else if (!execute_kill((pid_t) pid, signo, use_sigqueue, sigval))
             continue;
         error(0, errno, "(%ld)", pid);
+        pidfd_task_close(&tasks[i]);
         exitvalue = EXIT_FAILURE;
         continue;
     }
+    if (kill_after >= 0 && pidfd_tasks_wait(tasks, argc, kill_after)) {
+        for (i = 0; i < argc; i++)
+            if (tasks[i].pid && pidfd_task_signal(&tasks[i], SIGKILL, NULL))
+                error(0, errno, "(%ld)", (long)tasks[i].pid);
+    }
+    for (i = 0; i < argc; i++)
+        pidfd_task_close(&tasks[i]);
+    free(tasks);
 
     return exitvalue;
 }
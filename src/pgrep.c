@@ -44,9 +44,6 @@
 
 #ifdef ENABLE_PIDWAIT
 #include <sys/epoll.h>
-#ifndef HAVE_PIDFD_OPEN
-#include <sys/syscall.h>
-#endif /* !HAVE_PIDFD_OPEN */
 #endif
 
 /* EXIT_SUCCESS is 0 */
@@ -58,7 +55,9 @@
 #include "c.h"
 #include "fileutils.h"
 #include "nls.h"
+#include "pidfd.h"
 #include "signals.h"
+#include "strutils.h"
 #include "xalloc.h"
 
 #include "misc.h"
@@ -107,6 +106,7 @@ static enum {
 struct el {
     long    num;
     char *    str;
+    unsigned long long began;
 };
 
 /* User supplied arguments */
@@ -124,6 +124,7 @@ static int opt_signal = SIGTERM;
 static int opt_case = 0;
 static int opt_echo = 0;
 static int opt_threads = 0;
+static double opt_kill_after = -1;
 static pid_t opt_ns_pid = 0;
 static bool use_sigqueue = false;
 static bool require_handler = false;
@@ -169,6 +170,7 @@ static int __attribute__ ((__noreturn__)) usage(int opt)
         fputs(_(" -H, --require-handler     match only if signal handler is present\n"), fp);
         fputs(_(" -q, --queue <value>       integer value to be sent with the signal\n"), fp);
         fputs(_(" -e, --echo                display what is killed\n"), fp);
+        fputs(_("     --kill-after <secs>   send SIGKILL to those still running after secs\n"), fp);
         break;
 #ifdef ENABLE_PIDWAIT
     case PIDWAIT:
@@ -825,9 +827,11 @@ static struct el * select_procs (int *num)
             }
             if (list && (opt_long || opt_longlong || opt_echo)) {
                 list[matches].num = PIDS_GETINT(PID);
+                list[matches].began = PIDS_GETULL(STARTTIME);
                 list[matches++].str = xstrdup (cmdoutput);
             } else if (list) {
-                list[matches++].num = PIDS_GETINT(PID);
+                list[matches].num = PIDS_GETINT(PID);
+                list[matches++].began = PIDS_GETULL(STARTTIME);
             } else {
                 xerrx(EXIT_FATAL, _("internal error"));
             }
@@ -875,13 +879,6 @@ static int signal_option(int *argc, char **argv)
     return -1;
 }
 
-#if defined(ENABLE_PIDWAIT) && !defined(HAVE_PIDFD_OPEN)
-static int pidfd_open (pid_t pid, unsigned int flags)
-{
-	return syscall(__NR_pidfd_open, pid, flags);
-}
-#endif
-
 static void parse_opts (int argc, char **argv)
 {
     char opts[64] = "";
@@ -896,6 +893,7 @@ static void parse_opts (int argc, char **argv)
         NSLIST_OPTION,
         CGROUP_OPTION,
         ENV_OPTION,
+        KILL_AFTER_OPTION,
     };
     static const struct option longopts[] = {
         {"signal", required_argument, NULL, SIGNAL_OPTION},
@@ -929,6 +927,7 @@ static void parse_opts (int argc, char **argv)
         {"queue", required_argument, NULL, 'q'},
         {"runstates", required_argument, NULL, 'r'},
         {"env", required_argument, NULL, ENV_OPTION},
+        {"kill-after", required_argument, NULL, KILL_AFTER_OPTION},
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'V'},
         {NULL, 0, NULL, 0}
@@ -1125,6 +1124,13 @@ static void parse_opts (int argc, char **argv)
                 usage('?');
             ++criteria_count;
             break;
+        case KILL_AFTER_OPTION:
+            if (prog_mode != PKILL)
+                usage ('?');
+            opt_kill_after = strtod_or_err(optarg, _("invalid number of seconds"));
+            if (opt_kill_after < 0)
+                xerrx(EXIT_USAGE, _("invalid number of seconds"));
+            break;
         case 'H':
             require_handler = true;
             ++criteria_count;
@@ -1162,17 +1168,10 @@ static void parse_opts (int argc, char **argv)
                      program_invocation_short_name);
 }
 
-inline static int execute_kill(pid_t pid, int sig_num)
-{
-    if (use_sigqueue)
-        return sigqueue(pid, sig_num, sigval);
-    else
-        return kill(pid, sig_num);
-}
-
 int main (int argc, char **argv)
 {
     struct el *procs;
+    struct pidfd_task *tasks;
     int num;
     int i;
     int kill_count = 0;
@@ -1206,18 +1205,37 @@ int main (int argc, char **argv)
         }
         return !num;
     case PKILL:
+        /* hold every match first, so no recycled pid can be signalled */
+        tasks = xcalloc(num ? num : 1, sizeof *tasks);
+        for (i = 0; i < num; i++)
+            pidfd_task_open(&tasks[i], procs[i].num, procs[i].began);
         for (i = 0; i < num; i++) {
-            if (execute_kill (procs[i].num, opt_signal) != -1) {
+            if (!tasks[i].pid)
+                 /* gone now, which is OK */
+                continue;
+            if (pidfd_task_signal(&tasks[i], opt_signal, use_sigqueue ? &sigval : NULL) != -1) {
                 if (opt_echo)
                     printf(_("%s killed (pid %lu)\n"), procs[i].str, procs[i].num);
                 kill_count++;
                 continue;
             }
-            if (errno==ESRCH)
-                 /* gone now, which is OK */
-                continue;
-            xwarn(_("killing pid %ld failed"), procs[i].num);
+            if (errno != ESRCH)
+                xwarn(_("killing pid %ld failed"), procs[i].num);
+            pidfd_task_close(&tasks[i]);
+        }
+        if (kill_count && opt_kill_after >= 0
+        && pidfd_tasks_wait(tasks, num, opt_kill_after)) {
+            for (i = 0; i < num; i++) {
+                if (!tasks[i].pid
+                || pidfd_task_signal(&tasks[i], SIGKILL, NULL) == -1)
+                    continue;
+                if (opt_echo)
+                    printf(_("%s killed with SIGKILL (pid %lu)\n"), procs[i].str, procs[i].num);
+            }
         }
+        for (i = 0; i < num; i++)
+            pidfd_task_close(&tasks[i]);
+        free(tasks);
         if (opt_count)
             fprintf(stdout, "%d\n", num);
         return !kill_count;
@@ -172,6 +172,7 @@ makEXT(SUPGIDS)
 makEXT(SUPGROUPS)
 makEXT(TICS_ALL)
 makEXT(TICS_ALL_C)
+makEXT(TICS_ALL_DELTA)
 makEXT(TIME_ALL)
 makEXT(TIME_ELAPSED)
 makEXT(TICS_BEGAN)
@@ -470,6 +471,10 @@ extern int             page_size;  // "int" for math reasons?
 extern unsigned        personality;
 extern int             prefer_bsd_defaults;
 extern int             running_only;
+extern int             sample_count;
+extern double          sample_elapsed;
+extern double          sample_interval;
+extern int             sample_stamp;
 extern int             screen_cols;
 extern int             screen_rows;
 extern selection_node *selection_list;
@@ -499,6 +504,8 @@ extern void reset_sortformat(void);
 /* select.c */
 extern int want_this_proc(proc_t *buf);
 extern const char *select_bits_setup(void);
+extern void select_lists_setup(void);
+extern int select_pids_only(void);
 
 /* signames.c */
 int print_signame(char *restrict const outbuf, const char *restrict const sig, const size_t len);
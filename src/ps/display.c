@@ -21,12 +21,14 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <errno.h>
 #include <grp.h>
 #include <locale.h>
 #include <pwd.h>
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <sys/sysmacros.h>
@@ -289,11 +291,54 @@ static void value_this_proc_pcpu(proc_t *buf){
   }
 }
 
+#define SELECT_MAX  255    // per select, see FILL_ID_MAX in library/pids.c
+
+/***** ascending order for the -p list handed to the library */
+static int pid_compare(const void *a, const void *b){
+  unsigned pa = *(const unsigned *)a, pb = *(const unsigned *)b;
+  return (pa > pb) - (pa < pb);
+}
+
+/***** plain -p list, so read only those pids, in /proc (ascending) order */
+static void select_spew(int n){
+  struct pids_fetch *pidread;
+  unsigned *pidlist = xcalloc(n, sizeof(unsigned));
+  proc_t *buf;
+  int i, j, chunk;
+
+  for (i = j = 0; i < n; i++)
+    if (selection_list->u[i].pid > 0)
+      pidlist[j++] = selection_list->u[i].pid;
+  qsort(pidlist, j, sizeof(unsigned), pid_compare);
+  for (n = j, i = j = 0; i < n; i++)
+    if (!j || pidlist[i] != pidlist[j-1])
+      pidlist[j++] = pidlist[i];
+  n = j;
+  // the library accepts a limited number of pids with each select
+  for (i = 0; i < n; i += chunk) {
+    chunk = (n - i > SELECT_MAX) ? SELECT_MAX : n - i;
+    pidread = procps_pids_select(Pids_info, pidlist + i, chunk, PIDS_SELECT_PID);
+    if (!pidread) {
+      fprintf(stderr, _("fatal library error, reap\n"));
+      exit(EXIT_FAILURE);
+    }
+    for (j = 0; j < pidread->counts->total; j++) {
+      buf = pidread->stacks[j];
+      // a listed thread id is not a process, just as with a reap
+      if (rSv(ID_PID, s_int, buf) != rSv(ID_TGID, s_int, buf))
+        continue;
+      if (want_this_proc(buf))
+        show_one_proc(buf, proc_format_list);
+    }
+  }
+  free(pidlist);
+}
+
 /***** just display */
 static void simple_spew(void){
   struct pids_fetch *pidread;
   proc_t *buf;
-  int i;
+  int i, n;
 
   // -q option (only single SEL_PID_QUICK typecode entry expected in the list, if present)
   if (selection_list && selection_list->typecode == SEL_PID_QUICK) {
@@ -305,6 +350,10 @@ static void simple_spew(void){
       ? PIDS_SELECT_PID_THREADS : PIDS_SELECT_PID;
     pidread = procps_pids_select(Pids_info, pidlist, selection_list->n, which);
     free(pidlist);
+  } else if ((thread_flags & (TF_show_proc|TF_loose_tasks|TF_show_task)) == TF_show_proc
+  && (n = select_pids_only())) {
+    select_spew(n);
+    return;
   } else {
     enum pids_fetch_type which;
     which = (thread_flags & (TF_loose_tasks|TF_show_task))
@@ -493,10 +542,10 @@ static void fancy_spew(void){
       processes[n++] = buf;
   }
   if (n) {
-    if(forest_type) prep_forest_sort();
-    while(sort_list) {
-      procps_pids_sort(Pids_info, processes, n, sort_list->sr, sort_list->reverse);
-      sort_list = sort_list->next;
+    sort_node *s_node = sort_list;
+    while(s_node) {
+      procps_pids_sort(Pids_info, processes, n, s_node->sr, s_node->reverse);
+      s_node = s_node->next;
     }
     if(forest_type) show_forest(n);
     else show_proc_array(n);
@@ -548,6 +597,12 @@ static void arg_check_conflicts(void)
     exit(1);
   }
 
+  /* the %cpu deltas between samples never include dead children */
+  if (include_dead_children && (sample_interval > 0 || sample_count)) {
+    fprintf(stderr, "S/--cumulative cannot be used together with --interval or --count.\n");
+    exit(1);
+  }
+
 }
 
 static void finalize_stacks (void)
@@ -601,6 +656,9 @@ static void finalize_stacks (void)
   // special items with 'extra' used as former pcpu
   chkREL(extra)
   chkREL(noop)
+  // with --interval, %cpu comes from the tics since the prior sample
+  if (sample_interval > 0)
+    chkREL(TICS_ALL_DELTA)
 
   // now accommodate any results not yet satisfied
   f_node = format_list;
@@ -617,6 +675,43 @@ static void finalize_stacks (void)
   procps_pids_reset(Pids_info, Pids_items, Pids_index);
 }
 
+/***** with --timestamp, say when each sample was taken */
+static void show_stamp(void){
+  char buf[64];
+  time_t now = time(NULL);
+
+  if(!strftime(buf, sizeof(buf), "%F %T", localtime(&now))) *buf = '\0';
+  printf("%s\n", buf);
+}
+
+/***** once %cpu is per interval, sort on the tics which yield it */
+static void sort_by_delta(void){
+  sort_node *s_node = sort_list;
+  while(s_node){
+    if(s_node->sr == PIDS_UTILIZATION || s_node->sr == PIDS_UTILIZATION_C)
+      s_node->sr = PIDS_TICS_ALL_DELTA;
+    s_node = s_node->next;
+  }
+}
+
+/***** sleep out what remains of the --interval, noting the secs elapsed */
+static void sample_wait(struct timespec *then){
+  struct timespec now, nap;
+  double left;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  left = sample_interval - ((now.tv_sec - then->tv_sec) + (now.tv_nsec - then->tv_nsec) / 1e9);
+  if(left > 0){
+    nap.tv_sec = (time_t)left;
+    nap.tv_nsec = (left - nap.tv_sec) * 1e9;
+    while(nanosleep(&nap, &nap) && errno == EINTR)
+      ;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  sample_elapsed = (now.tv_sec - then->tv_sec) + (now.tv_nsec - then->tv_nsec) / 1e9;
+  *then = now;
+}
+
 /***** no comment */
 int main(int argc, char *argv[]){
   atexit(close_stdout);
@@ -662,6 +757,7 @@ int main(int argc, char *argv[]){
 
   /* check for invalid combination of arguments */
   arg_check_conflicts();
+  select_lists_setup();
 
 /*  arg_show(); */
   trace("screen is %ux%u\n",screen_cols,screen_rows);
@@ -669,12 +765,35 @@ int main(int argc, char *argv[]){
   trace("======= ps output follows =======\n");
 
   init_output(); /* must be between parser and output */
+  if(sample_count && sample_interval <= 0) sample_interval = 1;
 
   finalize_stacks();
   lists_and_needs();
 
-  if(forest_type || sort_list) fancy_spew(); /* sort or forest */
-  else simple_spew(); /* no sort, no forest */
+  if(forest_type) prep_forest_sort();
+
+  if(sample_interval > 0){
+    /* the Pids_info, its stacks and the lists above all persist, only
+       the reap, sort and output are repeated with each sample */
+    struct timespec then;
+    int headed = lines_to_next_header; /* each sample gets a header, if any */
+    int samples = 0;
+    clock_gettime(CLOCK_MONOTONIC, &then);
+    for(;;){
+      lines_to_next_header = headed;
+      if(sample_stamp) show_stamp();
+      if(forest_type || sort_list) fancy_spew(); /* sort or forest */
+      else simple_spew(); /* no sort, no forest */
+      fflush(stdout);
+      if(sample_count && ++samples >= sample_count) break;
+      sample_wait(&then);
+      sort_by_delta();
+    }
+  }else{
+    if(sample_stamp) show_stamp();
+    if(forest_type || sort_list) fancy_spew(); /* sort or forest */
+    else simple_spew(); /* no sort, no forest */
+  }
   show_one_proc((proc_t *)-1,format_list); /* no output yet? */
 
   procps_pids_unref(&Pids_info);
@@ -150,6 +150,7 @@ makREL(SUPGIDS)
 makREL(SUPGROUPS)
 makREL(TICS_ALL)
 makREL(TICS_ALL_C)
+makREL(TICS_ALL_DELTA)
 makREL(TIME_ALL)
 makREL(TIME_ELAPSED)
 makREL(TICS_BEGAN)
@@ -195,6 +196,10 @@ int             lines_to_next_header = -1;
 char           *lstart_format = NULL;
 int             negate_selection = -1;
 int             running_only = -1;
+int             sample_count = -1;
+double          sample_elapsed = -1;
+double          sample_interval = -1;
+int             sample_stamp = -1;
 int             page_size = -1;  // "int" for math reasons?
 unsigned        personality = 0xffffffff;
 int             prefer_bsd_defaults = -1;
@@ -530,6 +535,10 @@ void reset_global(void){
   negate_selection      = 0;
   page_size             = getpagesize();
   running_only          = 0;
+  sample_count          = 0;   /* --count, 0 is forever */
+  sample_elapsed        = 0;   /* secs since the prior sample, once there is one */
+  sample_interval       = 0;   /* --interval, 0 is just the once */
+  sample_stamp          = 0;   /* --timestamp */
   selection_list        = NULL;
   simple_select         = 0;
   sort_list             = NULL;
@@ -172,6 +172,10 @@ void do_help (const char *opt, int rc) {
     fputs(_("  c                   show true command name\n"), out);
     fputs(_("  e                   show the environment after command\n"), out);
     fputs(_("  k,    --sort        specify sort order as: [+|-]key[,[+|-]key[,...]]\n"), out);
+    fputs(_("     --interval <secs>\n"
+      "                      repeat, showing %cpu over each interval\n"), out);
+    fputs(_("     --count <num>    stop after this many samples\n"), out);
+    fputs(_("     --timestamp      show the time before each sample\n"), out);
     fputs(_("  L                   show format specifiers\n"), out);
     fputs(_("  n                   display numeric uid and wchan\n"), out);
     fputs(_("  S,    --cumulative  include some dead child process data\n"), out);
@@ -260,6 +260,20 @@ static int escape_str (char *dst, const char *src, int bufsize, int *maxcells) {
   return my_bytes;        // bytes of text, excluding the NUL
 }
 
+/*
+ * A string result which the library escaped, and found to be pure ASCII,
+ * can just be copied, one cell per byte, without walking it again here */
+static int escape_result (char *dst, const proc_t *pp, int rel, int bufsize, int *maxcells) {
+  const char *src = PIDS_VAL(rel, str, pp);
+  int ascii;
+
+  if (procps_pids_str_cols(pp, rel, &ascii) >= 0 && ascii)
+    return escaped_copy(dst, src, bufsize, maxcells);
+  return escape_str(dst, src, bufsize, maxcells);
+}
+#define escape_rSv(E, dst, bufsize, maxcells) \
+  escape_result(dst, pp, rel_ ## E, bufsize, maxcells)
+
 /***************************************************************************/
 /************ Lots of format functions, starting with the NOP **************/
 
@@ -415,15 +429,15 @@ setREL3(CMDLINE,CMD,ENVIRON)
   endp += fh;
   rightward -= fh;
   if (!bsd_c_option)
-    endp += escape_str(endp, rSv(CMDLINE, str, pp), OUTBUF_SIZE_AT(endp), &rightward);
+    endp += escape_rSv(CMDLINE, endp, OUTBUF_SIZE_AT(endp), &rightward);
   else
-    endp += escape_str(endp, rSv(CMD, str, pp), OUTBUF_SIZE_AT(endp), &rightward);
+    endp += escape_rSv(CMD, endp, OUTBUF_SIZE_AT(endp), &rightward);
   if(bsd_e_option && rightward>1) {
     char *e = rSv(ENVIRON, str, pp);
     if(*e != '-' || *(e+1) != '\0') {
       *endp++ = ' ';
       rightward--;
-      escape_str(endp, e, OUTBUF_SIZE_AT(endp), &rightward);
+      escape_rSv(ENVIRON, endp, OUTBUF_SIZE_AT(endp), &rightward);
     }
   }
   return max_rightward-rightward;
@@ -443,15 +457,15 @@ setREL3(CMD,CMDLINE,ENVIRON)
   endp += fh;
   rightward -= fh;
   if(unix_f_option)
-    endp += escape_str(endp, rSv(CMDLINE, str, pp), OUTBUF_SIZE_AT(endp), &rightward);
+    endp += escape_rSv(CMDLINE, endp, OUTBUF_SIZE_AT(endp), &rightward);
   else
-    endp += escape_str(endp, rSv(CMD, str, pp), OUTBUF_SIZE_AT(endp), &rightward);
+    endp += escape_rSv(CMD, endp, OUTBUF_SIZE_AT(endp), &rightward);
   if(bsd_e_option && rightward>1) {
     char *e = rSv(ENVIRON, str, pp);
     if(*e != '-' || *(e+1) != '\0') {
       *endp++ = ' ';
       rightward--;
-      escape_str(endp, e, OUTBUF_SIZE_AT(endp), &rightward);
+      escape_rSv(ENVIRON, endp, OUTBUF_SIZE_AT(endp), &rightward);
     }
   }
   return max_rightward-rightward;
@@ -461,7 +475,7 @@ static int pr_cgname(char *restrict const outbuf,const proc_t *restrict const pp
   int rightward;
 setREL1(CGNAME)
   rightward = max_rightward;
-  escape_str(outbuf, rSv(CGNAME, str, pp), OUTBUF_SIZE, &rightward);
+  escape_rSv(CGNAME, outbuf, OUTBUF_SIZE, &rightward);
   return max_rightward-rightward;
 }
 
@@ -469,7 +483,7 @@ static int pr_cgroup(char *restrict const outbuf,const proc_t *restrict const pp
   int rightward;
 setREL1(CGROUP)
   rightward = max_rightward;
-  escape_str(outbuf, rSv(CGROUP, str, pp), OUTBUF_SIZE, &rightward);
+  escape_rSv(CGROUP, outbuf, OUTBUF_SIZE, &rightward);
   return max_rightward-rightward;
 }
 
@@ -485,7 +499,7 @@ setREL1(CMD)
   rightward -= fh;
   if (rightward>8)  /* 8=default, but forest maybe feeds more */
     rightward = 8;
-  endp += escape_str(endp, rSv(CMD, str, pp), OUTBUF_SIZE_AT(endp), &rightward);
+  endp += escape_rSv(CMD, endp, OUTBUF_SIZE_AT(endp), &rightward);
   //return endp - outbuf;
   return max_rightward-rightward;
 }
@@ -521,14 +535,20 @@ setREL1(TIME_ELAPSED)
   return snprintf(outbuf, COLWID, "%u", t);
 }
 
+/* %cpu in tenths, since the prior sample once --interval has one */
+static unsigned pcpu_tenths(const proc_t *restrict const pp){
+  if (sample_elapsed > 0)
+    return rSv(TICS_ALL_DELTA, u_int, pp) * 1000.0 / Hertz / sample_elapsed;
+  if (include_dead_children)
+    return rSv(UTILIZATION_C, real, pp) * 10ULL;
+  return rSv(UTILIZATION, real, pp) * 10ULL;
+}
+
 /* "Processor utilisation for scheduling."  --- we use %cpu w/o fraction */
 static int pr_c(char *restrict const outbuf, const proc_t *restrict const pp){
   unsigned pcpu = 0;                   /* scaled %cpu, 99 means 99% */
 setREL2(UTILIZATION,UTILIZATION_C)
-  if (include_dead_children)
-    pcpu = rSv(UTILIZATION_C, real, pp);
-  else
-    pcpu = rSv(UTILIZATION, real, pp);
+  pcpu = pcpu_tenths(pp) / 10U;
   if (pcpu > 99U) pcpu = 99U;
   return snprintf(outbuf, COLWID, "%2u", pcpu);
 }
@@ -537,10 +557,7 @@ setREL2(UTILIZATION,UTILIZATION_C)
 static int pr_pcpu(char *restrict const outbuf, const proc_t *restrict const pp){
   unsigned pcpu = 0;               /* scaled %cpu, 999 means 99.9% */
 setREL2(UTILIZATION,UTILIZATION_C)
-  if (include_dead_children)
-    pcpu = rSv(UTILIZATION_C, real, pp) * 10ULL;
-  else
-    pcpu = rSv(UTILIZATION, real, pp) * 10ULL;
+  pcpu = pcpu_tenths(pp);
   if (pcpu > 999U)
     return snprintf(outbuf, COLWID, "%u", pcpu/10U);
   return snprintf(outbuf, COLWID, "%u.%u", pcpu/10U, pcpu%10U);
@@ -550,10 +567,7 @@ setREL2(UTILIZATION,UTILIZATION_C)
 static int pr_cp(char *restrict const outbuf, const proc_t *restrict const pp){
   unsigned pcpu = 0;                /* scaled %cpu, 999 means 99.9% */
 setREL2(UTILIZATION,UTILIZATION_C)
-  if (include_dead_children)
-    pcpu = rSv(UTILIZATION_C, real, pp) * 10ULL;
-  else
-    pcpu = rSv(UTILIZATION, real, pp) * 10ULL;
+  pcpu = pcpu_tenths(pp);
   if (pcpu > 999U) pcpu = 999U;
   return snprintf(outbuf, COLWID, "%3u", pcpu);
 }
@@ -879,7 +893,7 @@ setREL1(ENVIRON)
     char *e = rSv(ENVIRON, str, pp);
 
     if(e[0] != '-' || e[1] != '\0') {
-      escape_str(endp, e, OUTBUF_SIZE_AT(endp), &rightward);
+      escape_rSv(ENVIRON, endp, OUTBUF_SIZE_AT(endp), &rightward);
     }
     return max_rightward-rightward;
 }
@@ -1367,7 +1381,7 @@ static int pr_exe(char *restrict const outbuf, const proc_t *restrict const pp){
   int rightward;
 setREL1(EXE)
   rightward = max_rightward;
-  escape_str(outbuf, rSv(EXE, str, pp), OUTBUF_SIZE, &rightward);
+  escape_rSv(EXE, outbuf, OUTBUF_SIZE, &rightward);
   return max_rightward-rightward;
 }
 
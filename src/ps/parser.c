@@ -807,6 +807,7 @@ static const char *parse_gnu_option(void){
   {"cols",          &&case_cols},
   {"columns",       &&case_columns},
   {"context",       &&case_context},
+  {"count",         &&case_count},
   {"cumulative",    &&case_cumulative},
   {"date-format",   &&case_dateformat},
   {"deselect",      &&case_deselect},    /* -N */
@@ -819,6 +820,7 @@ static const char *parse_gnu_option(void){
   {"headings",      &&case_headings},
 //{"help",          &&case_help},        /* now TRANSLATABLE ! */
   {"info",          &&case_info},
+  {"interval",      &&case_interval},
   {"lines",         &&case_lines},
   {"no-header",     &&case_no_header},
   {"no-headers",    &&case_no_headers},
@@ -835,6 +837,7 @@ static const char *parse_gnu_option(void){
   {"sid",           &&case_sid},
   {"signames",      &&case_signames},
   {"sort",          &&case_sort},
+  {"timestamp",     &&case_timestamp},
   {"tty",           &&case_tty},
   {"user",          &&case_user},        /* euid */
   {"version",       &&case_version},
@@ -892,6 +895,19 @@ static const char *parse_gnu_option(void){
       }
     }
     return _("number of columns must follow --cols, --width, or --columns");
+  case_count:
+    trace("--count\n");
+    arg = grab_gnu_arg();
+    if(arg && *arg){
+      long t;
+      char *endptr;
+      t = strtol(arg, &endptr, 0);
+      if(!*endptr && (t>0) && (t<2000000000)){
+        sample_count = (int)t;
+        return NULL;
+      }
+    }
+    return _("number of samples must follow --count");
   case_cumulative:
     trace("--cumulative\n");
     if(s[sl]) return _("option --cumulative does not take an argument");
@@ -959,6 +975,19 @@ static const char *parse_gnu_option(void){
     self_info();
     exit(0);
     return NULL;
+  case_interval:
+    trace("--interval\n");
+    arg = grab_gnu_arg();
+    if(arg && *arg){
+      double t;
+      char *endptr;
+      t = strtod(arg, &endptr);
+      if(!*endptr && (t>0) && (t<2000000000)){
+        sample_interval = t;
+        return NULL;
+      }
+    }
+    return _("number of seconds must follow --interval");
   case_pid:
     trace("--pid\n");
     arg = grab_gnu_arg();
@@ -1015,6 +1044,11 @@ static const char *parse_gnu_option(void){
     if(!arg) return _("long sort specification must follow --sort");
     defer_sf_option(arg, SF_G_sort);
     return NULL;
+  case_timestamp:
+    trace("--timestamp\n");
+    if(s[sl]) return _("option --timestamp does not take an argument");
+    sample_stamp = 1;
+    return NULL;
   case_tty:
     trace("--tty\n");
     arg = grab_gnu_arg();
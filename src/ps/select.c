@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "xalloc.h"
 #include "common.h"
 
 //#define process_group_leader(p) (rSv(ID_PID, s_int, p) == rSv(ID_TGID, s_int, p))
@@ -84,53 +85,183 @@ static int table_accept(proc_t *buf){
   return (select_bits & (1<<proc_index));
 }
 
-/***** selected by some kind of list? */
-static int proc_was_listed(proc_t *buf){
+/***** hashed copies of the selection lists */
+/* With lists holding thousands of entries (ps -p $(cat pids), ps -C a,b,...)
+ * a linear search per process becomes the dominant cost, so each list is
+ * compiled once after parsing into an open addressed table of indexes into
+ * the original sel_union array.  A zero slot is empty, others hold index+1. */
+typedef struct sel_set {
+  struct sel_set *next;
+  const sel_union *u;
+  int typecode;
+  unsigned mask;
+  unsigned *slots;
+  unsigned *slots15;   /* SEL_COMM only, names of 15 or more characters */
+} sel_set;
+
+static sel_set *sel_sets;
+
+#define COMM_KEY_MAX  63    /* the strncmp limit used for comm matching */
+#define COMM_TRUNC    15    /* a task's comm is truncated at this length */
+
+static inline unsigned hash_num(unsigned num){
+  return num * 2654435761u;
+}
+
+static unsigned hash_str(const char *str, int len){
+  unsigned h = 2166136261u;
+  while(len-- && *str){
+    h ^= (unsigned char)*str++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/* the value a list entry is compared against, as return_if_match once did */
+static unsigned sel_key(int typecode, const sel_union *u){
+  switch(typecode){
+  case SEL_RUID: case SEL_EUID: case SEL_SUID: case SEL_FUID:
+    return (unsigned)u->uid;
+  case SEL_RGID: case SEL_EGID: case SEL_SGID: case SEL_FGID:
+    return (unsigned)u->gid;
+  case SEL_PPID:
+    return (unsigned)u->ppid;
+  case SEL_TTY:
+    return (unsigned)u->tty;
+  case SEL_PGRP: case SEL_PID: case SEL_PID_QUICK: case SEL_SESS:
+    return (unsigned)u->pid;
+  default:
+    catastrophic_failure(__FILE__, __LINE__, _("please report this bug"));
+  }
+  return 0;
+}
+
+static void num_insert(sel_set *ss, int i){
+  unsigned key = sel_key(ss->typecode, &ss->u[i]);
+  unsigned h = hash_num(key) & ss->mask;
+  while(ss->slots[h]){
+    if(sel_key(ss->typecode, &ss->u[ss->slots[h]-1]) == key) return;
+    h = (h + 1) & ss->mask;
+  }
+  ss->slots[h] = i + 1;
+}
+
+static int num_lookup(const sel_set *ss, unsigned key){
+  unsigned h = hash_num(key) & ss->mask;
+  unsigned x;
+  while((x = ss->slots[h])){
+    if(sel_key(ss->typecode, &ss->u[x-1]) == key) return 1;
+    h = (h + 1) & ss->mask;
+  }
+  return 0;
+}
+
+static void str_insert(const sel_set *ss, unsigned *slots, int i, int len){
+  const char *name = ss->u[i].cmd;
+  unsigned h = hash_str(name, len) & ss->mask;
+  while(slots[h]){
+    if(!strncmp(ss->u[slots[h]-1].cmd, name, len)) return;
+    h = (h + 1) & ss->mask;
+  }
+  slots[h] = i + 1;
+}
+
+static int str_lookup(const sel_set *ss, const unsigned *slots, const char *name, int len){
+  unsigned h = hash_str(name, len) & ss->mask;
+  unsigned x;
+  while((x = slots[h])){
+    if(!strncmp(ss->u[x-1].cmd, name, len)) return 1;
+    h = (h + 1) & ss->mask;
+  }
+  return 0;
+}
+
+/***** compile selection_list, must follow the parser */
+void select_lists_setup(void){
   selection_node *sn = selection_list;
+  sel_set **tail = &sel_sets;
+  sel_set *ss;
+  unsigned size;
   int i;
-  if(!sn) return 0;
+
   while(sn){
-    switch(sn->typecode){
+    ss = xcalloc(1, sizeof(sel_set));
+    ss->u = sn->u;
+    ss->typecode = sn->typecode;
+    for(size = 8; size < 2u * (unsigned)sn->n; size <<= 1)
+      ;
+    ss->mask = size - 1;
+    ss->slots = xcalloc(size, sizeof(unsigned));
+    if(sn->typecode == SEL_COMM){
+      ss->slots15 = xcalloc(size, sizeof(unsigned));
+      for(i = 0; i < sn->n; i++){
+        str_insert(ss, ss->slots, i, COMM_KEY_MAX);
+        /* special case, comm is 16 characters but match is longer */
+        if(strlen(sn->u[i].cmd) >= COMM_TRUNC)
+          str_insert(ss, ss->slots15, i, COMM_TRUNC);
+      }
+    }else{
+      for(i = 0; i < sn->n; i++)
+        num_insert(ss, i);
+    }
+    *tail = ss;
+    tail = &ss->next;
+    sn = sn->next;
+  }
+}
+
+/***** a plain pid list which the library can fetch directly? */
+/* Returns the pid count or 0 when every process must be read. */
+int select_pids_only(void){
+  if(!selection_list || selection_list->next) return 0;
+  if(selection_list->typecode != SEL_PID) return 0;
+  if(all_processes || simple_select || negate_selection) return 0;
+  return selection_list->n;
+}
+
+/***** selected by some kind of list? */
+static int proc_was_listed(proc_t *buf){
+  const sel_set *ss = sel_sets;
+  const char *comm;
+  if(!ss) return 0;
+  while(ss){
+    switch(ss->typecode){
     default:
       catastrophic_failure(__FILE__, __LINE__, _("please report this bug"));
 
-#define return_if_match(foo,bar) \
-        i=sn->n; while(i--) \
-        if((unsigned)foo == (unsigned)(*(sn->u+i)).bar) \
+#define return_if_match(foo) \
+        if(num_lookup(ss, (unsigned)foo)) \
         return 1
 
-    break; case SEL_RUID: return_if_match(rSv(ID_RUID, u_int, buf),uid);
-    break; case SEL_EUID: return_if_match(rSv(ID_EUID, u_int, buf),uid);
-    break; case SEL_SUID: return_if_match(rSv(ID_SUID, u_int, buf),uid);
-    break; case SEL_FUID: return_if_match(rSv(ID_FUID, u_int, buf),uid);
+    break; case SEL_RUID: return_if_match(rSv(ID_RUID, u_int, buf));
+    break; case SEL_EUID: return_if_match(rSv(ID_EUID, u_int, buf));
+    break; case SEL_SUID: return_if_match(rSv(ID_SUID, u_int, buf));
+    break; case SEL_FUID: return_if_match(rSv(ID_FUID, u_int, buf));
 
-    break; case SEL_RGID: return_if_match(rSv(ID_RGID, u_int, buf),gid);
-    break; case SEL_EGID: return_if_match(rSv(ID_EGID, u_int, buf),gid);
-    break; case SEL_SGID: return_if_match(rSv(ID_SGID, u_int, buf),gid);
-    break; case SEL_FGID: return_if_match(rSv(ID_FGID, u_int, buf),gid);
+    break; case SEL_RGID: return_if_match(rSv(ID_RGID, u_int, buf));
+    break; case SEL_EGID: return_if_match(rSv(ID_EGID, u_int, buf));
+    break; case SEL_SGID: return_if_match(rSv(ID_SGID, u_int, buf));
+    break; case SEL_FGID: return_if_match(rSv(ID_FGID, u_int, buf));
 
-    break; case SEL_PGRP: return_if_match(rSv(ID_PGRP, s_int, buf),pid);
-    break; case SEL_PID : return_if_match(rSv(ID_TGID, s_int, buf),pid);
-    break; case SEL_PID_QUICK : return_if_match(rSv(ID_TGID, s_int, buf),pid);
-    break; case SEL_PPID: return_if_match(rSv(ID_PPID, s_int, buf),ppid);
-    break; case SEL_TTY : return_if_match(rSv(TTY, s_int, buf),tty);
-    break; case SEL_SESS: return_if_match(rSv(ID_SESSION, s_int, buf),pid);
+    break; case SEL_PGRP: return_if_match(rSv(ID_PGRP, s_int, buf));
+    break; case SEL_PID : return_if_match(rSv(ID_TGID, s_int, buf));
+    break; case SEL_PID_QUICK : return_if_match(rSv(ID_TGID, s_int, buf));
+    break; case SEL_PPID: return_if_match(rSv(ID_PPID, s_int, buf));
+    break; case SEL_TTY : return_if_match(rSv(TTY, s_int, buf));
+    break; case SEL_SESS: return_if_match(rSv(ID_SESSION, s_int, buf));
 
     break;
     case SEL_COMM:
-        i=sn->n;
-        while(i--) {
-            /* special case, comm is 16 characters but match is longer */
-            if (strlen(rSv(CMD, str, buf)) == 15 && strlen((*(sn->u+i)).cmd) >= 15)
-                if(!strncmp( rSv(CMD, str, buf), (*(sn->u+i)).cmd, 15 )) return 1;
-            if(!strncmp( rSv(CMD, str, buf), (*(sn->u+i)).cmd, 63 )) return 1;
-        }
-
+        comm = rSv(CMD, str, buf);
+        /* special case, comm is 16 characters but match is longer */
+        if (strlen(comm) == COMM_TRUNC
+        && str_lookup(ss, ss->slots15, comm, COMM_TRUNC)) return 1;
+        if (str_lookup(ss, ss->slots, comm, COMM_KEY_MAX)) return 1;
 
 #undef return_if_match
 
     }
-    sn = sn->next;
+    ss = ss->next;
   }
   return 0;
 }
@@ -43,6 +43,7 @@
 #include "signals.h"
 #include "strutils.h"
 #include "nls.h"
+#include "pidfd.h"
 #include "xalloc.h"
 #include "rpmatch.h"
 
@@ -84,9 +85,10 @@ enum pids_item items[] = {
     PIDS_ID_EUSER,
     PIDS_TTY,
     PIDS_TTY_NAME,
-    PIDS_CMD};
+    PIDS_CMD,
+    PIDS_TICS_BEGAN};
 enum rel_items {
-    EU_PID, EU_EUID, EU_EUSER, EU_TTY, EU_TTYNAME, EU_CMD};
+    EU_PID, EU_EUID, EU_EUSER, EU_TTY, EU_TTYNAME, EU_CMD, EU_BEGAN};
 
 static int my_pid;
 
@@ -171,6 +173,7 @@ static int match_ns(const int pid)
 }
 
 #define PIDS_GETINT(e) PIDS_VAL(EU_ ## e, s_int, stack)
+#define PIDS_GETULL(e) PIDS_VAL(EU_ ## e, ull_int, stack)
 #define PIDS_GETSTR(e) PIDS_VAL(EU_ ## e, str, stack)
 
 static int ask_user(struct pids_stack *stack)
@@ -199,6 +202,7 @@ static int ask_user(struct pids_stack *stack)
 static void nice_or_kill(struct pids_stack *stack,
                          struct run_time_conf_t *run_time)
 {
+    struct pidfd_task task;
     int failed;
 
     if (run_time->interactive && !ask_user(stack))
@@ -206,9 +210,13 @@ static void nice_or_kill(struct pids_stack *stack,
 
     /* do the actual work */
     errno = 0;
-    if (program == PROG_SKILL)
-        failed = kill(PIDS_GETINT(PID), sig_or_pri);
-    else
+    if (program == PROG_SKILL) {
+        /* the scan may be long past (think -i), so be sure it's the same task */
+        failed = pidfd_task_open(&task, PIDS_GETINT(PID), PIDS_GETULL(BEGAN));
+        if (!failed)
+            failed = pidfd_task_signal(&task, sig_or_pri, NULL);
+        pidfd_task_close(&task);
+    } else
         failed = setpriority(PRIO_PROCESS, PIDS_GETINT(PID), sig_or_pri);
     if ((run_time->warnings && failed) || run_time->debugging || run_time->verbose) {
         fprintf(stderr, "%-8s %-8s %5d %-16.16s   ",
@@ -228,6 +236,7 @@ static void nice_or_kill(struct pids_stack *stack,
 }
 
 #undef PIDS_GETINT
+#undef PIDS_GETULL
 #undef PIDS_GETSTR
 
 /* debug function */
@@ -280,7 +289,7 @@ static void scan_procs(struct run_time_conf_t *run_time)
     struct pids_fetch *reap;
     int i, total_procs;
 
-    if (procps_pids_new(&Pids_info, items, 6) < 0)
+    if (procps_pids_new(&Pids_info, items, 7) < 0)
         xerrx(EXIT_FAILURE,
               _("Unable to create pid Pids_info structure"));
     if ((reap = procps_pids_reap(Pids_info, PIDS_FETCH_TASKS_ONLY)) == NULL)
@@ -0,0 +1,175 @@
+/*
+ * test_pidfd -- tasks held by pidfd_task_open, with and without /proc
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include "pidfd.h"
+#include "tests.h"
+
+static int no_proc;
+
+/* every open by pidfd.c lands here, so /proc can be made to vanish */
+int open(const char *path, int flags, ...)
+{
+    va_list ap;
+    int mode = 0;
+
+    if (flags & O_CREAT) {
+        va_start(ap, flags);
+        mode = va_arg(ap, int);
+        va_end(ap);
+    }
+    if (no_proc && !strncmp(path, "/proc/", 6)) {
+        errno = ENOENT;
+        return -1;
+    }
+    return syscall(SYS_openat, AT_FDCWD, path, flags, mode);
+}
+
+static pid_t spawn_sleeper(void)
+{
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        pause();
+        _exit(EXIT_SUCCESS);
+    }
+    return pid;
+}
+
+// true if the child was ended by 'sig', which it then reaps
+static int ended_by(pid_t pid, int sig)
+{
+    int status;
+
+    return (waitpid(pid, &status, 0) == pid
+    && WIFSIGNALED(status) && WTERMSIG(status) == sig);
+}
+
+int check_began_mismatch(void *data)
+{
+    struct pidfd_task task;
+    unsigned long long began;
+    pid_t pid;
+    int ok;
+
+    testname = "pidfd_task_open() refuses a task whose start time differs";
+    if ((pid = spawn_sleeper()) < 0)
+        return 0;
+    ok = (pidfd_task_open(&task, pid, 0) == 0 && task.began);
+    began = task.began;
+    pidfd_task_close(&task);
+    ok = ok && pidfd_task_open(&task, pid, began + 1) < 0 && errno == ESRCH
+        && task.pid == 0;
+    ok = ok && pidfd_task_open(&task, pid, began) == 0
+        && pidfd_task_signal(&task, SIGTERM, NULL) == 0;
+    pidfd_task_close(&task);
+    if (!ok)
+        kill(pid, SIGKILL);
+    return ended_by(pid, ok ? SIGTERM : SIGKILL) && ok;
+}
+
+int check_zombie(void *data)
+{
+    struct pidfd_task task;
+    siginfo_t info;
+    pid_t pid;
+    int ok;
+
+    testname = "pidfd_task_open() signals a zombie, which is then gone";
+    if ((pid = fork()) < 0)
+        return 0;
+    if (pid == 0)
+        _exit(EXIT_SUCCESS);
+    // wait until it's a zombie, without reaping it
+    if (waitid(P_PID, pid, &info, WEXITED | WNOWAIT) < 0)
+        return 0;
+    ok = (pidfd_task_open(&task, pid, 0) == 0
+    && pidfd_task_signal(&task, SIGTERM, NULL) == 0
+    && pidfd_tasks_wait(&task, 1, 5.0) == 0);
+    pidfd_task_close(&task);
+    return (waitpid(pid, NULL, 0) == pid) && ok;
+}
+
+int check_no_proc(void *data)
+{
+    struct pidfd_task task;
+    pid_t pid;
+    int ok;
+
+    testname = "pidfd_task_open() signals a bare pid not found under /proc";
+    if ((pid = spawn_sleeper()) < 0)
+        return 0;
+    no_proc = 1;
+    ok = (pidfd_task_open(&task, pid, 0) == 0 && task.began == 0
+    && pidfd_task_signal(&task, SIGTERM, NULL) == 0);
+    pidfd_task_close(&task);
+    no_proc = 0;
+    if (!ok)
+        kill(pid, SIGKILL);
+    return ended_by(pid, ok ? SIGTERM : SIGKILL) && ok;
+}
+
+int check_no_proc_no_pidfd(void *data)
+{
+    struct pidfd_task task;
+    struct rlimit rl = { 32, 32 };
+    pid_t pid, helper;
+    int status, ok;
+
+    testname = "pidfd_task_open() falls back to kill() with neither /proc nor a pidfd";
+    if ((pid = spawn_sleeper()) < 0)
+        return 0;
+    // a helper that's out of descriptors for good can't have a pidfd
+    if ((helper = fork()) == 0) {
+        no_proc = 1;
+        if (setrlimit(RLIMIT_NOFILE, &rl) < 0)
+            _exit(EXIT_FAILURE);
+        while (dup(STDIN_FILENO) >= 0)
+            ;
+        ok = (pidfd_task_open(&task, pid, 0) == 0 && task.fd < 0
+        && pidfd_task_signal(&task, SIGTERM, NULL) == 0);
+        _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    ok = (helper > 0 && waitpid(helper, &status, 0) == helper
+    && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+    if (!ok)
+        kill(pid, SIGKILL);
+    return ended_by(pid, ok ? SIGTERM : SIGKILL) && ok;
+}
+
+TestFunction test_funcs[] = {
+    check_began_mismatch,
+    check_zombie,
+    check_no_proc,
+    check_no_proc_no_pidfd,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    return run_tests(test_funcs, NULL);
+}
@@ -0,0 +1,126 @@
+/*
+ * test_procio -- count the reads made by fprocopen of a large file
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "procio.h"
+#include "tests.h"
+
+#define FIXTURE_SIZE (4 * 1024 * 1024)
+
+static char fixture[] = "/tmp/test_procio.XXXXXX";
+static char *expect;
+static size_t reads, bytes;
+static int intvec;
+
+/* every read by procio.c lands here rather than in libc */
+ssize_t pread(int fd, void *buf, size_t count, off_t offset)
+{
+    ssize_t n = 0;
+
+    // like the kernel's int vector and bitmap sysctls, EOF unless at 0
+    if (!intvec || !offset)
+        n = syscall(SYS_pread64, fd, buf, count, offset);
+    ++reads;
+    if (n > 0)
+        bytes += n;
+    return n;
+}
+
+static int read_fixture(void)
+{
+    static char chunk[BUFSIZ];
+    FILE *fp;
+    size_t n, tot = 0;
+    int ok = 1;
+
+    reads = bytes = 0;
+    if (!(fp = fprocopen(fixture, "r")))
+        return 0;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        if (tot + n > FIXTURE_SIZE || memcmp(chunk, expect + tot, n))
+            ok = 0;
+        tot += n;
+    }
+    fclose(fp);
+    return ok && tot == FIXTURE_SIZE;
+}
+
+int check_single_pass(void *data)
+{
+    static char name[256];
+    int ok;
+
+    testname = "fprocopen() reads a large file, EOF unless at offset 0";
+    intvec = 1;
+    ok = read_fixture();
+    intvec = 0;
+    if (!ok)
+        return 0;
+    snprintf(name, sizeof(name)
+        , "fprocopen() reads a large file, EOF unless at offset 0, %zu reads of %zu bytes"
+        , reads, bytes);
+    testname = name;
+    /* doubling from BUFSIZ to 4 MiB is at most a dozen or so reads and,
+       since each starts over at offset 0, under 3 times the file's size */
+    return (bytes < 3 * FIXTURE_SIZE && reads < 32);
+}
+
+int check_buffer_reuse(void *data)
+{
+    static char name[256];
+
+    testname = "fprocopen() reuses its grown buffer";
+    if (!read_fixture())
+        return 0;
+    snprintf(name, sizeof(name)
+        , "fprocopen() reuses its grown buffer, %zu reads", reads);
+    testname = name;
+    // one read for the whole file and one more to see the end of it
+    return (bytes == FIXTURE_SIZE && reads == 2);
+}
+
+TestFunction test_funcs[] = {
+    check_single_pass,
+    check_buffer_reuse,
+    NULL };
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    size_t i;
+    int fd, rc;
+
+    if (!(expect = malloc(FIXTURE_SIZE)))
+        return EXIT_FAILURE;
+    // a multi-megabyte 'sysctl' value, as lines of varied length
+    for (i = 0; i < FIXTURE_SIZE; i++)
+        expect[i] = (i % 97 == 96) ? '\n' : 'a' + (i % 23);
+    if ((fd = mkstemp(fixture)) < 0 || !(fp = fdopen(fd, "w"))
+    || fwrite(expect, 1, FIXTURE_SIZE, fp) != FIXTURE_SIZE || fclose(fp)) {
+        perror(fixture);
+        return EXIT_FAILURE;
+    }
+    rc = run_tests(test_funcs, NULL);
+    unlink(fixture);
+    free(expect);
+    return rc;
+}
@@ -51,9 +51,11 @@
 #include "signals.h"
 #include "nls.h"
 
+#include "irq.h"
 #include "meminfo.h"
 #include "misc.h"
 #include "pids.h"
+#include "snapshot.h"
 #include "stat.h"
 
 #include "top.h"
@@ -95,6 +97,13 @@ static const char *Cpu_States_fmts;
 static int Monpids [MONPIDMAX+1] = { 0 };
 static int Monpidsidx = 0;
 
+        /* Lazy thread expansion support, those tasks chosen with 'K'
+           plus those actually expanded during the most recent frame */
+static int Lazy_pids [LAZYPIDMAX];
+static int Lazy_pidsidx = 0;
+static int Lazy_shown [LAZYPIDMAX + LAZYBUSIEST];
+static int Lazy_shownidx = 0;
+
         /* Current screen dimensions.
            note: the number of processes displayed is tracked on a per window
                  basis (see the WIN_t).  Max_lines is the total number of
@@ -147,7 +156,11 @@ static int Batch = 0,           // batch mode, collect no input, dumb output
            Loops = -1,          // number of iterations, -1 loops forever
            Secure_mode = 0,     // set if some functionality restricted
            Width_mode = 0,      // set w/ 'w' - potential output override
-           Thread_mode = 0;     // set w/ 'H' - show threads vs. tasks
+           Thread_mode = 0,     // set w/ 'H' - show threads vs. tasks
+           Thread_lazy = 0,     // set w/ 'K' - show just some tasks' threads
+           Cost_mode = 0,       // set w/ 'D' - show our per frame costs
+           Irq_mode = 0,        // set w/ 'Q' - show the busiest irqs
+           Freq_mode = 0;       // set w/ 'p' - show cpu MHz + deep idle
 
         /* Unchangeable cap's stuff built just once (if at all) and
            thus NOT saved in a WIN_t's RCW_t.  To accommodate 'Batch'
@@ -224,12 +237,16 @@ static int Numa_node_tot;
 static int Numa_node_sel = -1;
 
         /* Support for Graphing of the View_STATES ('t') and View_MEMORY ('m')
-           commands -- which are now both 4-way toggles */
+           commands -- which are now 5-way and 4-way toggles */
 #define GRAPH_length_max  100  // the actual bars or blocks
 #define GRAPH_length_min   10  // the actual bars or blocks
 #define GRAPH_prefix_std   25  // '.......: 100.0/100.0 100['
 #define GRAPH_prefix_abv   12  // '.......:100['
 #define GRAPH_suffix        2  // '] ' (bracket + trailing space)
+#define GRAPH_freqs        19  // ' 9999 MHz, 100.0 dc ' (the 'p' toggle)
+#define GRAPH_heat_map      3  // rc.graph_cpus, each cpu as a single cell
+#define HEAT_prefix         8  // '.......:' (a node or a cpu label)
+#define HEAT_cluster        8  // cells between separating spaces
         // first 3 more static (adj_geometry), last 3 volatile (sum_tics/do_memory)
 struct graph_parms {
    float adjust;               // bars/blocks scaling factor
@@ -271,7 +288,13 @@ static struct pids_info *Pids_ctx;
 static int Pids_itms_tot;                   // same as MAXTBL(Fieldstab)
 static enum pids_item *Pids_itms;           // allocated as MAXTBL(Fieldstab)
 static struct pids_fetch *Pids_reap;        // for reap or select
-#define PIDSmaxt Pids_reap->counts->total   // just a little less wordy
+        // with 'K', the threads of some tasks are also added to the windows
+        // ( they come from a separate context, sharing that same item list )
+static struct pids_info *Thds_ctx;
+static struct pids_fetch *Thds_reap;
+static struct pids_stack **Thds_ppt;        // those stacks, in address order
+static int Thds_total;                      // how many (0 if no 'K' or 'H')
+#define PIDSmaxt (Pids_reap->counts->total + Thds_total)
         // pid stack results extractor macro, where e=our EU enum, t=type, s=stack
         // ( we'll exploit that <proc/pids.h> provided macro as much as possible )
         // ( but many functions use their own unique tailored version for access )
@@ -289,10 +312,11 @@ static enum stat_item Stat_items[] = {
    STAT_TIC_DELTA_GUEST,    STAT_TIC_DELTA_GUEST_NICE,
    STAT_TIC_SUM_DELTA_USER, STAT_TIC_SUM_DELTA_SYSTEM,
 #ifdef CORE_TYPE_NO
-   STAT_TIC_SUM_DELTA_TOTAL };
+   STAT_TIC_SUM_DELTA_TOTAL,
 #else
-   STAT_TIC_SUM_DELTA_TOTAL, STAT_TIC_TYPE_CORE };
+   STAT_TIC_SUM_DELTA_TOTAL, STAT_TIC_TYPE_CORE,
 #endif
+   STAT_TIC_CPUFREQ_CUR,    STAT_TIC_DELTA_CPUIDLE_DEEP };
 enum Rel_statitems {
    stat_ID, stat_NU,
    stat_US, stat_SY,
@@ -302,10 +326,14 @@ enum Rel_statitems {
    stat_GU, stat_GN,
    stat_SUM_USR, stat_SUM_SYS,
 #ifdef CORE_TYPE_NO
-   stat_SUM_TOT };
+   stat_SUM_TOT,
 #else
-   stat_SUM_TOT, stat_COR_TYP };
+   stat_SUM_TOT, stat_COR_TYP,
 #endif
+   stat_FRQ, stat_DEP };
+        // those last 2 come from sysfs, so they're reaped only under 'p'
+#define STAT_numitems  ( Freq_mode ? MAXTBL(Stat_items) : MAXTBL(Stat_items) - 2 )
+static int Stat_freqs;                      // stat_FRQ & stat_DEP were reaped
         // cpu/node stack results extractor macros, where e=rel enum, x=index
 #define CPU_VAL(e,x) STAT_VAL(e, s_int, Stat_reap->cpus->stacks[x])
 #define NOD_VAL(e,x) STAT_VAL(e, s_int, Stat_reap->numa->stacks[x])
@@ -328,6 +356,53 @@ enum Rel_memitems {
    swp_TOT, swp_FRE, swp_USE };
         // mem stack results extractor macro, where e=rel enum
 #define MEM_VAL(e) MEMINFO_VAL(e, ul_int, Mem_stack)
+        /*
+         * --- <proc/snapshot.h> ---------------------------------------------- */
+#if !defined THREADED_CPU && !defined THREADED_MEM && !defined THREADED_TSK
+#define FRAME_SNAPSHOT                      // one coherent sample per frame
+static struct snapshot_info *Snap_ctx;
+static struct snapshot_result *Snap_reap;
+#endif
+        /*
+         * --- <proc/misc.h> -------------------------------------------------- */
+static struct procps_cost *Pids_cost;       // these are acquired only when
+static struct procps_cost *Stat_cost;       // first needed by a 'D' toggle
+static struct procps_cost *Mem_cost;
+static double Cost_frame_ms, Cost_cpu_ms;   // the last frame, as timed by frame_make
+        /*
+         * --- <proc/irq.h> --------------------------------------------------- */
+static struct irq_info *Irq_ctx;            // acquired when first needed by 'Q'
+static struct timespec Irq_prev;            // when Irq_ctx was last reaped
+static enum irq_item Irq_items[] = {
+   IRQ_NAME, IRQ_DELTA_TOTAL, IRQ_DELTA_CPU_HOT, IRQ_DELTA_CPU_MAX };
+enum Rel_irqitems {
+   irq_NAM, irq_DEL, irq_HOT, irq_MAX };
+        // irq stack results extractor macro, where e=rel enum, x=index
+#define IRQ_VAL_x(e,t,x) IRQ_VAL(e, t, Irq_reap->stacks[x])
+
+        /* Support for the '-B' cpu budget governor, which is fed each
+           frame's cpu time by frame_make and which supplies the delay
+           then used by our main loop */
+static float Budget_pct;                    // percent of 1 cpu (0 = no budget)
+static int   Budget_level;                  // the budget_lvl now in effect
+static float Budget_delay;                  // the delay, perhaps stretched
+static char  Budget_note[SMLBUFSIZ];        // what's shown in the summary area
+static float Budget_aged;                   // the oldest retained field shown
+
+        /* Support for task_show's row memoization, where each window keeps
+           the last row formatted for a task, keyed by that task's tid and a
+           hash of every raw result (plus the geometry) which went into it */
+struct memo_s {
+   int   tid;                   // the task whose row this was (maybe)
+   int   siz;                   // current size of the row buffer
+   unsigned long long hash;     // from task_hash, when that row was made
+   char *row;                   // what task_show then built, sans emission
+};
+static struct memo_s *Memo_tab[GROUPSMAX];  // one per window, when visible
+static unsigned long long Memo_key[GROUPSMAX]; // each window's geometry hash
+static int      Memo_siz;                   // slots in each (a power of 2)
+static unsigned Memo_gen;                   // bumped by zap_fieldstab
+static unsigned Memo_rows, Memo_hits;       // for a frame, as shown by 'D'
 
         /* Support for concurrent library updates via
            multithreaded background processes */
@@ -548,10 +623,15 @@ static void bye_bye (const char *str) {
       pthread_join(Thread_id_tasks, NULL);
       sem_destroy(&Semaphore_tasks_end);
       sem_destroy(&Semaphore_tasks_beg);
+#endif
+#ifdef FRAME_SNAPSHOT
+      procps_snapshot_unref(&Snap_ctx);
 #endif
       procps_pids_unref(&Pids_ctx);
+      procps_pids_unref(&Thds_ctx);
       procps_stat_unref(&Stat_ctx);
       procps_meminfo_unref(&Mem_ctx);
+      procps_irq_unref(&Irq_ctx);
 #if defined THREADED_CPU || defined THREADED_MEM || defined THREADED_TSK
       }
 #endif
@@ -1498,35 +1578,6 @@ static int mkfloat (const char *str, float *num, int whole) {
       return 1;
    return 0;
 } // end: mkfloat
-
-
-        /*
-         * This routine provides the i/o in support of files whose size
-         * cannot be determined in advance.  Given a stream pointer, he'll
-         * try to slurp in the whole thing and return a dynamically acquired
-         * buffer supporting that single string glob.
-         *
-         * He always creates a buffer at least READMINSZ big, possibly
-         * all zeros (an empty string), even if the file wasn't read. */
-static int readfile (FILE *fp, char **baddr, size_t *bsize, size_t *bread) {
-   char chunk[4096*16];
-   size_t num;
-
-   *bread = 0;
-   *bsize = READMINSZ;
-   *baddr = alloc_c(READMINSZ);
-   if (fp) {
-      while (0 < (num = fread(chunk, 1, sizeof(chunk), fp))) {
-         *baddr = alloc_r(*baddr, num + *bsize);
-         memcpy(*baddr + *bread, chunk, num);
-         *bread += num;
-         *bsize += num;
-      };
-      *(*baddr + *bread) = '\0';
-      return ferror(fp);
-   }
-   return ENOENT;
-} // end: readfile
 
 /*######  Small Utility routines  ########################################*/
 
@@ -2133,8 +2184,9 @@ static void adj_geometry (void) {
    if (Curwin->rc.double_up) {
       int num = (Curwin->rc.double_up + 1);
       int pfx = (Curwin->rc.double_up < 2) ? GRAPH_prefix_std : GRAPH_prefix_abv;
+      int sfx = GRAPH_suffix + (Freq_mode ? GRAPH_freqs : 0);
 
-      Graph_cpus->length = (Screen_cols - (ADJOIN_space * Curwin->rc.double_up) - (num * (pfx + GRAPH_suffix))) / num;
+      Graph_cpus->length = (Screen_cols - (ADJOIN_space * Curwin->rc.double_up) - (num * (pfx + sfx))) / num;
       if (Graph_cpus->length > GRAPH_length_max) Graph_cpus->length = GRAPH_length_max;
       if (Graph_cpus->length < GRAPH_length_min) Graph_cpus->length = GRAPH_length_min;
 
@@ -2148,7 +2200,7 @@ static void adj_geometry (void) {
 
 #if !defined(TOG4_MEM_FIX) && !defined(TOG4_MEM_1UP)
       if (num > 2) {
-       #define cpuGRAPH  ( GRAPH_prefix_abv + Graph_cpus->length + GRAPH_suffix )
+       #define cpuGRAPH  ( GRAPH_prefix_abv + Graph_cpus->length + sfx )
        #define nxtGRAPH  ( cpuGRAPH + ADJOIN_space )
          int len = cpuGRAPH;
          for (;;) {
@@ -2162,9 +2214,11 @@ static void adj_geometry (void) {
       }
 #endif
    } else {
-      Graph_cpus->length = Screen_cols - (GRAPH_prefix_std + GRAPH_length_max + GRAPH_suffix);
+      int sfx = GRAPH_suffix + (Freq_mode ? GRAPH_freqs : 0);
+
+      Graph_cpus->length = Screen_cols - (GRAPH_prefix_std + GRAPH_length_max + sfx);
       if (Graph_cpus->length >= 0) Graph_cpus->length = GRAPH_length_max;
-      else Graph_cpus->length = Screen_cols - GRAPH_prefix_std - GRAPH_suffix;
+      else Graph_cpus->length = Screen_cols - GRAPH_prefix_std - sfx;
       if (Graph_cpus->length < GRAPH_length_min) Graph_cpus->length = GRAPH_length_min;
 #ifdef TOG4_MEM_1UP
       Graph_mems->length = (Screen_cols - (GRAPH_prefix_std + GRAPH_suffix));
@@ -2175,7 +2229,9 @@ static void adj_geometry (void) {
 #endif
    }
    Graph_cpus->adjust = (float)Graph_cpus->length / 100.0;
+   // the heat map's own summary line shows the block graph
    Graph_cpus->style  = Curwin->rc.graph_cpus;
+   if (Graph_cpus->style == GRAPH_heat_map) Graph_cpus->style = 2;
 
    Graph_mems->adjust = (float)Graph_mems->length / 100.0;
    Graph_mems->style  = Curwin->rc.graph_mems;
@@ -2185,12 +2241,53 @@ static void adj_geometry (void) {
 } // end: adj_geometry
 
 
+        /*
+         * Those fields whose refresh the '-B' governor may suspend,
+         * all of which are costly (in terms of the files read) yet |
+         * relatively static for the life of most any process.     | */
+static inline int budget_costly (FLG_t f) {
+   switch (f) {
+      case EU_CGN: case EU_CGR: case EU_DKR: case EU_ENV:
+      case EU_EXE: case EU_FDS: case EU_LXC:
+      case EU_NS1: case EU_NS2: case EU_NS3: case EU_NS4:
+      case EU_NS5: case EU_NS6: case EU_NS7: case EU_NS8:
+      case EU_PSS: case EU_PZA: case EU_PZF: case EU_PZS:
+      case EU_RSS: case EU_USS:
+         return 1;
+      default:
+         return 0;
+   }
+} // end: budget_costly
+
+
+        /*
+         * Under BUDGET_stale, have the library retain those costly fields
+         * it can, rather than suspend them.  The smaps fields are read now
+         * and again, the rest only once for each task.  Otherwise, they're
+         * always read anew (and those BUDGET_fields suspends aren't read). */
+static void budget_retain (void) {
+   static enum pids_item items[] = {
+      PIDS_CGROUP, PIDS_ENVIRON, PIDS_EXE, PIDS_NS_CGROUP, PIDS_SMAP_RSS };
+   double age;
+   int i, rc;
+
+   for (i = 0; i < MAXTBL(items); i++) {
+      age = 0;
+      if (Budget_level >= BUDGET_stale)
+         age = items[i] == PIDS_SMAP_RSS ? BUDGET_SMAPS : -1;
+      if ((rc = procps_pids_max_age(Pids_ctx, items[i], age))
+      || (rc = procps_pids_max_age(Thds_ctx, items[i], age)))
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+   }
+} // end: budget_retain
+
+
         /*
          * A calibrate_fields() *Helper* function to build the actual
          * column headers & ensure necessary item enumerators support */
 static void build_headers (void) {
  #define ckITEM(f) do { Pids_itms[f] = Fieldstab[f].item; } while (0)
- #define ckCMDS(w) do { if (CHKw(w, Show_CMDLIN)) ckITEM(eu_CMDLINE); } while (0)
+ #define ckCMDS(w) do { if (CMDLIN(w)) ckITEM(eu_CMDLINE); } while (0)
    FLG_t f;
    char *s;
    WIN_t *w = Curwin;
@@ -2224,7 +2321,8 @@ static void build_headers (void) {
 #else
             if (EU_MAXPFLGS <= f) continue;
 #endif
-            ckITEM(f);
+            if (Budget_level < BUDGET_fields || !budget_costly(f))
+               ckITEM(f);
             switch (f) {
                case EU_CMD:
                   ckCMDS(w);
@@ -2263,6 +2361,8 @@ static void build_headers (void) {
 #else
          if (CHKw(w, Show_FOREST)) { ckITEM(EU_PPD); ckITEM(EU_TGD); ckITEM(EU_TM3); ckITEM(eu_TREE_HID); ckITEM(eu_TREE_LVL); }
 #endif
+         // for 'K' lazy threads, we need to know who's busy, with threads
+         if (Thread_lazy) { ckITEM(EU_CPU); ckITEM(EU_TGD); ckITEM(EU_THD); }
          // for 'u/U' filtering we need these too (old top forgot that, oops)
          if (w->usrseltyp) { ckITEM(EU_UED); ckITEM(EU_URD); ckITEM(EU_USD); ckITEM(eu_ID_FUID); }
 
@@ -2389,6 +2489,9 @@ static void calibrate_fields (void) {
 
    if ((rc = procps_pids_reset(Pids_ctx, Pids_itms, Pids_itms_tot)))
       error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+   if ((rc = procps_pids_reset(Thds_ctx, Pids_itms, Pids_itms_tot)))
+      error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+   budget_retain();
 } // end: calibrate_fields
 
 
@@ -2623,6 +2726,8 @@ static void zap_fieldstab (void) {
    int i, digits;
    char buf[8];
 
+   // whatever was changed, no row memoized by task_show remains valid
+   ++Memo_gen;
    if (!once) {
       Fieldstab[EU_PID].width = Fieldstab[EU_PPD].width
          = Fieldstab[EU_PGD].width = Fieldstab[EU_SID].width
@@ -2740,22 +2845,96 @@ static void zap_fieldstab (void) {
 
 /*######  Library Interface (as separate threads)  #######################*/
 
+        /*
+         * This guy decides when the memory portion of libprocps is due,
+         * reducing its sampling frequency in order to minimize overhead. */
+static int memory_stale (void) {
+   static time_t sav_secs;
+   time_t cur_secs;
+
+   if (Frames_signal)
+      sav_secs = 0;
+   cur_secs = time(NULL);
+
+   if (3 <= cur_secs - sav_secs) {
+      sav_secs = cur_secs;
+      return 1;
+   }
+   return 0;
+} // end: memory_stale
+
+
+#ifdef FRAME_SNAPSHOT
+        /*
+         * This guy samples the library <stat>, <meminfo> & <pids> APIs
+         * as one snapshot, so every frame shares a single timestamp.
+         * Only changes in what's wanted are passed on to the library.
+         * ( the -p pids selection still relies on tasks_refresh ) */
+static void snapshot_refresh (void) {
+   static int sav_which = -1, sav_freqs = -1, sav_what = -1;
+   int which, what, rc = 0;
+
+   if (!Restrict_some) {
+      which = STAT_REAP_CPUS_ONLY;
+      if (CHKw(Curwin, View_CPUNOD))
+         which = STAT_REAP_NUMA_NODES_TOO;
+      if (which != sav_which || Freq_mode != sav_freqs) {
+         if ((rc = procps_snapshot_add_stat(Snap_ctx, Stat_ctx, which, Stat_items, STAT_numitems)))
+            error_exit(fmtmk(N_fmt(LIB_errorcpu_fmt), __LINE__, strerror(-rc)));
+         sav_which = which;
+         sav_freqs = Stat_freqs = Freq_mode;
+      }
+      // meminfo is included only in those snapshots for which it's due
+      if (memory_stale())
+         rc = procps_snapshot_add_meminfo(Snap_ctx, Mem_ctx, Mem_items, MAXTBL(Mem_items));
+      else
+         rc = procps_snapshot_add_meminfo(Snap_ctx, NULL, NULL, 0);
+      if (rc)
+         error_exit(fmtmk(N_fmt(LIB_errormem_fmt), __LINE__, strerror(-rc)));
+   }
+
+   what = Thread_mode ? PIDS_FETCH_THREADS_TOO : PIDS_FETCH_TASKS_ONLY;
+   if (Monpidsidx) what = -1;
+   if (what != sav_what) {
+      rc = procps_snapshot_add_pids(Snap_ctx, what < 0 ? NULL : Pids_ctx, what);
+      if (rc)
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+      sav_what = what;
+   }
+
+   Snap_reap = NULL;
+   if (!Restrict_some || !Monpidsidx) {
+      if (!(Snap_reap = procps_snapshot_take(Snap_ctx)))
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+   }
+} // end: snapshot_refresh
+#endif
+
+
         /*
          * This guy's responsible for interfacing with the library <stat> API
          * and reaping all cpu or numa node tics.
          * ( his task is now embarassingly small under the new api ) */
 static void *cpus_refresh (void *unused) {
+#ifndef FRAME_SNAPSHOT
    enum stat_reap_type which;
+#endif
 
    do {
 #ifdef THREADED_CPU
       sem_wait(&Semaphore_cpus_beg);
 #endif
+#ifdef FRAME_SNAPSHOT
+      // already reaped, along with everything else, by snapshot_refresh
+      Stat_reap = Snap_reap->stat;
+#else
       which = STAT_REAP_CPUS_ONLY;
       if (CHKw(Curwin, View_CPUNOD))
          which = STAT_REAP_NUMA_NODES_TOO;
 
-      Stat_reap = procps_stat_reap(Stat_ctx, which, Stat_items, MAXTBL(Stat_items));
+      Stat_freqs = Freq_mode;
+      Stat_reap = procps_stat_reap(Stat_ctx, which, Stat_items, STAT_numitems);
+#endif
       if (!Stat_reap)
          error_exit(fmtmk(N_fmt(LIB_errorcpu_fmt), __LINE__, strerror(errno)));
 #ifndef PRETEND0NUMA
@@ -2793,22 +2972,19 @@ static void *cpus_refresh (void *unused) {
          * This serves as our interface to the memory portion of libprocps.
          * The sampling frequency is reduced in order to minimize overhead. */
 static void *memory_refresh (void *unused) {
-   static time_t sav_secs;
-   time_t cur_secs;
-
    do {
 #ifdef THREADED_MEM
       sem_wait(&Semaphore_memory_beg);
 #endif
-      if (Frames_signal)
-         sav_secs = 0;
-      cur_secs = time(NULL);
-
-      if (3 <= cur_secs - sav_secs) {
+#ifdef FRAME_SNAPSHOT
+      if (Snap_reap && Snap_reap->meminfo)
+         Mem_stack = Snap_reap->meminfo;
+#else
+      if (memory_stale()) {
          if (!(Mem_stack = procps_meminfo_select(Mem_ctx, Mem_items, MAXTBL(Mem_items))))
             error_exit(fmtmk(N_fmt(LIB_errormem_fmt), __LINE__, strerror(errno)));
-         sav_secs = cur_secs;
       }
+#endif
 #ifdef THREADED_MEM
       sem_post(&Semaphore_memory_end);
    } while (1);
@@ -2820,6 +2996,164 @@ static void *memory_refresh (void *unused) {
 } // end: memory_refresh
 
 
+        /*
+         * A lazy_refresh / lazy_thread *Helper* function, ordering the
+         * thread stacks by address. | */
+static int lazy_compare (const void *a, const void *b) {
+   const struct pids_stack *x = *(struct pids_stack * const *)a,
+                           *y = *(struct pids_stack * const *)b;
+   return (x > y) - (x < y);
+} // end: lazy_compare
+
+
+        /*
+         * Determine if a stack represents a lazily expanded thread. | */
+static inline int lazy_thread (struct pids_stack *p) {
+   if (!Thds_total) return 0;
+   return NULL != bsearch(&p, Thds_ppt, Thds_total, sizeof(void *), lazy_compare);
+} // end: lazy_thread
+
+
+        /*
+         * This guy rearranges a window's already sorted stacks so that
+         * any lazily expanded threads follow their own task (and thus |
+         * each task's threads will retain that window's sort order). | */
+static void lazy_nest (WIN_t *q) {
+   static struct pids_stack **nest;
+   static int n_alloc;
+   int i, j, k, n, t;
+
+   if (n_alloc < PIDSmaxt) {
+      n_alloc = PIDSmaxt;
+      nest = alloc_r(nest, sizeof(void *) * n_alloc);
+   }
+   // the threads are gathered first (in sorted order), followed by the tasks
+   for (i = t = 0, n = Thds_total; i < PIDSmaxt; i++) {
+      if (lazy_thread(q->ppt[i])) nest[t++] = q->ppt[i];
+      else nest[n++] = q->ppt[i];
+   }
+   for (i = Thds_total, n = 0; i < PIDSmaxt; i++) {
+      int pid = PID_VAL(EU_PID, s_int, nest[i]);
+      q->ppt[n++] = nest[i];
+      for (k = 0; k < Lazy_shownidx; k++)
+         if (pid == Lazy_shown[k]) break;
+      if (k < Lazy_shownidx) {
+         for (j = 0; j < Thds_total; j++)
+            if (pid == PID_VAL(EU_TGD, s_int, nest[j]))
+               q->ppt[n++] = nest[j];
+      }
+   }
+} // end: lazy_nest
+
+
+        /*
+         * A forest_begin *Helper* function, grafting the lazily expanded
+         * threads beneath their own task in a forest of 'n' tasks, one |
+         * level below that task.  Returns the resulting 'tree' total.  | */
+static int lazy_graft (struct pids_stack **tree, int n, struct pids_stack **seed) {
+  // if xtra-procps-debug.h active, can't use PID_VAL with assignment
+ #define rSv_Lvl(X)  (X)->head[eu_TREE_LVL].result.s_int
+   static struct pids_stack **graft;
+   static int n_alloc;
+   int i, j, k, t, pid;
+
+   if (n_alloc < PIDSmaxt) {
+      n_alloc = PIDSmaxt;
+      graft = alloc_r(graft, sizeof(void *) * n_alloc);
+   }
+   memcpy(graft, tree, sizeof(void *) * n);
+   for (i = k = 0; i < n; i++) {
+      tree[k++] = graft[i];
+      pid = PID_VAL(EU_PID, s_int, graft[i]);
+      for (j = 0; j < Lazy_shownidx; j++)
+         if (pid == Lazy_shown[j]) break;
+      if (j == Lazy_shownidx) continue;
+      // the seed order is by start time, which the threads will retain
+      for (t = 0; t < PIDSmaxt && k < PIDSmaxt; t++) {
+         if (pid == PID_VAL(EU_TGD, s_int, seed[t]) && lazy_thread(seed[t])) {
+            rSv_Lvl(seed[t]) = rSv_Lvl(graft[i]) + 1;
+            tree[k++] = seed[t];
+         }
+      }
+   }
+   return k;
+ #undef rSv_Lvl
+} // end: lazy_graft
+
+
+        /*
+         * This guy's responsible for the lazily expanded threads, which
+         * are read only for those tasks chosen with the 'K' command, |
+         * plus the busiest multi-threaded tasks (if there are any).  |
+         * ( it's meant to avoid those 'H' costs on very busy hosts ) | */
+static void lazy_refresh (void) {
+ #define n_reap     Pids_reap->counts->total
+ #define rSv(E,T,X) PID_VAL(E, T, Pids_reap->stacks[X])
+   static int priors[LAZYPIDMAX + LAZYBUSIEST], priorsidx;
+   static int n_alloc;
+   int busy[LAZYBUSIEST];
+   int i, j, pid;
+
+   // first, those explicitly chosen (but only if still with us) ...
+   Lazy_shownidx = 0;
+   for (i = 0; i < n_reap && Lazy_shownidx < Lazy_pidsidx; i++) {
+      pid = rSv(EU_PID, s_int, i);
+      for (j = 0; j < Lazy_pidsidx; j++)
+         if (pid == Lazy_pids[j]) {
+            Lazy_shown[Lazy_shownidx++] = pid;
+            break;
+         }
+   }
+   // then, the busiest of those with threads, ordered by their tics ...
+   for (i = 0; i < LAZYBUSIEST; i++) busy[i] = -1;
+   for (i = 0; i < n_reap; i++) {
+      unsigned tics = rSv(EU_CPU, u_int, i);
+      if (!tics || 2 > rSv(EU_THD, s_int, i)) continue;
+      for (j = LAZYBUSIEST; j > 0; j--)
+         if (busy[j - 1] >= 0 && tics <= rSv(EU_CPU, u_int, busy[j - 1])) break;
+      if (j < LAZYBUSIEST) {
+         memmove(&busy[j + 1], &busy[j], sizeof(int) * (LAZYBUSIEST - j - 1));
+         busy[j] = i;
+      }
+   }
+   for (i = 0; i < LAZYBUSIEST && busy[i] >= 0; i++) {
+      pid = rSv(EU_PID, s_int, busy[i]);
+      for (j = 0; j < Lazy_shownidx; j++)
+         if (pid == Lazy_shown[j]) break;
+      if (j == Lazy_shownidx)
+         Lazy_shown[Lazy_shownidx++] = pid;
+   }
+   if (!Lazy_shownidx) return;
+
+   /* any newly expanded task would show its threads' total tics as if they
+      were recent, so we'll just prime the library's history for them... */
+   for (i = 0; i < Lazy_shownidx; i++) {
+      for (j = 0; j < priorsidx; j++)
+         if (Lazy_shown[i] == priors[j]) break;
+      if (j == priorsidx) break;
+   }
+   j = (i < Lazy_shownidx) ? 2 : 1;
+   while (j--) {
+      Thds_reap = procps_pids_select(Thds_ctx, (unsigned *)Lazy_shown, Lazy_shownidx, PIDS_SELECT_PID_THREADS);
+      if (!Thds_reap)
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+   }
+   Thds_total = Thds_reap->counts->total;
+   memcpy(priors, Lazy_shown, sizeof(int) * Lazy_shownidx);
+   priorsidx = Lazy_shownidx;
+
+   // lastly, an address ordered copy so that lazy_thread can use bsearch ...
+   if (n_alloc < Thds_total) {
+      n_alloc = Thds_total;
+      Thds_ppt = alloc_r(Thds_ppt, sizeof(void *) * n_alloc);
+   }
+   memcpy(Thds_ppt, Thds_reap->stacks, sizeof(void *) * Thds_total);
+   qsort(Thds_ppt, Thds_total, sizeof(void *), lazy_compare);
+ #undef n_reap
+ #undef rSv
+} // end: lazy_refresh
+
+
         /*
          * This guy's responsible for interfacing with the library <pids> API
          * then refreshing the WIN_t ptr arrays, growing them as appropirate. */
@@ -2838,8 +3172,14 @@ static void *tasks_refresh (void *unused) {
 #ifdef THREADED_TSK
       sem_wait(&Semaphore_tasks_beg);
 #endif
-      clock_gettime(CLOCK_BOOTTIME, &ts);
-      uptime_cur = (ts.tv_sec + ts.tv_nsec * 1.0e-9);
+#ifdef FRAME_SNAPSHOT
+      if (Snap_reap)
+         uptime_cur = Snap_reap->boottime;
+      else
+#endif
+      {  clock_gettime(CLOCK_BOOTTIME, &ts);
+         uptime_cur = (ts.tv_sec + ts.tv_nsec * 1.0e-9);
+      }
       et = uptime_cur - uptime_sav;
       if (et < 0.01) et = 0.005;
       uptime_sav = uptime_cur;
@@ -2850,22 +3190,28 @@ static void *tasks_refresh (void *unused) {
       if (Monpidsidx) {
          what |= PIDS_SELECT_PID;
          Pids_reap = procps_pids_select(Pids_ctx, (unsigned *)Monpids, Monpidsidx, what);
+#ifdef FRAME_SNAPSHOT
+      } else if (Snap_reap) {
+         Pids_reap = Snap_reap->pids;
+#endif
       } else
          Pids_reap = procps_pids_reap(Pids_ctx, what);
       if (!Pids_reap)
          error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+      Thds_total = 0;
+      if (Thread_lazy) lazy_refresh();
 
       // now refresh each window's stacks pointer array...
-      if (n_alloc < n_reap) {
-//       n_alloc = nALIGN(n_reap, 100);
-         n_alloc = nALGN2(n_reap, 128);
-         for (i = 0; i < GROUPSMAX; i++) {
-            Winstk[i].ppt = alloc_r(Winstk[i].ppt, sizeof(void *) * n_alloc);
-            memcpy(Winstk[i].ppt, Pids_reap->stacks, sizeof(void *) * PIDSmaxt);
-         }
-      } else {
+      if (n_alloc < PIDSmaxt) {
+//       n_alloc = nALIGN(PIDSmaxt, 100);
+         n_alloc = nALGN2(PIDSmaxt, 128);
          for (i = 0; i < GROUPSMAX; i++)
-            memcpy(Winstk[i].ppt, Pids_reap->stacks, sizeof(void *) * PIDSmaxt);
+            Winstk[i].ppt = alloc_r(Winstk[i].ppt, sizeof(void *) * n_alloc);
+      }
+      for (i = 0; i < GROUPSMAX; i++) {
+         memcpy(Winstk[i].ppt, Pids_reap->stacks, sizeof(void *) * n_reap);
+         if (Thds_total)
+            memcpy(Winstk[i].ppt + n_reap, Thds_reap->stacks, sizeof(void *) * Thds_total);
       }
 #ifdef THREADED_TSK
       sem_post(&Semaphore_tasks_end);
@@ -2960,6 +3306,11 @@ static int      Insp_utf8;        // treat Insp_buf as translatable, else raw
 static char    *Insp_buf;         // the results from insp_do_file/pipe
 static size_t   Insp_bufsz;       // allocated size of Insp_buf
 static size_t   Insp_bufrd;       // bytes actually in Insp_buf
+static size_t   Insp_scan;        // bytes in Insp_buf already line indexed
+static int      Insp_lns;         // lines ended by a newline (so complete)
+static int      Insp_pmax;        // allocated Insp_p entries
+static FILE    *Insp_fp;          // the file/pipe still being read, or NULL
+static int      Insp_pipe;        // Insp_fp came from popen (not fopen)
 static struct I_ent *Insp_sel;    // currently selected Inspect entry
 
         // Our 'make status line' macro
@@ -2979,18 +3330,18 @@ static struct I_ent *Insp_sel;    // currently selected Inspect entry
 
 
         /*
-         * Establish the number of lines present in the Insp_buf glob plus
-         * build the all important row start array.  It is that array that
-         * others will rely on since we dare not try to use strlen() on what
-         * is potentially raw binary data.  Who knows what some user might
-         * name as a file or include in a pipeline (scary, ain't it?). */
+         * Extend the number of lines present in the Insp_buf glob plus
+         * the all important row start array, for what's been added since
+         * we were last called.  It is that array that others will rely on
+         * since we dare not try to use strlen() on what is potentially raw
+         * binary data.  Who knows what some user might name as a file or
+         * include in a pipeline (scary, ain't it?). */
 static void insp_cnt_nl (void) {
-   char *beg = Insp_buf;
-   char *cur = Insp_buf;
+   char *beg = Insp_buf + Insp_scan;
    char *end = Insp_buf + Insp_bufrd + 1;
 
 #ifdef INSP_SAVEBUF
-{
+if (!Insp_fp) {
    static int n = 1;
    char fn[SMLBUFSIZ];
    FILE *fd;
@@ -3002,24 +3353,120 @@ static void insp_cnt_nl (void) {
    }
 }
 #endif
-   Insp_p = alloc_c(sizeof(char *) * 2);
-
-   for (Insp_nl = 0; beg < end; beg++) {
+   if (!Insp_p) {
+      Insp_pmax = 64;
+      Insp_p = alloc_c(sizeof(char *) * Insp_pmax);
+      Insp_p[0] = Insp_buf;
+      Insp_lns = 0;
+   }
+   for ( ; beg < end; beg++) {
       if (*beg == '\n') {
-         Insp_p[Insp_nl++] = cur;
-         // keep our array ahead of next potential need (plus the 2 above)
-         Insp_p = alloc_r(Insp_p, (sizeof(char *) * (Insp_nl +3)));
-         cur = beg +1;
+         // keep our array ahead of next potential need (plus the 2 below)
+         if (Insp_lns +3 > Insp_pmax) {
+            Insp_pmax *= 2;
+            Insp_p = alloc_r(Insp_p, sizeof(char *) * Insp_pmax);
+         }
+         Insp_p[++Insp_lns] = beg +1;
       }
    }
-   Insp_p[0] = Insp_buf;
-   Insp_p[Insp_nl++] = cur;
+   Insp_scan = Insp_bufrd;
+   Insp_nl = Insp_lns +1;
    Insp_p[Insp_nl] = end;
-   if ((end - cur) == 1)          // if there's an eof null delimiter,
-      --Insp_nl;                  // don't count it as a new line
+   if ((end - Insp_p[Insp_lns]) == 1) // if there's an eof null delimiter,
+      --Insp_nl;                      // don't count it as a new line
 } // end: insp_cnt_nl
 
 
+        /*
+         * Finish with the file/pipe being inspected, if still open. */
+static void insp_end (void) {
+   if (!Insp_fp)
+      return;
+   if (Insp_pipe) {
+      struct sigaction sa;
+
+      pclose(Insp_fp);
+      memset(&sa, 0, sizeof(sa));
+      sigemptyset(&sa.sa_mask);
+      sa.sa_handler = sig_endpgm;
+      sigaction(SIGINT, &sa, NULL);
+   } else
+      fclose(Insp_fp);
+   Insp_fp = NULL;
+} // end: insp_end
+
+
+        /*
+         * Read the next chunk of the file/pipe being inspected, growing
+         * Insp_buf geometrically (so without a memcpy for every chunk) and
+         * extending the row start array.  At eof or error the file/pipe is
+         * closed.  Returns the number of bytes read, if any. */
+static ssize_t insp_more (void) {
+ #define INSP_CHUNK (1024*64)
+   ssize_t num;
+
+   if (!Insp_fp)
+      return 0;
+   if (Insp_bufsz - Insp_bufrd < INSP_CHUNK +1) {
+      char *old = Insp_buf;
+      int i;
+
+      Insp_bufsz *= 2;
+      if (Insp_bufsz < Insp_bufrd + INSP_CHUNK +1)
+         Insp_bufsz = Insp_bufrd + INSP_CHUNK +1;
+      // rather than realloc, copy so each row start can be rebased safely
+      Insp_buf = alloc_c(Insp_bufsz);
+      memcpy(Insp_buf, old, Insp_bufrd +1);
+      if (Insp_p)
+         for (i = 0; i <= Insp_lns; i++)
+            Insp_p[i] = Insp_buf + (Insp_p[i] - old);
+      free(old);
+   }
+   do
+      num = read(fileno(Insp_fp), Insp_buf + Insp_bufrd, INSP_CHUNK);
+   while (num < 0 && errno == EINTR);
+
+   if (num > 0) {
+      Insp_bufrd += num;
+      Insp_buf[Insp_bufrd] = '\0';
+   } else {
+      if (num < 0 && !Insp_bufrd)
+         Insp_bufrd = snprintf(Insp_buf, Insp_bufsz, "%s"
+            , fmtmk(N_fmt(YINSP_failed_fmt), strerror(errno)));
+      insp_end();
+      Insp_utf8 = utf8_delta(Insp_buf);
+   }
+   insp_cnt_nl();
+   return num;
+ #undef INSP_CHUNK
+} // end: insp_more
+
+
+        /*
+         * Prepare Insp_buf and then read just enough of the file/pipe
+         * for a first screen -- any remainder will be read by insp_wait
+         * while the user is viewing that which is already available. */
+static void insp_begin (FILE *fp, int pipe) {
+   struct stat sb;
+
+   Insp_bufsz = READMINSZ;
+   // for a regular file, we can avoid (most) buffer growth entirely
+   if (fp && !pipe && !fstat(fileno(fp), &sb) && S_ISREG(sb.st_mode))
+      Insp_bufsz += sb.st_size;
+   Insp_buf   = alloc_c(Insp_bufsz);
+   Insp_bufrd = Insp_scan = 0;
+   Insp_fp    = fp;
+   Insp_pipe  = pipe;
+   if (!fp)
+      Insp_bufrd = snprintf(Insp_buf, Insp_bufsz, "%s"
+         , fmtmk(N_fmt(YINSP_failed_fmt), strerror(errno)));
+   insp_cnt_nl();
+   // a pipe might be slow, so we'll settle for whatever it first offers
+   while (Insp_fp && Insp_nl <= Screen_rows)
+      if (0 < insp_more() && pipe) break;
+} // end: insp_begin
+
+
 #ifndef INSP_OFFDEMO
         /*
          * The pseudo output DEMO utility. */
@@ -3030,6 +3477,7 @@ static void insp_do_demo (char *fmts, int pid) {
    Insp_bufsz = READMINSZ + strlen(N_txt(YINSP_dstory_txt));
    Insp_buf   = alloc_c(Insp_bufsz);
    Insp_bufrd = snprintf(Insp_buf, Insp_bufsz, "%s", N_txt(YINSP_dstory_txt));
+   Insp_scan  = 0;
    insp_cnt_nl();
 } // end: insp_do_demo
 #endif
@@ -3039,26 +3487,18 @@ static void insp_do_demo (char *fmts, int pid) {
          * The generalized FILE utility. */
 static void insp_do_file (char *fmts, int pid) {
    char buf[LRGBUFSIZ];
-   FILE *fp;
-   int rc;
 
    snprintf(buf, sizeof(buf), fmts, pid);
-   fp = fopen(buf, "r");
-   rc = readfile(fp, &Insp_buf, &Insp_bufsz, &Insp_bufrd);
-   if (fp) fclose(fp);
-   if (rc) Insp_bufrd = snprintf(Insp_buf, Insp_bufsz, "%s"
-      , fmtmk(N_fmt(YINSP_failed_fmt), strerror(errno)));
-   insp_cnt_nl();
+   insp_begin(fopen(buf, "r"), 0);
 } // end: insp_do_file
 
 
         /*
-         * The generalized PIPE utility. */
+         * The generalized PIPE utility (whose SIGINT handling is restored
+         * by insp_end, only after the pipe has been closed). */
 static void insp_do_pipe (char *fmts, int pid) {
    char buf[LRGBUFSIZ];
    struct sigaction sa;
-   FILE *fp;
-   int rc;
 
    memset(&sa, 0, sizeof(sa));
    sigemptyset(&sa.sa_mask);
@@ -3066,18 +3506,51 @@ static void insp_do_pipe (char *fmts, int pid) {
    sigaction(SIGINT, &sa, NULL);
 
    snprintf(buf, sizeof(buf), fmts, pid);
-   fp = popen(buf, "r");
-   rc = readfile(fp, &Insp_buf, &Insp_bufsz, &Insp_bufrd);
-   if (fp) pclose(fp);
-   if (rc) Insp_bufrd = snprintf(Insp_buf, Insp_bufsz, "%s"
-      , fmtmk(N_fmt(YINSP_failed_fmt), strerror(errno)));
-   insp_cnt_nl();
-
-   sa.sa_handler = sig_endpgm;
-   sigaction(SIGINT, &sa, NULL);
+   insp_begin(popen(buf, "r"), 1);
+   if (!Insp_fp) {
+      sa.sa_handler = sig_endpgm;
+      sigaction(SIGINT, &sa, NULL);
+   }
 } // end: insp_do_pipe
 
 
+        /*
+         * While a file/pipe is still being read, this guy continues that
+         * reading until a keystroke is waiting or, having acquired some
+         * new data, it's time to refresh the display.  A signal (such as
+         * SIGWINCH) will also end the wait.  Returns 1 if a key is ready. */
+static int insp_wait (void) {
+ #define INSP_PAUSE (1000000000 / 4)
+   struct timespec beg, now;
+   int got = 0;
+
+   clock_gettime(CLOCK_MONOTONIC, &beg);
+   while (Insp_fp) {
+      struct timespec ts = { 0, INSP_PAUSE };
+      int fd = fileno(Insp_fp);
+      fd_set fs;
+
+      FD_ZERO(&fs);
+      FD_SET(STDIN_FILENO, &fs);
+      FD_SET(fd, &fs);
+      if (0 > pselect(fd + 1, &fs, NULL, NULL, &ts, &Sigwinch_set))
+         return 0;
+      if (FD_ISSET(STDIN_FILENO, &fs))
+         return 1;
+      if (FD_ISSET(fd, &fs)) {
+         insp_more();
+         got = 1;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      if (got && INSP_PAUSE <= (now.tv_sec - beg.tv_sec) * 1000000000
+         + (now.tv_nsec - beg.tv_nsec))
+            return 0;
+   }
+   return 0;
+ #undef INSP_PAUSE
+} // end: insp_wait
+
+
         /*
          * This guy is a *Helper* function serving the following two masters:
          *   insp_find_str() - find the next Insp_sel->fstr match
@@ -3342,7 +3815,7 @@ static int insp_view_choice (struct pids_stack *p) {
        snprintf(dst, sizeof(dst), "%s", Insp_sel->fstr); \
     else snprintf(dst, sizeof(dst), "%.19s...", Insp_sel->fstr); }
    char buf[LRGBUFSIZ];
-   int key, curlin = 0, curcol = 0;
+   int key, curlin = 0, curcol = 0, more = 0;
 
 signify_that:
    putp(Cap_clr_scr);
@@ -3363,10 +3836,16 @@ signify_that:
       insp_show_pgs(curcol, curlin, maxLN);
       fflush(stdout);
       /* fflush(stdin) didn't do the trick, so we'll just dip a little deeper
-         lest repeated <Enter> keys produce immediate re-selection in caller */
-      tcflush(STDIN_FILENO, TCIFLUSH);
+         lest repeated <Enter> keys produce immediate re-selection in caller
+         ( but not when we're merely showing more of an ongoing read ) */
+      if (!more) tcflush(STDIN_FILENO, TCIFLUSH);
+      more = 0;
 
       if (Frames_signal) goto signify_that;
+      if (Insp_fp && !insp_wait()) {
+         more = 1;
+         continue;
+      }
       key = iokey(IOKEY_ONCE);
       if (key < 1) goto signify_that;
 
@@ -3505,8 +3984,10 @@ signify_that:
             Inspect.tab[sel].func(Inspect.tab[sel].fmts, pid);
             Insp_utf8 = utf8_delta(Insp_buf);
             key = insp_view_choice(p);
+            insp_end();
             free(Insp_buf);
             free(Insp_p);
+            Insp_p = NULL;
             break;
          default:
             goto signify_that;
@@ -3524,6 +4005,35 @@ signify_that:
 
 /*######  Other Filtering  ###############################################*/
 
+        /*
+         * Derive a task's %CPU, exactly as it would be displayed */
+static float task_pcpu (const WIN_t *q, struct pids_stack *p) {
+ #define rSv(E,T)  PID_VAL(E, T, p)
+   float u = (float)rSv(EU_CPU, u_int);
+   int n = rSv(EU_THD, s_int);
+
+#ifndef TREE_VCPUOFF
+ #ifndef TREE_VWINALL
+   if (q == Curwin) // note: the following is NOT indented
+ #endif
+   if (CHKw(q, Show_FOREST)) u += rSv(eu_TREE_ADD, u_int);
+   u *= Frame_etscale;
+   /* technically, eu_TREE_HID is only valid if Show_FOREST is active
+      but its zeroed out slot will always be present now */
+   if (rSv(eu_TREE_HID, s_ch) != 'x' && u > 100.0 * n) u = 100.0 * n;
+#else
+   (void)q;
+   u *= Frame_etscale;
+   /* process can't use more %cpu than number of threads it has
+    ( thanks Jaromir Capik <jcapik@redhat.com> ) */
+   if (u > 100.0 * n) u = 100.0 * n;
+#endif
+   if (u > Cpu_pmax) u = Cpu_pmax;
+   return u;
+ #undef rSv
+} // end: task_pcpu
+
+
         /*
          * This structure is hung from a WIN_t when other filtering is active */
 struct osel_s {
@@ -3536,8 +4046,66 @@ struct osel_s {
    int   inc;                                  // include == 1, exclude == 0
    int   enu;                                  // field (procflag) to filter
    int   typ;                                  // typ used to set: rel & sel
+   int   how;                                  // how evaluated (see below)
+   int   sfx;                                  // OSEL_mem suffix, else -1
+   double num;                                 // the value when numeric
+};
+
+        /*
+         * These govern how a criteria is evaluated, where all but the
+         * first are done against the raw results before any formatting */
+enum osel_how {
+   OSEL_txt = 0,             // formatted column text (the traditional way)
+   OSEL_chr, OSEL_str,       // '=' with a raw s_ch or str result
+   OSEL_sint, OSEL_uint,     // '<' or '>' with a raw numeric result ...
+   OSEL_ulint, OSEL_real,
+   OSEL_mem,                 // ... or memory (KiB) as seen in the display
+   OSEL_pcpu, OSEL_pmem      // ... or those percentages we derive
 };
 
+
+        /*
+         * Determine how an 'other filter' for a particular field and
+         * operation might be evaluated before any formatting occurs */
+static int osel_how (int enu, int ops) {
+   if (ops == '=') switch (enu) {
+      case EU_STA:
+         return OSEL_chr;
+      case EU_CGN: case EU_CGR: case EU_CLS: case EU_DKR: case EU_ENV:
+      case EU_EXE: case EU_GRP: case EU_LXC: case EU_SGD: case EU_SGN:
+      case EU_TTY: case EU_UEN: case EU_URN: case EU_USN: case EU_WCH:
+         return OSEL_str;
+      default:               // (COMMAND may be decorated, so it's not here)
+         return OSEL_txt;
+   }
+   switch (enu) {
+      case EU_AGI: case EU_AGN: case EU_CPN: case EU_FDS: case EU_FV1:
+      case EU_FV2: case EU_LID: case EU_NCE: case EU_NMA: case EU_OOA:
+      case EU_OOM: case EU_PGD: case EU_PID: case EU_PPD: case EU_PRI:
+      case EU_SID: case EU_TGD: case EU_THD: case EU_TPG:
+         return OSEL_sint;
+      case EU_GID: case EU_UED: case EU_URD: case EU_USD:
+         return OSEL_uint;
+      case EU_FL1: case EU_FL2: case EU_IRB: case EU_IRO: case EU_IWB:
+      case EU_IWO: case EU_NS1: case EU_NS2: case EU_NS3: case EU_NS4:
+      case EU_NS5: case EU_NS6: case EU_NS7: case EU_NS8:
+         return OSEL_ulint;
+      case EU_CUC: case EU_CUU:
+         return OSEL_real;
+      case EU_COD: case EU_DAT: case EU_PSS: case EU_PZA: case EU_PZF:
+      case EU_PZS: case EU_RES: case EU_RSS: case EU_RZA: case EU_RZF:
+      case EU_RZL: case EU_RZS: case EU_SHR: case EU_SWP: case EU_USE:
+      case EU_USS: case EU_VRT:
+         return OSEL_mem;
+      case EU_CPU:
+         return OSEL_pcpu;
+      case EU_MEM:
+         return Restrict_some ? OSEL_txt : OSEL_pmem;
+      default:
+         return OSEL_txt;
+   }
+} // end: osel_how
+
         /*
          * A function to parse, validate and build a single 'other filter' */
 static const char *osel_add (WIN_t *q, int ch, char *glob, int push) {
@@ -3585,6 +4153,19 @@ static const char *osel_add (WIN_t *q, int ch, char *glob, int push) {
    osel->inc = inc;
    osel->enu = enu;
    osel->ops = ops;
+   osel->sfx = -1;
+   osel->how = osel_how(enu, ops);
+   if (osel->how >= OSEL_sint) {
+      // a value we can't fully digest means formatted text will be used
+      char *end;
+      osel->num = strtod(pval, &end);
+      if (osel->how == OSEL_mem && *end) {
+         const char *sfxs = "kmgtpe", *q = strchr(sfxs, tolower(*end));
+         if (q) { osel->sfx = (int)(q - sfxs); ++end; }
+      }
+      while (isspace(*end)) ++end;
+      if (end == pval || *end) osel->how = OSEL_txt;
+   }
    if (ops == '=') osel->val = alloc_s(pval);
    else osel->val = alloc_s(justify_pad(pval, Fieldstab[enu].width, Fieldstab[enu].align));
    osel->rel = rel;
@@ -3639,7 +4220,7 @@ static inline int osel_matched (const WIN_t *q, FLG_t enu, const char *str) {
    struct osel_s *osel = q->osel_1st;
 
    while (osel) {
-      if (osel->enu == enu) {
+      if (osel->enu == enu && osel->how == OSEL_txt) {
          int r;
          switch (osel->ops) {
             case '<':                          // '<' needs the r < 0 unless
@@ -3661,6 +4242,76 @@ static inline int osel_matched (const WIN_t *q, FLG_t enu, const char *str) {
    }
    return 1;
 } // end: osel_matched
+
+
+        /*
+         * Determine if a task satisfies those other criteria which can be
+         * evaluated against raw results -- called before any formatting so
+         * that a rejected task never incurs that cost (but, just as always,
+         * only fields currently being displayed are ever considered) */
+static int osel_prefilter (const WIN_t *q, struct pids_stack *p) {
+ #define rSv(E,T)  PID_VAL(E, T, p)
+   struct osel_s *osel;
+   double v;
+   int x;
+
+   for (osel = q->osel_1st; osel; osel = osel->nxt) {
+      if (osel->how == OSEL_txt)
+         continue;
+      for (x = 0; x < q->maxpflgs; x++)
+         if (q->procflgs[x] == osel->enu) break;
+      if (x >= q->maxpflgs)
+         continue;
+      switch (osel->how) {
+         case OSEL_chr:
+         {  char buf[2] = { rSv(osel->enu, s_ch), '\0' };
+            char *r = osel->sel(buf, osel->val);
+            if ((!r && osel->inc) || (r && !osel->inc)) return 0;
+         }
+            continue;
+         case OSEL_str:
+         {  char *r = osel->sel(rSv(osel->enu, str), osel->val);
+            if ((!r && osel->inc) || (r && !osel->inc)) return 0;
+         }
+            continue;
+         case OSEL_sint:
+            v = rSv(osel->enu, s_int);
+            break;
+         case OSEL_uint:
+            v = rSv(osel->enu, u_int);
+            break;
+         case OSEL_ulint:
+            v = rSv(osel->enu, ul_int);
+            break;
+         case OSEL_real:
+            v = rSv(osel->enu, real);
+            break;
+         case OSEL_mem:
+            // without a suffix, the value is in the field's current scaling
+            v = rSv(osel->enu, ul_int);
+            for (x = osel->sfx < 0 ? Fieldstab[osel->enu].scale : 0; x > SK_Kb; x--)
+               v /= 1024.0;
+            for (x = osel->sfx; x > SK_Kb; x--)
+               v /= 1024.0;
+            break;
+         case OSEL_pcpu:
+            v = task_pcpu(q, p);
+            break;
+         case OSEL_pmem:
+            v = (float)rSv(EU_MEM, ul_int) * 100 / MEM_VAL(mem_TOT);
+            break;
+         default:
+            continue;
+      }
+      if (osel->ops == '<') {
+         if ((v >= osel->num && osel->inc) || (v < osel->num && !osel->inc)) return 0;
+      } else {
+         if ((v <= osel->num && osel->inc) || (v > osel->num && !osel->inc)) return 0;
+      }
+   }
+   return 1;
+ #undef rSv
+} // end: osel_prefilter
 
 /*######  Startup routines  ##############################################*/
 
@@ -3707,7 +4358,7 @@ static void before (char *me) {
       Restrict_some = 1;
       Cpu_cnt = sysconf(_SC_NPROCESSORS_ONLN);
    } else {
-      if (!(Stat_reap = procps_stat_reap(Stat_ctx, doALL, Stat_items, MAXTBL(Stat_items))))
+      if (!(Stat_reap = procps_stat_reap(Stat_ctx, doALL, Stat_items, STAT_numitems)))
          error_exit(fmtmk(N_fmt(LIB_errorcpu_fmt), __LINE__, strerror(errno)));
 #ifndef PRETEND0NUMA
       Numa_node_tot = Stat_reap->numa->total;
@@ -3731,6 +4382,12 @@ static void before (char *me) {
    // we will identify specific items in the build_headers() function
    if ((rc = procps_pids_new(&Pids_ctx, Pids_itms, Pids_itms_tot)))
       error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+   if ((rc = procps_pids_new(&Thds_ctx, Pids_itms, Pids_itms_tot)))
+      error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+#ifdef FRAME_SNAPSHOT
+   if ((rc = procps_snapshot_new(&Snap_ctx)))
+      error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(-rc)));
+#endif
 
 #if defined THREADED_CPU || defined THREADED_MEM || defined THREADED_TSK
 {  struct sigaction sa;
@@ -4030,7 +4687,7 @@ static int config_wins (FILE *fp, char *buf, int wix) {
       return 0;
    if (w->rc.maxtasks < 0)
       return 0;
-   if (w->rc.graph_cpus < 0 || w->rc.graph_cpus > 2)
+   if (w->rc.graph_cpus < 0 || w->rc.graph_cpus > GRAPH_heat_map)
       return 0;
    if (w->rc.graph_mems < 0 || w->rc.graph_mems > 2)
       return 0;
@@ -4289,8 +4946,9 @@ default_or_error:
          *       overridden -- we'll force some on and negate others in our
          *       best effort to honor the loser's (oops, user's) wishes... */
 static void parse_args (int argc, char **argv) {
-    static const char sopts[] = "bcd:E:e:Hhin:Oo:p:SsU:u:Vw::1";
+    static const char sopts[] = "B:bcd:E:e:Hhin:Oo:p:SsU:u:Vw::1";
     static const struct option lopts[] = {
+       { "cpu-budget",        required_argument, NULL, 'B' },
        { "batch-mode",        no_argument,       NULL, 'b' },
        { "cmdline-toggle",    no_argument,       NULL, 'c' },
        { "delay",             required_argument, NULL, 'd' },
@@ -4340,6 +4998,14 @@ static void parse_args (int argc, char **argv) {
             OFFw(Curwin, View_CPUNOD);
             SETw(Curwin, View_STATES);
             break;
+         case 'B':
+         {  char tmp_pct[SMLBUFSIZ];   // allow for an optional trailing '%'
+            size_t n = strcspn(cp, "%");
+            snprintf(tmp_pct, sizeof(tmp_pct), "%.*s", (int)n, cp);
+            if (!mkfloat(tmp_pct, &Budget_pct, 0) || (cp[n] && cp[n + 1])
+            || 0.0 >= Budget_pct || 100.0 <= Budget_pct)
+               error_exit(fmtmk(N_fmt(BAD_cpubudget_fmt), cp));
+         }  continue;
          case 'b':
             Batch = 1;
             break;
@@ -4937,8 +5603,9 @@ static void forest_adds (const int self, int level) {
 #else
       for (i = self + 1; i < PIDSmaxt; i++) {
 #endif
-         if (rSv(EU_PID, self) == rSv(EU_TGD, i)
+         if ((rSv(EU_PID, self) == rSv(EU_TGD, i)
          || (rSv(EU_PID, self) == rSv(EU_PPD, i) && rSv(EU_PID, i) == rSv(EU_TGD, i)))
+         && !lazy_thread(Seed_ppt[i]))      // ( 'K' threads come later ) |
             forest_adds(i, level + 1);      // got one child any others?
       }
    }
@@ -4969,9 +5636,12 @@ static void forest_begin (WIN_t *q) {
             error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
 #endif
       for (i = 0; i < PIDSmaxt; i++) {         // avoid hidepid distorts |
-         if (!PID_VAL(eu_TREE_LVL, s_int, Seed_ppt[i])) // parents lvl 0 |
+         if (!PID_VAL(eu_TREE_LVL, s_int, Seed_ppt[i]) // parents lvl 0 |
+         && !lazy_thread(Seed_ppt[i]))
             forest_adds(i, 0);                 // add parents + children |
       }
+      if (Thds_total)                          // nest any 'K' threads   |
+         Tree_idx = lazy_graft(Tree_ppt, Tree_idx, Seed_ppt);
 
       /* we use up to three additional 'PIDS_extra' results in our stack |
             eu_TREE_HID (s_ch) :  where 'x' == collapsed & 'z' == unseen |
@@ -5085,7 +5755,7 @@ static inline const char *forest_display (const WIN_t *q, int idx) {
    static char buf[ROWMINSIZ];
 #endif
    struct pids_stack *p = q->ppt[idx];
-   const char *which = (CHKw(q, Show_CMDLIN)) ? rSv(eu_CMDLINE) : rSv(EU_CMD);
+   const char *which = (CMDLIN(q)) ? rSv(eu_CMDLINE) : rSv(EU_CMD);
    int level = rSv_Lvl;
 
 #ifdef FOCUS_TREE_X
@@ -5094,7 +5764,13 @@ static inline const char *forest_display (const WIN_t *q, int idx) {
          level -= q->focus_lvl;
    }
 #endif
-   if (!CHKw(q, Show_FOREST) || level == 0) return which;
+   if (!CHKw(q, Show_FOREST)) {
+      // any lazily expanded threads are shown beneath their task
+      if (!lazy_thread(p)) return which;
+      snprintf(buf, sizeof(buf), "%*s%s", 4, " `- ", which);
+      return buf;
+   }
+   if (level == 0) return which;
 #ifndef TREE_VWINALL
    if (q == Curwin)            // note: the following is NOT indented
 #endif
@@ -5618,6 +6294,30 @@ static void keys_global (int ch) {
          TOGw(w, View_NOBOLD);
          capsmk(w);
          break;
+      case 'D':
+         if (!Pids_cost) {
+            Pids_cost = procps_pids_cost(Pids_ctx);
+            Stat_cost = procps_stat_cost(Stat_ctx);
+            Mem_cost = procps_meminfo_cost(Mem_ctx);
+         }
+         Cost_mode = !Cost_mode;
+         break;
+      case 'Q':
+         if (!Irq_ctx && procps_irq_new(&Irq_ctx)) {
+            show_msg(fmtmk(N_fmt(LIB_errorirq_fmt), __LINE__, strerror(errno)));
+            break;
+         }
+         if (!Irq_prev.tv_sec)
+            clock_gettime(CLOCK_MONOTONIC, &Irq_prev);
+         Irq_mode = !Irq_mode;
+         break;
+      case 'p':
+         if (Restrict_some) {
+            show_msg(N_txt(X_RESTRICTED_txt));
+            break;
+         }
+         Freq_mode = !Freq_mode;
+         break;
       case 'd':
       case 's':
          if (Secure_mode)
@@ -5642,6 +6342,7 @@ static void keys_global (int ch) {
          break;
       case 'H':
          Thread_mode = !Thread_mode;
+         Thread_lazy = 0;
          if (!CHKw(w, View_STATES))
             show_msg(fmtmk(N_fmt(THREADS_show_fmt)
                , Thread_mode ? N_txt(ON_word_only_txt) : N_txt(OFF_one_word_txt)));
@@ -5652,6 +6353,28 @@ static void keys_global (int ch) {
          // signal that we just corrupted entire screen
          Frames_signal = BREAK_screen;
          break;
+      case 'K':
+         def = PID_VAL(EU_PID, s_int, w->ppt[w->begtask]);
+         pid = get_int(fmtmk(N_fmt(GET_threads_fmt), def));
+         if (pid > GET_NUM_ESC) {
+            if (pid == GET_NUM_NOT) pid = def;
+            if (!pid) Thread_lazy = Lazy_pidsidx = 0;
+            else {
+               for (i = 0; i < Lazy_pidsidx; i++)
+                  if (pid == Lazy_pids[i]) break;
+               if (i < Lazy_pidsidx)
+                  Lazy_pids[i] = Lazy_pids[--Lazy_pidsidx];
+               else if (Lazy_pidsidx < LAZYPIDMAX)
+                  Lazy_pids[Lazy_pidsidx++] = pid;
+               else
+                  show_msg(fmtmk(N_fmt(LIMIT_exceed_fmt), LAZYPIDMAX));
+               Thread_lazy = 1;
+               Thread_mode = 0;
+            }
+            // force an extra procs refresh to avoid %cpu distortions...
+            Pseudo_row = PROC_XTRA;
+         }
+         break;
       case 'I':
          if (Cpu_cnt > 1) {
             Rc.mode_irixps = !Rc.mode_irixps;
@@ -5813,7 +6536,8 @@ static void keys_summary (int ch) {
    }
    switch (ch) {
       case '!':
-         if (CHKw(w, View_CPUSUM) || CHKw(w, View_CPUNOD))
+         if (CHKw(w, View_CPUSUM) || CHKw(w, View_CPUNOD)
+         || (w->rc.graph_cpus == GRAPH_heat_map))
             show_msg(N_txt(XTRA_modebad_txt));
          else {
             if (!w->rc.combine_cpus) w->rc.combine_cpus = 2;
@@ -5860,6 +6584,10 @@ static void keys_summary (int ch) {
          }
          break;
       case '4':
+         if (w->rc.graph_cpus == GRAPH_heat_map) {
+            show_msg(N_txt(XTRA_modebad_txt));
+            break;
+         }
          w->rc.double_up += 1;
          if ((w->rc.double_up >= ADJOIN_limit)
          || ((w->rc.double_up >= Cpu_cnt)))
@@ -5905,13 +6633,17 @@ static void keys_summary (int ch) {
       case 't':
          if (!CHKw(w, View_STATES))
             SETw(w, View_STATES);
-         else if (++w->rc.graph_cpus > 2) {
+         else if (++w->rc.graph_cpus > GRAPH_heat_map) {
             w->rc.graph_cpus = 0;
             OFFw(w, View_STATES);
          }
          if ((w->rc.double_up > 1)
          && (!w->rc.graph_cpus))
             w->rc.double_up = 0;
+         if (w->rc.graph_cpus == GRAPH_heat_map) {
+            w->rc.double_up = 0;
+            w->rc.combine_cpus = 0;
+         }
          break;
       default:                    // keep gcc happy
          break;
@@ -6298,7 +7030,7 @@ static void keys_xtra (int ch) {
 
         /*
          * note how alphabetical order is maintained within carefully chosen |
-         * function names such as: (s)sum_see, (t)sum_tics, and (u)sum_unify |
+         * function names: (s)sum_see, (t)sum_tics, (u)sum_unify, (v)sum_vistas |
          * with every name exactly 1 letter more than the preceding function |
          * ( surely, this must make us run much more efficiently. amirite? ) | */
 
@@ -6397,9 +7129,11 @@ static int sum_tics (struct stat_stack *this, const char *pfx, int nobuf) {
   // tailored 'results stack value' extractor macros
  #define qSv(E)  STAT_VAL(E, s_int, this)
  #define rSv(E)  TIC_VAL(E, this)
+   char row[ROWMINSIZ], mhz[SMLBUFSIZ];
+   const char *str;
    SIC_t idl_frme, tot_frme;
    struct rx_st *rx;
-   float scale;
+   float scale, deep;
 
 #ifndef CORE_TYPE_NO
    if (Curwin->rc.core_types == P_CORES_ONLY && qSv(stat_COR_TYP) != P_CORE) return 0;
@@ -6423,20 +7157,32 @@ static int sum_tics (struct stat_stack *this, const char *pfx, int nobuf) {
       Graph_cpus->part2 = rSv(stat_SUM_SYS);
       rx = sum_rx(Graph_cpus);
       if (Curwin->rc.double_up > 1)
-         return sum_see(fmtmk("%s~3%3.0f%s", pfx, rx->pcnt_tot, rx->graph), nobuf);
+         str = fmtmk("%s~3%3.0f%s", pfx, rx->pcnt_tot, rx->graph);
       else {
-         return sum_see(fmtmk("%s ~3%#5.1f~2/%-#5.1f~3 %3.0f%s"
+         str = fmtmk("%s ~3%#5.1f~2/%-#5.1f~3 %3.0f%s"
             , pfx, rx->pcnt_one, rx->pcnt_two, rx->pcnt_tot
-            , rx->graph)
-            , nobuf);
+            , rx->graph);
       }
    } else {
-      return sum_see(fmtmk(Cpu_States_fmts, pfx
+      str = fmtmk(Cpu_States_fmts, pfx
          , (float)rSv(stat_US) * scale, (float)rSv(stat_SY) * scale
          , (float)rSv(stat_NI) * scale, (float)idl_frme * scale
          , (float)rSv(stat_IO) * scale, (float)rSv(stat_IR) * scale
-         , (float)rSv(stat_SI) * scale, (float)rSv(stat_ST) * scale), nobuf);
+         , (float)rSv(stat_SI) * scale, (float)rSv(stat_ST) * scale);
    }
+   if (!Stat_freqs)
+      return sum_see(str, nobuf);
+
+   /* under that 'p' toggle, append the average MHz and the share of time
+      spent in the deepest idle state, as a percentage of the tics elapsed */
+   if (STAT_VAL(stat_FRQ, ul_int, this))
+      snprintf(mhz, sizeof(mhz), "%lu", STAT_VAL(stat_FRQ, ul_int, this) / 1000);
+   else
+      snprintf(mhz, sizeof(mhz), "-");
+   deep = (float)STAT_VAL(stat_DEP, ull_int, this) * (float)Hertz / ((float)tot_frme * 10000.0);
+   if (deep > 100.0) deep = 100.0;
+   snprintf(row, sizeof(row), FREQS_suffix, str, mhz, deep);
+   return sum_see(row, nobuf);
  #undef qSv
  #undef rSv
 } // end: sum_tics
@@ -6451,7 +7197,7 @@ static int sum_unify (struct stat_stack *this, int nobuf) {
  #define rSv(E,T)  STAT_VAL(E, T, this)
    static struct stat_result stack[MAXTBL(Stat_items)];
    static struct stat_stack accum = { &stack[0] };
-   static int ix, beg;
+   static int ix, beg, frqs;
    char pfx[16];
    int n;
 
@@ -6469,19 +7215,164 @@ static int sum_unify (struct stat_stack *this, int nobuf) {
    stack[stat_SUM_USR].result.sl_int += rSv(stat_SUM_USR, sl_int);
    stack[stat_SUM_SYS].result.sl_int += rSv(stat_SUM_SYS, sl_int);
    stack[stat_SUM_TOT].result.sl_int += rSv(stat_SUM_TOT, sl_int);
+   // the MHz are averaged for just those cpus which have reported any
+   if (Stat_freqs) {
+      if (rSv(stat_FRQ, ul_int)) {
+         stack[stat_FRQ].result.ul_int += rSv(stat_FRQ, ul_int);
+         ++frqs;
+      }
+      stack[stat_DEP].result.ull_int += rSv(stat_DEP, ull_int);
+   }
 
    if (!ix) beg = rSv(stat_ID, s_int);
    if (nobuf || ix >= (Curwin->rc.combine_cpus - 1)) {
       snprintf(pfx, sizeof(pfx), "%-7.7s:", fmtmk("%d-%d", beg, rSv(stat_ID, s_int)));
+      if (frqs) stack[stat_FRQ].result.ul_int /= frqs;
       n = sum_tics(&accum, pfx, nobuf);
       memset(&stack, 0, sizeof(stack));
-      ix = 0;
+      ix = frqs = 0;
       return n;
    }
    ++ix;
    return 0;
  #undef rSv
 } // end: sum_unify
+
+
+        /*
+         * Cpu *Helper* function to show each cpu as a single heat map cell |
+         * so that even hundreds of cpus need just a few lines. Cells are   |
+         * grouped by numa node (or else core type), with every cell simply |
+         * 1 byte of a ramp plus an occasional color change. Thus, there's  |
+         * no formatting for each cpu, just the labels for each line shown. |
+         * ( we return the number of lines printed, unlike through sum_see ) | */
+static int sum_vistas (void) {
+ #define noMAS  (Msg_row + shown + 1 >= SCREEN_ROWS - 1)
+ #define rSv(E,x)  TIC_VAL(E, Stat_reap->cpus->stacks[x])
+   static const char ramp[] = ".123456789#";
+   static int *order, *keys, *cnts, ord_siz, cnt_siz;
+#ifndef CORE_TYPE_NO
+ #ifdef CORE_TYPE_LO
+   static char ctab[] = { 'u', 'e', 'p' };
+ #else
+   static char ctab[] = { 'u', 'E', 'P' };
+ #endif
+#endif
+   char row[ROWMAXSIZ], lbl[SMLBUFSIZ], *rp;
+   const char *tier_cap[3];
+   int tier_len[3], off_len, room, colors;
+   int i, g, beg, end, grps, per_row, tot, shown = 0;
+
+   tot = Stat_reap->cpus->total;
+   if (ord_siz < tot) {
+      ord_siz = tot;
+      order = alloc_r(order, sizeof(int) * ord_siz);
+      keys = alloc_r(keys, sizeof(int) * ord_siz);
+   }
+   grps = Numa_node_tot ? Numa_node_tot + 1 : 3;
+   if (cnt_siz < grps + 1) {
+      cnt_siz = grps + 1;
+      cnts = alloc_r(cnts, sizeof(int) * cnt_siz);
+   }
+   memset(cnts, 0, sizeof(int) * cnt_siz);
+
+   /* group the cpus with one counting sort, by numa node (with the invalid
+      ones last) or else by core type (P-Cores, E-Cores then the others) */
+   for (i = 0; i < tot; i++) {
+      int key = grps - 1;
+      if (Numa_node_tot) {
+         int nod = CPU_VAL(stat_NU, i);
+         if (nod >= 0 && nod < Numa_node_tot) key = nod;
+      }
+#ifndef CORE_TYPE_NO
+      else if (CPU_VAL(stat_COR_TYP, i) == P_CORE) key = 0;
+      else if (CPU_VAL(stat_COR_TYP, i) == E_CORE) key = 1;
+      if (Curwin->rc.core_types == P_CORES_ONLY && CPU_VAL(stat_COR_TYP, i) != P_CORE) key = -1;
+      if (Curwin->rc.core_types == E_CORES_ONLY && CPU_VAL(stat_COR_TYP, i) != E_CORE) key = -1;
+#endif
+      keys[i] = key;
+      if (key >= 0) cnts[key + 1]++;
+   }
+   for (g = 1; g <= grps; g++)
+      cnts[g] += cnts[g - 1];
+   for (i = 0; i < tot; i++)
+      if (keys[i] >= 0) order[cnts[keys[i]]++] = i;
+
+   // cool cells use the normal attributes, warm and hot ones add color
+   tier_cap[0] = "";
+   tier_cap[1] = Curwin->captab[3];
+   tier_cap[2] = Curwin->captab[4];
+   for (i = 0; i < 3; i++)
+      tier_len[i] = strlen(tier_cap[i]);
+   off_len = strlen(Caps_off);
+
+   per_row = ((Screen_cols - HEAT_prefix) / (HEAT_cluster + 1)) * HEAT_cluster;
+   if (per_row < HEAT_cluster) per_row = HEAT_cluster;
+
+   for (g = 0, beg = 0; g < grps; g++, beg = end) {
+      end = cnts[g];
+      for (i = beg; i < end; ) {
+         int n, cur = 0, last = i + per_row;
+         if (noMAS) goto all_done;
+         if (last > end) last = end;
+         // a group's 1st line names its node, any others their 1st cpu
+         if (i == beg && Numa_node_tot && g < Numa_node_tot)
+            snprintf(lbl, sizeof(lbl), N_fmt(NUMA_nodenam_fmt), g);
+         else
+#ifndef CORE_TYPE_NO
+            snprintf(lbl, sizeof(lbl), N_fmt(WORD_eachcpu_fmt)
+               , Curwin->rc.core_types || (!Numa_node_tot && g < 2)
+                  ? ctab[CPU_VAL(stat_COR_TYP, order[i])] : 'u'
+               , CPU_VAL(stat_ID, order[i]));
+#else
+            snprintf(lbl, sizeof(lbl), N_fmt(WORD_eachcpu_fmt), 'u', CPU_VAL(stat_ID, order[i]));
+#endif
+         row[0] = '\0';
+         rp = scat(row, lbl);
+         // leave room for the final Caps_off plus that of PUFF's Caps_endline
+         room = sizeof(row) - (rp - row) - (last - i) * 2 - off_len - (int)strlen(Caps_endline) - 1;
+         colors = 1;
+         for (n = 0; i < last; i++, n++) {
+            SIC_t busy, all;
+            int bin, tier;
+            if (!(n % HEAT_cluster)) *rp++ = ' ';
+            all = rSv(stat_SUM_TOT, order[i]);
+            busy = rSv(stat_SUM_USR, order[i]) + rSv(stat_SUM_SYS, order[i])
+               + rSv(stat_GU, order[i]) + rSv(stat_GN, order[i]);
+            if (1 > all) busy = 0, all = 1;
+            if (busy > all) busy = all;
+            bin = (int)((busy * 10) / all);
+            tier = (bin < 3) ? 0 : (bin < 7) ? 1 : 2;
+            if (colors && tier != cur) {
+               // once out of room for color, the ramp alone must suffice
+               if (room < off_len + tier_len[tier]) {
+                  tier = 0;
+                  colors = 0;
+               }
+               if (tier != cur) {
+                  memcpy(rp, Caps_off, off_len);
+                  memcpy(rp + off_len, tier_cap[tier], tier_len[tier]);
+                  rp += off_len + tier_len[tier];
+                  room -= off_len + tier_len[tier];
+                  cur = tier;
+               }
+            }
+            *rp++ = ramp[bin];
+         }
+         if (cur) {
+            memcpy(rp, Caps_off, off_len);
+            rp += off_len;
+         }
+         *rp = '\0';
+         PUFF("%s%s\n", row, Caps_endline);
+         ++shown;
+      }
+   }
+all_done:
+   return shown;
+ #undef noMAS
+ #undef rSv
+} // end: sum_vistas
 
 /*######  Secondary summary display support (summary_show helpers)  ######*/
 
@@ -6536,6 +7427,13 @@ numa_oops:
  #undef deLIMIT
       }
 
+   } else if (!CHKw(Curwin, View_CPUSUM)
+   && (Curwin->rc.graph_cpus == GRAPH_heat_map)) {
+      /*
+       * display the 1st /proc/stat line, then every cpu's heat map cell ... */
+      Msg_row += sum_tics(Stat_reap->summary, N_txt(WORD_allcpus_txt), 1);
+      Msg_row += sum_vistas();
+
    } else if (!CHKw(Curwin, View_CPUSUM)) {
       /*
        * display each cpu's states separately, screen height permitting ... */
@@ -6595,6 +7493,81 @@ numa_oops:
 } // end: do_cpus
 
 
+        /*
+         * A helper function which will display the library costs for |
+         * the prior frame along with that frame's time ( via the 'D' ) | */
+static void do_costs (void) {
+ #define nsMS(n)  (double)(n) / 1000000.0
+   static const char *names[PROCPS_COST_COUNT] = {
+      "stat", "statm", "status", "cmdline", "environ",
+      "cgroup", "smaps", "io", "oom", "other" };
+   char files[SMLBUFSIZ], *fp = files;
+   int i;
+
+   *fp = '\0';
+   for (i = 0; i < PROCPS_COST_COUNT; i++) {
+      if (!Pids_cost->file[i].opened) continue;
+      fp += snprintf(fp, sizeof(files) - (fp - files), " %s %.1f"
+         , names[i], nsMS(Pids_cost->file[i].read_ns));
+      if (fp >= files + sizeof(files) - 1) break;
+   }
+   show_special(0, fmtmk(COSTS_line_1
+      , Cost_frame_ms, Cost_cpu_ms, nsMS(Pids_cost->total_ns)
+      , nsMS(Stat_cost->total_ns), nsMS(Mem_cost->total_ns)));
+   show_special(0, fmtmk(COSTS_line_2
+      , Pids_cost->opened, Pids_cost->reads, (double)Pids_cost->bytes / 1024.0
+      , Pids_cost->allocs, Pids_cost->vanished));
+   show_special(0, fmtmk(COSTS_line_3
+      , nsMS(Pids_cost->read_ns), nsMS(Pids_cost->parse_ns), files));
+   show_special(0, fmtmk(COSTS_line_4
+      , Memo_rows, Memo_hits, Memo_rows ? 100.0 * Memo_hits / Memo_rows : 0.0));
+   Msg_row += 4;
+ #undef nsMS
+} // end: do_costs
+
+
+        /*
+         * A helper function which will display the busiest interrupts |
+         * and softirqs since the prior frame along with each hot cpu  | */
+static void do_irqs (void) {
+   struct irq_reaped *Irq_reap;
+   struct timespec now;
+   char line[SCREENMAX], *lp = line;
+   double secs;
+   int i;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   secs = (double)(now.tv_sec - Irq_prev.tv_sec) + (double)(now.tv_nsec - Irq_prev.tv_nsec) / 1.0e9;
+   Irq_prev = now;
+   if (secs <= 0.0) secs = 1.0;
+   if (!(Irq_reap = procps_irq_reap(Irq_ctx, Irq_items, MAXTBL(Irq_items))))
+      error_exit(fmtmk(N_fmt(LIB_errorirq_fmt), __LINE__, strerror(errno)));
+   procps_irq_sort(Irq_ctx, Irq_reap->stacks, Irq_reap->total
+      , IRQ_DELTA_TOTAL, IRQ_SORT_DESCEND);
+
+   *lp = '\0';
+   for (i = 0; i < Irq_reap->total && i < IRQS_limit; i++) {
+      int delta = IRQ_VAL_x(irq_DEL, s_int, i);
+      int hot = IRQ_VAL_x(irq_HOT, s_int, i);
+      char tmp[SMLBUFSIZ];
+
+      if (delta <= 0) break;
+      if (hot < 0)
+         snprintf(tmp, sizeof(tmp), " %s %.0f/s"
+            , IRQ_VAL_x(irq_NAM, str, i), delta / secs);
+      else
+         snprintf(tmp, sizeof(tmp), " %s %.0f/s (cpu%d %d%%)"
+            , IRQ_VAL_x(irq_NAM, str, i), delta / secs
+            , hot, (int)(100.0 * IRQ_VAL_x(irq_MAX, s_int, i) / delta));
+      // stop short of what the screen width could ever show
+      if ((lp - line) + (int)strlen(tmp) + 1 >= Screen_cols) break;
+      lp += snprintf(lp, sizeof(line) - (lp - line), "%s", tmp);
+   }
+   show_special(0, fmtmk(IRQS_line, *line ? line : " -"));
+   Msg_row += 1;
+} // end: do_irqs
+
+
         /*
          * A helper function which will display the memory/swap stuff |
          * ( so as to keep the 'summary_show' guy a reasonable size ) | */
@@ -6718,6 +7691,56 @@ static void do_memory (void) {
 
 /*######  Main Screen routines  ##########################################*/
 
+        /*
+         * Adjust the delay and any degradations so that our cpu time
+         * for each frame stays within the '-B' budget, preferring a |
+         * stretched delay over any lost information (when possible) | */
+static void budget_govern (double cpu_ms) {
+ #define needs(c)  ((c) * (100.0 / Budget_pct - 1.0))
+   static double costs[BUDGET_fields + 1];   // smoothed cpu secs for each level
+   static int frames;                        // frames seen at the current level
+   double max, need;
+   int was = Budget_level;
+   char *p;
+
+   costs[was] = frames ? costs[was] * 0.7 + cpu_ms / 1000.0 * 0.3 : cpu_ms / 1000.0;
+   ++frames;
+   if ((max = Rc.delay_time * BUDGET_STRETCH) < BUDGET_MINDLY)
+      max = BUDGET_MINDLY;
+   need = needs(costs[was]);
+
+   /* when even the longest delay won't do, shed some work (but only after
+      a cost for the current level has been confirmed) -- then later relax
+      if the prior level now fits or, lacking some proof, now and again... */
+   if (need > max) {
+      if (was < BUDGET_fields && frames > 1) ++Budget_level;
+   } else if (was > BUDGET_all) {
+      if (needs(costs[was - 1]) < max * 0.8 || frames > BUDGET_PROBE)
+         --Budget_level;
+   }
+   if (Budget_level != was) {
+      frames = 0;
+      // force a calibrate_fields, thus revising our library items
+      Frames_signal = BREAK_kbd;
+   }
+
+   Budget_delay = need < Rc.delay_time ? Rc.delay_time : need > max ? max : need;
+
+   *(p = Budget_note) = '\0';
+   if (Budget_delay > Rc.delay_time || Budget_level) {
+      p += snprintf(p, sizeof(Budget_note), ", budget: %.1f secs", Budget_delay);
+      if (Budget_level >= BUDGET_names)
+         p += snprintf(p, sizeof(Budget_note) - (p - Budget_note), ", names only");
+      if (Budget_level == BUDGET_stale)
+         snprintf(p, sizeof(Budget_note) - (p - Budget_note), ", costly fields %.0f secs old", Budget_aged);
+      if (Budget_level >= BUDGET_fields)
+         snprintf(p, sizeof(Budget_note) - (p - Budget_note), ", costly fields off");
+   }
+   Budget_aged = 0;
+ #undef needs
+} // end: budget_govern
+
+
         /*
          * Process keyboard input during the main loop */
 static void do_key (int ch) {
@@ -6726,8 +7749,8 @@ static void do_key (int ch) {
       char keys[SMLBUFSIZ];
    } key_tab[] = {
       { keys_global,
-         { '?', 'B', 'd', 'E', 'e', 'f', 'g', 'H', 'h'
-         , 'I', 'k', 'r', 's', 'X', 'Y', 'Z', '0'
+         { '?', 'B', 'D', 'd', 'E', 'e', 'f', 'g', 'H', 'h'
+         , 'I', 'K', 'k', 'p', 'Q', 'r', 's', 'X', 'Y', 'Z', '0'
          , kbd_CtrlE, kbd_CtrlG, kbd_CtrlI, kbd_CtrlK, kbd_CtrlL
          , kbd_CtrlN, kbd_CtrlP, kbd_CtrlR, kbd_CtrlU
          , kbd_ENTER, kbd_SPACE, kbd_BTAB, '\0' } },
@@ -6806,6 +7829,49 @@ all_done:
 } // end: do_key
 
 
+        /*
+         * Ready a window's row memoization for this frame, making room
+         * for the rows that might be shown and hashing everything else,
+         * beyond a task's own results, which could affect those rows. */
+static void memo_prep (const WIN_t *q, int rows) {
+ #define mixIN(v)  ( h = (h ^ (unsigned long long)(v)) * 0x100000001b3ULL )
+   unsigned long long h = 0xcbf29ce484222325ULL;
+   int i, j, need;
+
+   // a task's slot is its tid modulo the table size, so leave plenty
+   for (need = 64; need < 4 * rows; need <<= 1)
+      ;
+   if (need > Memo_siz) {
+      for (i = 0; i < GROUPSMAX; i++) {
+         if (!Memo_tab[i]) continue;
+         for (j = 0; j < Memo_siz; j++)
+            free(Memo_tab[i][j].row);
+         free(Memo_tab[i]);
+         Memo_tab[i] = NULL;
+      }
+      Memo_siz = need;
+   }
+   if (!Memo_tab[q->winnum - 1])
+      Memo_tab[q->winnum - 1] = alloc_c(sizeof(struct memo_s) * Memo_siz);
+
+   mixIN(Memo_gen);
+   mixIN(Screen_cols);
+   mixIN(q->rc.winflags);
+   mixIN(q->varcolsz);
+#ifndef SCROLLVAR_NO
+   mixIN(q->varcolbeg);
+#endif
+   mixIN(q == Curwin);
+   mixIN(q->focus_pid);
+   mixIN(Rc.mode_altscr);
+   mixIN(Budget_level);
+   mixIN(Restrict_some);
+   if (!Restrict_some) mixIN(MEM_VAL(mem_TOT));
+   Memo_key[q->winnum - 1] = h;
+ #undef mixIN
+} // end: memo_prep
+
+
         /*
          * In support of a new frame:
          *    1) Display uptime and load average (maybe)
@@ -6822,22 +7888,26 @@ static void summary_show (void) {
       if (isROOM(View_STATES, 1)) {
          show_special(0, fmtmk(N_unq(STATE_line_1_fmt)
             , Thread_mode ? N_txt(WORD_threads_txt) : N_txt(WORD_process_txt)
-            , PIDSmaxt, Pids_reap->counts->running
+            , Pids_reap->counts->total, Pids_reap->counts->running
             , Pids_reap->counts->sleeping + Pids_reap->counts->other
             , Pids_reap->counts->disk_sleep
             , Pids_reap->counts->stopped, Pids_reap->counts->zombied));
          Msg_row += 1;
       }
+      if (Irq_mode && Msg_row + 1 < SCREEN_ROWS - 1)
+         do_irqs();
+      if (Cost_mode && Msg_row + 4 < SCREEN_ROWS - 1)
+         do_costs();
       return;
    }
 
    // Display Uptime and Loadavg
    if (isROOM(View_LOADAV, 1)) {
       if (!Rc.mode_altscr)
-         show_special(0, fmtmk(LOADAV_line, Myname, procps_uptime_sprint()));
+         show_special(0, fmtmk(LOADAV_line, Myname, procps_uptime_sprint(), Budget_note));
       else
          show_special(0, fmtmk(CHKw(Curwin, Show_TASKON)? LOADAV_line_alt : LOADAV_line
-            , Curwin->grpname, procps_uptime_sprint()));
+            , Curwin->grpname, procps_uptime_sprint(), Budget_note));
       Msg_row += 1;
    } // end: View_LOADAV
 
@@ -6851,7 +7921,7 @@ static void summary_show (void) {
    if (isROOM(View_STATES, 2)) {
       show_special(0, fmtmk(N_unq(STATE_line_1_fmt)
          , Thread_mode ? N_txt(WORD_threads_txt) : N_txt(WORD_process_txt)
-         , PIDSmaxt, Pids_reap->counts->running
+         , Pids_reap->counts->total, Pids_reap->counts->running
          , Pids_reap->counts->sleeping + Pids_reap->counts->other
          , Pids_reap->counts->disk_sleep
          , Pids_reap->counts->stopped, Pids_reap->counts->zombied));
@@ -6868,10 +7938,84 @@ static void summary_show (void) {
       do_memory();
    }
 
+   // Display the busiest irqs (since that prior frame)
+   if (Irq_mode && Msg_row + 1 < SCREEN_ROWS - 1)
+      do_irqs();
+
+   // Display our own costs (for that prior frame)
+   if (Cost_mode && Msg_row + 4 < SCREEN_ROWS - 1)
+      do_costs();
+
  #undef isROOM
 } // end: summary_show
 
 
+        /*
+         * Hash just those raw results which task_show would format for a
+         * task, plus its window's memo_prep key, so that an unchanged row
+         * can be reused instead of being formatted all over again. */
+static unsigned long long task_hash (const WIN_t *q, int idx) {
+ #define rSv(E,T)  PID_VAL(E, T, p)
+ #define mixIN(v)  ( h = (h ^ (unsigned long long)(v)) * 0x100000001b3ULL )
+   struct pids_stack *p = q->ppt[idx];
+   unsigned long long h = Memo_key[q->winnum - 1];
+   const unsigned char *str;
+   unsigned bits;
+   float pcpu;
+   int x, n;
+
+   mixIN(rSv(EU_STA, s_ch));           // for any Show_HIROWS highlighting
+   for (x = 0; x < q->maxpflgs; x++) {
+      FLG_t i = q->procflgs[x];
+
+      switch (i) {
+#ifndef USE_X_COLHDR
+         case EU_XOF:
+         case EU_XON:
+            continue;
+#endif
+         case EU_CPU:        // this one's scaled by each frame's elapsed time
+            pcpu = task_pcpu(q, p);
+            memcpy(&bits, &pcpu, sizeof(bits));
+            mixIN(bits);
+            continue;
+         case EU_TM2:
+         case EU_TME:
+            mixIN(rSv(eu_TICS_ALL_C, ull_int));
+            mixIN(rSv(i, ull_int));
+            continue;
+         case EU_CMD:        // plus whatever forest_display might add
+            mixIN(rSv(eu_TREE_LVL, s_int));
+            mixIN(rSv(eu_TREE_HID, s_ch));
+            mixIN(lazy_thread(p));
+            mixIN(idx >= q->focus_beg && idx < q->focus_end);
+            str = (const unsigned char *)rSv(CMDLIN(q) ? eu_CMDLINE : EU_CMD, str);
+            break;
+         case EU_CGN: case EU_CGR: case EU_CLS: case EU_DKR: case EU_ENV:
+         case EU_EXE: case EU_GRP: case EU_LXC: case EU_SGD: case EU_SGN:
+         case EU_TTY: case EU_UEN: case EU_URN: case EU_USN: case EU_WCH:
+            str = (const unsigned char *)rSv(i, str);
+            break;
+         default:            // every other result is a number of some sort
+            mixIN(rSv(i, ull_int));
+            continue;
+      }
+      // nothing beyond SCREENMAX (plus any scrolling) could ever be seen
+#ifndef SCROLLVAR_NO
+      n = SCREENMAX + 4 * q->varcolbeg;
+#else
+      n = SCREENMAX;
+#endif
+      while (*str && n--)
+         mixIN(*str++);
+      mixIN(n);
+   }
+   return h;
+ #undef rSv
+ #undef mixIN
+} // end: task_hash
+
+
         /*
          * Build the information for a single task row and
          * display the results or return them to the caller. */
@@ -6890,10 +8034,15 @@ static const char *task_show (const WIN_t *q, int idx) {
  #define makeVAR(S)  { cp = make_str(S, q->varcolsz, Js, AUTOX_NO); }
  #define varUTF8(S)  { cp = make_str_utf8(S, q->varcolsz, Js, AUTOX_NO); }
 #endif
+   // the library tells us which strings it found to be pure ascii while
+   // escaping them, sparing those any of the multi-byte width overhead
+ #define isASCII(E)  ( procps_pids_str_cols(p, E, &ascii), ascii )
    struct pids_stack *p = q->ppt[idx];
    static char rbuf[ROWMINSIZ];
+   struct memo_s *m = NULL;
+   unsigned long long hash = 0;
    char *rp;
-   int x;
+   int x, ascii;
 
    /* we use up to three additional 'PIDS_extra' results in our stacks
          eu_TREE_HID (s_ch) : where 'x' == collapsed and 'z' == unseen
@@ -6904,6 +8053,28 @@ static const char *task_show (const WIN_t *q, int idx) {
 #endif
    if (CHKw(q, Show_FOREST) && rSv(eu_TREE_HID, s_ch)  == 'z')
       return "";
+   if (q->osel_tot && !osel_prefilter(q, p))
+      return "";
+   // the '-B' governor notes the oldest of any fields it let the library retain
+   if (Budget_level == BUDGET_stale)
+      for (x = 0; x < q->maxpflgs; x++)
+         if (budget_costly(q->procflgs[x])
+         && Budget_aged < procps_pids_age(p, q->procflgs[x]))
+            Budget_aged = procps_pids_age(p, q->procflgs[x]);
+
+   /* when nothing that goes into this row has changed since we last built
+      it, there's no need to format it again ( but any other filters might
+      reject some fields, and the NOPRINT_xxx users can span every task ) */
+   if (!q->osel_tot && !CHKw(q, NOPRINT_xxx) && Memo_tab[q->winnum - 1]) {
+      hash = task_hash(q, idx);
+      m = &Memo_tab[q->winnum - 1][rSv(EU_PID, s_int) & (Memo_siz - 1)];
+      ++Memo_rows;
+      if (m->row && m->tid == rSv(EU_PID, s_int) && m->hash == hash) {
+         ++Memo_hits;
+         strcpy(rbuf, m->row);
+         goto memo_hit;
+      }
+   }
 
    // we must begin a row with a possible window number in mind...
    *(rp = rbuf) = '\0';
@@ -6921,6 +8092,11 @@ static const char *task_show (const WIN_t *q, int idx) {
       by result type according to capacity (small -> large) and then ordered by
       additional processing requirements (as in plain, scaled, decorated, etc.) */
 
+      if (Budget_level == BUDGET_fields && budget_costly(i) && PIDS_noop == Pids_itms[i]) {
+         // the '-B' governor has suspended this field's refresh
+         if (VARcol(i)) makeVAR("-")
+         else cp = make_str("-", W, Js, AUTOX_NO);
+      } else
       switch (i) {
 #ifndef USE_X_COLHDR
          // these 2 aren't real procflgs, they're used in column highlighting!
@@ -6978,26 +8154,7 @@ static const char *task_show (const WIN_t *q, int idx) {
             break;
    /* s_int, scale_pcnt with special handling */
          case EU_CPU:        // PIDS_TICS_ALL_DELTA
-         {  float u = (float)rSv(EU_CPU, u_int);
-            int n = rSv(EU_THD, s_int);
-#ifndef TREE_VCPUOFF
- #ifndef TREE_VWINALL
-            if (q == Curwin) // note: the following is NOT indented
- #endif
-            if (CHKw(q, Show_FOREST)) u += rSv(eu_TREE_ADD, u_int);
-            u *= Frame_etscale;
-            /* technically, eu_TREE_HID is only valid if Show_FOREST is active
-               but its zeroed out slot will always be present now */
-            if (rSv(eu_TREE_HID, s_ch) != 'x' && u > 100.0 * n) u = 100.0 * n;
-#else
-            u *= Frame_etscale;
-            /* process can't use more %cpu than number of threads it has
-             ( thanks Jaromir Capik <jcapik@redhat.com> ) */
-            if (u > 100.0 * n) u = 100.0 * n;
-#endif
-            if (u > Cpu_pmax) u = Cpu_pmax;
-            cp = scale_pcnt(u, W, Jn, 0);
-         }
+            cp = scale_pcnt(task_pcpu(q, p), W, Jn, 0);
             break;
    /* ull_int, scale_pcnt for 'utilization' */
          case EU_CUU:        // PIDS_UTILIZATION
@@ -7104,6 +8261,9 @@ static const char *task_show (const WIN_t *q, int idx) {
          case EU_CGR:        // PIDS_CGROUP
          case EU_ENV:        // PIDS_ENVIRON
          case EU_EXE:        // PIDS_EXE
+            if (isASCII(i)) makeVAR(rSv(i, str))
+            else varUTF8(rSv(i, str))
+            break;
          case EU_SGN:        // PIDS_SUPGROUPS
             varUTF8(rSv(i, str))
             break;
@@ -7113,7 +8273,9 @@ static const char *task_show (const WIN_t *q, int idx) {
             break;
    /* str, make_str with variable width + additional decoration */
          case EU_CMD:        // PIDS_CMD or PIDS_CMDLINE
-            varUTF8(forest_display(q, idx))
+            // ( any forest artwork is itself ascii )
+            if (isASCII(CMDLIN(q) ? eu_CMDLINE : EU_CMD)) makeVAR(forest_display(q, idx))
+            else varUTF8(forest_display(q, idx))
             break;
          default:            // keep gcc happy
             continue;
@@ -7129,6 +8291,18 @@ static const char *task_show (const WIN_t *q, int idx) {
       #undef Jn
    } // end: for 'maxpflgs'
 
+   if (m) {
+      x = (int)(rp - rbuf) + 1;
+      if (m->siz < x) {
+         m->row = alloc_r(m->row, x);
+         m->siz = x;
+      }
+      memcpy(m->row, rbuf, x);
+      m->tid = rSv(EU_PID, s_int);
+      m->hash = hash;
+   }
+
+memo_hit:
    if (!CHKw(q, NOPRINT_xxx)) {
       const char *cap = ((CHKw(q, Show_HIROWS) && 'R' == rSv(EU_STA, s_ch)))
          ? q->capclr_rowhigh : q->capclr_rownorm;
@@ -7157,6 +8331,7 @@ static const char *task_show (const WIN_t *q, int idx) {
  #undef rSv
  #undef makeVAR
  #undef varUTF8
+ #undef isASCII
 } // end: task_show
 
 
@@ -7240,16 +8415,18 @@ static int window_show (WIN_t *q, int wmax) {
       if (q->focus_pid) forest_config(q);
    } else {
       enum pids_item item = Fieldstab[q->rc.sortindx].item;
-      if (item == PIDS_CMD && CHKw(q, Show_CMDLIN))
+      if (item == PIDS_CMD && CMDLIN(q))
          item = PIDS_CMDLINE;
       else if (item == PIDS_TICS_ALL && CHKw(q, Show_CTIMES))
          item = PIDS_TICS_ALL_C;
-      if (!(procps_pids_sort(Pids_ctx, q->ppt , PIDSmaxt, item, sORDER)))
+      if (!(procps_pids_sort_hinted(Pids_ctx, &q->sort_hint, q->ppt, PIDSmaxt, item, sORDER)))
          error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+      if (Thds_total) lazy_nest(q);
    }
 
    if (mkVIZyes) window_hlp();
    else OFFw(q, NOPRINT_xxx);
+   memo_prep(q, winMIN(wmax, PIDSmaxt));
 
    i = q->begtask;
    lwin = 1;                                        // 1 for the column header
@@ -7321,8 +8498,14 @@ static void frame_hlp (int wix, int max) {
          */
 static void frame_make (void) {
    WIN_t *w = Curwin;             // avoid gcc bloat with a local copy
+   struct timespec wall, cpu, now;
    int i, scrlins;
 
+   if (Cost_mode || Budget_pct) {
+      clock_gettime(CLOCK_MONOTONIC, &wall);
+      clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+   }
+
    // check auto-sized width increases from the last iteration...
    if (AUTOX_MODE && Autox_found)
       widths_resize();
@@ -7339,6 +8522,9 @@ static void frame_make (void) {
 #ifdef THREADED_TSK
    sem_post(&Semaphore_tasks_beg);
 #else
+#ifdef FRAME_SNAPSHOT
+   snapshot_refresh();
+#endif
    tasks_refresh(NULL);
 #endif
 
@@ -7364,6 +8550,10 @@ static void frame_make (void) {
       sem_wait(&Semaphore_tasks_end);
       sem_post(&Semaphore_tasks_beg);
 #else
+#ifdef FRAME_SNAPSHOT
+      // only the tasks are re-primed, leaving the cpu tics undisturbed
+      Snap_reap = NULL;
+#endif
       tasks_refresh(NULL);
 #endif
       putp(Cap_clr_scr);
@@ -7372,6 +8562,8 @@ static void frame_make (void) {
 
    Tree_idx = Pseudo_row = Msg_row = scrlins = 0;
    summary_show();
+   // ( the 'D' toggle has now shown the prior frame's memoization )
+   Memo_rows = Memo_hits = 0;
    Max_lines = (SCREEN_ROWS - Msg_row) - 1;
 
    // we're now on Msg_row so clear out any residual messages ...
@@ -7413,6 +8605,16 @@ static void frame_make (void) {
    /* we'll deem any terminal not supporting tgoto as dumb and disable
       the normal non-interactive output optimization... */
    if (!Cap_can_goto) PSU_CLREOS(0);
+
+   if (Cost_mode || Budget_pct) {
+    #define tsMS(a,b) ((a.tv_sec - b.tv_sec) * 1000.0 + (a.tv_nsec - b.tv_nsec) / 1000000.0)
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      Cost_frame_ms = tsMS(now, wall);
+      clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+      Cost_cpu_ms = tsMS(now, cpu);
+    #undef tsMS
+      if (Budget_pct) budget_govern(Cost_cpu_ms);
+   }
 } // end: frame_make
 
 
@@ -7431,14 +8633,16 @@ int main (int argc, char *argv[]) {
 
    for (;;) {
       struct timespec ts;
+      float delay;
 
       frame_make();
 
       if (0 < Loops) --Loops;
       if (!Loops) bye_bye(NULL);
 
-      ts.tv_sec = Rc.delay_time;
-      ts.tv_nsec = (Rc.delay_time - (int)Rc.delay_time) * 1000000000;
+      delay = Budget_pct ? Budget_delay : Rc.delay_time;
+      ts.tv_sec = delay;
+      ts.tv_nsec = (delay - (int)delay) * 1000000000;
 
       if (Batch)
          pselect(0, NULL, NULL, NULL, &ts, NULL);
@@ -126,6 +126,11 @@ char *strcasestr(const char *haystack, const char *needle);
         /* Specific process id monitoring support (command line only) */
 #define MONPIDMAX  20
 
+        /* Lazy thread expansion support (the 'K' command), where only
+           some tasks have their threads read and shown beneath them */
+#define LAZYPIDMAX  20             // tasks which can be expanded explicitly
+#define LAZYBUSIEST 3              // plus these busiest multi-threaded tasks
+
         /* Output override minimums (the -w switch and/or env vars) */
 #define W_MIN_COL  3
 #define W_MIN_ROW  3
@@ -152,7 +157,7 @@ char *strcasestr(const char *haystack, const char *needle);
       many termcap/color transitions - these definitions ensure we have room */
 #define ROWMINSIZ  ( SCREENMAX +  8 * (CAPBUFSIZ + CLRBUFSIZ) )
 #define ROWMAXSIZ  ( SCREENMAX + 16 * (CAPBUFSIZ + CLRBUFSIZ) )
-   // minimum size guarantee for dynamically acquired 'readfile' buffer
+   // minimum size guarantee for dynamically acquired 'Insp_buf' buffer
 #define READMINSZ  2048
    // size of preallocated search string buffers, same as ioline()
 #define FNDBUFSIZ  MEDBUFSIZ
@@ -242,6 +247,16 @@ enum scale_enum {
    SK_Kb, SK_Mb, SK_Gb, SK_Tb, SK_Pb, SK_Eb
 };
 
+        /* The degradations imposed by the '-B' cpu budget governor,
+           beyond any stretched delay, in the order they're applied */
+enum budget_lvl {
+   BUDGET_all, BUDGET_names, BUDGET_stale, BUDGET_fields
+};
+#define BUDGET_STRETCH  4.0       // the delay may be stretched this many times
+#define BUDGET_MINDLY   1.0       // ( but to at least this many seconds )
+#define BUDGET_PROBE    30        // frames before a degradation is retried
+#define BUDGET_SMAPS    10.0      // how long BUDGET_stale lets smaps go unread
+
         /* Used to manipulate (and document) the Frames_signal states */
 enum resize_states {
    BREAK_off = 0, BREAK_kbd, BREAK_sig, BREAK_autox, BREAK_screen
@@ -404,6 +419,7 @@ typedef struct WIN_t {
    int    focus_lvl;                   // the indentation level of parent task
 #endif
    struct pids_stack **ppt;            // this window's stacks ptr array
+   struct pids_sort_hint *sort_hint;   // its last sort order, for the library
    struct WIN_t *next,                 // next window in window stack
                 *prev;                 // prior window in window stack
 } WIN_t;
@@ -417,6 +433,8 @@ typedef struct WIN_t {
 #define VIZISw(q)    (!Rc.mode_altscr || CHKw(q,Show_TASKON))
 #define VIZCHKw(q)   (VIZISw(q)) ? 1 : win_warn(Warn_VIZ)
 #define VIZTOGw(q,f) (VIZISw(q)) ? TOGw(q,(f)) : win_warn(Warn_VIZ)
+        // ( the 'c' toggle, unless the '-B' governor has overridden it )
+#define CMDLIN(q)    (CHKw(q, Show_CMDLIN) && Budget_level < BUDGET_names)
 
         // Used to test/manipulte fieldscur values
 #define FLDon        0x01
@@ -611,8 +629,15 @@ typedef struct WIN_t {
 
         /* Summary Lines specially formatted string(s) --
            see 'show_special' for syntax details + other cautions. */
-#define LOADAV_line  "%s -%s\n"
-#define LOADAV_line_alt  "%s~6 -%s\n"
+#define LOADAV_line  "%s -%s%s\n"
+#define LOADAV_line_alt  "%s~6 -%s%s\n"
+#define COSTS_line_1 "Cost: %8.1f ms frame, %8.1f ms cpu;  pids %.2f, stat %.2f, mem %.2f\n"
+#define COSTS_line_2 "Pids: %8lu files, %8lu reads, %8.1f KiB, %lu allocs, %lu vanished\n"
+#define COSTS_line_3 "Read: %8.1f ms, %8.1f ms parse;%s\n"
+#define COSTS_line_4 "Rows: %8u shown, %8u reused, %5.1f%% hit rate\n"
+#define IRQS_line    "Irqs:%s\n"
+#define IRQS_limit   8
+#define FREQS_suffix "%s~3%5s ~2MHz,~3%5.1f ~2dc~3 ~1"
 
 /*######  For Piece of mind  #############################################*/
 
@@ -679,7 +704,6 @@ typedef struct WIN_t {
 //atic int           iokey (int action);
 //atic char         *ioline (const char *prompt);
 //atic int           mkfloat (const char *str, float *num, int whole);
-//atic int           readfile (FILE *fp, char **baddr, size_t *bsize, size_t *bread);
 /*------  Small Utility routines  ----------------------------------------*/
 //atic float         get_float (const char *prompt);
 //atic int           get_int (const char *prompt);
@@ -698,6 +722,7 @@ typedef struct WIN_t {
 /*------  Fields Management support  -------------------------------------*/
 /*atic struct        Fieldstab[] = { ... }                                */
 //atic void          adj_geometry (void);
+//atic inline int    budget_costly (FLG_t f);
 //atic void          build_headers (void);
 //atic void          calibrate_fields (void);
 //atic void          display_fields (int focus, int extend);
@@ -707,14 +732,22 @@ typedef struct WIN_t {
 /*------  Library Interface (as separate threads)  -----------------------*/
 //atic void         *cpus_refresh (void *unused);
 //atic void         *memory_refresh (void *unused);
+//atic int           lazy_compare (const void *a, const void *b);
+//atic inline int    lazy_thread (struct pids_stack *p);
+//atic void          lazy_nest (WIN_t *q);
+//atic void          lazy_refresh (void);
 //atic void         *tasks_refresh (void *unused);
 /*------  Inspect Other Output  ------------------------------------------*/
 //atic void          insp_cnt_nl (void);
+//atic void          insp_end (void);
+//atic ssize_t       insp_more (void);
+//atic void          insp_begin (FILE *fp, int pipe);
 #ifndef INSP_OFFDEMO
 //atic void          insp_do_demo (char *fmts, int pid);
 #endif
 //atic void          insp_do_file (char *fmts, int pid);
 //atic void          insp_do_pipe (char *fmts, int pid);
+//atic int           insp_wait (void);
 //atic inline int    insp_find_ofs (int col, int row);
 //atic void          insp_find_str (int ch, int *col, int *row);
 //atic void          insp_mkrow_raw (int col, int row);
@@ -723,9 +756,12 @@ typedef struct WIN_t {
 //atic int           insp_view_choice (struct pids_stack *p);
 //atic void          inspection_utility (int pid);
 /*------  Other Filtering ------------------------------------------------*/
+//atic float         task_pcpu (const WIN_t *q, struct pids_stack *p);
+//atic int           osel_how (int enu, int ops);
 //atic const char   *osel_add (WIN_t *q, int ch, char *glob, int push);
 //atic void          osel_clear (WIN_t *q);
 //atic inline int    osel_matched (const WIN_t *q, FLG_t enu, const char *str);
+//atic int           osel_prefilter (const WIN_t *q, struct pids_stack *p);
 /*------  Startup routines  ----------------------------------------------*/
 //atic void          before (char *me);
 //atic int           cfg_xform (WIN_t *q, char *flds, const char *defs);
@@ -779,9 +815,12 @@ typedef struct WIN_t {
 //atic int           sum_tics (struct stat_stack *this, const char *pfx, int nobuf);
 //atic int           sum_unify (struct stat_stack *this, int nobuf);
 /*------  Secondary summary display support (summary_show helpers)  ------*/
+//atic void          do_costs (void);
+//atic void          do_irqs (void);
 //atic void          do_cpus (void);
 //atic void          do_memory (void);
 /*------  Main Screen routines  ------------------------------------------*/
+//atic void          budget_govern (double cpu_ms);
 //atic void          do_key (int ch);
 //atic void          summary_show (void);
 //atic const char   *task_show (const WIN_t *q, int idx);
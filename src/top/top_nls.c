@@ -423,6 +423,7 @@ static void build_norm_nlstab (void) {
       " %s [options]\n"
       "\n"
       "Options:\n"
+      " -B, --cpu-budget =PERCENT       limit our cpu use to this PERCENT\n"
       " -b, --batch-mode                run in non-interactive batch mode\n"
       " -c, --cmdline-toggle            reverse last remembered 'c' state\n"
       " -d, --delay =SECS [.TENTHS]     iterative delay as SECS [.TENTHS]\n"
@@ -445,6 +446,7 @@ static void build_norm_nlstab (void) {
       " -V, --version                   output version information & exit\n"
       "\n"
       "For more details see top(1).");
+   Norm_nlstab[BAD_cpubudget_fmt] = _("bad cpu budget '%s'");
    Norm_nlstab[BAD_delayint_fmt] = _("bad delay interval '%s'");
    Norm_nlstab[BAD_niterate_fmt] = _("bad iterations argument '%s'");
    Norm_nlstab[LIMIT_exceed_fmt] = _("pid limit (%d) exceeded");
@@ -470,6 +472,7 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[THREADS_show_fmt] = _("Show threads %s");
    Norm_nlstab[IRIX_curmode_fmt] = _("Irix mode %s");
    Norm_nlstab[GET_pid2kill_fmt] = _("PID to signal/kill [default pid = %d]");
+   Norm_nlstab[GET_threads_fmt] = _("PID to show/hide threads (0 = off) [default pid = %d]");
    Norm_nlstab[GET_sigs_num_fmt] = _("Send pid %d signal [%d/sigterm]");
    Norm_nlstab[FAIL_signals_fmt] = _("Failed signal pid '%d' with '%d': %s");
    Norm_nlstab[BAD_signalid_txt] = _("Invalid signal");
@@ -604,6 +607,7 @@ static void build_norm_nlstab (void) {
    Norm_nlstab[WORD_abv_swp_txt] = _("Swap");
    Norm_nlstab[LIB_errormem_fmt] = _("library failed memory statistics, at %d: %s");
    Norm_nlstab[LIB_errorcpu_fmt] = _("library failed cpu statistics, at %d: %s");
+   Norm_nlstab[LIB_errorirq_fmt] = _("library failed irq statistics, at %d: %s");
    Norm_nlstab[LIB_errorpid_fmt] = _("library failed pids statistics, at %d: %s");
    Norm_nlstab[BAD_memscale_fmt] = _("bad memory scaling arg '%s'");
    Norm_nlstab[XTRA_vforest_fmt] = _("PID to collapse/expand [default pid = %d]");
@@ -688,7 +692,8 @@ static void build_uniq_nlstab (void) {
       "%s"
       "  ^G,K,N,U  View: ctl groups ~1^G~2; cmdline ~1^K~2; environment ~1^N~2; supp groups ~1^U~2\n"
       "  Y,!,^E,P  Inspect '~1Y~2'; Combine Cpus '~1!~2'; Scale time ~1^E~2; View namespaces ~1^P~2\n"
-      "  W,q       Write config file '~1W~2'; Quit '~1q~2'\n"
+      "  K,W,q,D   Threads of PID '~1K~2'; Write config '~1W~2'; Quit '~1q~2'; Frame costs '~1D~2'\n"
+      "  Q,p       Busiest irqs line '~1Q~2'; Cpu MHz + deepest idle state '~1p~2'\n"
       "          ( commands shown with '.' require a ~1visible~2 task display ~1window~2 ) \n"
       "Press '~1h~2' or '~1?~2' for help with ~1Windows~2,\n"
       "Type 'q' or <Esc> to continue ");
@@ -46,11 +46,14 @@
 #include "strutils.h"
 
 #include "diskstats.h"
+#include "irq.h"
 #include "meminfo.h"
 #include "misc.h"
+#include "netdev.h"
 #include "slabinfo.h"
 #include "stat.h"
 #include "vmstat.h"
+#include "zones.h"
 
 #define UNIT_B        1
 #define UNIT_k        1000
@@ -67,6 +70,9 @@ static char szDataUnit[3] = "K";
 #define SLABSTAT      0x00000004
 #define PARTITIONSTAT 0x00000008
 #define DISKSUMSTAT   0x00000010
+#define IRQSTAT       0x00000020
+#define NETSTAT       0x00000040
+#define FRAGSTAT      0x00000080
 
 static int statMode = VMSTAT;
 
@@ -222,8 +228,11 @@ static void __attribute__ ((__noreturn__))
     fputs(USAGE_OPTIONS, out);
     fputs(_(" -a, --active           active/inactive memory\n"), out);
     fputs(_(" -f, --forks            number of forks since boot\n"), out);
+    fputs(_(" -F, --fragmentation    memory zone fragmentation\n"), out);
+    fputs(_(" -i, --irqs             interrupt and softirq rates\n"), out);
     fputs(_(" -m, --slabs            slabinfo\n"), out);
     fputs(_(" -n, --one-header       do not redisplay header\n"), out);
+    fputs(_(" -N, --network          network interface rates\n"), out);
     fputs(_(" -s, --stats            event counter statistics\n"), out);
     fputs(_(" -d, --disk             disk statistics\n"), out);
     fputs(_(" -D, --disk-sum         summarize disk statistics\n"), out);
@@ -824,6 +833,297 @@ static void slabformat (void)
  #undef slabVAL
 }
 
+static void irqheader(void)
+{
+    printf("%-10s %12s %10s %5s %5s %5s  %s\n",
+    /* Translation Hint: Translating folloging irq fields that
+     * follow (marked with max x chars) might not work, unless
+     * manual page is translated as well.  */
+           /* Translation Hint: max 10 chars */
+           _("IRQ"),
+           /* Translation Hint: max 12 chars */
+           _("total"),
+           /* Translation Hint: max 10 chars */
+           _("per sec"),
+           /* Translation Hint: max 5 chars */
+           _("cpus"),
+           /* Translation Hint: max 5 chars */
+           _("hot"),
+           /* Translation Hint: max 5 chars */
+           _("hot%"),
+           _("description"));
+}
+
+static void irqformat(void)
+{
+ #define MAX_ITEMS (int)(sizeof(node_items) / sizeof(node_items[0]))
+ #define irqVAL(e,t) IRQ_VAL(e, t, p)
+    struct irq_info *irq_info = NULL;
+    struct irq_reaped *reaped;
+    unsigned long i, max, count;
+    double uptime, secs;
+    int j, k, ncpus, hot, active, lines;
+    enum irq_item node_items[] = {
+        IRQ_NAME,        IRQ_TYPE,
+        IRQ_DESCRIPTION, IRQ_TOTAL,
+        IRQ_CPUS,        IRQ_DELTA_TOTAL,
+        IRQ_DELTA_CPUS };
+    enum rel_enums {
+        irq_NAME, irq_TYPE, irq_DESC, irq_TOTAL, irq_CPUS,
+        irq_DELTA, irq_DCPUS };
+
+    if (procps_irq_new(&irq_info) < 0)
+        xerr(EXIT_FAILURE, _("Unable to create irq structure"));
+
+    for (i = 0; infinite_updates || i < num_updates; i++) {
+        if (!(reaped = procps_irq_reap(irq_info, node_items, MAX_ITEMS)))
+            xerrx(EXIT_FAILURE, _("Unable to get irq data"));
+        /* like the other modes, the first report averages what was
+           counted since boot, but each later one only the delay */
+        secs = sleep_time;
+        if (!i && procps_uptime(&uptime, NULL) >= 0 && uptime > 0)
+            secs = uptime;
+        if (!(procps_irq_sort(irq_info, reaped->stacks, reaped->total
+            , i ? IRQ_DELTA_TOTAL : IRQ_TOTAL, IRQ_SORT_DESCEND)))
+            xerrx(EXIT_FAILURE, _("Unable to sort irq nodes"));
+        ncpus = procps_irq_cpus(irq_info);
+
+        if (i || !y_option) {
+            if (moreheaders || i == (unsigned long)y_option)
+                irqheader();
+            for (j = lines = 0; j < reaped->total; j++) {
+                struct irq_stack *p = reaped->stacks[j];
+                const unsigned long *cpus = i ? irqVAL(irq_DCPUS, ul_cpus) : irqVAL(irq_CPUS, ul_cpus);
+
+                count = i ? (unsigned long)irqVAL(irq_DELTA, s_int) : irqVAL(irq_TOTAL, ul_int);
+                // the idle ones would only bury those of interest
+                if (!count)
+                    continue;
+                for (k = active = 0, hot = -1, max = 0; k < ncpus; k++) {
+                    if (!cpus[k])
+                        continue;
+                    active++;
+                    if (cpus[k] > max) {
+                        max = cpus[k];
+                        hot = k;
+                    }
+                }
+                if (moreheaders && lines && ((lines % height) == 0))
+                    irqheader();
+                lines++;
+                // ERR and MIS are only counted in total, never per cpu
+                if (hot < 0)
+                    printf("%-10.10s %12lu %10.1f %5s %5s %5s  %s\n",
+                        irqVAL(irq_NAME, str), irqVAL(irq_TOTAL, ul_int),
+                        count / secs, "-", "-", "-", irqVAL(irq_DESC, str));
+                else
+                    printf("%-10.10s %12lu %10.1f %5d %5d %5.0f  %s\n",
+                        irqVAL(irq_NAME, str), irqVAL(irq_TOTAL, ul_int),
+                        count / secs, active, hot, max * 100.0 / count,
+                        irqVAL(irq_TYPE, s_int) == IRQ_TYPE_SOFT ? _("softirq") : irqVAL(irq_DESC, str));
+            }
+            if (infinite_updates || i+1 < num_updates)
+                printf("\n");
+        }
+        if (infinite_updates || i+1 < num_updates)
+            sleep(sleep_time);
+    }
+    procps_irq_unref(&irq_info);
+ #undef MAX_ITEMS
+ #undef irqVAL
+}
+
+static void netheader(void)
+{
+    printf("%-15s %10s %10s %9s %8s %10s %10s %9s %8s\n",
+    /* Translation Hint: Translating folloging network fields that
+     * follow (marked with max x chars) might not work, unless
+     * manual page is translated as well.  */
+           /* Translation Hint: max 15 chars */
+           _("interface"),
+           /* Translation Hint: max 10 chars */
+           _("rx kB/s"),
+           /* Translation Hint: max 10 chars */
+           _("rx pkt/s"),
+           /* Translation Hint: max 9 chars */
+           _("rx drop/s"),
+           /* Translation Hint: max 8 chars */
+           _("rx err/s"),
+           /* Translation Hint: max 10 chars */
+           _("tx kB/s"),
+           /* Translation Hint: max 10 chars */
+           _("tx pkt/s"),
+           /* Translation Hint: max 9 chars */
+           _("tx drop/s"),
+           /* Translation Hint: max 8 chars */
+           _("tx err/s"));
+}
+
+static void netformat(void)
+{
+ #define MAX_ITEMS (int)(sizeof(node_items) / sizeof(node_items[0]))
+ #define netVAL(e) NETDEV_VAL(e, ul_int, p)
+    struct netdev_info *net_info = NULL;
+    struct netdev_reaped *reaped;
+    unsigned long i;
+    double uptime, secs;
+    int j, lines, d;
+    enum netdev_item node_items[] = {
+        NETDEV_NAME,
+        NETDEV_RX_BYTES,         NETDEV_RX_PACKETS,
+        NETDEV_RX_DROPPED,       NETDEV_RX_ERRORS,
+        NETDEV_TX_BYTES,         NETDEV_TX_PACKETS,
+        NETDEV_TX_DROPPED,       NETDEV_TX_ERRORS,
+        NETDEV_DELTA_RX_BYTES,   NETDEV_DELTA_RX_PACKETS,
+        NETDEV_DELTA_RX_DROPPED, NETDEV_DELTA_RX_ERRORS,
+        NETDEV_DELTA_TX_BYTES,   NETDEV_DELTA_TX_PACKETS,
+        NETDEV_DELTA_TX_DROPPED, NETDEV_DELTA_TX_ERRORS };
+    enum rel_enums {
+        net_NAME,
+        net_RX_BYTES, net_RX_PACKETS, net_RX_DROPPED, net_RX_ERRORS,
+        net_TX_BYTES, net_TX_PACKETS, net_TX_DROPPED, net_TX_ERRORS };
+    /* each delta item follows its total by this many */
+    enum { net_DELTA = net_TX_ERRORS };
+
+    if (procps_netdev_new(&net_info) < 0)
+        xerr(EXIT_FAILURE, _("Unable to create network structure"));
+
+    for (i = 0; infinite_updates || i < num_updates; i++) {
+        if (!(reaped = procps_netdev_reap(net_info, node_items, MAX_ITEMS)))
+            xerrx(EXIT_FAILURE, _("Unable to get network data"));
+        /* like the other modes, the first report averages what was
+           counted since boot, but each later one only the delay */
+        secs = sleep_time;
+        if (!i && procps_uptime(&uptime, NULL) >= 0 && uptime > 0)
+            secs = uptime;
+        d = i ? net_DELTA : 0;
+
+        if (i || !y_option) {
+            if (moreheaders || i == (unsigned long)y_option)
+                netheader();
+            for (j = lines = 0; j < reaped->total; j++) {
+                struct netdev_stack *p = reaped->stacks[j];
+
+                if (moreheaders && lines && ((lines % height) == 0))
+                    netheader();
+                lines++;
+                printf("%-15.15s %10.1f %10.1f %9.1f %8.1f %10.1f %10.1f %9.1f %8.1f\n",
+                    NETDEV_VAL(net_NAME, str, p),
+                    netVAL(net_RX_BYTES + d) / 1024.0 / secs,
+                    netVAL(net_RX_PACKETS + d) / secs,
+                    netVAL(net_RX_DROPPED + d) / secs,
+                    netVAL(net_RX_ERRORS + d) / secs,
+                    netVAL(net_TX_BYTES + d) / 1024.0 / secs,
+                    netVAL(net_TX_PACKETS + d) / secs,
+                    netVAL(net_TX_DROPPED + d) / secs,
+                    netVAL(net_TX_ERRORS + d) / secs);
+            }
+            if (infinite_updates || i+1 < num_updates)
+                printf("\n");
+        }
+        if (infinite_updates || i+1 < num_updates)
+            sleep(sleep_time);
+    }
+    procps_netdev_unref(&net_info);
+ #undef MAX_ITEMS
+ #undef netVAL
+}
+
+static void fragheader(void)
+{
+    printf("%4s %-8s %10s %10s %10s %10s %10s %7s %7s %7s %8s\n",
+    /* Translation Hint: Translating folloging fragmentation fields that
+     * follow (marked with max x chars) might not work, unless
+     * manual page is translated as well.  */
+           /* Translation Hint: max 4 chars */
+           _("node"),
+           /* Translation Hint: max 8 chars */
+           _("zone"),
+           /* Translation Hint: max 10 chars */
+           _("free"),
+           /* Translation Hint: max 10 chars */
+           _("min"),
+           /* Translation Hint: max 10 chars */
+           _("low"),
+           /* Translation Hint: max 10 chars */
+           _("high"),
+           /* Translation Hint: max 10 chars */
+           _("headroom"),
+           /* Translation Hint: max 7 chars */
+           _("largest"),
+           /* Translation Hint: max 7 chars */
+           _("costly"),
+           /* Translation Hint: max 7 chars */
+           _("thp"),
+           /* Translation Hint: max 8 chars */
+           _("unusable"));
+}
+
+static void fragformat(void)
+{
+ #define MAX_ITEMS (int)(sizeof(node_items) / sizeof(node_items[0]))
+ #define fragMEM(e) unitConvert(ZONES_VAL(e, ul_int, p) * kb_per_page)
+    struct zones_info *zone_info = NULL;
+    struct zones_reaped *reaped;
+    unsigned long i, kb_per_page = sysconf(_SC_PAGESIZE) / 1024ul;
+    long headroom;
+    int j, lines;
+    enum zones_item node_items[] = {
+        ZONES_NODE,              ZONES_NAME,
+        ZONES_PAGES_FREE,        ZONES_PAGES_MIN,
+        ZONES_PAGES_LOW,         ZONES_PAGES_HIGH,
+        ZONES_DISTANCE_LOW,      ZONES_LARGEST_ORDER,
+        ZONES_FRAG_INDEX_COSTLY, ZONES_FRAG_INDEX_HUGE,
+        ZONES_UNUSABLE_HUGE };
+    enum rel_enums {
+        frag_NODE, frag_NAME, frag_FREE, frag_MIN, frag_LOW, frag_HIGH,
+        frag_DIST, frag_ORDER, frag_COSTLY, frag_HUGE, frag_UNUSABLE };
+
+    if (procps_zones_new(&zone_info) < 0)
+        xerr(EXIT_FAILURE, _("Unable to create zones structure"));
+
+    for (i = 0; infinite_updates || i < num_updates; i++) {
+        if (!(reaped = procps_zones_reap(zone_info, node_items, MAX_ITEMS)))
+            xerrx(EXIT_FAILURE, _("Unable to get zones data"));
+
+        if (i || !y_option) {
+            if (moreheaders || i == (unsigned long)y_option)
+                fragheader();
+            for (j = lines = 0; j < reaped->total; j++) {
+                struct zones_stack *p = reaped->stacks[j];
+
+                if (moreheaders && lines && ((lines % height) == 0))
+                    fragheader();
+                lines++;
+                /* below the low watermark, kswapd is awake, and below min,
+                   allocations themselves are stalling to reclaim */
+                headroom = ZONES_VAL(frag_DIST, sl_int, p);
+                printf("%4d %-8.8s %10lu %10lu %10lu %10lu %10ld %7d %7.3f %7.3f %8.3f\n",
+                    ZONES_VAL(frag_NODE, s_int, p),
+                    ZONES_VAL(frag_NAME, str, p),
+                    fragMEM(frag_FREE),
+                    fragMEM(frag_MIN),
+                    fragMEM(frag_LOW),
+                    fragMEM(frag_HIGH),
+                    headroom < 0
+                        ? -(long)unitConvert(-headroom * kb_per_page)
+                        : (long)unitConvert(headroom * kb_per_page),
+                    ZONES_VAL(frag_ORDER, s_int, p),
+                    ZONES_VAL(frag_COSTLY, real, p),
+                    ZONES_VAL(frag_HUGE, real, p),
+                    ZONES_VAL(frag_UNUSABLE, real, p));
+            }
+            if (infinite_updates || i+1 < num_updates)
+                printf("\n");
+        }
+        if (infinite_updates || i+1 < num_updates)
+            sleep(sleep_time);
+    }
+    procps_zones_unref(&zone_info);
+ #undef MAX_ITEMS
+ #undef fragMEM
+}
+
 static void disksum_format(void)
 {
 #define diskVAL(e,t) DISKSTATS_VAL(e, t, reap->stacks[j])
@@ -973,8 +1273,11 @@ int main(int argc, char *argv[])
     static const struct option longopts[] = {
         {"active", no_argument, NULL, 'a'},
         {"forks", no_argument, NULL, 'f'},
+        {"fragmentation", no_argument, NULL, 'F'},
+        {"irqs", no_argument, NULL, 'i'},
         {"slabs", no_argument, NULL, 'm'},
         {"one-header", no_argument, NULL, 'n'},
+        {"network", no_argument, NULL, 'N'},
         {"stats", no_argument, NULL, 's'},
         {"disk", no_argument, NULL, 'd'},
         {"disk-sum", no_argument, NULL, 'D'},
@@ -997,7 +1300,7 @@ int main(int argc, char *argv[])
     atexit(close_stdout);
 
     while ((c =
-        getopt_long(argc, argv, "afmnsdDp:S:wthVy", longopts, NULL)) != -1)
+        getopt_long(argc, argv, "afFimnNsdDp:S:wthVy", longopts, NULL)) != -1)
         switch (c) {
         case 'V':
             printf(PROCPS_NG_VERSION);
@@ -1015,6 +1318,12 @@ int main(int argc, char *argv[])
             /* FIXME: check for conflicting args */
             fork_format();
             exit(0);
+        case 'F':
+            statMode |= FRAGSTAT;
+            break;
+        case 'i':
+            statMode |= IRQSTAT;
+            break;
         case 'm':
             statMode |= SLABSTAT;
             break;
@@ -1025,6 +1334,9 @@ int main(int argc, char *argv[])
             /* print only one header */
             moreheaders = FALSE;
             break;
+        case 'N':
+            statMode |= NETSTAT;
+            break;
         case 'p':
             statMode |= PARTITIONSTAT;
             partition = optarg;
@@ -1110,6 +1422,15 @@ int main(int argc, char *argv[])
     case (SLABSTAT):
         slabformat();
         break;
+    case (IRQSTAT):
+        irqformat();
+        break;
+    case (NETSTAT):
+        netformat();
+        break;
+    case (FRAGSTAT):
+        fragformat();
+        break;
     case (DISKSUMSTAT):
         disksum_format();
         break;
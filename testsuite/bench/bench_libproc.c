@@ -0,0 +1,343 @@
+/* bench_libproc.c - Time libproc2 reap, sort and format operations
+ *
+ * Normally run via 'make bench' against a synthetic tree produced by
+ * mkprocfs (and named by LIBPROC_PROC_ROOT), though it works just as
+ * well with the real /proc.  Each operation is repeated and its best
+ * time reported.  When given a prior run's output as a baseline, any
+ * operation slower by more than BENCH_TOLERANCE percent (default 10)
+ * is reported as a regression and the exit status will be non-zero.
+ *
+ * Usage:   ./bench_libproc [ <BASELINE> ]
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "diskstats.h"
+#include "meminfo.h"
+#include "misc.h"
+#include "pids.h"
+#include "slabinfo.h"
+#include "stat.h"
+
+#define REPEATS  5
+#define MAXTIMES 32
+#define FRAMES   20          /* successive sorts of the slowly changing tasks */
+#define CHANGING 100         /* one task in this many changes between frames */
+#define MAXTBL(t) (int)(sizeof(t) / sizeof(t[0]))
+
+static struct {
+	const char *name;
+	double ms;
+} Times[MAXTIMES];
+static int Ntimes;
+
+static char Line[4096];
+static size_t Formatted;   /* keeps the formatting from being optimized away */
+
+static double now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void record(const char *name, double ms)
+{
+	int i;
+
+	for (i = 0; i < Ntimes; i++)
+		if (!strcmp(Times[i].name, name))
+			break;
+	if (i == Ntimes) {
+		if (Ntimes >= MAXTIMES)
+			return;
+		Times[Ntimes].name = name;
+		Times[Ntimes++].ms = ms;
+	} else if (ms < Times[i].ms)
+		Times[i].ms = ms;
+}
+
+#define TIMED(name, code) { double _b = now_ms(); code; record(name, now_ms() - _b); }
+
+static void bench_pids(enum pids_fetch_type which, const char *reap, const char *sort, const char *format)
+{
+	enum pids_item items[] = {
+		PIDS_ID_PID, PIDS_ID_PPID, PIDS_ID_EUSER, PIDS_STATE, PIDS_TICS_ALL,
+		PIDS_MEM_RES, PIDS_MEM_VIRT, PIDS_CMD, PIDS_CGROUP, PIDS_CMDLINE };
+	struct pids_info *info = NULL;
+	struct pids_fetch *fetch = NULL;
+	int i, j;
+
+	if (procps_pids_new(&info, items, MAXTBL(items)) < 0) {
+		perror("procps_pids_new");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < REPEATS; i++) {
+		TIMED(reap, fetch = procps_pids_reap(info, which));
+		if (!fetch) {
+			perror("procps_pids_reap");
+			exit(EXIT_FAILURE);
+		}
+		TIMED(sort, procps_pids_sort(info, fetch->stacks, fetch->counts->total,
+			PIDS_MEM_RES, PIDS_SORT_DESCEND));
+		TIMED(format,
+			for (j = 0; j < fetch->counts->total; j++) {
+				struct pids_stack *s = fetch->stacks[j];
+				Formatted += snprintf(Line, sizeof(Line),
+					"%7d %7d %-8.8s %c %10llu %8lu %9lu %-15s %s %s\n",
+					PIDS_VAL(0, s_int, s), PIDS_VAL(1, s_int, s),
+					PIDS_VAL(2, str, s), PIDS_VAL(3, s_ch, s),
+					PIDS_VAL(4, ull_int, s), PIDS_VAL(5, ul_int, s),
+					PIDS_VAL(6, ul_int, s), PIDS_VAL(7, str, s),
+					PIDS_VAL(8, str, s), PIDS_VAL(9, str, s));
+			});
+	}
+	procps_pids_unref(&info);
+}
+
+/*
+ * Sort the same tasks, frame after frame, as top would.  Between frames a
+ * few of them change their resident memory, and the stacks come back in
+ * their original reap order.  Both ordinary and hinted sorts are timed,
+ * with their compares per frame reported as a comment.
+ */
+static void bench_resort(void)
+{
+	enum pids_item items[] = { PIDS_ID_PID, PIDS_MEM_RES };
+	struct pids_info *info = NULL;
+	struct pids_sort_hint *hint = NULL;
+	struct pids_fetch *fetch;
+	struct pids_stack **reaped, **stacks;
+	struct procps_cost *cost;
+	unsigned long plain = 0, hinted = 0, seed = 1;
+	int i, j, num;
+
+	if (procps_pids_new(&info, items, MAXTBL(items)) < 0
+	|| !(cost = procps_pids_cost(info))
+	|| !(fetch = procps_pids_reap(info, PIDS_FETCH_THREADS_TOO))) {
+		perror("procps_pids_reap");
+		exit(EXIT_FAILURE);
+	}
+	num = fetch->counts->total;
+	if (!(reaped = malloc(sizeof(void *) * num))
+	|| !(stacks = malloc(sizeof(void *) * num))) {
+		perror("malloc");
+		exit(EXIT_FAILURE);
+	}
+	memcpy(reaped, fetch->stacks, sizeof(void *) * num);
+
+	for (i = 0; i < FRAMES; i++) {
+		for (j = 0; j < num; j++) {
+			seed = seed * 1103515245 + 12345;
+			if ((seed >> 16) % CHANGING == 0)
+				PIDS_VAL(1, ul_int, reaped[j]) = (seed >> 8) % 65536;
+		}
+		memcpy(stacks, reaped, sizeof(void *) * num);
+		cost->compares = 0;
+		TIMED("pids resort", procps_pids_sort(info, stacks, num,
+			PIDS_MEM_RES, PIDS_SORT_DESCEND));
+		plain += cost->compares;
+
+		memcpy(stacks, reaped, sizeof(void *) * num);
+		cost->compares = 0;
+		TIMED("pids resort hinted", procps_pids_sort_hinted(info, &hint, stacks, num,
+			PIDS_MEM_RES, PIDS_SORT_DESCEND));
+		// the first frame has no hint to go on, so it's no fair comparison
+		if (i)
+			hinted += cost->compares;
+	}
+	printf("# resorting %d tasks, 1 in %d changing: %lu compares/frame, %lu hinted\n",
+		num, CHANGING, plain / FRAMES, hinted / (FRAMES - 1));
+	free(stacks);
+	free(reaped);
+	procps_pids_unref(&info);
+}
+
+static void bench_stat(void)
+{
+	enum stat_item items[] = {
+		STAT_TIC_ID, STAT_TIC_USER, STAT_TIC_SYSTEM, STAT_TIC_IDLE };
+	struct stat_info *info = NULL;
+	struct stat_reaped *reaped = NULL;
+	int i, j;
+
+	if (procps_stat_new(&info) < 0) {
+		perror("procps_stat_new");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < REPEATS; i++) {
+		TIMED("stat reap", reaped = procps_stat_reap(info, STAT_REAP_CPUS_ONLY,
+			items, MAXTBL(items)));
+		if (!reaped) {
+			perror("procps_stat_reap");
+			exit(EXIT_FAILURE);
+		}
+		TIMED("stat sort", procps_stat_sort(info, reaped->cpus->stacks,
+			reaped->cpus->total, STAT_TIC_USER, STAT_SORT_DESCEND));
+		TIMED("stat format",
+			for (j = 0; j < reaped->cpus->total; j++) {
+				struct stat_stack *s = reaped->cpus->stacks[j];
+				Formatted += snprintf(Line, sizeof(Line), "%4d %12llu %12llu %12llu\n",
+					STAT_VAL(0, s_int, s), STAT_VAL(1, ull_int, s),
+					STAT_VAL(2, ull_int, s), STAT_VAL(3, ull_int, s));
+			});
+	}
+	procps_stat_unref(&info);
+}
+
+static void bench_meminfo(void)
+{
+	enum meminfo_item items[] = {
+		MEMINFO_MEM_TOTAL, MEMINFO_MEM_FREE, MEMINFO_MEM_AVAILABLE, MEMINFO_SWAP_FREE };
+	struct meminfo_info *info = NULL;
+	struct meminfo_stack *s = NULL;
+	int i;
+
+	if (procps_meminfo_new(&info) < 0) {
+		perror("procps_meminfo_new");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < REPEATS; i++) {
+		TIMED("meminfo select", s = procps_meminfo_select(info, items, MAXTBL(items)));
+		if (!s) {
+			perror("procps_meminfo_select");
+			exit(EXIT_FAILURE);
+		}
+		TIMED("meminfo format",
+			Formatted += snprintf(Line, sizeof(Line), "%lu %lu %lu %lu\n",
+				MEMINFO_VAL(0, ul_int, s), MEMINFO_VAL(1, ul_int, s),
+				MEMINFO_VAL(2, ul_int, s), MEMINFO_VAL(3, ul_int, s)));
+	}
+	procps_meminfo_unref(&info);
+}
+
+static void bench_diskstats(void)
+{
+	enum diskstats_item items[] = {
+		DISKSTATS_NAME, DISKSTATS_READS, DISKSTATS_WRITES, DISKSTATS_IO_TIME };
+	struct diskstats_info *info = NULL;
+	struct diskstats_reaped *reaped = NULL;
+	int i, j;
+
+	if (procps_diskstats_new(&info) < 0) {
+		perror("procps_diskstats_new");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < REPEATS; i++) {
+		TIMED("diskstats reap", reaped = procps_diskstats_reap(info, items, MAXTBL(items)));
+		if (!reaped) {
+			perror("procps_diskstats_reap");
+			exit(EXIT_FAILURE);
+		}
+		TIMED("diskstats sort", procps_diskstats_sort(info, reaped->stacks,
+			reaped->total, DISKSTATS_READS, DISKSTATS_SORT_DESCEND));
+		TIMED("diskstats format",
+			for (j = 0; j < reaped->total; j++) {
+				struct diskstats_stack *s = reaped->stacks[j];
+				Formatted += snprintf(Line, sizeof(Line), "%-10s %10lu %10lu %10lu\n",
+					DISKSTATS_VAL(0, str, s), DISKSTATS_VAL(1, ul_int, s),
+					DISKSTATS_VAL(2, ul_int, s), DISKSTATS_VAL(3, ul_int, s));
+			});
+	}
+	procps_diskstats_unref(&info);
+}
+
+static void bench_slabinfo(void)
+{
+	enum slabinfo_item items[] = {
+		SLAB_NAME, SLAB_NUM_OBJS, SLAB_OBJ_SIZE, SLAB_SIZE_TOTAL };
+	struct slabinfo_info *info = NULL;
+	struct slabinfo_reaped *reaped = NULL;
+	int i, j;
+
+	if (procps_slabinfo_new(&info) < 0) {
+		perror("procps_slabinfo_new");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < REPEATS; i++) {
+		TIMED("slabinfo reap", reaped = procps_slabinfo_reap(info, items, MAXTBL(items)));
+		if (!reaped) {
+			perror("procps_slabinfo_reap");
+			exit(EXIT_FAILURE);
+		}
+		TIMED("slabinfo sort", procps_slabinfo_sort(info, reaped->stacks,
+			reaped->total, SLAB_SIZE_TOTAL, SLABINFO_SORT_DESCEND));
+		TIMED("slabinfo format",
+			for (j = 0; j < reaped->total; j++) {
+				struct slabinfo_stack *s = reaped->stacks[j];
+				Formatted += snprintf(Line, sizeof(Line), "%-24s %8u %6u %10lu\n",
+					SLABINFO_VAL(0, str, s), SLABINFO_VAL(1, u_int, s),
+					SLABINFO_VAL(2, u_int, s), SLABINFO_VAL(3, ul_int, s));
+			});
+	}
+	procps_slabinfo_unref(&info);
+}
+
+/* compare with a prior run's output, returning the number of regressions */
+static int compare(const char *baseline)
+{
+	char buf[256], name[64];
+	double tol = 10.0, ms;
+	const char *env;
+	int i, bad = 0;
+	FILE *fp;
+
+	if ((env = getenv("BENCH_TOLERANCE")))
+		tol = atof(env);
+	if (!(fp = fopen(baseline, "r"))) {
+		perror(baseline);
+		exit(EXIT_FAILURE);
+	}
+	while (fgets(buf, sizeof(buf), fp)) {
+		if (2 != sscanf(buf, "%63[^:]: %lf ms", name, &ms))
+			continue;
+		for (i = 0; i < Ntimes; i++) {
+			if (strcmp(Times[i].name, name))
+				continue;
+			if (Times[i].ms > ms * (1.0 + tol / 100.0)) {
+				printf("REGRESSION %s: %.3f ms, was %.3f ms (+%.1f%%)\n",
+					name, Times[i].ms, ms, (Times[i].ms / ms - 1.0) * 100.0);
+				++bad;
+			}
+			break;
+		}
+	}
+	fclose(fp);
+	return bad;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *root = getenv("LIBPROC_PROC_ROOT");
+	int i;
+
+	if (argc > 2) {
+		fprintf(stderr, "Usage: %s [ <BASELINE> ]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	bench_pids(PIDS_FETCH_TASKS_ONLY, "pids reap", "pids sort", "pids format");
+	bench_pids(PIDS_FETCH_THREADS_TOO, "pids reap threads", "pids sort threads", "pids format threads");
+	bench_resort();
+	bench_stat();
+	bench_meminfo();
+	bench_diskstats();
+	bench_slabinfo();
+
+	printf("# best of %d, procfs: %s, %zu bytes formatted\n",
+		REPEATS, root ? root : "/proc", Formatted);
+	for (i = 0; i < Ntimes; i++)
+		printf("%s: %.3f ms\n", Times[i].name, Times[i].ms);
+
+	if (argc == 2 && compare(argv[1]))
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
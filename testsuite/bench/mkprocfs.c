@@ -0,0 +1,299 @@
+/* mkprocfs.c - Synthesize a realistic /proc tree for benchmarks
+ *
+ * The resulting directory can be substituted for "/proc" by way of
+ * the LIBPROC_PROC_ROOT environment variable, so that libproc2 can be
+ * measured at any scale, and reproducibly, on an ordinary machine.
+ *
+ * Usage:   ./mkprocfs [-p procs] [-t threads] [-c cpus] [-d disks]
+ *                     [-s slabs] [-l cmdline-len] <DIR>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define FIRST_PID  1000
+#define KIB_TOTAL  (64UL * 1024 * 1024)
+
+#define STRINGIFY_ARG(a)  #a
+#define STRINGIFY(a)      STRINGIFY_ARG(a)
+
+static const char *root;
+static char *cmdline;
+static int cmdline_len;
+
+static void fail(const char *what)
+{
+	fprintf(stderr, "mkprocfs: %s: %s\n", what, strerror(errno));
+	exit(EXIT_FAILURE);
+}
+
+static void mkdirf(const char *fmt, ...)
+{
+	char path[PATH_MAX];
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(path, sizeof(path), fmt, ap);
+	va_end(ap);
+	if (mkdir(path, 0755) && errno != EEXIST)
+		fail(path);
+}
+
+/* write 'len' bytes of 'buf' (or all of it when 'len' < 0) to dir/name */
+static void put(const char *dir, const char *name, const char *buf, int len)
+{
+	char path[PATH_MAX];
+	FILE *fp;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+	if (!(fp = fopen(path, "w")))
+		fail(path);
+	if (len < 0)
+		len = strlen(buf);
+	if (len && fwrite(buf, len, 1, fp) != 1)
+		fail(path);
+	if (fclose(fp))
+		fail(path);
+}
+
+static void putf(const char *dir, const char *name, const char *fmt, ...)
+{
+	char *buf;
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = vasprintf(&buf, fmt, ap);
+	va_end(ap);
+	if (len < 0)
+		fail(name);
+	put(dir, name, buf, len);
+	free(buf);
+}
+
+/* the files read for both a process and each of its threads */
+static void task_files(const char *dir, int pid, int tid, int nthreads)
+{
+	unsigned long vsz = 4096UL * (1000 + pid % 50000);
+	unsigned long rss = 1 + pid % 20000;
+	char comm[16];
+
+	snprintf(comm, sizeof(comm), "bench-%d", pid % 997);
+	putf(dir, "stat",
+		"%d (%s) %c %d %d %d 0 -1 4194560 %lu 0 %lu 0 %lu %lu 0 0 20 0 %d 0 "
+		"%lu %lu %lu 18446744073709551615 1 1 0 0 0 0 0 4096 0 0 0 0 17 %d "
+		"0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+		tid, comm, "RSDI"[tid % 4], pid > FIRST_PID ? FIRST_PID : 1, pid, pid,
+		1000UL + tid, 10UL + tid % 10, 100UL * (tid % 300), 50UL * (tid % 200),
+		nthreads, 100UL + tid, vsz, rss, tid % 64);
+	putf(dir, "statm", "%lu %lu %lu 10 0 %lu 0\n",
+		vsz / 4096, rss, rss / 2, rss / 3);
+	putf(dir, "status",
+		"Name:\t%s\nUmask:\t0022\nState:\t%c (running)\nTgid:\t%d\nNgid:\t0\n"
+		"Pid:\t%d\nPPid:\t%d\nTracerPid:\t0\nUid:\t%d\t%d\t%d\t%d\n"
+		"Gid:\t%d\t%d\t%d\t%d\nFDSize:\t64\nGroups:\t4 24 27 %d\n"
+		"NStgid:\t%d\nNSpid:\t%d\nNSpgid:\t%d\nNSsid:\t%d\n"
+		"VmPeak:\t%8lu kB\nVmSize:\t%8lu kB\nVmLck:\t       0 kB\nVmPin:\t       0 kB\n"
+		"VmHWM:\t%8lu kB\nVmRSS:\t%8lu kB\nRssAnon:\t%8lu kB\nRssFile:\t%8lu kB\n"
+		"RssShmem:\t       0 kB\nVmData:\t%8lu kB\nVmStk:\t     132 kB\n"
+		"VmExe:\t     120 kB\nVmLib:\t    2048 kB\nVmPTE:\t      64 kB\n"
+		"VmSwap:\t       0 kB\nHugetlbPages:\t       0 kB\nThreads:\t%d\n"
+		"SigQ:\t0/63378\nSigPnd:\t0000000000000000\nShdPnd:\t0000000000000000\n"
+		"SigBlk:\t0000000000000000\nSigIgn:\t0000000000001000\n"
+		"SigCgt:\t0000000180004a02\nCapInh:\t0000000000000000\n"
+		"CapPrm:\t0000000000000000\nCapEff:\t0000000000000000\n"
+		"CapBnd:\t000001ffffffffff\nCapAmb:\t0000000000000000\n"
+		"Cpus_allowed:\tffff\nCpus_allowed_list:\t0-15\n"
+		"voluntary_ctxt_switches:\t%d\nnonvoluntary_ctxt_switches:\t%d\n",
+		comm, "RSDI"[tid % 4], pid, tid, pid > FIRST_PID ? FIRST_PID : 1,
+		pid % 7, pid % 7, pid % 7, pid % 7, pid % 5, pid % 5, pid % 5, pid % 5,
+		1000 + pid % 5, pid, tid, pid, pid,
+		vsz / 1024, vsz / 1024, rss * 4, rss * 4, rss * 3, rss,
+		vsz / 2048, nthreads, tid % 1000, tid % 100);
+	put(dir, "cmdline", cmdline, cmdline_len);
+	putf(dir, "io", "rchar: %d\nwchar: %d\nsyscr: 10\nsyscw: 5\n"
+		"read_bytes: 4096\nwrite_bytes: 0\ncancelled_write_bytes: 0\n",
+		tid * 10, tid * 5);
+	putf(dir, "cgroup", "0::/system.slice/bench-%d.service\n", pid % 97);
+	putf(dir, "environ", "HOME=/root%cPATH=/usr/bin:/bin%cBENCH=%d%c",
+		0, 0, pid, 0);
+	putf(dir, "loginuid", "%d", pid % 7);
+	putf(dir, "oom_score", "%d\n", pid % 1000);
+	putf(dir, "oom_score_adj", "0\n");
+	putf(dir, "wchan", "%s", tid % 4 == 1 ? "do_select" : "0");
+}
+
+static void processes(int nprocs, int nthreads)
+{
+	char dir[PATH_MAX];
+	int i, j, pid;
+
+	for (i = 0; i < nprocs; i++) {
+		pid = FIRST_PID + i * nthreads;
+		snprintf(dir, sizeof(dir), "%s/%d", root, pid);
+		mkdirf("%s", dir);
+		task_files(dir, pid, pid, nthreads);
+		mkdirf("%s/task", dir);
+		for (j = 0; j < nthreads; j++) {
+			snprintf(dir, sizeof(dir), "%s/%d/task/%d", root, pid, pid + j);
+			mkdirf("%s", dir);
+			task_files(dir, pid, pid + j, nthreads);
+		}
+	}
+	/* libproc2 looks for a task directory via "self" */
+	snprintf(dir, sizeof(dir), "%s/self", root);
+	unlink(dir);
+	if (nprocs && symlink(STRINGIFY(FIRST_PID), dir))
+		fail(dir);
+}
+
+static void system_files(int nprocs, int nthreads, int ncpus, int ndisks, int nslabs)
+{
+	char dir[PATH_MAX], *buf = NULL;
+	size_t len = 0;
+	FILE *fp;
+	int i;
+
+	if (!(fp = open_memstream(&buf, &len)))
+		fail("open_memstream");
+	fprintf(fp, "cpu  %d %d %d %d %d %d %d 0 0 0\n",
+		ncpus * 1000, ncpus * 10, ncpus * 500, ncpus * 90000,
+		ncpus * 100, 0, ncpus * 20);
+	for (i = 0; i < ncpus; i++)
+		fprintf(fp, "cpu%d %d %d %d %d %d %d %d 0 0 0\n",
+			i, 1000 + i, 10, 500 + i, 90000 - i, 100, 0, 20);
+	fprintf(fp, "intr 123456789\nctxt 987654321\nbtime 1700000000\n"
+		"processes %d\nprocs_running %d\nprocs_blocked 0\n"
+		"softirq 1234 0 0 0 0 0 0 0 0 0 0\n",
+		nprocs * nthreads, ncpus);
+	fflush(fp);
+	put(root, "stat", buf, len);
+	rewind(fp);
+	len = 0;
+
+	for (i = 0; i < ncpus; i++)
+		fprintf(fp, "processor\t: %d\nvendor_id\t: GenuineBench\n"
+			"model name\t: Synthetic CPU\ncpu MHz\t\t: 2400.000\n"
+			"physical id\t: %d\ncore id\t\t: %d\ncpu cores\t: %d\n\n",
+			i, i / 64, i % 64, ncpus < 64 ? ncpus : 64);
+	fflush(fp);
+	put(root, "cpuinfo", buf, len);
+	rewind(fp);
+	len = 0;
+
+	for (i = 0; i < ndisks; i++) {
+		int j;
+		fprintf(fp, "%4d %7d sd%c%c %d 10 %d 300 %d 20 %d 400 0 500 700 0 0 0 0 5 6\n",
+			8 + i / 16, (i % 16) * 16, 'a' + i / 26 % 26, 'a' + i % 26,
+			1000 + i, 80000 + i, 2000 + i, 90000 + i);
+		for (j = 1; j <= 3; j++)
+			fprintf(fp, "%4d %7d sd%c%c%d %d 1 %d 30 %d 2 %d 40 0 50 70 0 0 0 0 0 0\n",
+				8 + i / 16, (i % 16) * 16 + j, 'a' + i / 26 % 26, 'a' + i % 26, j,
+				100 + j, 8000 + j, 200 + j, 9000 + j);
+	}
+	fflush(fp);
+	put(root, "diskstats", buf, len);
+	rewind(fp);
+	len = 0;
+
+	fprintf(fp, "slabinfo - version: 2.1\n"
+		"# name            <active_objs> <num_objs> <objsize> <objperslab> "
+		"<pagesperslab> : tunables <limit> <batchcount> <sharedfactor> "
+		": slabdata <active_slabs> <num_slabs> <sharedavail>\n");
+	for (i = 0; i < nslabs; i++)
+		fprintf(fp, "bench_cache_%-8d %6d %6d %4d %3d %2d : tunables 0 0 0 "
+			": slabdata %5d %5d 0\n",
+			i, 900 + i % 100, 1000 + i % 100, 64 << (i % 6), (64 >> (i % 6)) + 1,
+			1 << (i % 3), 30 + i % 10, 32 + i % 10);
+	fflush(fp);
+	put(root, "slabinfo", buf, len);
+	fclose(fp);
+	free(buf);
+
+	putf(root, "meminfo",
+		"MemTotal:       %lu kB\nMemFree:        %lu kB\nMemAvailable:   %lu kB\n"
+		"Buffers:          123456 kB\nCached:          4567890 kB\n"
+		"SwapCached:            0 kB\nActive:          3456789 kB\n"
+		"Inactive:        2345678 kB\nActive(anon):    1234567 kB\n"
+		"Inactive(anon):   123456 kB\nActive(file):    2222222 kB\n"
+		"Inactive(file):  2222222 kB\nUnevictable:           0 kB\n"
+		"Mlocked:               0 kB\nSwapTotal:       8388604 kB\n"
+		"SwapFree:        8388604 kB\nDirty:               100 kB\n"
+		"Writeback:             0 kB\nAnonPages:       1357913 kB\n"
+		"Mapped:           456789 kB\nShmem:            123456 kB\n"
+		"KReclaimable:     234567 kB\nSlab:             345678 kB\n"
+		"SReclaimable:     234567 kB\nSUnreclaim:       111111 kB\n"
+		"KernelStack:       %d kB\nPageTables:        56789 kB\n"
+		"CommitLimit:    40000000 kB\nCommitted_AS:    9876543 kB\n"
+		"VmallocTotal:   34359738367 kB\nVmallocUsed:       98765 kB\n"
+		"HugePages_Total:       0\nHugePages_Free:        0\n"
+		"Hugepagesize:       2048 kB\n",
+		KIB_TOTAL, KIB_TOTAL / 2, KIB_TOTAL * 3 / 4, nprocs * nthreads * 16);
+	putf(root, "uptime", "123456.78 %d.00\n", ncpus * 100000);
+	putf(root, "loadavg", "1.00 0.75 0.50 %d/%d %d\n",
+		ncpus, nprocs * nthreads, FIRST_PID + nprocs * nthreads);
+	putf(root, "vmstat", "nr_free_pages %lu\npgpgin 123456\npgpgout 654321\n"
+		"pswpin 0\npswpout 0\npgfault 987654321\npgmajfault 1234\n",
+		KIB_TOTAL / 8);
+	mkdirf("%s/sys", root);
+	mkdirf("%s/sys/kernel", root);
+	snprintf(dir, sizeof(dir), "%s/sys/kernel", root);
+	putf(dir, "pid_max", "4194304\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int nprocs = 10000, nthreads = 4, ncpus = 64, ndisks = 32, nslabs = 200;
+	int opt, i;
+
+	cmdline_len = 256;
+	while ((opt = getopt(argc, argv, "p:t:c:d:s:l:")) != -1) {
+		switch (opt) {
+		case 'p': nprocs = atoi(optarg); break;
+		case 't': nthreads = atoi(optarg); break;
+		case 'c': ncpus = atoi(optarg); break;
+		case 'd': ndisks = atoi(optarg); break;
+		case 's': nslabs = atoi(optarg); break;
+		case 'l': cmdline_len = atoi(optarg); break;
+		default:
+			goto usage;
+		}
+	}
+	if (optind + 1 != argc || nprocs < 0 || nthreads < 1 || ncpus < 1
+	|| ndisks < 0 || nslabs < 0 || cmdline_len < 1)
+		goto usage;
+	root = argv[optind];
+
+	/* a long, nul separated, command line shared by every task */
+	if (!(cmdline = malloc(cmdline_len)))
+		fail("malloc");
+	for (i = 0; i < cmdline_len; i++)
+		cmdline[i] = (i % 16 == 15) ? '\0' : 'a' + i % 26;
+	cmdline[cmdline_len - 1] = '\0';
+
+	mkdirf("%s", root);
+	processes(nprocs, nthreads);
+	system_files(nprocs, nthreads, ncpus, ndisks, nslabs);
+	free(cmdline);
+	return EXIT_SUCCESS;
+
+usage:
+	fprintf(stderr, "Usage: %s [-p procs] [-t threads] [-c cpus] [-d disks]"
+		" [-s slabs] [-l cmdline-len] <DIR>\n", argv[0]);
+	return EXIT_FAILURE;
+}